@@ -0,0 +1,148 @@
+#include "ConversationDb.h"
+#include "ProcessStats.h"
+#include <json/json.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+//! What scenes looked like before: a heap string per line, id and node
+struct HeapScene {
+    std::vector<std::string> sequence;
+    std::map<std::string, std::vector<std::string>> data;
+} /*struct HeapScene*/;
+
+//! `scenes` scenes of 12 nodes; a few stock lines recur, as they do in real scripts
+std::string makeCorpus(std::size_t scenes)
+{
+    static const char * stock[] = {"Thank you.", "Hmm...", "Let's go!", "I don't know about that.", "Goodbye."};
+    std::mt19937 rng{7};
+    std::ostringstream out{};
+    out << "[";
+    for (std::size_t s = 0; s < scenes; ++s) {
+        out << "{\"id\":\"scene-" << s << "\",\"sequence\":[";
+        for (int step = 0; step < 16; ++step) { out << (step ? "," : "") << "\"n" << rng() % 12 << "\""; }
+        out << "],\"data\":{";
+        for (int n = 0; n < 12; ++n) {
+            out << (n ? "," : "") << "\"n" << n << "\":[";
+            const int lines = 1 + static_cast<int>(rng() % 2);
+            for (int l = 0; l < lines; ++l) {
+                out << (l ? "," : "") << "\"Speaker" << rng() % 200 << ": ";
+                if (rng() % 4 == 0) {
+                    out << stock[rng() % 5];
+                } else {
+                    out << "Line " << s << "." << n << "." << l << " of the script, long enough to wrap once or twice.";
+                }
+                out << "\"";
+            }
+            out << "]";
+        }
+        out << "}},";
+    }
+    out << "]";
+    return out.str();
+}
+
+struct Measure {
+    std::size_t before;
+    std::chrono::steady_clock::time_point start;
+
+    Measure() { resetPeak(), before = statusKiB("VmRSS"), start = std::chrono::steady_clock::now(); }
+
+    void report(const char * name, double kept)
+    {
+        const double ms = millisSince(start);
+        const double peak = static_cast<double>(statusKiB("VmHWM") - before) / 1024;
+        std::printf("%-14s %10.1f %12.1f %12.1f\n", name, ms, peak, kept / (1 << 20));
+    }
+} /*struct Measure*/;
+
+} /*namespace*/;
+
+
+int main(int argc, char ** argv)
+{
+    const std::size_t scenes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{20000};
+    const std::size_t lookups = 200000;
+    const std::string corpus = makeCorpus(scenes);
+    const std::string path = "/tmp/mint-conversations-bench.mconv";
+
+    std::printf("%zu scenes, %.1f MiB of JSON\n", scenes, static_cast<double>(corpus.size()) / (1 << 20));
+    std::printf("%-14s %10s %12s %12s\n", "load", "ms", "peak-MiB", "kept-MiB");
+
+    std::unordered_map<std::string, HeapScene> heap;
+    {
+        Measure m{};
+        Json::Value root;
+        std::istringstream src{corpus};
+        Json::Reader{}.parse(src, root);
+        for (const auto& scene : root) {
+            HeapScene& hs = heap[scene["id"].asString()];
+            for (const auto& step : scene["sequence"]) { hs.sequence.push_back(step.asString()); }
+            for (const auto& key : scene["data"].getMemberNames()) {
+                for (const auto& line : scene["data"][key]) { hs.data[key].push_back(line.asString()); }
+            }
+        }
+        root = Json::Value{};
+        trimHeap();
+        m.report("jsoncpp+heap", static_cast<double>(statusKiB("VmRSS") - m.before) * 1024);
+    }
+
+    ConversationDb db{};
+    {
+        Measure m{};
+        ConversationBuilder builder{};
+        std::istringstream src{corpus};
+        builder.read(src);
+        db = builder.build();
+        m.report("compile", static_cast<double>(db.getMemoryUsage()));
+    }
+    {
+        std::ofstream dst{path, std::ios::binary};
+        db.write(dst);
+    }
+    ConversationDb mapped{};
+    {
+        Measure m{};
+        mapped = ConversationDb::map(path);
+        m.report("map", 0);
+    }
+
+    // Plays random scenes through, as a dialogue box would
+    std::printf("\n%-14s %10s %12s\n", "play", "ms", "ns/scene");
+    std::vector<std::string> ids;
+    std::mt19937 rng{11};
+    for (std::size_t i = 0; i < lookups; ++i) { ids.push_back("scene-" + std::to_string(rng() % scenes)); }
+
+    std::size_t chars{0};
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& id : ids) {
+        const HeapScene& hs = heap.at(id);
+        for (const auto& step : hs.sequence) {
+            for (const auto& line : hs.data.at(step)) { chars += line.size(); }
+        }
+    }
+    double ms = millisSince(start);
+    std::printf("%-14s %10.1f %12.1f\n", "heap", ms, ms * 1e6 / lookups);
+
+    for (const ConversationDb * which : {&db, &mapped}) {
+        start = std::chrono::steady_clock::now();
+        for (const auto& id : ids) {
+            which->forEachLine(which->findScene(id), [&](std::size_t, const ConversationDb::Line& line) { chars += line.text.size(); });
+        }
+        ms = millisSince(start);
+        std::printf("%-14s %10.1f %12.1f\n", which == &db ? "db" : "db-mapped", ms, ms * 1e6 / lookups);
+    }
+    std::printf("(%zu characters)\n", chars);
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include "CookedLevel.h"
+#include "ProcessStats.h"
+#include "TiledLoader.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+LevelMap makeMap(unsigned int side, unsigned int layers)
+{
+    LevelMap map{};
+    map.name = "bench";
+    map.size = {side, side};
+    map.tileSize = {16, 16};
+    for (unsigned int l = 0; l < layers; ++l) {
+        std::vector<std::uint32_t> gids(static_cast<std::size_t>(side) * side);
+        for (std::size_t i = 0; i < gids.size(); ++i) {
+            gids[i] = l > 0 && (i * 7 + l) % 5 ? 0u : static_cast<std::uint32_t>((i / 7 + l * 31) % 300 + 1);
+        }
+        map.layers.emplace_back("layer" + std::to_string(l), map.size, std::move(gids));
+    }
+    Tileset ts{};
+    ts.name = "tiles", ts.image = "tiles.png", ts.tileSize = {16, 16}, ts.columns = 24, ts.tileCount = 336;
+    map.tilesets.push_back(ts);
+    for (std::uint32_t id = 1; id <= 1000; ++id) {
+        LevelObject obj{};
+        obj.id = id, obj.name = "spawn", obj.bounds = {float(id % side) * 16, float(id / side) * 16, 16, 16};
+        map.objects.push_back(obj);
+    }
+    map.indexObjects();
+    return map;
+}
+
+void writeTmx(const LevelMap& map, const std::string& path)
+{
+    std::ofstream out{path, std::ios::binary};
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<map width=\"" << map.size.x << "\" height=\"" << map.size.y
+        << "\" tilewidth=\"16\" tileheight=\"16\">\n";
+    for (const auto& layer : map.layers) {
+        out << " <layer name=\"" << layer.getName() << "\" width=\"" << map.size.x << "\" height=\"" << map.size.y
+            << "\">\n  <data encoding=\"csv\">\n";
+        const std::size_t count = static_cast<std::size_t>(map.size.x) * map.size.y;
+        for (std::size_t i = 0; i < count; ++i) { out << layer.data()[i] << (i + 1 < count ? "," : ""); }
+        out << "\n  </data>\n </layer>\n";
+    }
+    out << " <objectgroup name=\"spawns\">\n";
+    for (const auto& obj : map.objects) {
+        out << "  <object id=\"" << obj.id << "\" name=\"spawn\" x=\"" << obj.bounds.left << "\" y=\"" << obj.bounds.top
+            << "\" width=\"16\" height=\"16\"/>\n";
+    }
+    out << " </objectgroup>\n</map>\n";
+}
+
+} /*namespace*/;
+
+
+int main(int argc, char ** argv)
+{
+    const unsigned int side = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 4096u;
+    const unsigned int layers = argc > 2 ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 3u;
+    const std::string tmx = "/tmp/mint-cooked-bench.tmx";
+    const std::string mlvl = cookedLevelPath(tmx);
+    {
+        const LevelMap map = makeMap(side, layers);
+        writeTmx(map, tmx);
+        std::ofstream dst{mlvl, std::ios::binary};
+        cookLevel(map, dst);
+    }
+
+    struct Case { const char * name; std::function<LevelMap()> load; };
+    const Case cases[] = {
+        {"tmx-csv", [&] { return readTiledFile(tmx); }},
+        {"cooked-read", [&] { std::ifstream src{mlvl, std::ios::binary}; return readCookedLevel(src); }},
+        {"cooked-mmap", [&] { return mapCookedLevel(mlvl); }},
+    };
+
+    std::printf("Loading a %ux%u map with %u layers and 1000 objects (warm page cache)\n", side, side, layers);
+    std::printf("%-12s %10s %12s %14s\n", "loader", "load-ms", "+touch-ms", "peak-over-MiB");
+    for (const Case& c : cases) {
+        resetPeak();
+        const std::size_t before = statusKiB("VmRSS");
+        const auto start = std::chrono::steady_clock::now();
+        const LevelMap map = c.load();
+        const double loadMs = millisSince(start);
+
+        // Reads every gid once, as a first render would; mapped pages fault in here
+        const auto touch = std::chrono::steady_clock::now();
+        std::uint64_t sum{0};
+        for (const auto& layer : map.layers) {
+            const std::size_t count = static_cast<std::size_t>(layer.getSize().x) * layer.getSize().y;
+            for (std::size_t i = 0; i < count; ++i) { sum += layer.data()[i]; }
+        }
+        const double touchMs = millisSince(touch);
+        const double peak = static_cast<double>(statusKiB("VmHWM") - before) / 1024;
+        std::printf("%-12s %10.2f %12.2f %14.1f   (sum %llu)\n", c.name, loadMs, touchMs, peak, static_cast<unsigned long long>(sum));
+    }
+    std::remove(tmx.c_str());
+    std::remove(mlvl.c_str());
+    return 0;
+}
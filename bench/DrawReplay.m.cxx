@@ -0,0 +1,142 @@
+#include "CommandList.h"
+#include "DrawCapture.h"
+#include "GameContext.h"
+#include "GameSettings.h"
+#include "GameWorld.h"
+#include "RenderDevice.h"
+#include "SoftwareRenderDevice.h"
+#include "SpriteBatch.h"
+#include "SpriteComp.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+//! Captures `frames` frames of a scrolling sprite field, for runs without a capture file
+std::string syntheticCapture(std::size_t frames)
+{
+    GameContext context{};
+    GameSettings settings{context.generateSettings()};
+    settings.setHeadless(true);
+    GameWorld world{context, settings};
+    sf::Texture textures[4];
+    for (std::size_t i = 0; i < 20000; ++i) {
+        auto& sprite = world.emplace<SpriteComp>(textures[i % 4], sf::IntRect{0, 0, 16, 16});
+        sprite.setPosition(static_cast<float>(i * 37 % 4000), static_cast<float>(i * 53 % 2000));
+        sprite.setLayer(static_cast<std::uint8_t>(i % 3));
+    }
+    world.update(0.f);
+
+    std::ostringstream out{};
+    DrawRecorder recorder{out};
+    NullRenderDevice device{{1280, 720}};
+    world.setDrawRecorder(&recorder);
+    for (std::size_t f = 0; f < frames; ++f) {
+        device.setView(sf::View{sf::FloatRect{f * 20.f, 0.f, 1280.f, 720.f}});
+        world.render(device);
+    }
+    return out.str();
+}
+
+struct Timing {
+    double record = 0, sort = 0, submit = 0;
+    std::size_t commands = 0, drawCalls = 0;
+} /*struct Timing*/;
+
+} /*namespace*/;
+
+
+/**
+ *  Usage: DrawReplay [capture|-] [null|software|window] [passes]
+ *
+ *  Replays every frame of a capture written by `DrawRecorder` with no game
+ *  logic, reporting per-frame record, sort and submit times averaged over
+ *  `passes`.  Without a capture (or with "-"), a synthetic one is generated.
+ */
+int main(int argc, char ** argv)
+{
+    const char * path = argc > 1 ? argv[1] : "-";
+    const char * target = argc > 2 ? argv[2] : "null";
+    const std::size_t passes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : std::size_t{20};
+
+    std::string bytes;
+    if (std::strcmp(path, "-") == 0) {
+        bytes = syntheticCapture(60);
+    } else {
+        std::ifstream file{path, std::ios::binary};
+        if (!file) {
+            std::fprintf(stderr, "can not open %s\n", path);
+            return 1;
+        }
+        bytes.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+    }
+
+    std::istringstream src{bytes};
+    DrawReplayer replayer{src};
+    std::vector<DrawFrame> frames;
+    for (DrawFrame frame{}; replayer.nextFrame(frame); ) { frames.push_back(frame); }
+    if (frames.empty()) {
+        std::fprintf(stderr, "capture holds no frames\n");
+        return 1;
+    }
+
+    const sf::Vector2u size{
+        static_cast<unsigned int>(frames[0].getView().getSize().x), static_cast<unsigned int>(frames[0].getView().getSize().y)};
+    std::unique_ptr<sf::RenderWindow> window;
+    std::unique_ptr<RenderDevice> device;
+    if (std::strcmp(target, "window") == 0) {
+        window.reset(new sf::RenderWindow{sf::VideoMode{size.x, size.y}, "DrawReplay"});
+        for (std::size_t i = 0; i < replayer.getTextureSizes().size(); ++i) {
+            const sf::Vector2u tex = replayer.getTextureSizes()[i];
+            replayer.getTexture(i).create(std::max(tex.x, 1u), std::max(tex.y, 1u));
+        }
+        device.reset(new RenderTargetDevice{*window});
+    } else if (std::strcmp(target, "software") == 0) {
+        device.reset(new SoftwareRenderDevice{size});
+    } else {
+        device.reset(new NullRenderDevice{size});
+    }
+
+    std::vector<Timing> timings(frames.size());
+    CommandList list{};
+    SpriteBatch batch{};
+    for (std::size_t pass = 0; pass < passes; ++pass) {
+        for (std::size_t f = 0; f < frames.size(); ++f) {
+            Timing& t = timings[f];
+            sf::Clock clock{};
+            frames[f].record(list);
+            t.record += clock.restart().asMicroseconds();
+            list.sort();
+            t.sort += clock.restart().asMicroseconds();
+            batch.resetStats();
+            list.submit(*device, batch);
+            if (window) {
+                window->display();
+            }
+            t.submit += clock.restart().asMicroseconds();
+            t.commands = list.size();
+            t.drawCalls = batch.getStats().drawCalls;
+            list.clear();
+        }
+    }
+
+    std::printf("Replay of %zu frames x %zu passes into %s, %zu textures\n"
+        , frames.size(), passes, target, replayer.getTextureSizes().size());
+    std::printf("%6s %10s %10s %12s %10s %12s\n", "frame", "commands", "draws", "record-us", "sort-us", "submit-us");
+    Timing total{};
+    for (std::size_t f = 0; f < frames.size(); ++f) {
+        const Timing& t = timings[f];
+        std::printf("%6zu %10zu %10zu %12.1f %10.1f %12.1f\n"
+            , f, t.commands, t.drawCalls, t.record / passes, t.sort / passes, t.submit / passes);
+        total.record += t.record, total.sort += t.sort, total.submit += t.submit;
+    }
+    const double n = static_cast<double>(passes * frames.size());
+    std::printf("%6s %10s %10s %12.1f %10.1f %12.1f\n", "mean", "", "", total.record / n, total.sort / n, total.submit / n);
+    return 0;
+}
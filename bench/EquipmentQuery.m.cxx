@@ -0,0 +1,125 @@
+#include "EquipmentTable.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using Column = EquipmentTable::Column;
+using Slot = EquipmentTable::Slot;
+
+//! What a row looked like as a plain struct, as an array-of-structs scan sees it
+struct RowStruct {
+    std::uint32_t id;
+    std::string name;
+    Slot slot;
+    std::int32_t stats[EquipmentTable::ColumnCount];
+} /*struct RowStruct*/;
+
+double millisSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} /*namespace*/;
+
+
+int main(int argc, char ** argv)
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{100000};
+    const std::size_t queries = 2000;
+    const std::size_t lookups = 2000000;
+
+    std::mt19937 rng{5};
+    std::vector<EquipmentTable::Item> items(n);
+    std::vector<RowStruct> rows(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        auto& item = items[i];
+        item.id = static_cast<std::uint32_t>(i * 2654435761u);
+        item.name = "Item " + std::to_string(i) + " of the armory";
+        item.slot = static_cast<Slot>(rng() % static_cast<unsigned int>(Slot::Count));
+        for (auto& stat : item.stats) { stat = static_cast<std::int32_t>(rng() % 100); }
+        rows[i] = RowStruct{item.id, item.name, item.slot, {}};
+        std::copy(item.stats.begin(), item.stats.end(), rows[i].stats);
+    }
+    auto start = std::chrono::steady_clock::now();
+    const EquipmentTable table{items};
+    std::printf("%zu items, built in %.1f ms, %zu columns\n\n", n, millisSince(start), EquipmentTable::ColumnCount);
+
+    // Shop screen filters: a slot, a level cap and one or two stat floors
+    std::vector<EquipmentTable::Query> filters(queries);
+    std::vector<std::int32_t> minAtt(queries), maxLevel(queries), minDef(queries);
+    std::vector<Slot> slots(queries);
+    for (std::size_t q = 0; q < queries; ++q) {
+        slots[q] = static_cast<Slot>(rng() % static_cast<unsigned int>(Slot::Count));
+        minAtt[q] = static_cast<std::int32_t>(rng() % 100);
+        maxLevel[q] = static_cast<std::int32_t>(rng() % 100);
+        minDef[q] = static_cast<std::int32_t>(rng() % 50);
+        filters[q].slot(slots[q]).atLeast(Column::Att, minAtt[q]).atMost(Column::Level, maxLevel[q]).atLeast(Column::Def, minDef[q]);
+    }
+
+    std::printf("%-14s %10s %14s %12s\n", "filter", "ms", "queries/s", "matches");
+    std::size_t matches{0};
+    start = std::chrono::steady_clock::now();
+    for (std::size_t q = 0; q < queries; ++q) {
+        for (const auto& row : rows) {
+            matches += row.slot == slots[q] && row.stats[int(Column::Att)] >= minAtt[q]
+                && row.stats[int(Column::Level)] <= maxLevel[q] && row.stats[int(Column::Def)] >= minDef[q];
+        }
+    }
+    double ms = millisSince(start);
+    std::printf("%-14s %10.1f %14.0f %12zu\n", "structs", ms, queries * 1e3 / ms, matches);
+
+    matches = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& filter : filters) { matches += table.count(filter); }
+    ms = millisSince(start);
+    std::printf("%-14s %10.1f %14.0f %12zu\n", "columns-count", ms, queries * 1e3 / ms, matches);
+
+    matches = 0;
+    std::vector<std::uint32_t> found;
+    start = std::chrono::steady_clock::now();
+    for (const auto& filter : filters) {
+        found.clear();
+        table.select(filter, found);
+        matches += found.size();
+    }
+    ms = millisSince(start);
+    std::printf("%-14s %10.1f %14.0f %12zu\n", "columns-select", ms, queries * 1e3 / ms, matches);
+
+    // Lookups by name and id, as scripts and save games do them
+    std::unordered_map<std::string, std::size_t> byName;
+    std::unordered_map<std::uint32_t, std::size_t> byId;
+    for (std::size_t i = 0; i < n; ++i) { byName.emplace(items[i].name, i), byId.emplace(items[i].id, i); }
+    std::vector<std::uint32_t> picks(lookups);
+    for (auto& pick : picks) { pick = static_cast<std::uint32_t>(rng() % n); }
+
+    std::printf("\n%-14s %10s %14s\n", "lookup", "ms", "ns/lookup");
+    std::size_t sum{0};
+    start = std::chrono::steady_clock::now();
+    for (std::uint32_t pick : picks) { sum += byName.find(items[pick].name)->second; }
+    ms = millisSince(start);
+    std::printf("%-14s %10.1f %14.1f\n", "name-map", ms, ms * 1e6 / lookups);
+
+    start = std::chrono::steady_clock::now();
+    for (std::uint32_t pick : picks) { sum += table.findName(items[pick].name); }
+    ms = millisSince(start);
+    std::printf("%-14s %10.1f %14.1f\n", "name-perfect", ms, ms * 1e6 / lookups);
+
+    start = std::chrono::steady_clock::now();
+    for (std::uint32_t pick : picks) { sum += byId.find(items[pick].id)->second; }
+    ms = millisSince(start);
+    std::printf("%-14s %10.1f %14.1f\n", "id-map", ms, ms * 1e6 / lookups);
+
+    start = std::chrono::steady_clock::now();
+    for (std::uint32_t pick : picks) { sum += table.findId(items[pick].id); }
+    ms = millisSince(start);
+    std::printf("%-14s %10.1f %14.1f\n", "id-perfect", ms, ms * 1e6 / lookups);
+    std::printf("(%zu)\n", sum);
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include "Component.h"
+#include "GameContext.h"
+#include "GameSettings.h"
+#include "GameWorld.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+//! Cheap stand-in for gameplay: integrates a velocity each tick
+struct DriftComp : public Component {
+
+    sf::Vector2f velocity{1.f, 0.5f};
+
+    void update(float dt) override
+    {
+        move(velocity * dt);
+    }
+
+} /*struct DriftComp*/;
+
+} /*namespace*/;
+
+
+int main(int argc, char ** argv)
+{
+    const std::size_t ticks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{600};
+
+    GameContext context{};
+    GameSettings settings{context.generateSettings()};
+    settings.setHeadless(true);
+    const float dt = settings.getFixedTimestep().asSeconds();
+
+    std::printf("Headless GameWorld: %zu ticks of %.4fs\n", ticks, dt);
+    std::printf("%12s %14s %14s\n", "components", "ticks/s", "worst-tick-us");
+    for (std::size_t components : {0, 1000, 10000, 100000}) {
+        GameWorld world{context, settings};
+        for (std::size_t i = 0; i < components; ++i) { world.emplace<DriftComp>(); }
+        const auto report = world.runTicks(ticks, dt);
+        std::printf("%12zu %14.1f %14lld\n"
+            , components, report.ticksPerSecond()
+            , static_cast<long long>(report.worstTick.asMicroseconds()));
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include "JsonReader.h"
+#include "ProcessStats.h"
+#include <json/json.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Input {
+    std::string name;
+    std::string text;
+    //! Key whose value the on-demand pass reads, skipping its siblings
+    std::string wanted;
+} /*struct Input*/;
+
+//! Reads a string in place, so that no parser is charged for a copy of its input
+struct StringViewBuf : std::streambuf {
+    explicit StringViewBuf(const std::string& text)
+    {
+        char * p = const_cast<char *>(text.data());
+        setg(p, p, p + text.size());
+    }
+} /*struct StringViewBuf*/;
+
+// Synthetic inputs are strict JSON, so that jsoncpp accepts them too
+
+//! Conversations: short objects, mostly prose
+std::string makeScenes(std::size_t scenes)
+{
+    std::mt19937 rng{7};
+    std::ostringstream out{};
+    out << "[\n";
+    for (std::size_t s = 0; s < scenes; ++s) {
+        out << (s ? ",\n" : "") << "  {\n    \"id\": \"scene-" << s << "\",\n    \"sequence\": [";
+        for (int step = 0; step < 16; ++step) { out << (step ? ", " : "") << "\"n" << rng() % 12 << "\""; }
+        out << "],\n    \"data\": {\n";
+        for (int n = 0; n < 12; ++n) {
+            out << (n ? ",\n" : "") << "      \"n" << n << "\": [\"Speaker" << rng() % 200 << ": Line " << s << "." << n
+                << " of the script, \\\"quoted\\\", long enough to wrap once or twice.\"]";
+        }
+        out << "\n    }\n  }";
+    }
+    out << "\n]\n";
+    return out.str();
+}
+
+//! A Tiled map: three layers of `side` x `side` gids
+std::string makeMap(std::size_t side)
+{
+    std::mt19937 rng{3};
+    std::string out = "{\"height\": " + std::to_string(side) + ", \"width\": " + std::to_string(side) + ", \"layers\": [";
+    for (int layer = 0; layer < 3; ++layer) {
+        out += std::string{layer ? ", " : ""} + "{\"name\": \"layer" + std::to_string(layer) + "\", \"data\": [";
+        for (std::size_t i = 0; i < side * side; ++i) { out += (i ? ", " : "") + std::to_string(rng() % 300); }
+        out += "]}";
+    }
+    return out + "], \"tilesets\": [{\"firstgid\": 1, \"source\": \"basic.tsx\"}]}";
+}
+
+//! Equipment: many small records, pretty-printed
+std::string makeItems(std::size_t n)
+{
+    std::mt19937 rng{5};
+    std::string out = "[\n";
+    for (std::size_t i = 0; i < n; ++i) {
+        out += (i ? ",\n" : "") + std::string{"    {\n        \"id\": "} + std::to_string(i) + ",\n        \"name\": \"Item " + std::to_string(i) + "\",\n";
+        out += "        \"slot\": \"weapon\",\n        \"att\": " + std::to_string(rng() % 100) + ",\n";
+        out += "        \"notes\": {\"flavor\": \"Forged in [the] {north}.\", \"tags\": [\"rare\", \"sword\"]}\n    }";
+    }
+    return out + "\n]\n";
+}
+
+std::string readFile(const char * path)
+{
+    std::ifstream src{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{src}, std::istreambuf_iterator<char>{}};
+}
+
+//! Runs `pass` until at least 0.2 s have gone by; returns MiB/s and peak MiB over the baseline
+template<typename F>
+void measure(const char * what, const Input& input, F&& pass)
+{
+    resetPeak();
+    const std::size_t before = statusKiB("VmRSS");
+    std::size_t runs{0};
+    std::size_t checksum{0};
+    const auto start = std::chrono::steady_clock::now();
+    double seconds{0};
+    do {
+        checksum += pass(input.text);
+        ++runs;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (seconds < 0.2);
+    const double peak = static_cast<double>(statusKiB("VmHWM") - before) / 1024;
+    const double mib = static_cast<double>(input.text.size()) * runs / (1 << 20);
+    std::printf("%-12s %-14s %10.1f %10.1f %14zu\n", input.name.c_str(), what, mib / seconds, peak, checksum / runs);
+}
+
+std::size_t jsoncppDom(const std::string& text)
+{
+    Json::Value root;
+    StringViewBuf buf{text};
+    std::istream src{&buf};
+    if (!Json::Reader{}.parse(src, root)) {
+        return 0;
+    }
+    return root.size();
+}
+
+//! Visits every token, as a loader reading all of a file does
+std::size_t walk(const std::string& text)
+{
+    StringViewBuf buf{text};
+    std::istream src{&buf};
+    JsonReader json{src};
+    std::size_t tokens{0};
+    while (json.next() != JsonReader::Token::End) { ++tokens; }
+    return tokens;
+}
+
+//! Reads `wanted` from each top-level record and skips everything else
+std::size_t onDemand(const std::string& text, const std::string& wanted)
+{
+    using Token = JsonReader::Token;
+    StringViewBuf buf{text};
+    std::istream src{&buf};
+    JsonReader json{src};
+    std::size_t found{0};
+    for (Token t = json.next(); t != Token::End; t = json.next()) {
+        if (t == Token::Key) {
+            found += json.getString() == wanted;
+            json.skipValue(json.next());
+        }
+    }
+    return found;
+}
+
+} /*namespace*/;
+
+
+int main(int argc, char ** argv)
+{
+    const std::size_t scale = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1};
+    std::vector<Input> inputs{
+        {"basic-map", readFile("assets/tilesets/basic-map.json"), "height"},
+        {"sample-chat", readFile("assets/SampleChat.json"), "sequence"},
+        {"scenes", makeScenes(20000 * scale), "id"},
+        {"map", makeMap(1024 * scale), "height"},
+        {"items", makeItems(100000 * scale), "name"},
+    };
+
+    std::printf("%-12s %-14s %10s %10s %14s\n", "input", "parser", "MiB/s", "peak-MiB", "checksum");
+    for (const auto& input : inputs) {
+        if (input.text.empty()) {
+            std::printf("%-12s (missing; run from the repository root)\n", input.name.c_str());
+            continue;
+        }
+        measure("jsoncpp-dom", input, jsoncppDom);
+        measure("reader-walk", input, walk);
+        measure("reader-skip", input, [&](const std::string& text) { return onDemand(text, input.wanted); });
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "InlineFunction.h"
+#include "MpscQueue.h"
+#include <SFML/System.hpp>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Task_t = InlineFunction<void(std::size_t&), 64>;
+
+struct Result {
+    double mopsPerSec;
+    std::size_t fullRetries;
+} /*struct Result*/;
+
+//! `producers` threads push `total` tasks between them while this thread drains
+Result contend(std::size_t producers, std::size_t total, std::size_t capacity)
+{
+    MpscQueue<Task_t> queue{capacity};
+    std::atomic<bool> go{false};
+    std::atomic<std::size_t> retries{0};
+    std::vector<std::thread> threads;
+
+    for (std::size_t p = 0; p < producers; ++p) {
+        const std::size_t count = total / producers + (p < total % producers ? 1 : 0);
+        threads.emplace_back([&, count, p] {
+            while (!go.load(std::memory_order_acquire)) { }
+            std::size_t localRetries{0};
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::size_t payload = p ^ i;
+                while (!queue.tryEmplace([payload](std::size_t& sum) { sum += payload; })) {
+                    ++localRetries;
+                    std::this_thread::yield();
+                }
+            }
+            retries.fetch_add(localRetries, std::memory_order_relaxed);
+        });
+    }
+
+    sf::Clock clock{};
+    go.store(true, std::memory_order_release);
+    std::size_t received{0}, sum{0};
+    Task_t task{};
+    while (received < total) {
+        if (queue.tryPop(task)) {
+            task(sum);
+            ++received;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    const double elapsed = clock.getElapsedTime().asSeconds();
+
+    for (auto& t : threads) { t.join(); }
+    return {total / elapsed / 1e6, retries.load()};
+}
+
+} /*namespace*/;
+
+
+int main(int argc, char ** argv)
+{
+    const std::size_t total = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1} << 22;
+    const std::size_t capacity = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::size_t{1024};
+
+    std::printf("MpscQueue<InlineFunction<64>>: %zu items, capacity %zu, %u hw threads\n"
+        , total, capacity, std::thread::hardware_concurrency());
+    std::printf("%10s %12s %14s\n", "producers", "Mitems/s", "full-retries");
+    for (std::size_t producers : {1, 2, 4, 8, 16, 32}) {
+        const Result r = contend(producers, total, capacity);
+        std::printf("%10zu %12.2f %14zu\n", producers, r.mopsPerSec, r.fullRetries);
+    }
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include "ParticleSystem.h"
+#include "WorkerPool.h"
+#include <SFML/System/Clock.hpp>
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char ** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{500000};
+    const int frames = 120;
+    const float dt = 1.f / 60.f;
+
+    ParticleSystem::Emitter emitter{};
+    emitter.velocity = {0.f, -50.f};
+    emitter.spread = {40.f, 40.f};
+    emitter.minLife = emitter.maxLife = 1000.f;
+
+    std::printf("ParticleSystem: %zu particles, %d frames, %s path\n", count, frames, ParticleSystem::getSimdPath());
+    std::printf("%10s %14s %14s\n", "threads", "mean-us", "worst-us");
+
+    // Zero threads is the plain `update`, anything else goes through the pool
+    WorkerPool pool{};
+    for (std::size_t threads : {std::size_t{0}, pool.getThreadCount()}) {
+        ParticleSystem particles{count};
+        particles.setGravity({0.f, 98.f});
+        particles.emit(emitter, count);
+
+        sf::Time total{}, worst{};
+        for (int f = 0; f < frames; ++f) {
+            sf::Clock clock{};
+            if (threads == 0) {
+                particles.update(dt);
+            } else {
+                particles.update(dt, pool);
+            }
+            const sf::Time spent = clock.getElapsedTime();
+            total += spent;
+            worst = std::max(worst, spent);
+        }
+        std::printf("%10zu %14lld %14lld\n", threads
+            , static_cast<long long>(total.asMicroseconds() / frames)
+            , static_cast<long long>(worst.asMicroseconds()));
+    }
+    return 0;
+}
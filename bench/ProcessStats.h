@@ -0,0 +1,59 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#ifdef __linux__
+#include <malloc.h>
+#endif
+
+/**
+ *  Timing and memory readings shared by the benchmark drivers.
+ *
+ *  Memory comes from /proc/self and glibc, so it is only measured on Linux;
+ *  elsewhere `statusKiB` reads 0 and the memory columns of a report are
+ *  meaningless, but every driver still builds and times its passes.
+ */
+
+
+//! Field of /proc/self/status in KiB, e.g. "VmHWM"; 0 when it can not be read
+inline std::size_t statusKiB(const char * field)
+{
+#ifdef __linux__
+    std::ifstream status{"/proc/self/status"};
+    std::string line;
+    const std::string prefix = std::string{field} + ":";
+    while (std::getline(status, line)) {
+        if (line.compare(0, prefix.size(), prefix) == 0) {
+            return std::strtoull(line.c_str() + prefix.size(), nullptr, 10);
+        }
+    }
+#else
+    static_cast<void>(field);
+#endif
+    return 0;
+}
+
+//! Returns free heap to the system, so RSS reflects what is still in use
+inline void trimHeap()
+{
+#ifdef __linux__
+    malloc_trim(0);
+#endif
+}
+
+//! Trims the heap, then restarts the peak RSS count from the current RSS
+//! (Linux 4.0 and later)
+inline void resetPeak()
+{
+    trimHeap();
+#ifdef __linux__
+    std::ofstream{"/proc/self/clear_refs"} << "5";
+#endif
+}
+
+inline double millisSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
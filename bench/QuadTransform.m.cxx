@@ -0,0 +1,69 @@
+#include "QuadTransform.h"
+#include <SFML/Graphics.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+//! What every sprite draw did before: one `transformPoint` per corner
+void perVertex(const sf::Transform * transforms, const LocalQuad * quads, std::size_t count, sf::Vertex * out)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        const sf::FloatRect& r = quads[i].rect;
+        const sf::FloatRect& t = quads[i].texRect;
+        const sf::Color c = quads[i].color;
+        sf::Vertex * v = out + 4 * i;
+        v[0] = sf::Vertex{transforms[i].transformPoint(r.left, r.top), c, {t.left, t.top}};
+        v[1] = sf::Vertex{transforms[i].transformPoint(r.left + r.width, r.top), c, {t.left + t.width, t.top}};
+        v[2] = sf::Vertex{transforms[i].transformPoint(r.left + r.width, r.top + r.height), c, {t.left + t.width, t.top + t.height}};
+        v[3] = sf::Vertex{transforms[i].transformPoint(r.left, r.top + r.height), c, {t.left, t.top + t.height}};
+    }
+}
+
+template<typename F>
+double mverts(std::size_t quads, std::size_t vertsPerQuad, std::size_t passes, F&& run)
+{
+    sf::Clock clock{};
+    for (std::size_t p = 0; p < passes; ++p) { run(); }
+    const double seconds = clock.getElapsedTime().asSeconds();
+    return quads * vertsPerQuad * passes / seconds / 1e6;
+}
+
+} /*namespace*/;
+
+
+int main(int argc, char ** argv)
+{
+    const std::size_t passes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{50};
+#if defined(__AVX2__)
+    const char * isa = "avx2";
+#elif defined(__SSE2__)
+    const char * isa = "sse2";
+#else
+    const char * isa = "scalar";
+#endif
+
+    std::printf("Quad transform throughput, %s build, %zu passes\n", isa, passes);
+    std::printf("%10s %16s %16s %16s\n", "quads", "per-vertex-Mv/s", "bulk-quads-Mv/s", "bulk-tris-Mv/s");
+    for (std::size_t count : {1000, 10000, 100000, 1000000}) {
+        std::vector<sf::Transform> transforms(count);
+        std::vector<LocalQuad> quads(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            sf::Transformable t{};
+            t.setPosition(static_cast<float>(i % 1280), static_cast<float>(i % 720));
+            t.setRotation(static_cast<float>(i % 360));
+            transforms[i] = t.getTransform();
+            quads[i] = LocalQuad{{0.f, 0.f, 16.f, 16.f}, {0.f, 0.f, 16.f, 16.f}, sf::Color::White};
+        }
+        std::vector<sf::Vertex> out(6 * count);
+
+        const double scalar = mverts(count, 4, passes, [&] { perVertex(transforms.data(), quads.data(), count, out.data()); });
+        const double bulk = mverts(count, 4, passes, [&] { transformQuads(transforms.data(), quads.data(), count, out.data()); });
+        const double tris = mverts(count, 6, passes, [&] {
+            transformQuads(transforms.data(), quads.data(), count, out.data(), QuadLayout::Triangles);
+        });
+        std::printf("%10zu %16.1f %16.1f %16.1f\n", count, scalar, bulk, tris);
+    }
+    return 0;
+}
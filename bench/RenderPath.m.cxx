@@ -0,0 +1,48 @@
+#include "GameContext.h"
+#include "GameSettings.h"
+#include "GameWorld.h"
+#include "SoftwareRenderDevice.h"
+#include "SpriteComp.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+double frameMs(GameWorld& world, RenderDevice& device, std::size_t frames)
+{
+    sf::Clock clock{};
+    for (std::size_t i = 0; i < frames; ++i) { world.render(device); }
+    return clock.getElapsedTime().asMicroseconds() / 1000.0 / frames;
+}
+
+} /*namespace*/;
+
+
+int main(int argc, char ** argv)
+{
+    const std::size_t frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{60};
+
+    GameContext context{};
+    GameSettings settings{context.generateSettings()};
+    settings.setHeadless(true);
+    sf::Texture texture{};
+
+    std::printf("Render path, 1280x720, %zu frames\n", frames);
+    std::printf("%10s %14s %14s %16s\n", "sprites", "submit-ms", "raster-ms", "checksum");
+    for (std::size_t sprites : {100, 1000, 10000}) {
+        GameWorld world{context, settings};
+        for (std::size_t i = 0; i < sprites; ++i) {
+            world.emplace<SpriteComp>(texture, sf::IntRect{0, 0, 16, 16})
+                .setPosition(static_cast<float>(i * 37 % 1264), static_cast<float>(i * 53 % 704));
+        }
+        world.update(0.f);
+
+        NullRenderDevice null{{1280, 720}};
+        SoftwareRenderDevice software{{1280, 720}};
+        const double submit = frameMs(world, null, frames);
+        const double raster = frameMs(world, software, frames);
+        std::printf("%10zu %14.3f %14.3f %016llx\n", sprites, submit, raster
+            , static_cast<unsigned long long>(software.checksum()));
+    }
+    return 0;
+}
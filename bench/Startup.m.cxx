@@ -0,0 +1,124 @@
+#include "ConversationDb.h"
+#include "EquipmentTable.h"
+#include "GameContext.h"
+#include "LevelAtlas.h"
+#include "StartupReport.h"
+#include "WorkerPool.h"
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using DataType = GameContext::DataType;
+
+std::string tempPath(const std::string& leaf)
+{
+    return std::string{P_tmpdir} + "/mint-startup-" + std::to_string(::getpid()) + "-" + leaf;
+}
+
+void writeLevel(const std::string& path, unsigned int side, std::mt19937& rng)
+{
+    std::ofstream dst{path, std::ios::binary};
+    dst << "{\"width\": " << side << ", \"height\": " << side << ", \"tilewidth\": 16, \"tileheight\": 16, \"layers\": [";
+    for (int layer = 0; layer < 3; ++layer) {
+        dst << (layer ? "," : "") << "{\"type\": \"tilelayer\", \"name\": \"layer" << layer << "\", \"width\": " << side
+            << ", \"height\": " << side << ", \"data\": [";
+        for (unsigned int i = 0; i < side * side; ++i) { dst << (i ? "," : "") << rng() % 300; }
+        dst << "]}";
+    }
+    dst << "], \"tilesets\": []}";
+}
+
+void writeItems(const std::string& path, std::uint32_t first, std::size_t n, std::mt19937& rng)
+{
+    std::ofstream dst{path, std::ios::binary};
+    dst << "[";
+    for (std::uint32_t id = first; id < first + n; ++id) {
+        dst << (id != first ? ",\n" : "") << "{\"id\": " << id << ", \"name\": \"Item " << id << "\", \"slot\": \"weapon\", \"level\": "
+            << rng() % 99 << ", \"att\": " << rng() % 100 << ", \"def\": " << rng() % 100 << "}";
+    }
+    dst << "]";
+}
+
+void writeScenes(const std::string& path, std::size_t first, std::size_t n, std::mt19937& rng)
+{
+    std::ofstream dst{path, std::ios::binary};
+    dst << "[";
+    for (std::size_t s = first; s < first + n; ++s) {
+        dst << (s != first ? ",\n" : "") << "{\"id\": \"scene-" << s << "\", \"sequence\": [\"n0\", \"n1\"], \"data\": {";
+        for (int node = 0; node < 12; ++node) {
+            dst << (node ? "," : "") << "\"n" << node << "\": [\"Speaker" << rng() % 200 << ": Line " << s << "." << node
+                << " of the script, long enough to wrap once or twice.\"]";
+        }
+        dst << "}}";
+    }
+    dst << "]";
+}
+
+double millisSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} /*namespace*/;
+
+
+int main(int argc, char ** argv)
+{
+    const std::size_t threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{0};
+    std::mt19937 rng{13};
+    std::vector<GameContext::Source> sources;
+    for (int i = 0; i < 6; ++i) {
+        sources.push_back({DataType::LevelMap, tempPath("level" + std::to_string(i) + ".json")});
+        writeLevel(sources.back().path, 512, rng);
+    }
+    for (std::uint32_t i = 0; i < 2; ++i) {
+        sources.push_back({DataType::EquipmentData, tempPath("items" + std::to_string(i) + ".json")});
+        writeItems(sources.back().path, 50000 * i, 50000, rng);
+    }
+    for (std::size_t i = 0; i < 4; ++i) {
+        sources.push_back({DataType::Conversation, tempPath("scenes" + std::to_string(i) + ".json")});
+        writeScenes(sources.back().path, 10000 * i, 10000, rng);
+    }
+
+    // Everything, one file after another, as the game used to start
+    auto start = std::chrono::steady_clock::now();
+    {
+        GameContext context{};
+        for (const auto& source : sources) {
+            std::ifstream src{source.path, std::ios::binary};
+            switch (source.type) {
+            case DataType::EquipmentData: context.loadEquipment(src); break;
+            case DataType::LevelMap: context.loadLevelFile(source.path); break;
+            default: context.loadConversations(src); break;
+            }
+        }
+        context.getConversations();
+    }
+    std::printf("serial, everything          %10.1f ms\n", millisSince(start));
+
+    // One thread first, so the parallel speedup is measured rather than assumed
+    for (const std::size_t n : {std::size_t{1}, threads}) {
+        WorkerPool pool{n};
+        StartupReport report{};
+        GameContext context{};
+        context.setStartupReport(&report);
+        start = std::chrono::steady_clock::now();
+        context.loadFiles(sources, pool);
+        std::printf("loadFiles, %2zu threads       %10.1f ms\n", pool.getThreadCount(), millisSince(start));
+        start = std::chrono::steady_clock::now();
+        const std::size_t scenes = context.getConversations().getSceneCount();
+        std::printf("  then getConversations     %10.1f ms (%zu scenes)\n\n", millisSince(start), scenes);
+        if (n == threads) { report.print(std::cout); }
+    }
+
+    for (const auto& source : sources) { std::remove(source.path.c_str()); }
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include "ProcessStats.h"
+#include "TiledLoader.h"
+#include <json/json.h>
+#include <zlib.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+//! Gid of a synthetic cell; upper layers are mostly empty, like real maps
+std::uint32_t gidAt(unsigned int layer, unsigned int x, unsigned int y)
+{
+    if (layer > 0 && (x * 7 + y * 13 + layer) % 5 != 0) {
+        return 0;
+    }
+    return (x / 7 + y / 5 + layer * 31) % 300 + 1;
+}
+
+std::vector<std::uint32_t> layerGids(unsigned int layer, unsigned int side)
+{
+    std::vector<std::uint32_t> gids(static_cast<std::size_t>(side) * side);
+    for (unsigned int y = 0; y < side; ++y) {
+        for (unsigned int x = 0; x < side; ++x) { gids[static_cast<std::size_t>(y) * side + x] = gidAt(layer, x, y); }
+    }
+    return gids;
+}
+
+std::string base64(const unsigned char * p, std::size_t n)
+{
+    static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((n + 2) / 3 * 4);
+    std::size_t i = 0;
+    for (; i + 3 <= n; i += 3) {
+        const std::uint32_t v = std::uint32_t(p[i]) << 16 | std::uint32_t(p[i + 1]) << 8 | p[i + 2];
+        out += {digits[v >> 18], digits[(v >> 12) & 63], digits[(v >> 6) & 63], digits[v & 63]};
+    }
+    if (i < n) {
+        const std::uint32_t v = std::uint32_t(p[i]) << 16 | (i + 1 < n ? std::uint32_t(p[i + 1]) << 8 : 0);
+        out += {digits[v >> 18], digits[(v >> 12) & 63], i + 1 < n ? digits[(v >> 6) & 63] : '=', '='};
+    }
+    return out;
+}
+
+//! Layer data in `encoding`: "csv", "array" (JSON), "base64" or "zlib"
+std::string layerData(const std::vector<std::uint32_t>& gids, const std::string& encoding)
+{
+    if (encoding == "csv" || encoding == "array") {
+        std::string out;
+        for (std::size_t i = 0; i < gids.size(); ++i) {
+            out += std::to_string(gids[i]);
+            out += ',';
+        }
+        out.pop_back();
+        return out;
+    }
+    // Stored little-endian; this benchmark assumes a little-endian host
+    const auto * bytes = reinterpret_cast<const unsigned char *>(gids.data());
+    const std::size_t size = gids.size() * 4;
+    if (encoding == "base64") {
+        return base64(bytes, size);
+    }
+    uLongf packed = compressBound(size);
+    std::vector<unsigned char> out(packed);
+    compress(out.data(), &packed, bytes, size);
+    return base64(out.data(), packed);
+}
+
+//! Writes a `side`² map of `layers` layers; returns its size in bytes
+std::size_t writeMap(const std::string& path, bool json, const std::string& encoding, unsigned int side, unsigned int layers)
+{
+    std::ofstream out{path, std::ios::binary};
+    const std::string dim = std::to_string(side);
+    if (json) {
+        out << "{\"width\":" << dim << ",\"height\":" << dim << ",\"tilewidth\":16,\"tileheight\":16,\"layers\":[";
+    } else {
+        out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<map version=\"1.0\" width=\"" << dim << "\" height=\"" << dim
+            << "\" tilewidth=\"16\" tileheight=\"16\">\n <tileset firstgid=\"1\" name=\"tiles\" tilewidth=\"16\" tileheight=\"16\" tilecount=\"336\" columns=\"24\">\n"
+            << "  <image source=\"tiles.png\" width=\"384\" height=\"224\"/>\n </tileset>\n";
+    }
+    for (unsigned int l = 0; l < layers; ++l) {
+        const std::string data = layerData(layerGids(l, side), encoding);
+        const std::string name = "layer" + std::to_string(l);
+        if (json) {
+            out << (l ? "," : "") << "{\"type\":\"tilelayer\",\"name\":\"" << name << "\",\"width\":" << dim << ",\"height\":" << dim;
+            if (encoding == "array") {
+                out << ",\"data\":[" << data << "]}";
+            } else {
+                out << ",\"encoding\":\"base64\"" << (encoding == "zlib" ? ",\"compression\":\"zlib\"" : "") << ",\"data\":\"" << data << "\"}";
+            }
+        } else {
+            out << " <layer name=\"" << name << "\" width=\"" << dim << "\" height=\"" << dim << "\">\n  <data encoding=\""
+                << (encoding == "csv" ? "csv" : "base64") << "\"" << (encoding == "zlib" ? " compression=\"zlib\"" : "") << ">\n"
+                << data << "\n  </data>\n </layer>\n";
+        }
+    }
+    out << (json ? "]}" : "</map>\n");
+    return static_cast<std::size_t>(out.tellp());
+}
+
+} /*namespace*/;
+
+
+int main(int argc, char ** argv)
+{
+    const unsigned int side = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 4096u;
+    const unsigned int layers = argc > 2 ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 3u;
+    const bool dom = argc > 3 && std::string{argv[3]} == "dom";
+
+    struct Case { const char * name; bool json; const char * encoding; };
+    const Case cases[] = {
+        {"tmx-csv", false, "csv"}, {"tmx-base64", false, "base64"}, {"tmx-zlib", false, "zlib"},
+        {"json-array", true, "array"}, {"json-base64", true, "base64"}, {"json-zlib", true, "zlib"},
+    };
+    const double gidMiB = static_cast<double>(side) * side * layers * 4 / (1 << 20);
+
+    std::printf("Streaming load of a %ux%u map with %u layers, %.0f MiB of gids\n", side, side, layers, gidMiB);
+    std::printf("%-12s %10s %10s %10s %10s %14s\n", "format", "file-MiB", "ms", "MiB/s", "gid-MiB/s", "peak-over-MiB");
+    for (const Case& c : cases) {
+        const std::string path = std::string{"/tmp/mint-tiled-"} + c.name + (c.json ? ".json" : ".tmx");
+        const double fileMiB = static_cast<double>(writeMap(path, c.json, c.encoding, side, layers)) / (1 << 20);
+
+        resetPeak();
+        const std::size_t before = statusKiB("VmRSS");
+        const auto start = std::chrono::steady_clock::now();
+        std::size_t checksum{0};
+        {
+            std::ifstream src{path, std::ios::binary};
+            const LevelMap map = readTiledMap(src, c.name);
+            for (const auto& layer : map.layers) { checksum += layer.at(side - 1, side - 1); }
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const double peak = static_cast<double>(statusKiB("VmHWM") - before) / 1024;
+        std::printf("%-12s %10.1f %10.1f %10.1f %10.1f %14.1f\n", c.name, fileMiB, ms, fileMiB / ms * 1000, gidMiB / ms * 1000, peak);
+        if (checksum == 0) {
+            std::printf("  (unexpected empty corner)\n");
+        }
+
+        if (dom && c.json && std::string{c.encoding} == "array") {
+            // The jsoncpp document the loader used to need, for comparison
+            resetPeak();
+            const std::size_t domBefore = statusKiB("VmRSS");
+            const auto domStart = std::chrono::steady_clock::now();
+            {
+                std::ifstream src{path, std::ios::binary};
+                Json::Value root;
+                Json::Reader{}.parse(src, root);
+            }
+            const double domMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - domStart).count();
+            const double domPeak = static_cast<double>(statusKiB("VmHWM") - domBefore) / 1024;
+            std::printf("%-12s %10.1f %10.1f %10.1f %10.1f %14.1f\n", "jsoncpp-dom", fileMiB, domMs, fileMiB / domMs * 1000, gidMiB / domMs * 1000, domPeak);
+        }
+        std::remove(path.c_str());
+    }
+    return 0;
+}
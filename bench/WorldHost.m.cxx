@@ -0,0 +1,58 @@
+#include "Component.h"
+#include "GameContext.h"
+#include "GameSettings.h"
+#include "WorldHost.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+struct DriftComp : public Component {
+
+    sf::Vector2f velocity{1.f, 0.5f};
+
+    void update(float dt) override
+    {
+        move(velocity * dt);
+    }
+
+} /*struct DriftComp*/;
+
+} /*namespace*/;
+
+
+int main(int argc, char ** argv)
+{
+    const std::size_t worlds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{500};
+    const std::size_t components = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::size_t{200};
+    const float seconds = argc > 3 ? std::strtof(argv[3], nullptr) : 5.f;
+    const std::size_t threads = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : std::size_t{0};
+
+    GameContext context{};
+    WorldHost host{context, context.generateSettings(), threads};
+    const sf::Time rates[] = {sf::seconds(1.f / 20.f), sf::seconds(1.f / 30.f), sf::seconds(1.f / 60.f)};
+    for (std::size_t w = 0; w < worlds; ++w) {
+        auto& world = host.getWorld(host.spawn(rates[w % 3]));
+        for (std::size_t c = 0; c < components; ++c) { world.emplace<DriftComp>(); }
+    }
+
+    host.runFor(sf::seconds(seconds));
+
+    std::printf("WorldHost: %zu worlds x %zu components for %.1fs\n", worlds, components, seconds);
+    std::printf("%8s %10s %10s %12s %12s\n", "rate-hz", "ticks", "dropped", "mean-us", "worst-us");
+    for (int r = 0; r < 3; ++r) {
+        std::size_t ticks{0}, dropped{0};
+        sf::Time busy{}, worst{};
+        for (std::size_t w = r; w < worlds; w += 3) {
+            const auto stats = host.getStats(w);
+            ticks += stats.ticks, dropped += stats.dropped;
+            busy += stats.busy, worst = std::max(worst, stats.worstTick);
+        }
+        std::printf("%8.0f %10zu %10zu %12lld %12lld\n"
+            , 1.f / rates[r].asSeconds(), ticks, dropped
+            , static_cast<long long>(ticks ? busy.asMicroseconds() / static_cast<sf::Int64>(ticks) : 0)
+            , static_cast<long long>(worst.asMicroseconds()));
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "GameContext.h"
+#include "GameSettings.h"
+#include "GameWorld.h"
+#include "RenderDevice.h"
+#include "SpriteComp.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+//! Bobs up and down when awake, crossing its neighbours' feet
+struct WalkerComp : public SpriteComp {
+
+    using SpriteComp::SpriteComp;
+
+    bool awake{false};
+    float phase{0};
+
+    void update(float dt) override
+    {
+        if (awake) {
+            phase += dt;
+            move(0.f, std::sin(phase * 3.f) * 40.f * dt);
+        }
+    }
+
+} /*struct WalkerComp*/;
+
+const char * methodName(CommandList::SortMethod method)
+{
+    switch (method) {
+    case CommandList::SortMethod::None: return "none";
+    case CommandList::SortMethod::Insertion: return "insertion";
+    case CommandList::SortMethod::Radix: return "radix";
+    }
+    return "?";
+}
+
+} /*namespace*/;
+
+
+int main(int argc, char ** argv)
+{
+    const std::size_t frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{120};
+    const std::size_t sprites = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::size_t{20000};
+
+    GameContext context{};
+    GameSettings settings{context.generateSettings()};
+    settings.setHeadless(true);
+    sf::Texture texture{};
+
+    std::printf("Y-sorted render of %zu sprites, %zu frames\n", sprites, frames);
+    std::printf("%8s %12s %12s %12s\n", "moving", "sort-us", "worst-us", "last-method");
+    for (double moving : {0.0, 0.01, 0.1, 0.5, 1.0}) {
+        GameWorld world{context, settings};
+        std::vector<WalkerComp *> walkers;
+        for (std::size_t i = 0; i < sprites; ++i) {
+            auto& w = world.emplace<WalkerComp>(texture, sf::IntRect{0, 0, 16, 24});
+            w.setPosition(static_cast<float>(i * 37 % 1264), static_cast<float>(i * 53 % 696));
+            w.setYSorted(true);
+            w.awake = i < sprites * moving;
+            w.phase = static_cast<float>(i);
+        }
+        NullRenderDevice device{{1280, 720}};
+        world.update(0.f);
+        world.render(device);
+
+        double total{0}, worst{0};
+        for (std::size_t f = 0; f < frames; ++f) {
+            world.update(1.f / 60.f);
+            world.render(device);
+            const double us = world.getCommandStats().sortTime.asMicroseconds();
+            total += us;
+            worst = std::max(worst, us);
+        }
+        std::printf("%7.0f%% %12.1f %12.1f %12s\n"
+            , moving * 100.0, total / frames, worst, methodName(world.getCommandStats().sortMethod));
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "Animation.h"
+#include "Component.h"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * @brief   Every animated sprite sharing one texture, evaluated in one pass.
+ *
+ *  An instance's animation state is its `ClipId` and start time, six bytes,
+ *  against clips shared through an `AnimationLibrary`.  Each `update` scans
+ *  the instances once, and only rewrites the quads of those whose frame
+ *  changed; the quads are kept ready to submit as one command.
+ *
+ *  Handles are indices: `remove` moves the last instance into the removed
+ *  one's handle.
+ */
+class AnimatedSprites : public Component {
+
+public:
+
+    using Handle = std::uint32_t;
+
+    //! `library` and `texture` must outlive this
+    AnimatedSprites(const AnimationLibrary& library, const sf::Texture& texture);
+
+    //! Starts `clip` now, with its frame's top-left at `position`
+    Handle add(ClipId clip, sf::Vector2f position);
+
+    //! Restarts `handle` on `clip`
+    void play(Handle handle, ClipId clip);
+
+    void setPosition(Handle handle, sf::Vector2f position);
+
+    //! Removes `handle`; the last instance takes its place and handle
+    void remove(Handle handle);
+
+    std::size_t size() const;
+    std::size_t getFrame(Handle handle) const;
+
+    //! Advances the clock and patches the quads of instances whose frame changed
+    void update(float dt) override;
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void record(CommandList& list, sf::RenderStates states) const override;
+
+private:
+
+    void writeFrame(Handle handle, std::size_t frame);
+
+    const AnimationLibrary&  m_library;
+    const sf::Texture&  m_texture;
+    float  m_time = 0.f;
+
+    //! Animation state proper
+    std::vector<ClipId>  m_clip;
+    std::vector<float>  m_start;
+
+    //! Render cache: the frame last written, and four vertices per instance
+    std::vector<std::uint16_t>  m_frame;
+    std::vector<sf::Vertex>  m_vertices;
+
+} /*class AnimatedSprites*/;
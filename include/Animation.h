@@ -0,0 +1,71 @@
+#pragma once
+#include <SFML/Graphics/Rect.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+using ClipId = std::uint16_t;
+
+
+/**
+ * @brief   One immutable animation: frames, how long each shows, how it ends.
+ *
+ *  Clips are built once, handed to an `AnimationLibrary` and from then on
+ *  shared by every instance playing them; an instance is only a `ClipId` and
+ *  the time at which it started.
+ */
+struct AnimationClip {
+
+    enum class Loop : std::uint8_t {
+        Once, Repeat, PingPong
+    };
+
+    std::vector<sf::IntRect> frames;
+
+    //! Seconds per frame; a single entry applies to every frame
+    std::vector<float> durations;
+
+    Loop loop = Loop::Repeat;
+
+    //! Frame index showing `t` seconds after the clip started
+    std::size_t frameAt(float t) const;
+
+    float getLength() const;
+
+    //! Derives the lookup tables; `AnimationLibrary::add` calls this.  Throws std::invalid_argument for durations which are not positive
+    void freeze();
+
+private:
+
+    //! `ends[i]`: time at which frame `i` stops showing
+    std::vector<float>  m_ends;
+    float  m_length = 0.f;
+    float  m_uniform = 0.f;
+
+} /*struct AnimationClip*/;
+
+
+//! Every clip of a game, by id and by name; read-only once loaded
+class AnimationLibrary {
+
+public:
+
+    //! Throws std::length_error past 65535 clips, std::invalid_argument for invalid clips or a name already taken
+    ClipId add(const std::string& name, AnimationClip clip);
+
+    const AnimationClip& get(ClipId id) const;
+
+    //! Throws std::out_of_range for unknown names
+    ClipId find(const std::string& name) const;
+
+    std::size_t size() const;
+
+private:
+
+    std::vector<AnimationClip>  m_clips;
+    std::unordered_map<std::string, ClipId>  m_names;
+
+} /*class AnimationLibrary*/;
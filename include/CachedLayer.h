@@ -0,0 +1,55 @@
+#pragma once
+#include "Component.h"
+#include "LayerCache.h"
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief   A group of rarely-changing components drawn as one cached quad.
+ *
+ *  The children inside of `area` are rendered once into a texture held by a
+ *  `LayerCache`; every later frame draws only that texture, until the layer
+ *  is invalidated or its texture is evicted.  Children are updated along with
+ *  the layer, but nothing notices when they change: call `invalidate`.
+ */
+class CachedLayer : public Component {
+
+public:
+
+    //! Caches `area`, in this layer's local space, at one texel per unit
+    CachedLayer(LayerCache& cache, sf::FloatRect area);
+    ~CachedLayer();
+
+    //! Adds a child, which invalidates the layer
+    template <typename C, typename... A>
+    C& emplace(A&&... args)
+    {
+        m_children.emplace_back(std::make_unique<C>(std::forward<A>(args)...));
+        invalidate();
+        return static_cast<C&>(*m_children.back());
+    }
+
+    //! The next draw re-renders every child
+    void invalidate();
+
+    void update(float dt) override;
+    std::optional<sf::FloatRect> getLocalBounds() const override;
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void record(CommandList& list, sf::RenderStates states) const override;
+
+private:
+
+    //! The cached image, re-rendered first when missing or stale
+    const sf::Texture& refresh() const;
+
+    sf::Sprite quad(const sf::Texture& texture) const;
+
+    LayerCache&  m_cache;
+    sf::FloatRect  m_area;
+    std::vector<Component::Ptr>  m_children;
+    mutable bool  m_dirty = true;
+
+} /*class CachedLayer*/;
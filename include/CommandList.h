@@ -0,0 +1,199 @@
+#pragma once
+#include "FrameArena.h"
+#include "QuadTransform.h"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class RenderDevice;
+class SpriteBatch;
+
+
+/**
+ * @brief   Packs draw ordering into 64 bits so a frame sorts as plain integers.
+ *
+ *  From most to least significant:
+ *
+ *  | bits | field   |                                                       |
+ *  |------|---------|-------------------------------------------------------|
+ *  | 8    | layer   | coarse ordering: background, world, ui, ...           |
+ *  | 24   | depth   | order within a layer, from the float's top 24 bits    |
+ *  | 24   | texture | hash of the texture, for captures; never orders draws |
+ *  | 8    | blend   | index into a process-wide table of blend modes        |
+ *
+ *  Only layer and depth order draws; `CommandList::sort` breaks their ties by
+ *  source and then recording order, never by texture, so sprites which
+ *  overlap at equal depth keep their submission order from run to run.
+ *  Texture and blend ride along for captures and tools; batching comes from
+ *  consecutive draws sharing a texture, which submission compares directly.
+ */
+struct SortKey {
+
+    static std::uint64_t make(std::uint8_t layer, float depth, const sf::Texture * texture, const sf::BlendMode& blend);
+
+    //! Built-in modes have fixed indices, others are interned on first use
+    static std::uint8_t blendIndex(const sf::BlendMode& blend);
+    static const sf::BlendMode& blendMode(std::uint8_t index);
+
+    static std::uint8_t layerOf(std::uint64_t key)
+    {
+        return static_cast<std::uint8_t>(key >> 56);
+    }
+
+    //! The layer and depth fields, which are all that orders draws
+    static std::uint32_t orderOf(std::uint64_t key)
+    {
+        return static_cast<std::uint32_t>(key >> 32);
+    }
+
+} /*struct SortKey*/;
+
+
+//! One recorded draw; lives in a `CommandList`'s arena
+struct RenderCommand {
+
+    enum class Kind : std::uint8_t {
+        Quad, Vertices, Drawable
+    };
+
+    Kind kind;
+    std::uint8_t blend;
+    sf::PrimitiveType primitive;
+    std::uint32_t count;
+    std::uint32_t source;
+    const sf::Texture * texture;
+    const sf::Vertex * vertices;
+    const sf::Drawable * drawable;
+    const sf::RenderStates * states;
+
+} /*struct RenderCommand*/;
+
+
+/**
+ * @brief   Records a frame's draws as keyed commands, sorts them, submits them.
+ *
+ *  Recording copies only what is needed into a per-frame `FrameArena`; sorting
+ *  is stable and adaptive, see `sort`; submission is a single pass feeding
+ *  runs of quads that share a texture and blend mode into a `SpriteBatch`.
+ *
+ *  Sprites are recorded as a transform and a local quad; `expandSprites`, which
+ *  `sort` also calls, computes the corners of every sprite recorded since at
+ *  once, with `transformQuads`.  Visiting or submitting a list holding sprites
+ *  which were not expanded since throws `std::logic_error`.
+ *
+ *  Each thread records into its own list.  `merge` then borrows another list's
+ *  commands, so the lender must not be cleared or destroyed before `submit`.
+ */
+class CommandList {
+
+public:
+
+    //! How the last `sort` ordered the commands
+    enum class SortMethod : std::uint8_t {
+        None, Insertion, Radix
+    };
+
+    //! Counters for the last `sort` and `submit`
+    struct Stats {
+        std::size_t commands = 0;
+        std::size_t arenaBytes = 0;
+        sf::Time sortTime{};
+        SortMethod sortMethod = SortMethod::None;
+        //! Entries the insertion pass shifted, including any abandoned to the radix sort
+        std::size_t moves = 0;
+    } /*struct Stats*/;
+
+    //! Marks commands that were not recorded on behalf of a source
+    static constexpr std::uint32_t NoSource = 0xffffffffu;
+
+    explicit CommandList(std::size_t arenaBlock = 64 * 1024);
+
+    //! A world-space quad given clockwise from its top-left corner
+    void quad(std::uint64_t key, const sf::Texture * texture, const sf::BlendMode& blend, const sf::Vertex (&quad)[4]);
+
+    //! `sprite` placed by `states.transform`, keyed by its texture and blend; see the class notes
+    void sprite(std::uint8_t layer, float depth, const sf::Sprite& sprite, const sf::RenderStates& states);
+
+    //! Borrows `vertices`; they must outlive `submit`
+    void vertices(std::uint64_t key, const sf::Vertex * vertices, std::size_t count, sf::PrimitiveType primitive, const sf::RenderStates& states);
+
+    //! Borrows `drawable`; it must outlive `submit`
+    void drawable(std::uint64_t key, const sf::Drawable& drawable, const sf::RenderStates& states);
+
+    //! Tags every following command with `source`, e.g. the recording component's index;
+    //! untagged commands sort after tagged ones with the same key
+    void setSource(std::uint32_t source);
+
+    //! The view these commands will be drawn through; sources which cull their
+    //! own parts, such as a `TileMapRenderer`, cull against it
+    void setView(const sf::View& view);
+    const sf::View& getView() const;
+
+    //! Borrows every command of `other`, see the class notes
+    void merge(const CommandList& other);
+
+    //! Computes the vertices of every sprite recorded since the last call, leaving
+    //! the order alone, e.g. to capture commands as they were recorded
+    void expandSprites();
+
+    /**
+     * @brief   Orders the commands by layer and depth, then by source, then in recording order.
+     *
+     *  Ties are broken by source rather than by recording order alone, so the
+     *  result does not depend on the order sources record in; texture and
+     *  blend never take part, see `SortKey`.  Recording in roughly last
+     *  frame's order then makes this cheap: input that is already sorted
+     *  costs one scan, and input with few entries out of place is repaired by
+     *  insertion.  When the insertion pass has shifted more than a few
+     *  entries per command, e.g. because many sprites moved, the rest is left
+     *  to an LSD radix sort which skips every byte all entries share.
+     */
+    void sort();
+
+    //! Draws every command in key order; see the class notes on sprites
+    void submit(RenderDevice& device, SpriteBatch& batch) const;
+
+    //! Forgets every command and rewinds the arena
+    void clear();
+
+    //! Visits every (key, command) in the current order; see the class notes on sprites
+    template<typename F>
+    void forEach(F&& visit) const
+    {
+        requireExpanded();
+        for (const auto& e : m_entries) { visit(e.key, *e.cmd); }
+    }
+
+    std::size_t size() const;
+    const Stats& getStats() const;
+
+private:
+
+    //! `source` is copied from the command so sorting never chases `cmd`
+    struct Entry {
+        std::uint64_t  key;
+        const RenderCommand *  cmd;
+        std::uint32_t  source;
+    } /*struct Entry*/;
+
+    RenderCommand * push(std::uint64_t key, RenderCommand::Kind kind);
+
+    //! Throws `std::logic_error` while some sprite has no vertices yet
+    void requireExpanded() const;
+
+    //! Returns false, leaving a permutation of the entries, once `budget` shifts are spent
+    bool insertionSort(std::size_t budget);
+    void radixSort();
+
+    FrameArena  m_arena;
+    std::vector<sf::Transform>  m_spriteTransforms;
+    std::vector<LocalQuad>  m_spriteQuads;
+    std::vector<RenderCommand *>  m_spriteCommands;
+    std::vector<Entry>  m_entries;
+    std::vector<Entry>  m_scratch;
+    std::uint32_t  m_source = NoSource;
+    sf::View  m_view;
+    Stats  m_stats;
+
+} /*class CommandList*/;
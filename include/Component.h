@@ -1,6 +1,11 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <memory>
+#include <optional>
+
+class CommandList;
+class StateHasher;
 
 class Component : public sf::Drawable, public sf::Transformable {
 public:
@@ -9,6 +14,34 @@ public:
 
     virtual ~Component() = default;
     virtual void update(float ft);
-    virtual void draw(const sf::RenderTarget&, sf::RenderStates) const;
+    virtual void draw(sf::RenderTarget&, sf::RenderStates) const override;
+
+    //! Records draw commands for later sorting; the default defers to `draw`
+    virtual void record(CommandList& list, sf::RenderStates states) const;
+
+    //! Extent before this component's transform; nothing means never culled
+    virtual std::optional<sf::FloatRect> getLocalBounds() const;
+
+    //! `getLocalBounds` placed by this component's transform
+    std::optional<sf::FloatRect> getBounds() const;
+
+    //! Coarse draw order, see `SortKey`
+    void setLayer(std::uint8_t layer);
+    std::uint8_t getLayer() const;
+
+    //! Y-sorted components draw in order of their feet within their layer, for top-down scenes
+    void setYSorted(bool ySorted);
+    bool isYSorted() const;
+
+    //! Order within the layer: the bottom edge of `getBounds` when y-sorted, otherwise 0
+    float getDepth() const;
+
+    //! Folds simulation state into `h`; the default covers the transform only
+    virtual void hashState(StateHasher& h) const;
+
+private:
+
+    std::uint8_t  m_layer = 0;
+    bool  m_ySorted = false;
 
 } /*struct Component*/;
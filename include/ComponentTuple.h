@@ -7,6 +7,9 @@
 #include <boost/hana.hpp>
 #include <boost/hana/ext/std/tuple.hpp>
 #include "Component.h"
+#include "CommandList.h"
+#include "SpatialGrid.h"
+#include "SpriteBatch.h"
 
 /**
  * `Designed to compose several _related_ components as one functioning component. ComponentTuple` is built upon
@@ -55,10 +58,23 @@ public:
         boost::hana::for_each(m_componentTuple.tie(), updater);
     }
 
+    void record(CommandList& list, sf::RenderStates stt) const
+    {
+        DrawVisitor recorder{list, stt};
+        boost::hana::for_each(m_componentTuple.ctie(), recorder);
+    }
+
+    //! Immediate drawing still goes through a (private) sorted command list, culled to the target's view.
+    //! The list and batch are kept between calls so their storage is reused instead of reallocated per frame
     void draw(sf::RenderTarget& tar, sf::RenderStates stt) const
     {
-        DrawVisitor drawer{tar, stt};
-        boost::hana::for_each(m_componentTuple.ctie(), drawer);
+        m_commands.clear();
+        m_batch.resetStats();
+        DrawVisitor recorder{m_commands, stt, viewBounds(tar.getView())};
+        boost::hana::for_each(m_componentTuple.ctie(), recorder);
+        m_commands.sort();
+        RenderTargetDevice device{tar};
+        m_commands.submit(device, m_batch);
     }
 
     constexpr auto tie()
@@ -74,5 +90,7 @@ public:
 private:
 
     FactoryTuple<C...>  m_componentTuple;
+    mutable CommandList m_commands{};
+    mutable SpriteBatch m_batch{};
 
 } /*class ComponentTuple*/;
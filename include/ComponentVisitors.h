@@ -1,32 +1,50 @@
 #pragma once
 #include <functional>
+#include <optional>
 #include <type_traits>
 #include <utility>
-#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Drawable.hpp>
 #include <SFML/Graphics/RenderStates.hpp>
+#include "CommandList.h"
 
 namespace detail {
 
+//! Default behavior, record drawables as deferred draws and skip anything else
 template<typename C, typename = void>
-class DrawVisitorResolverFunctor {
+struct DrawVisitorResolverFunctor {
 
-    void operator()(const C& visitee, sf::RenderTarget& target, sf::RenderStates states) const { }
+    void operator()(const C& visitee, CommandList& list, sf::RenderStates states) const
+    {
+        recordDrawable(visitee, list, states, std::is_base_of<sf::Drawable, C>{});
+    }
+
+private:
+
+    static void recordDrawable(const C& visitee, CommandList& list, sf::RenderStates states, std::true_type)
+    {
+        list.drawable(SortKey::make(0, 0.f, states.texture, states.blendMode), visitee, states);
+    }
 
-};
+    static void recordDrawable(const C&, CommandList&, sf::RenderStates, std::false_type)
+    {
+    }
 
+} /*struct DrawVisitorResolverFunctor*/;
 
+
+//! Specialized behavior, let the visitee record its own commands
 template<typename C>
 struct DrawVisitorResolverFunctor
   < C
-  , decltype(std::declval<const C&>().draw(std::declval<sf::RenderTarget&>(), std::declval<sf::RenderStates>()))
+  , decltype(std::declval<const C&>().record(std::declval<CommandList&>(), std::declval<sf::RenderStates>()))
     > {
 
-    void operator()(const C& visitee, sf::RenderTarget& target, sf::RenderStates states) const
+    void operator()(const C& visitee, CommandList& list, sf::RenderStates states) const
     {
-        visitee.draw(target, states);
+        visitee.record(list, states);
     }
 
-};
+} /*struct DrawVisitorResolverFunctor*/;
 
 
 //! Default behavior, do nothing
@@ -52,6 +70,21 @@ struct UpdateVisitorResolverFunctor
 
 } /*struct UpdateVisitorResolverFunctor*/;
 
+//! Visitees which report bounds may be culled; others are always potentially visible
+template<typename C>
+auto mayBeVisible(const C& visitee, const sf::Transform& transform, const sf::FloatRect& area, int)
+    -> decltype(visitee.getBounds(), bool())
+{
+    const auto bounds = visitee.getBounds();
+    return !bounds || transform.transformRect(*bounds).intersects(area);
+}
+
+template<typename C>
+bool mayBeVisible(const C&, const sf::Transform&, const sf::FloatRect&, long)
+{
+    return true;
+}
+
 } /*namespace detail*/;
 
 
@@ -80,27 +113,32 @@ private:
 } /*struct UpdateVisitor*/;
 
 
+//! Records each visitee into a `CommandList` rather than drawing it immediately
 class DrawVisitor {
 
 public:
 
-    DrawVisitor(sf::RenderTarget& targetIn, sf::RenderStates statesIn);
+    //! Visitees whose bounds miss `cullIn`, given in target space, are skipped
+    DrawVisitor(CommandList& listIn, sf::RenderStates statesIn, std::optional<sf::FloatRect> cullIn = std::nullopt);
 
     template<typename C>
     void operator()(const C& visitee) const
     {
-        detail::DrawVisitorResolverFunctor<C>{}(visitee, m_target.get(), m_states);
+        if (!m_cull || detail::mayBeVisible(visitee, m_states.transform, *m_cull, 0)) {
+            detail::DrawVisitorResolverFunctor<C>{}(visitee, m_list.get(), m_states);
+        }
     }
 
     template<typename C>
     void operator()(std::reference_wrapper<const C> visitee) const
     {
-        detail::DrawVisitorResolverFunctor<C>{}(visitee.get(), m_target.get(), m_states);
+        (*this)(visitee.get());
     }
 
 private:
 
-    std::reference_wrapper<sf::RenderTarget> m_target;
+    std::reference_wrapper<CommandList> m_list;
     sf::RenderStates m_states;
+    std::optional<sf::FloatRect> m_cull;
 
 } /*class DrawVisitor*/;
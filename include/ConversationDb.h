@@ -0,0 +1,190 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class JsonReader;
+
+
+/**
+ * @brief   Every conversation scene, compiled into one read-only image.
+ *
+ *  A scene is a `sequence` of steps, each naming one of the scene's nodes,
+ *  and a node holds one or more lines.  A line "Name: text" is said by the
+ *  speaker "Name"; speakers are interned, so each is stored once and lines
+ *  refer to it by index.
+ *
+ *  Scenes, nodes, lines, speakers and steps are fixed-size records in flat
+ *  arrays, and all of their text is in one arena which lines view as
+ *  `std::string_view`.  Scenes are found by id through a hash table that is
+ *  part of the image, so `write` followed by `map` gives a database which is
+ *  usable at once, without parsing or rebuilding anything.
+ *
+ *  The image starts with "MINTCONV", a u32 version and the record counts;
+ *  all integers are little-endian.
+ */
+class ConversationDb {
+
+public:
+
+    static constexpr std::uint32_t NoScene = 0xffffffffu;
+    static constexpr std::uint32_t NoNode = 0xffffffffu;
+    static constexpr std::uint32_t NoSpeaker = 0xffffffffu;
+
+    //! `text` views the database and lives as long as it does
+    struct Line {
+        std::uint32_t speaker;
+        std::string_view text;
+    } /*struct Line*/;
+
+    //! An empty database
+    ConversationDb();
+
+    //! Maps a database written by `write`; throws `std::runtime_error` if it is damaged
+    static ConversationDb map(const std::string& path);
+    static ConversationDb read(std::istream& src);
+    void write(std::ostream& dst) const;
+
+    //! `NoScene` for unknown ids; constant time
+    std::uint32_t findScene(std::string_view id) const;
+    std::size_t getSceneCount() const;
+    std::string_view getSceneId(std::uint32_t scene) const;
+
+    //! A scene's sequence; each step is the index of a node
+    std::size_t getStepCount(std::uint32_t scene) const;
+    std::uint32_t getStep(std::uint32_t scene, std::size_t step) const;
+
+    //! A scene's nodes are numbered consecutively from its first
+    std::uint32_t getFirstNode(std::uint32_t scene) const;
+    std::size_t getNodeCount(std::uint32_t scene) const;
+
+    //! `NoNode` if `scene` has no node `id`; linear in the scene's nodes
+    std::uint32_t findNode(std::uint32_t scene, std::string_view id) const;
+    std::string_view getNodeId(std::uint32_t node) const;
+    std::size_t getLineCount(std::uint32_t node) const;
+    Line getLine(std::uint32_t node, std::size_t line) const;
+
+    //! `NoSpeaker` for unknown names; linear in the speakers
+    std::uint32_t findSpeaker(std::string_view name) const;
+    std::size_t getSpeakerCount() const;
+    std::string_view getSpeakerName(std::uint32_t speaker) const;
+
+    //! Calls `visit(step, line)` for every line of `scene`, in sequence order
+    template<typename F>
+    void forEachLine(std::uint32_t scene, F&& visit) const
+    {
+        for (std::size_t step = 0, steps = getStepCount(scene); step < steps; ++step) {
+            const std::uint32_t node = getStep(scene, step);
+            for (std::size_t line = 0, lines = getLineCount(node); line < lines; ++line) {
+                visit(step, getLine(node, line));
+            }
+        }
+    }
+
+    //! Bytes of the image, which is the whole of the database
+    std::size_t getMemoryUsage() const;
+
+private:
+
+    friend class ConversationBuilder;
+
+    //! Validates every record of the image
+    ConversationDb(std::shared_ptr<const unsigned char> image, std::size_t size);
+
+    std::uint32_t word(const unsigned char * table, std::size_t index) const;
+    std::string_view text(const unsigned char * ref) const;
+
+    std::shared_ptr<const unsigned char>  m_image;
+    std::size_t  m_size = 0;
+    std::uint32_t  m_scenes = 0, m_nodes = 0, m_lines = 0, m_speakers = 0, m_steps = 0, m_slots = 0, m_textBytes = 0;
+    const unsigned char *  m_sceneTable = nullptr;
+    const unsigned char *  m_nodeTable = nullptr;
+    const unsigned char *  m_lineTable = nullptr;
+    const unsigned char *  m_speakerTable = nullptr;
+    const unsigned char *  m_stepTable = nullptr;
+    const unsigned char *  m_slotTable = nullptr;
+    const char *  m_text = nullptr;
+
+} /*class ConversationDb*/;
+
+
+/**
+ * @brief   Compiles conversation scenes from JSON into a `ConversationDb`.
+ *
+ *  Each source holds one scene object, as assets/SampleChat.json does, or an
+ *  array of them.  A scene may name itself with "id"; unnamed scenes are
+ *  called "scene0", "scene1", ... in the order they are read.  Strings are
+ *  deduplicated as they are read, so the builder never holds more text than
+ *  the finished database.
+ *
+ *  Throws `std::runtime_error` for malformed input, duplicate scene ids and
+ *  sequences naming nodes their scene lacks.
+ */
+class ConversationBuilder {
+
+public:
+
+    ConversationBuilder();
+
+    void read(std::istream& json);
+
+    //! Copies every scene of `db`
+    void add(const ConversationDb& db);
+
+    ConversationDb build() const;
+
+    std::size_t getSceneCount() const;
+
+private:
+
+    struct Ref {
+        std::uint32_t offset;
+        std::uint32_t length;
+    } /*struct Ref*/;
+
+    struct Scene {
+        Ref id;
+        std::uint32_t firstNode, nodeCount, firstStep, stepCount;
+    } /*struct Scene*/;
+
+    struct Node {
+        Ref id;
+        std::uint32_t firstLine, lineCount;
+    } /*struct Node*/;
+
+    struct Line {
+        std::uint32_t speaker;
+        Ref text;
+    } /*struct Line*/;
+
+    //! Stores `s` once, however often it is interned
+    Ref intern(std::string_view s);
+    std::uint32_t internSpeaker(std::string_view name);
+    void addLine(std::string_view utf8);
+    void readScene(JsonReader& json);
+    std::string_view view(Ref ref) const;
+
+    //! Text is appended to fixed blocks, so views into it stay valid
+    struct Chunk {
+        std::unique_ptr<char[]> bytes;
+        std::uint64_t offset;
+        std::size_t used, capacity;
+    } /*struct Chunk*/;
+
+    std::vector<Chunk>  m_chunks;
+    std::uint64_t  m_textBytes = 0;
+    std::unordered_map<std::string_view, Ref>  m_strings;
+    std::unordered_map<std::string_view, std::uint32_t>  m_speakerIndex;
+    std::unordered_map<std::string_view, std::uint32_t>  m_sceneIndex;
+    std::vector<Scene>  m_scenes;
+    std::vector<Node>  m_nodes;
+    std::vector<Line>  m_lines;
+    std::vector<Ref>  m_speakers;
+    std::vector<std::uint32_t>  m_steps;
+
+} /*class ConversationBuilder*/;
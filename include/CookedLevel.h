@@ -0,0 +1,49 @@
+#pragma once
+#include "LevelMap.h"
+#include <iostream>
+#include <string>
+
+
+/**
+ * @brief   Writes `map` in the cooked level format, which loads without parsing.
+ *
+ *  All integers are little-endian.  A file is a 32-byte header, a section
+ *  table, then the sections, each starting on a 64-byte boundary:
+ *
+ *  | offset | field                                   |
+ *  |--------|-----------------------------------------|
+ *  | 0      | magic, "MINTLEVL"                       |
+ *  | 8      | u32 version                             |
+ *  | 12     | u32 section count                       |
+ *  | 16     | u64 file size                           |
+ *  | 24     | u64 reserved, zero                      |
+ *  | 32     | per section: u32 kind, u32 records, u64 offset, u64 bytes |
+ *
+ *  Sections hold fixed-size records: the map itself, tilesets, layers and
+ *  objects, whose strings are (offset, length) pairs into a string section.
+ *  Every layer's gids sit in a tile section at a 64-byte aligned offset, so
+ *  a loaded layer can point straight into the file.  Loaders skip section
+ *  kinds they do not know.
+ */
+void cookLevel(const LevelMap& map, std::ostream& dst);
+
+/**
+ * @brief   Maps a cooked level into memory; its tile layers view the mapping.
+ *
+ *  Nothing is parsed or copied but names and objects; the mapping stays
+ *  alive as long as any layer of the map does.  Throws `std::runtime_error`
+ *  for files which are truncated, corrupt or of another version.
+ *
+ *  N.B.:  Overwriting a cooked file while a level mapped from it is alive
+ *  changes that level underneath; cook to a new file and rename instead.
+ */
+LevelMap mapCookedLevel(const std::string& path);
+
+//! Reads a cooked level from a stream into one buffer, which the tile layers then view
+LevelMap readCookedLevel(std::istream& src);
+
+//! The cooked sibling of a source map, e.g. "maps/cave.tmx" -> "maps/cave.mlvl"
+std::string cookedLevelPath(const std::string& source);
+
+//! True if `cooked` exists and was modified after `source`, to the nanosecond, or `source` is missing
+bool isCookedLevelFresh(const std::string& cooked, const std::string& source);
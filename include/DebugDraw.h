@@ -0,0 +1,128 @@
+#pragma once
+#include "RenderDevice.h"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+
+/**
+ * @brief   Immediate-mode debug shapes, callable from any thread at any time.
+ *
+ *  Each call appends vertices to a buffer owned by the calling thread, so
+ *  threads never contend with each other, only briefly with `flush`.  The
+ *  next `GameWorld::render` flushes every thread's buffer after the frame's
+ *  own commands: outlines as one `sf::Lines` draw, filled shapes as one
+ *  `sf::Triangles` draw, and labels, if a font was set, as one more.
+ *  Coordinates are in world space.
+ *
+ *  While a `Scope` is alive on a thread, that thread's shapes go to the
+ *  scope's `Canvas` instead.  Each `GameWorld` updates and renders inside a
+ *  scope of its own, so worlds never draw each other's shapes, and a world
+ *  which was not rendered drops them on its next update rather than keeping
+ *  them forever.  Shapes from threads outside of any scope, e.g. a world's
+ *  pool jobs, stay shared and are drawn by whichever world renders next.
+ *
+ *  When `NDEBUG` is defined every function is an empty inline and nothing is
+ *  compiled in; guard expensive argument computation with `Enabled`.
+ */
+class DebugDraw {
+
+public:
+
+#ifdef NDEBUG
+    static constexpr bool Enabled = false;
+#else
+    static constexpr bool Enabled = true;
+#endif
+
+    //! What the last `flush` drew
+    struct Stats {
+        std::size_t draws = 0;
+        std::size_t lines = 0;
+        std::size_t triangles = 0;
+        std::size_t labels = 0;
+    } /*struct Stats*/;
+
+    static void line(sf::Vector2f from, sf::Vector2f to, sf::Color color = sf::Color::Green);
+    static void box(const sf::FloatRect& rect, sf::Color color = sf::Color::Green, bool filled = false);
+    static void circle(sf::Vector2f center, float radius, sf::Color color = sf::Color::Green, bool filled = false);
+
+    //! Dropped at flush unless a font has been set
+    static void label(sf::Vector2f at, const std::string& utf8, sf::Color color = sf::Color::White);
+
+    //! `font` must outlive every later flush; null drops labels again
+    static void setFont(const sf::Font * font, unsigned int size = 12);
+
+    //! Draws and forgets everything appended outside of any `Scope`, from every thread, since the last flush
+    static void flush(RenderDevice& device, const sf::RenderStates& states = {});
+
+    //! What the last flush drew, of the shared buffers or of any `Canvas`
+    static Stats getStats();
+
+    //! Shapes kept apart from the shared buffers, e.g. one world's; see `Scope`
+    class Canvas {
+
+    public:
+
+        Canvas();
+        ~Canvas();
+
+        Canvas(const Canvas&) = delete;
+        Canvas& operator=(const Canvas&) = delete;
+
+        //! As `DebugDraw::flush`, drawing this canvas's shapes in the same draws, on top
+        void flush(RenderDevice& device, const sf::RenderStates& states = {});
+
+        //! Forgets everything appended since the last flush, keeping the storage
+        void discard();
+
+        //! Vertices and labels appended since the last flush or discard
+        std::size_t getPending() const;
+
+    private:
+
+        friend class DebugDraw;
+
+        struct Impl;
+        std::unique_ptr<Impl>  m_impl;
+
+    } /*class Canvas*/;
+
+    //! Sends the calling thread's shapes to `canvas` until destroyed; scopes nest
+    class Scope {
+
+    public:
+
+        explicit Scope(Canvas& canvas);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+
+        Canvas *  m_previous = nullptr;
+
+    } /*class Scope*/;
+
+} /*class DebugDraw*/;
+
+
+#ifdef NDEBUG
+inline void DebugDraw::line(sf::Vector2f, sf::Vector2f, sf::Color) { }
+inline void DebugDraw::box(const sf::FloatRect&, sf::Color, bool) { }
+inline void DebugDraw::circle(sf::Vector2f, float, sf::Color, bool) { }
+inline void DebugDraw::label(sf::Vector2f, const std::string&, sf::Color) { }
+inline void DebugDraw::setFont(const sf::Font *, unsigned int) { }
+inline void DebugDraw::flush(RenderDevice&, const sf::RenderStates&) { }
+inline DebugDraw::Stats DebugDraw::getStats() { return {}; }
+struct DebugDraw::Canvas::Impl { };
+inline DebugDraw::Canvas::Canvas() { }
+inline DebugDraw::Canvas::~Canvas() { }
+inline void DebugDraw::Canvas::flush(RenderDevice&, const sf::RenderStates&) { }
+inline void DebugDraw::Canvas::discard() { }
+inline std::size_t DebugDraw::Canvas::getPending() const { return 0; }
+inline DebugDraw::Scope::Scope(Canvas&) { }
+inline DebugDraw::Scope::~Scope() { }
+#endif
@@ -0,0 +1,58 @@
+#pragma once
+#include "Component.h"
+#include "TextLayout.h"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+
+/**
+ * @brief   A wrapped conversation line with an optional typewriter reveal.
+ *
+ *  The line is laid out once, through a `TextLayoutCache`, when its string
+ *  changes; revealing it only changes how many of the cached vertices are
+ *  drawn, never the vertices themselves.
+ */
+class DialogueText : public Component {
+
+public:
+
+    //! `cache` and `font` must outlive the component
+    DialogueText(TextLayoutCache& cache, const sf::Font& font, unsigned int size, float wrapWidth);
+
+    //! Copies `utf8`, so it may view a `ConversationDb` that is later released
+    void setString(std::string_view utf8);
+    void setColor(sf::Color color);
+
+    //! Characters shown per second; zero shows the whole line at once
+    void setRevealRate(float charactersPerSecond);
+
+    //! Shows the whole line now
+    void skipReveal();
+    bool isRevealed() const;
+
+    std::size_t getCharacterCount() const;
+    std::size_t getRevealedCount() const;
+
+    void update(float dt) override;
+    std::optional<sf::FloatRect> getLocalBounds() const override;
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void record(CommandList& list, sf::RenderStates states) const override;
+
+private:
+
+    void relayout();
+
+    TextLayoutCache&  m_cache;
+    const sf::Font&  m_font;
+    unsigned int  m_size;
+    float  m_wrapWidth;
+    sf::Color  m_color = sf::Color::White;
+    std::string  m_string;
+    std::shared_ptr<const GlyphRun>  m_run;
+    float  m_revealRate = 0.f;
+    float  m_revealed = 0.f;
+
+} /*class DialogueText*/;
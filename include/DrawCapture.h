@@ -0,0 +1,114 @@
+#pragma once
+#include "CommandList.h"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * @brief   Writes the draw commands of a range of frames as a binary capture.
+ *
+ *  Frames are captured as recorded, before sorting, so replaying them can
+ *  measure changes to sorting as well as to batching.  The capture starts
+ *  with an 8-byte magic and a version, followed by one record per frame: the
+ *  view, any textures seen for the first time (as an id and a size), then
+ *  each command with its full sort key, source, blend mode, texture id and
+ *  vertices; raw vertex draws also carry their primitive and transform.
+ *
+ *  Textures are identified, not stored: a GPU texture's pixels can not be read
+ *  back cheaply mid-frame, and submission cost does not depend on them.
+ *  Opaque `sf::Drawable` commands can not be serialized and are counted
+ *  and dropped, as are shaders.
+ */
+class DrawRecorder {
+
+public:
+
+    //! Writes the header immediately
+    explicit DrawRecorder(std::ostream& dst);
+
+    //! Appends every command of `list`, in its current order, as one frame seen through
+    //! `view`; its sprites must have been expanded, see `CommandList`
+    void recordFrame(const CommandList& list, const sf::View& view);
+
+    std::size_t getFrameCount() const;
+    std::size_t getSkippedDrawables() const;
+
+private:
+
+    std::ostream&  m_dst;
+    std::string  m_frame;
+    std::unordered_map<const sf::Texture *, std::uint32_t>  m_textures;
+    std::size_t  m_frames = 0;
+    std::size_t  m_skipped = 0;
+
+} /*class DrawRecorder*/;
+
+
+//! One decoded frame of a capture
+class DrawFrame {
+
+public:
+
+    //! Re-records the frame's commands, in capture order and with their sources, into `list`
+    void record(CommandList& list) const;
+
+    const sf::View& getView() const;
+    std::size_t size() const;
+
+private:
+
+    friend class DrawReplayer;
+
+    struct Command {
+        std::uint64_t  key;
+        std::uint32_t  source;
+        RenderCommand::Kind  kind;
+        sf::PrimitiveType  primitive;
+        sf::BlendMode  blend;
+        const sf::Texture *  texture;
+        sf::Transform  transform;
+        std::size_t  first;
+        std::size_t  count;
+    } /*struct Command*/;
+
+    sf::View  m_view;
+    std::vector<Command>  m_commands;
+    std::vector<sf::Vertex>  m_vertices;
+
+} /*class DrawFrame*/;
+
+
+/**
+ * @brief   Reads back captures written by `DrawRecorder`, throwing on malformed input.
+ *
+ *  Each captured texture is replaced by a stand-in owned by the replayer, so
+ *  decoded frames must not outlive it.  Stand-ins start empty; create them at
+ *  their captured size before replaying against the GPU.
+ */
+class DrawReplayer {
+
+public:
+
+    //! Validates the header
+    explicit DrawReplayer(std::istream& src);
+
+    //! Returns false once the capture is exhausted
+    bool nextFrame(DrawFrame& frame);
+
+    //! Stand-ins in order of first appearance, matching `getTextureSizes`
+    sf::Texture& getTexture(std::size_t index);
+    const std::vector<sf::Vector2u>& getTextureSizes() const;
+
+private:
+
+    std::istream&  m_src;
+    std::deque<sf::Texture>  m_textures;
+    std::vector<sf::Vector2u>  m_sizes;
+
+} /*class DrawReplayer*/;
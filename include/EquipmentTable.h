@@ -0,0 +1,137 @@
+#pragma once
+#include "BattleStats.h"
+#include "PerfectHash.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/**
+ * @brief   Every equipment item, stored column by column.
+ *
+ *  Each stat is one contiguous `std::int32_t` array indexed by row, and the
+ *  slot one byte array, so a query reads only the columns it filters on.
+ *  Queries scan 64 rows at a time into a bit mask, comparing eight rows per
+ *  instruction on AVX2 and four on SSE2, and skip a block's remaining
+ *  columns as soon as no row of it still matches.
+ *
+ *  Ids and names are looked up through perfect hashes built with the table,
+ *  so finding a row costs the same whatever the key.  The table is
+ *  immutable once built and may be read from many threads.
+ */
+class EquipmentTable {
+
+public:
+
+    enum class Slot : std::uint8_t {
+        Weapon, Head, Body, Hands, Feet, Accessory, Count
+    };
+
+    //! `Level` and `Price` are requirements; the rest modify `BattleStats` of the same name
+    enum class Column : std::uint8_t {
+        Level, Price, HpMax, MpMax, Att, Def, Mag, MagDef, Spd, Count
+    };
+
+    static constexpr std::size_t ColumnCount = static_cast<std::size_t>(Column::Count);
+    static constexpr std::uint32_t NoRow = 0xffffffffu;
+
+    //! One item, as loaded
+    struct Item {
+        std::uint32_t id = 0;
+        std::string name;
+        Slot slot = Slot::Weapon;
+        std::array<std::int32_t, ColumnCount> stats{};
+    } /*struct Item*/;
+
+    //! Every condition must hold; unconstrained columns match anything
+    class Query {
+
+    public:
+
+        //! Matches every row
+        Query();
+
+        //! Allows `slot`; calling it again allows several
+        Query& slot(Slot slot);
+        Query& atLeast(Column column, std::int32_t min);
+        Query& atMost(Column column, std::int32_t max);
+
+    private:
+
+        friend class EquipmentTable;
+
+        std::uint8_t  m_slots = 0;
+        std::array<std::int32_t, ColumnCount>  m_min;
+        std::array<std::int32_t, ColumnCount>  m_max;
+        std::uint32_t  m_constrained = 0;
+
+    } /*class Query*/;
+
+    //! An empty table
+    EquipmentTable();
+
+    //! Throws `std::invalid_argument` if two items share an id or a name
+    explicit EquipmentTable(const std::vector<Item>& items);
+
+    std::size_t size() const;
+
+    //! `NoRow` for unknown keys
+    std::uint32_t findId(std::uint32_t id) const;
+    std::uint32_t findName(std::string_view name) const;
+
+    //! A copy of `row` as loaded
+    Item getItem(std::uint32_t row) const;
+
+    std::uint32_t getId(std::uint32_t row) const;
+    std::string_view getName(std::uint32_t row) const;
+    Slot getSlot(std::uint32_t row) const;
+    std::int32_t get(std::uint32_t row, Column column) const;
+
+    //! `size()` values, one per row
+    const std::int32_t * column(Column column) const;
+
+    //! Appends every matching row to `rows`, in row order
+    void select(const Query& query, std::vector<std::uint32_t>& rows) const;
+    std::size_t count(const Query& query) const;
+
+    //! Adds `row`'s modifiers to `stats`, stopping at zero
+    void applyTo(std::uint32_t row, BattleStats& stats) const;
+
+    //! "att" for `Column::Att`, and so on; the keys `readEquipment` accepts
+    static const char * getColumnName(Column column);
+    static const char * getSlotName(Slot slot);
+
+private:
+
+    //! Calls `visit(firstRow, mask)` for every 64-row block with a match
+    template<typename F>
+    void scan(const Query& query, F&& visit) const;
+
+    std::vector<std::uint32_t>  m_ids;
+    std::vector<std::uint32_t>  m_nameOffsets;
+    std::string  m_names;
+    //! `1 << slot` per row, so that a query tests any set of slots at once
+    std::vector<std::uint8_t>  m_slotBits;
+    std::array<std::vector<std::int32_t>, ColumnCount>  m_columns;
+
+    PerfectHash  m_idHash;
+    std::vector<std::uint32_t>  m_idRows;
+    PerfectHash  m_nameHash;
+    std::vector<std::uint32_t>  m_nameRows;
+
+} /*class EquipmentTable*/;
+
+
+/**
+ * @brief   Reads an array of items from JSON.
+ *
+ *  Each item is an object with an "id", a "name", a "slot" named as by
+ *  `getSlotName` (e.g. "weapon") and any stats named as by `getColumnName`;
+ *  unknown keys are skipped.  Throws `std::runtime_error` for anything else.
+ */
+std::vector<EquipmentTable::Item> readEquipment(std::istream& json);
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief   A linear allocator whose memory is reclaimed all at once.
+ *
+ *  Allocation is a pointer bump inside of the current block; `reset` rewinds
+ *  to the first block without returning anything to the system, so after the
+ *  first few frames recording a frame never touches the heap.  Only trivially
+ *  destructible objects may live here, nothing is ever destroyed.
+ */
+class FrameArena {
+
+public:
+
+    explicit FrameArena(std::size_t blockSize = 64 * 1024) : m_blockSize{blockSize}
+    {
+    }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    FrameArena(FrameArena&&) = default;
+    FrameArena& operator=(FrameArena&&) = default;
+
+    void * allocate(std::size_t size, std::size_t align)
+    {
+        std::uintptr_t p = (m_cursor + align - 1) & ~static_cast<std::uintptr_t>(align - 1);
+        if (!m_cursor || p + size > m_end) {
+            nextBlock(size + align);
+            p = (m_cursor + align - 1) & ~static_cast<std::uintptr_t>(align - 1);
+        }
+        m_cursor = p + size;
+        m_used += size;
+        return reinterpret_cast<void*>(p);
+    }
+
+    template<typename T, typename... A>
+    T * create(A&&... args)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<A>(args)...);
+    }
+
+    //! Uninitialized storage for `n` objects of type `T`
+    template<typename T>
+    T * createArray(std::size_t n)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed");
+        return static_cast<T*>(allocate(sizeof(T) * n, alignof(T)));
+    }
+
+    //! Invalidates everything allocated so far
+    void reset()
+    {
+        m_current = 0;
+        m_cursor = m_end = 0;
+        m_used = 0;
+        if (!m_blocks.empty()) {
+            enter(0);
+        }
+    }
+
+    //! Bytes handed out since the last reset
+    std::size_t getBytesUsed() const
+    {
+        return m_used;
+    }
+
+    //! Bytes held onto, including unused capacity
+    std::size_t getBytesReserved() const
+    {
+        std::size_t bytes{0};
+        for (const auto& block : m_blocks) { bytes += block.size; }
+        return bytes;
+    }
+
+private:
+
+    struct Block {
+        std::unique_ptr<char[]>  memory;
+        std::size_t  size;
+    } /*struct Block*/;
+
+    void enter(std::size_t i)
+    {
+        m_current = i;
+        m_cursor = reinterpret_cast<std::uintptr_t>(m_blocks[i].memory.get());
+        m_end = m_cursor + m_blocks[i].size;
+    }
+
+    void nextBlock(std::size_t atLeast)
+    {
+        // Blocks past the current one are free; reuse one when it is big enough
+        const std::size_t next = m_cursor ? m_current + 1 : 0;
+        for (std::size_t i = next; i < m_blocks.size(); ++i) {
+            if (m_blocks[i].size >= atLeast) {
+                std::swap(m_blocks[i], m_blocks[next]);
+                enter(next);
+                return;
+            }
+        }
+        const std::size_t size = atLeast > m_blockSize ? atLeast : m_blockSize;
+        m_blocks.push_back({std::unique_ptr<char[]>{new char[size]}, size});
+        std::swap(m_blocks.back(), m_blocks[next]);
+        enter(next);
+    }
+
+    std::size_t  m_blockSize;
+    std::vector<Block>  m_blocks;
+    std::size_t  m_current = 0;
+    std::uintptr_t  m_cursor = 0;
+    std::uintptr_t  m_end = 0;
+    std::size_t  m_used = 0;
+
+} /*class FrameArena*/;
@@ -2,16 +2,36 @@
 #include "GameSettings.h"
 #include <iostream>
 #include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 // Forward Declarations
+class AnimationLibrary;
+class ConversationBuilder;
+class ConversationDb;
+class EquipmentTable;
 class LevelAtlas;
+class StartupReport;
+class WorkerPool;
 
 //! A mediator of Game-specific details
 /**
  *  Meant to hold onto global data that other Game instances may have an
  *  interest in, for example equipment data, levels, npc data, shop data,
  *  and so on.  
+ *
+ *  Once loading is done a context is read-only, and its const members may be
+ *  called from many threads at once; every world hosted by a `WorldHost`
+ *  shares a single context rather than loading its own copy.
+ *
+ *  `loadFiles` parses equipment and maps on a `WorkerPool`, then merges them
+ *  in the order given, so the result never depends on which file finished
+ *  first.  Conversations are not needed to show a frame: `loadFiles` only
+ *  checks that their files exist, then leaves them parsing on the pool, and
+ *  only `getConversations` waits for them.
  */
 class GameContext {
 
@@ -21,20 +41,111 @@ public:
         EquipmentData, LevelMap, Conversation, Count
     };
 
+    //! A file to load, see `loadFiles`
+    struct Source {
+        DataType type;
+        std::string path;
+    } /*struct Source*/;
+
     //! Begins with default debug-settings
     GameContext();
+    ~GameContext();
 
-    //! Adds a stream from which data may be extracted
+    //! Adds a stream from which data may be extracted; items whose id or name
+    //! is taken throw `std::invalid_argument`, and the stream adds nothing
     void loadEquipment(std::istream& src);
     void loadLevelMaps(std::istream& src);
     void loadConversations(std::istream& src);
 
+    //! Loads the map at `path`, or its cooked sibling instead when that is up to
+    //! date, see `cookedLevelPath`; cooked levels are mapped, not parsed
+    void loadLevelFile(const std::string& path);
+
+    /**
+     * @brief   Loads every source, in parallel on `pool`; see the class notes.
+     *
+     *  Returns once equipment and maps are in place, waiting only for its own
+     *  jobs.  A failure to read any of them, or an item id or name which
+     *  clashes with one loaded before, throws the first error in source
+     *  order, naming its file, and leaves the context as it was.
+     *  Conversation files which cannot be opened throw too; anything else
+     *  wrong with them throws from `getConversations`.
+     *
+     *  N.B.: Conversations are still parsing on `pool` when this returns;
+     *  the pool may be destroyed meanwhile, as it finishes its queue first.
+     */
+    void loadFiles(const std::vector<Source>& sources, WorkerPool& pool);
+
+    //! Every later load, including deferred ones, is timed into `report`; null stops reporting
+    void setStartupReport(StartupReport * report);
+
     //! Generates settings from context accumulated in lifetime of this
     GameSettings generateSettings();
 
     //! Returns window title
     const char * getWindowTitle() const;
 
+    //! Loaded levels, shared by every world built from this context
+    const LevelAtlas& getLevelAtlas() const;
+
+    //! Every item loaded so far, indexed on first use after a load, so a run of
+    //! loads indexes once.  A later `loadEquipment` or `loadFiles` invalidates
+    //! the returned table
+    const EquipmentTable& getEquipment() const;
+
+    //! Every scene loaded so far, compiled on first use after a load or waited
+    //! for while `loadFiles` compiles it; a compiled database loaded on its own
+    //! is returned as loaded.  A later `loadConversations` or `loadFiles`
+    //! invalidates the returned database
+    const ConversationDb& getConversations() const;
+
+    //! Animation clips, shared by every instance playing them
+    AnimationLibrary& getAnimationLibrary();
+    const AnimationLibrary& getAnimationLibrary() const;
+
 private:
 
+    struct EquipmentSource;
+
+    //! After items are added: the next `getEquipment` builds the table afresh
+    void dropEquipmentIndex();
+
+    //! Reads conversation files deferred by `loadFiles`; the caller holds `m_conversationMutex`
+    //! or, while `m_compiling`, is the one job compiling them
+    void readPendingConversations() const;
+
+    //! Reads the deferred conversations and compiles them, on a pool's thread; see `loadFiles`
+    void compileConversations();
+
+    //! Holds `db` as it is when it is the only source so far, else copies its scenes into the builder
+    void addConversations(ConversationDb&& db) const;
+
+    //! Reads JSON scenes into the builder, after any held database's
+    void readConversations(std::istream& src) const;
+
+    //! The held database when it is the only source, else a build of every source
+    ConversationDb buildConversations() const;
+
+    //! Copies a held database's scenes into the builder, once a second source arrives
+    void foldHeldConversations() const;
+
+    //! Blocks while conversations compile on a pool; `lock` holds `m_conversationMutex`
+    void waitForConversations(std::unique_lock<std::mutex>& lock) const;
+
+    std::unique_ptr<LevelAtlas>  m_levels;
+    std::unique_ptr<AnimationLibrary>  m_animations;
+    std::unique_ptr<EquipmentSource>  m_equipmentSource;
+    //! Built by `getEquipment` at most once per run of loads, since each build costs every item loaded
+    mutable std::unique_ptr<EquipmentTable>  m_equipment;
+    mutable std::mutex  m_equipmentMutex;
+    mutable std::unique_ptr<ConversationBuilder>  m_conversationSource;
+    //! A compiled or mapped database loaded first, kept out of the builder while it is the only one
+    mutable std::unique_ptr<ConversationDb>  m_heldConversations;
+    mutable std::vector<std::string>  m_pendingConversations;
+    mutable std::unique_ptr<ConversationDb>  m_conversations;
+    mutable std::mutex  m_conversationMutex;
+    mutable std::condition_variable  m_conversationsCompiled;
+    bool  m_compiling = false;
+    StartupReport *  m_report = nullptr;
+
 } /*class GameContext*/;
@@ -18,6 +18,24 @@ public:
 
     sf::Vector2u getWindowDim() const;
 
+    //! Headless worlds never open a window nor render
+    bool isHeadless() const;
+    void setHeadless(bool headless);
+
+    //! Step used when the simulation is not paced by a window
+    sf::Time getFixedTimestep() const;
+
+    //! Bounds of the queue through which other threads post work to the world
+    std::size_t getPostQueueCapacity() const;
+
+    //! Time per frame the world may spend running posted work
+    sf::Time getPostBudget() const;
+
+    //! Bytes of off-screen textures cached layers may hold between them
+    std::size_t getLayerCacheBudget() const;
+
 private:
 
+    bool  m_headless = false;
+
 } /*class GameSettings*/;
@@ -1,10 +1,26 @@
 #pragma once
 #include "GameContext.h"
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <functional>
+#include <iostream>
+#include <memory>
 #include <vector>
 #include <array>
 #include "Component.h"
+#include "InlineFunction.h"
+#include "LayerCache.h"
+#include "CommandList.h"
+#include "DebugDraw.h"
+#include "MpscQueue.h"
+#include "RenderDevice.h"
+#include "SpatialGrid.h"
+#include "SpriteBatch.h"
+
+class DrawRecorder;
+class InputRecorder;
+class InputReplayer;
+class StartupReport;
 
 class GameWorld {
 
@@ -12,6 +28,24 @@ class GameWorld {
 
 public:
 
+    //! Work handed back to the thread which owns this world
+    using Task_t = InlineFunction<void(GameWorld&), 64>;
+
+    //! How many components the last `render` visited and skipped
+    struct CullStats {
+        std::size_t visible = 0;
+        std::size_t culled = 0;
+    } /*struct CullStats*/;
+
+    //! Throughput of a headless run
+    struct TickReport {
+        std::size_t ticks = 0;
+        sf::Time elapsed{};
+        sf::Time worstTick{};
+
+        double ticksPerSecond() const;
+    } /*struct TickReport*/;
+
     GameWorld(GameContext& context, GameSettings& settings);
 
     template <typename F>
@@ -20,18 +54,151 @@ public:
         m_callbacks[e].emplace_back(std::forward<F>(f));
     }
 
+    //! Constructs a component in-place; it lives as long as the world
+    template <typename C, typename... A>
+    C& emplace(A&&... args)
+    {
+        m_components.emplace_back(std::make_unique<C>(std::forward<A>(args)...));
+        refreshBounds(m_components.size() - 1);
+        return static_cast<C&>(*m_components.back());
+    }
+
+    //! Safe from any thread; returns false if the queue is full and `f` was dropped
+    template <typename F>
+    bool post(F&& f)
+    {
+        return m_posted.tryEmplace(std::forward<F>(f));
+    }
+
+    //! Runs posted tasks until none remain or `budget` has been spent
+    std::size_t drainPosted(sf::Time budget);
+
     void run();
 
+    //! Simulates `ticks` steps of `dt` seconds as fast as possible, never rendering
+    TickReport runTicks(std::size_t ticks, float dt);
+
+    //! Simulates steps of `dt` seconds as fast as possible until `duration` has passed
+    TickReport runFor(sf::Time duration, float dt);
+
+    //! A single simulation step: posted work, then `update`
+    void tick(float dt);
+
+    bool isHeadless() const;
+
+    //! Shared, read-only game data; many worlds may hold the same context
+    const GameContext& getContext() const;
+
+    //! Polls the window, or does nothing when headless
     void processInput();
 
+    //! Dispatches already-polled events, e.g. from a replayed log
+    void processInput(const std::vector<sf::Event>& events);
+
+    //! Updates every component, then refreshes its bounds in the culling grid;
+    //! transforms changed outside of an update are seen by the next one
     void update(float dt);
 
+    //! Renders to the window, or does nothing when headless
     void render(sf::RenderStates = {});
 
+    /**
+     * @brief   Records components which may be in `device`'s view, sorts the commands, then submits them in one pass.
+     *
+     *  Components record in the order they were drawn last frame, followed by
+     *  any which just came into view, so y-sorted scenes where only a few
+     *  sprites cross each other sort by a quick insertion pass; see
+     *  `CommandList::sort` and `getCommandStats` for what each frame cost.
+     *  `DebugDraw` shapes, this world's and those outside of any world, are
+     *  drawn last, on top.
+     */
+    void render(RenderDevice& device, sf::RenderStates = {});
+
+    //! Borrows commands recorded on another thread into the next `render`
+    void queueCommands(const CommandList& list);
+
+    //! Draw calls and vertices submitted by the last `render`
+    const SpriteBatch::Stats& getRenderStats() const;
+
+    //! Command count, arena use and sort time of the last `render`
+    const CommandList::Stats& getCommandStats() const;
+
+    const CullStats& getCullStats() const;
+
+    //! `DebugDraw` shapes from this world's updates and renders, see `DebugDraw::Scope`
+    const DebugDraw::Canvas& getDebugDraw() const;
+
+    //! Shared by this world's `CachedLayer`s, budgeted by `GameSettings`
+    LayerCache& getLayerCache();
+
+    //! Indices of the components whose bounds intersect `area`, plus every unbounded one
+    void queryVisible(const sf::FloatRect& area, std::vector<std::uint32_t>& out) const;
+
+    //! Every polled event and frame dt from `run` is written to `recorder`
+    void setRecorder(InputRecorder * recorder);
+
+    //! Every `render` writes its sorted commands to `recorder`; null stops capturing
+    void setDrawRecorder(DrawRecorder * recorder);
+
+    //! The first frame `run` renders, or the first tick of a headless run, is marked in `report`
+    void setStartupReport(StartupReport * report);
+
+    /**
+     * @brief   Feeds a recorded session through `processInput` and `update`.
+     *
+     * @param   log         The session to replay
+     * @param   realTime    When true, sleeps so frames are paced by their dt
+     * @param   report      Receives per-frame timing and state hashes
+     *
+     *  Nothing is rendered.  Work posted from other threads is not part of the
+     *  log, so worlds relying on it will not replay deterministically.
+     */
+    void replay(InputReplayer& log, bool realTime, std::ostream& report);
+
+    //! Hash of every component's simulation state, in order
+    std::uint64_t stateHash() const;
+
 private:
 
-    sf::RenderWindow  m_window;
+    //! Moves component `i` in the culling grid, or out of it once it reports no bounds
+    void refreshBounds(std::size_t i);
+
+    //! Fills `m_order` with the visible components, in last frame's draw order where known
+    void orderVisible();
+
+    //! Keeps the sorted commands' sources as the next frame's draw order
+    void rememberOrder();
+
+    //! Marks the startup report, once
+    void markFirstFrame();
+
+    const GameContext&  m_context;
+    std::unique_ptr<sf::RenderWindow>  m_window;
     std::array<std::vector<Callback_t>, sf::Event::EventType::Count>  m_callbacks;
+
+    //! Declared before the components, some of which release into it as they die
+    LayerCache  m_layerCache;
     std::vector<Component::Ptr> m_components;
+    MpscQueue<Task_t>  m_posted;
+    sf::Time  m_postBudget;
+    InputRecorder *  m_recorder = nullptr;
+    DrawRecorder *  m_drawRecorder = nullptr;
+    //! Cleared once the first frame is marked
+    StartupReport *  m_startupReport = nullptr;
+    CommandList  m_commands;
+    SpriteBatch  m_batch;
+    SpriteBatch::Stats  m_renderStats;
+    SpatialGrid  m_grid;
+    std::vector<std::uint32_t>  m_unbounded;
+    std::vector<std::uint32_t>  m_visible;
+    std::vector<std::uint32_t>  m_order;
+    std::vector<std::uint32_t>  m_drawOrder;
+    //! Per component, `m_orderEpoch` once visible, +1 once ordered, +2 once remembered
+    std::vector<std::uint32_t>  m_orderMark;
+    std::uint32_t  m_orderEpoch = 0;
+    CullStats  m_cullStats;
+    DebugDraw::Canvas  m_debugDraw;
+    //! Whether a `render` flushed `m_debugDraw` since the last `update`
+    bool  m_debugDrawn = true;
 
 } /*class GameWorld*/;
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+//! 64-bit FNV-1a over `len` bytes, chained through `seed`
+inline std::uint64_t fnv1a(const void * data, std::size_t len, std::uint64_t seed = 14695981039346656037ull)
+{
+    const unsigned char * p = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < len; ++i) {
+        seed = (seed ^ p[i]) * 1099511628211ull;
+    }
+    return seed;
+}
+
+
+/**
+ * @brief   Accumulates a stable hash of simulation state.
+ *
+ *  Values are hashed by their object representation, so floats are compared
+ *  bit-for-bit; this is exactly what is wanted when hunting for desyncs.
+ */
+class StateHasher {
+
+public:
+
+    StateHasher& bytes(const void * data, std::size_t len)
+    {
+        m_hash = fnv1a(data, len, m_hash);
+        return *this;
+    }
+
+    template<typename T>
+    StateHasher& operator<<(const T& v)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "hash the members instead");
+        return bytes(&v, sizeof(T));
+    }
+
+    std::uint64_t value() const
+    {
+        return m_hash;
+    }
+
+private:
+
+    std::uint64_t  m_hash = 14695981039346656037ull;
+
+} /*class StateHasher*/;
@@ -0,0 +1,112 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template<typename Sig, std::size_t Capacity = 48>
+class InlineFunction;
+
+
+/**
+ * @brief   A move-only variant of `std::function` which never allocates.
+ *
+ * @tparam  R(A...)     The call signature
+ * @tparam  Capacity    Bytes reserved in-place for the callable
+ *
+ *  The callable is stored inside of the `InlineFunction` itself, so handing one
+ *  across threads (e.g. through an `MpscQueue`) never touches the heap.
+ *  Storing a callable larger than `Capacity` is a compile-time error rather
+ *  than a silent fallback to an allocation.
+ */
+template<typename R, typename... A, std::size_t Capacity>
+class InlineFunction<R(A...), Capacity> {
+
+    struct Ops {
+        R (*invoke)(void*, A&&...);
+        void (*relocate)(void* dst, void* src);
+        void (*destroy)(void*);
+    } /*struct Ops*/;
+
+    template<typename F>
+    static const Ops * opsFor()
+    {
+        static const Ops ops{
+            [](void * f, A&&... args) -> R {
+                return (*static_cast<F*>(f))(std::forward<A>(args)...);
+            }
+          , [](void * dst, void * src) {
+                new (dst) F(std::move(*static_cast<F*>(src)));
+                static_cast<F*>(src)->~F();
+            }
+          , [](void * f) { static_cast<F*>(f)->~F(); }
+        };
+        return &ops;
+    }
+
+public:
+
+    //! Empty, calling it is undefined behavior
+    InlineFunction() = default;
+
+    template<typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, InlineFunction>::value>>
+    InlineFunction(F&& f)
+    {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= Capacity, "callable does not fit into InlineFunction");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "callable is over-aligned");
+        new (&m_storage) Fn(std::forward<F>(f));
+        m_ops = opsFor<Fn>();
+    }
+
+    InlineFunction(InlineFunction&& src) noexcept
+    {
+        *this = std::move(src);
+    }
+
+    InlineFunction& operator=(InlineFunction&& src) noexcept
+    {
+        if (this != &src) {
+            reset();
+            if (src.m_ops) {
+                src.m_ops->relocate(&m_storage, &src.m_storage);
+                m_ops = src.m_ops;
+                src.m_ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    //! Copying could duplicate captured resources; move instead
+    InlineFunction(const InlineFunction&) = delete;
+    InlineFunction& operator=(const InlineFunction&) = delete;
+
+    ~InlineFunction()
+    {
+        reset();
+    }
+
+    R operator()(A... args)
+    {
+        return m_ops->invoke(&m_storage, std::forward<A>(args)...);
+    }
+
+    explicit operator bool() const
+    {
+        return m_ops != nullptr;
+    }
+
+    void reset()
+    {
+        if (m_ops) {
+            m_ops->destroy(&m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+private:
+
+    std::aligned_storage_t<Capacity, alignof(std::max_align_t)>  m_storage;
+    const Ops *  m_ops = nullptr;
+
+} /*class InlineFunction*/;
@@ -0,0 +1,58 @@
+#pragma once
+#include <SFML/Window/Event.hpp>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief   Writes the polled event stream and per-frame dt as a binary log.
+ *
+ *  The log starts with an 8-byte magic and a version, followed by one record
+ *  per frame: the frame's dt as a raw float, the number of events polled, and
+ *  each event as a type byte plus only the fields that type uses.  Integers
+ *  are stored as LEB128 varints (zig-zagged when signed), so the common
+ *  mouse-move event costs a handful of bytes.
+ */
+class InputRecorder {
+
+public:
+
+    //! Writes the header immediately
+    explicit InputRecorder(std::ostream& dst);
+
+    //! Buffers `e` until the end of the current frame
+    void recordEvent(const sf::Event& e);
+
+    //! Flushes the buffered events along with the frame's `dt`
+    void endFrame(float dt);
+
+    std::size_t getFrameCount() const;
+
+private:
+
+    std::ostream&  m_dst;
+    std::string  m_frame;
+    std::size_t  m_pendingEvents = 0;
+    std::size_t  m_frames = 0;
+
+} /*class InputRecorder*/;
+
+
+//! Reads back logs written by `InputRecorder`, throwing on malformed input
+class InputReplayer {
+
+public:
+
+    //! Validates the header
+    explicit InputReplayer(std::istream& src);
+
+    //! Returns false once the log is exhausted
+    bool nextFrame(float& dt, std::vector<sf::Event>& events);
+
+private:
+
+    std::istream&  m_src;
+
+} /*class InputReplayer*/;
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief   A pull parser for JSON which never builds a document.
+ *
+ *  Each `next` returns one token, reading the stream through a fixed-size
+ *  buffer; only the current key, string or number is held.  A string too
+ *  large to hold, e.g. a base64 layer, can instead be consumed in pieces with
+ *  `streamString`.
+ *
+ *  Commas are treated as separators only, so the stray leading and trailing
+ *  commas our hand-written data has (see assets/SampleChat.json) are
+ *  accepted.  Anything else malformed throws `std::runtime_error`.
+ *
+ *  Strings, runs of whitespace and skipped values are scanned with SSE2 or
+ *  AVX2 when built for them.  `skipValue` never tokenizes what it skips: it
+ *  classifies 64 bytes at a time into bitmasks of quotes, backslashes and
+ *  brackets, masks out the brackets inside strings and counts the rest.
+ *
+ *  N.B.:  A skipped object or array is therefore only checked for balanced
+ *  brackets and closed strings; `{]` inside it is not an error.
+ */
+class JsonReader {
+
+public:
+
+    enum class Token {
+        BeginObject, EndObject, BeginArray, EndArray, Key, String, Number, True, False, Null, End
+    };
+
+    explicit JsonReader(std::istream& src, std::size_t bufferSize = 64 * 1024);
+
+    Token next();
+
+    //! The key or string just read, unescaped, or the text of the number just read
+    const std::string& getString() const;
+
+    double getNumber() const;
+
+    //! The number just read, which must be a non-negative integer
+    std::uint64_t getUnsigned() const;
+
+    //! After any value's first token, consumes the rest of that value; see the class notes
+    void skipValue(Token first);
+
+    //! Objects and arrays currently open
+    std::size_t getDepth() const;
+
+    /**
+     * @brief   Reads the next value, which must be a string, in pieces.
+     *
+     *  `sink(const char * data, std::size_t size)` is called with consecutive
+     *  unescaped pieces of at most about the buffer's size.  Returns false,
+     *  consuming nothing, when the next value is not a string.
+     */
+    template<typename F>
+    bool streamString(F&& sink)
+    {
+        if (!beginString()) {
+            return false;
+        }
+        for (bool more = true; more; ) {
+            more = readStringPiece();
+            sink(m_string.data(), m_string.size());
+        }
+        valueDone();
+        return true;
+    }
+
+private:
+
+    bool fill();
+    int peek();
+    int get();
+    void skipSeparators();
+    void readString();
+    void readNumber();
+    void readLiteral(const char * word);
+    void valueDone();
+
+    //! Consumes the opening quote of a string value, if that is what comes next
+    bool beginString();
+
+    //! Replaces `m_string` with the next piece; false once the closing quote was read
+    bool readStringPiece();
+
+    std::istream&  m_src;
+    std::vector<char>  m_buffer;
+    std::size_t  m_pos = 0;
+    std::size_t  m_end = 0;
+
+    std::string  m_string;
+    std::vector<char>  m_open;
+    bool  m_expectKey = false;
+
+} /*class JsonReader*/;
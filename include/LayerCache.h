@@ -0,0 +1,87 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+class CachedLayer;
+
+
+/**
+ * @brief   Owns the off-screen textures of every `CachedLayer`, within a budget.
+ *
+ *  Textures are kept in least-recently-used order.  Making room for a new one
+ *  evicts from the cold end, skipping any texture used since `beginFrame`,
+ *  as commands recorded this frame may still point at it; if only such
+ *  textures remain the budget is briefly exceeded rather than drawing garbage.
+ *  An evicted layer simply redraws itself the next time it is seen.
+ *
+ *  Textures come from a factory, by default one creating an `sf::RenderTexture`
+ *  on the current GL context, so the bookkeeping can run without one.
+ */
+class LayerCache {
+
+public:
+
+    struct Stats {
+        std::size_t hits = 0;
+        std::size_t redraws = 0;
+        std::size_t evictions = 0;
+        std::size_t bytes = 0;
+    } /*struct Stats*/;
+
+    //! Makes a texture of the given size, throwing if it can not
+    using TextureFactory = std::function<std::unique_ptr<sf::RenderTexture>(sf::Vector2u)>;
+
+    explicit LayerCache(std::size_t budgetBytes, TextureFactory factory = createTexture);
+
+    LayerCache(const LayerCache&) = delete;
+    LayerCache& operator=(const LayerCache&) = delete;
+
+    //! `owner`'s texture, marked as used this frame, or nullptr once evicted
+    sf::RenderTexture * find(const CachedLayer * owner);
+
+    //! A `size` texture for `owner`, evicting cold ones to stay within budget
+    sf::RenderTexture& acquire(const CachedLayer * owner, sf::Vector2u size);
+
+    //! Frees `owner`'s texture, if it still has one
+    void release(const CachedLayer * owner);
+
+    //! Starts a frame: textures used before now become evictable again
+    void beginFrame();
+
+    void countRedraw();
+
+    std::size_t getBudget() const;
+    void setBudget(std::size_t budgetBytes);
+
+    const Stats& getStats() const;
+
+    //! The default factory: a created `sf::RenderTexture`, which needs a GL context
+    static std::unique_ptr<sf::RenderTexture> createTexture(sf::Vector2u size);
+
+private:
+
+    struct Entry {
+        const CachedLayer *  owner;
+        std::unique_ptr<sf::RenderTexture>  texture;
+        std::size_t  bytes;
+        std::uint64_t  lastFrame;
+    } /*struct Entry*/;
+
+    //! Evicts cold entries until `incoming` more bytes fit, or nothing more may go
+    void makeRoom(std::size_t incoming);
+
+    std::size_t  m_budget;
+    TextureFactory  m_factory;
+    std::uint64_t  m_frame = 0;
+
+    //! Most recently used first
+    std::list<Entry>  m_lru;
+    std::unordered_map<const CachedLayer *, std::list<Entry>::iterator>  m_index;
+    Stats  m_stats;
+
+} /*class LayerCache*/;
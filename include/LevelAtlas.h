@@ -0,0 +1,30 @@
+#pragma once
+#include "LevelInstance.h"
+#include "LevelMap.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+
+//! Every loaded level, by name, each shared read-only by all of its instances
+class LevelAtlas {
+
+public:
+
+    //! Freezes `map` and publishes it under `map.name`, replacing any namesake
+    std::shared_ptr<const LevelMap> add(LevelMap map);
+
+    //! Returns nullptr for unknown names
+    std::shared_ptr<const LevelMap> find(const std::string& name) const;
+
+    //! A fresh, unedited instance; throws `std::out_of_range` for unknown names
+    LevelInstance instantiate(const std::string& name) const;
+
+    std::size_t size() const;
+
+private:
+
+    std::unordered_map<std::string, std::shared_ptr<const LevelMap>>  m_levels;
+
+} /*class LevelAtlas*/;
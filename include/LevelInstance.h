@@ -0,0 +1,71 @@
+#pragma once
+#include "LevelMap.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+
+/**
+ * @brief   One live copy of a level: a shared `LevelMap` plus sparse edits.
+ *
+ *  Reads fall through a per-instance overlay to the shared base map, and
+ *  writes only ever touch the overlay, so a hundred instances of the same
+ *  dungeon hold one copy of its tiles between them.  Memory per instance
+ *  grows with the number of edits, never with the size of the map; writing a
+ *  tile back to its original gid releases its overlay entry.
+ */
+class LevelInstance {
+
+public:
+
+    explicit LevelInstance(std::shared_ptr<const LevelMap> base);
+
+    const LevelMap& getBase() const;
+
+    //! Both throw `std::out_of_range` for a layer or cell outside the base map
+    std::uint32_t getTile(std::size_t layer, unsigned int x, unsigned int y) const;
+    void setTile(std::size_t layer, unsigned int x, unsigned int y, std::uint32_t gid);
+
+    //! Returns nullptr for unknown or removed objects
+    const LevelObject * findObject(std::uint32_t id) const;
+
+    //! Adds `obj`, or replaces the object sharing its id
+    void setObject(const LevelObject& obj);
+    void removeObject(std::uint32_t id);
+
+    //! Visits live objects: the base's, as edited, then those added here
+    template<typename F>
+    void forEachObject(F&& f) const
+    {
+        for (const auto& obj : m_base->objects) {
+            const LevelObject * live = findObject(obj.id);
+            if (live) { f(*live); }
+        }
+        for (const auto& entry : m_objectEdits) {
+            if (entry.second && !m_base->findObject(entry.first)) { f(*entry.second); }
+        }
+    }
+
+    //! Number of tiles and objects which differ from the base
+    std::size_t getEditCount() const;
+
+    //! Approximate heap footprint of this instance alone, excluding the base
+    std::size_t getMemoryUsage() const;
+
+    //! Drops every edit
+    void reset();
+
+private:
+
+    //! The base layer holding cell (`x`, `y`), checked
+    const TileLayer& layerAt(std::size_t layer, unsigned int x, unsigned int y) const;
+
+    static std::uint64_t tileKey(std::size_t layer, std::size_t index);
+
+    std::shared_ptr<const LevelMap>  m_base;
+    std::unordered_map<std::uint64_t, std::uint32_t>  m_tileEdits;
+    std::unordered_map<std::uint32_t, std::optional<LevelObject>>  m_objectEdits;
+
+} /*class LevelInstance*/;
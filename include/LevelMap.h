@@ -0,0 +1,114 @@
+#pragma once
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+//! Tiled stores flip flags in the top bits of every gid
+constexpr std::uint32_t GidFlipMask = 0xE0000000u;
+
+
+//! One tileset image and how its tiles are laid out
+struct Tileset {
+
+    std::uint32_t firstGid = 1;
+    std::string name;
+    std::string image;
+    sf::Vector2u tileSize{};
+    sf::Vector2u imageSize{};
+    std::uint32_t columns = 0;
+    std::uint32_t tileCount = 0;
+    std::uint32_t margin = 0;
+    std::uint32_t spacing = 0;
+
+    //! Pixel rect of `gid` inside of `image`
+    sf::IntRect getTextureRect(std::uint32_t gid) const;
+
+} /*struct Tileset*/;
+
+
+//! A placed object from an object layer
+struct LevelObject {
+
+    std::uint32_t id = 0;
+    std::string name;
+    std::string type;
+    sf::FloatRect bounds{};
+    std::uint32_t gid = 0;
+
+} /*struct LevelObject*/;
+
+
+/**
+ * @brief   A rectangular grid of gids.
+ *
+ *  The gids are held through a type-erased shared owner, so a layer can view
+ *  memory it did not allocate (e.g. a mapped file) just as cheaply as it can
+ *  own a vector.  Layers are immutable once built.
+ */
+class TileLayer {
+
+public:
+
+    TileLayer(std::string name, sf::Vector2u size, std::vector<std::uint32_t> gids);
+
+    //! Views `size.x * size.y` gids kept alive by `gids`
+    TileLayer(std::string name, sf::Vector2u size, std::shared_ptr<const std::uint32_t> gids);
+
+    const std::string& getName() const;
+    sf::Vector2u getSize() const;
+
+    std::uint32_t at(unsigned int x, unsigned int y) const
+    {
+        return m_gids.get()[static_cast<std::size_t>(y) * m_size.x + x];
+    }
+
+    const std::uint32_t * data() const
+    {
+        return m_gids.get();
+    }
+
+private:
+
+    std::string  m_name;
+    sf::Vector2u  m_size;
+    std::shared_ptr<const std::uint32_t>  m_gids;
+
+} /*class TileLayer*/;
+
+
+/**
+ * @brief   The immutable contents of one Tiled map.
+ *
+ *  Loaders fill a `LevelMap` in and then publish it as a
+ *  `std::shared_ptr<const LevelMap>`; from then on it is shared, never copied,
+ *  by every `LevelInstance` of the level.
+ */
+struct LevelMap {
+
+    std::string name;
+    sf::Vector2u size{};
+    sf::Vector2u tileSize{};
+    std::vector<TileLayer> layers;
+    std::vector<Tileset> tilesets;
+    std::vector<LevelObject> objects;
+    std::unordered_map<std::uint32_t, std::size_t> objectIndex;
+
+    //! Rebuilds `objectIndex`; loaders call this before publishing the map
+    void indexObjects();
+
+    //! Returns nullptr for unknown ids
+    const LevelObject * findObject(std::uint32_t id) const;
+
+    //! The tileset owning `gid`, or nullptr for the empty tile
+    const Tileset * findTileset(std::uint32_t gid) const;
+
+    //! Approximate heap footprint, shared views included
+    std::size_t getMemoryUsage() const;
+
+} /*struct LevelMap*/;
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief   A whole file, mapped read-only and private.
+ *
+ *  On targets without `mmap` the file is read into memory instead, so
+ *  callers may treat the bytes the same either way.  The bytes start on a
+ *  page boundary when mapped, and are at least 16-byte aligned otherwise.
+ */
+class MappedFile {
+
+public:
+
+    //! Throws `std::runtime_error` if `path` can not be opened or is empty
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char * data() const;
+    std::size_t size() const;
+
+private:
+
+    const unsigned char *  m_data = nullptr;
+    std::size_t  m_size = 0;
+    std::vector<unsigned char>  m_copy;
+
+} /*class MappedFile*/;
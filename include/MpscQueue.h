@@ -0,0 +1,132 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+/**
+ * @brief   A bounded, lock-free, multi-producer/single-consumer queue.
+ *
+ * @tparam  T   The type of the queued items
+ *
+ *  Each cell of the ring carries a sequence number which tells producers
+ *  whether the cell is free for the lap they are on, and tells the consumer
+ *  whether the cell has been published.  Producers race on a single tail
+ *  counter with a CAS; the consumer owns the head exclusively and never needs
+ *  an atomic read-modify-write.
+ *
+ *  Items are constructed in-place inside of the ring, so pushing never
+ *  allocates.  When the queue is full `tryEmplace` fails immediately instead
+ *  of blocking; it is up to the producer to retry or drop the item.
+ *
+ *  N.B.:  `tryPop` must only ever be called from one thread at a time.
+ */
+template<typename T>
+class MpscQueue {
+
+    static constexpr std::size_t CacheLine = 64;
+
+    struct Cell {
+        std::atomic<std::size_t>  seq;
+        std::aligned_storage_t<sizeof(T), alignof(T)>  storage;
+    } /*struct Cell*/;
+
+public:
+
+    //! `capacity` is rounded up to the next power of two
+    explicit MpscQueue(std::size_t capacity)
+      : m_mask{roundUpPow2(capacity < 2 ? 2 : capacity) - 1}
+      , m_cells{new Cell[m_mask + 1]}
+    {
+        for (std::size_t i = 0; i <= m_mask; ++i) {
+            m_cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpscQueue()
+    {
+        T discarded{};
+        while (tryPop(discarded)) { }
+    }
+
+    //! The queue is shared by reference between threads, it never moves
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue(MpscQueue&&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    MpscQueue& operator=(MpscQueue&&) = delete;
+
+    //! Safe from any thread; returns false when the queue is full
+    template<typename... A>
+    bool tryEmplace(A&&... args)
+    {
+        std::size_t pos = m_tail.load(std::memory_order_relaxed);
+        Cell * cell;
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            const std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+        new (&cell->storage) T(std::forward<A>(args)...);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPush(T&& value)
+    {
+        return tryEmplace(std::move(value));
+    }
+
+    //! Consumer thread only; returns false when nothing has been published
+    bool tryPop(T& out)
+    {
+        Cell& cell = m_cells[m_head & m_mask];
+        if (cell.seq.load(std::memory_order_acquire) != m_head + 1) {
+            return false;
+        }
+        T * item = reinterpret_cast<T*>(&cell.storage);
+        out = std::move(*item);
+        item->~T();
+        cell.seq.store(m_head + m_mask + 1, std::memory_order_release);
+        ++m_head;
+        return true;
+    }
+
+    std::size_t capacity() const
+    {
+        return m_mask + 1;
+    }
+
+    //! Consumer thread only; approximate while producers are active
+    std::size_t size() const
+    {
+        return m_tail.load(std::memory_order_relaxed) - m_head;
+    }
+
+private:
+
+    static std::size_t roundUpPow2(std::size_t n)
+    {
+        std::size_t p = 1;
+        while (p < n) { p <<= 1; }
+        return p;
+    }
+
+    const std::size_t  m_mask;
+    std::unique_ptr<Cell[]>  m_cells;
+    alignas(CacheLine) std::atomic<std::size_t>  m_tail{0};
+    alignas(CacheLine) std::size_t  m_head = 0;
+
+} /*class MpscQueue*/;
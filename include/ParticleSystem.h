@@ -0,0 +1,91 @@
+#pragma once
+#include "Component.h"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class WorkerPool;
+
+
+/**
+ * @brief   Many short-lived quads simulated as arrays rather than components.
+ *
+ *  Particle state lives in parallel arrays (structure of arrays), so that
+ *  integration is a handful of straight-line SIMD loops: AVX2 or SSE2,
+ *  whichever the running CPU supports, scalar otherwise.  Each update then
+ *  writes two triangles per live particle straight into a single vertex
+ *  array, which is drawn or recorded as one command.
+ *
+ *  A system touches nothing but itself, so whole systems may be updated on
+ *  worker threads; `update(dt, pool)` also splits one large system across a
+ *  pool.  Neither may overlap with `emit` or drawing the same system.
+ */
+class ParticleSystem : public Component {
+
+public:
+
+    //! How new particles are spawned
+    struct Emitter {
+        sf::Vector2f position{};
+        sf::Vector2f velocity{};
+        //! Each velocity component varies uniformly by up to this much either way
+        sf::Vector2f spread{};
+        float minLife = 1.f;
+        float maxLife = 1.f;
+        float size = 4.f;
+        sf::Color color = sf::Color::White;
+    } /*struct Emitter*/;
+
+    explicit ParticleSystem(std::size_t capacity);
+
+    void setGravity(sf::Vector2f gravity);
+
+    //! Every particle samples all of `rect` from `texture`; nullptr draws flat quads
+    void setTexture(const sf::Texture * texture, const sf::IntRect& rect = {});
+
+    //! Spawns up to `count` particles and returns how many fit
+    std::size_t emit(const Emitter& emitter, std::size_t count);
+
+    void update(float dt) override;
+
+    //! As `update`, but splitting the particles across `pool`'s threads
+    void update(float dt, WorkerPool& pool);
+
+    std::size_t size() const;
+    std::size_t capacity() const;
+
+    //! The integration kernel picked for this CPU: "AVX2", "SSE2" or "scalar"
+    static const char * getSimdPath();
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void record(CommandList& list, sf::RenderStates states) const override;
+
+private:
+
+    //! Integrates particles [begin, end)
+    void simulate(std::size_t begin, std::size_t end, float dt);
+
+    //! Drops expired particles, moving the last live ones into their slots
+    void compact();
+
+    //! Writes two triangles for each of particles [begin, end)
+    void writeVertices(std::size_t begin, std::size_t end);
+
+    //! Fits the vertex array to the live particles, filling in new texture coordinates
+    void resizeVertices();
+
+    float random();
+
+    std::size_t  m_capacity;
+    std::size_t  m_count = 0;
+    std::vector<float>  m_x, m_y, m_vx, m_vy, m_age, m_life, m_invLife, m_size;
+    std::vector<sf::Color>  m_color;
+    std::vector<sf::Vertex>  m_vertices;
+    sf::Vector2f  m_gravity{};
+    const sf::Texture *  m_texture = nullptr;
+    sf::IntRect  m_textureRect{};
+    bool  m_texCoordsValid = false;
+    std::uint32_t  m_seed = 0x9E3779B9u;
+
+} /*class ParticleSystem*/;
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * @brief   A collision-free map from a fixed set of 64-bit key hashes to slots.
+ *
+ *  Built once by hash and displace: keys are spread over buckets of about
+ *  four, and each bucket, largest first, searches for a seed which sends all
+ *  of its keys to free slots.  A lookup is then one seed load and seven
+ *  multiplies, whatever the key: two for each of two mixes, one for the seed
+ *  and one for each of two range reductions.  Slots number about 1.1 per key.
+ *
+ *  Every key of the set gets its own slot; any other hash gets some slot
+ *  too, so callers store their keys by slot and compare on lookup.
+ */
+class PerfectHash {
+
+public:
+
+    //! An empty set; every lookup lands in slot 0 of none
+    PerfectHash();
+
+    //! Throws `std::invalid_argument` if two of `hashes` are equal
+    explicit PerfectHash(const std::vector<std::uint64_t>& hashes);
+
+    std::size_t getSlotCount() const
+    {
+        return m_slots;
+    }
+
+    //! Only meaningful when there is at least one slot
+    std::size_t slot(std::uint64_t hash) const
+    {
+        // Buckets are chosen from mixed bits, so weak hashes still spread evenly
+        hash = mix(hash);
+        const std::uint32_t seed = m_seeds[reduce(hash, m_seeds.size())];
+        return reduce(mix(hash ^ (seed * 0x9E3779B97F4A7C15ull)), m_slots);
+    }
+
+    //! Spreads the bits of a 64-bit value; splitmix64's finalizer
+    static std::uint64_t mix(std::uint64_t x)
+    {
+        x ^= x >> 30, x *= 0xBF58476D1CE4E5B9ull;
+        x ^= x >> 27, x *= 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+private:
+
+    //! Maps the top 32 bits of `hash` onto [0, n) without a division
+    static std::size_t reduce(std::uint64_t hash, std::size_t n)
+    {
+        return static_cast<std::size_t>(((hash >> 32) * static_cast<std::uint64_t>(n)) >> 32);
+    }
+
+    std::vector<std::uint32_t>  m_seeds;
+    std::size_t  m_slots = 0;
+
+} /*class PerfectHash*/;
@@ -0,0 +1,33 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+
+
+//! An axis-aligned quad before its transform, with the texture rectangle it shows
+struct LocalQuad {
+    sf::FloatRect rect;
+    //! Negative sizes flip the texture, as with `sf::Sprite`
+    sf::FloatRect texRect;
+    sf::Color color;
+} /*struct LocalQuad*/;
+
+//! The quad an `sf::Sprite` draws, before its own transform
+LocalQuad localQuad(const sf::Sprite& sprite);
+
+//! How `transformQuads` lays out each quad's vertices
+enum class QuadLayout {
+    //! 4 vertices, clockwise from the top-left, for `sf::Quads`
+    Quads,
+    //! 6 vertices, (0, 1, 2) and (0, 2, 3) of the above, for `sf::Triangles`
+    Triangles
+};
+
+/**
+ * @brief   Places `count` quads by their transforms, writing vertices in bulk.
+ *
+ *  Corner positions are computed four at a time with SSE2, or two quads at
+ *  a time with AVX2, when the build targets them, and scalar otherwise,
+ *  with the same arithmetic as `sf::Transform::transformPoint`.  `out`
+ *  receives 4 or 6 vertices per quad depending on `layout`.
+ */
+void transformQuads(const sf::Transform * transforms, const LocalQuad * quads, std::size_t count, sf::Vertex * out, QuadLayout layout = QuadLayout::Quads);
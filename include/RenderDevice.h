@@ -0,0 +1,71 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+
+
+/**
+ * @brief   Where submitted draws go: the engine's one drawing interface.
+ *
+ *  `CommandList` and `SpriteBatch` submit through a device rather than an
+ *  `sf::RenderTarget`, so that the same render path can feed the GPU, a CPU
+ *  rasterizer, or a recorder, none of which the recording code can tell
+ *  apart.
+ */
+class RenderDevice {
+
+public:
+
+    virtual ~RenderDevice() = default;
+
+    virtual void draw(const sf::Vertex * vertices, std::size_t count, sf::PrimitiveType primitive, const sf::RenderStates& states) = 0;
+
+    //! Opaque SFML drawables; devices which can not draw them count them, skip them and return false
+    virtual bool draw(const sf::Drawable& drawable, const sf::RenderStates& states) = 0;
+
+    //! The view that culling and placement work against
+    virtual const sf::View& getView() const = 0;
+
+    virtual sf::Vector2u getSize() const = 0;
+
+} /*class RenderDevice*/;
+
+
+//! Forwards to an `sf::RenderTarget`, i.e. to the GPU
+class RenderTargetDevice : public RenderDevice {
+
+public:
+
+    explicit RenderTargetDevice(sf::RenderTarget& target);
+
+    void draw(const sf::Vertex * vertices, std::size_t count, sf::PrimitiveType primitive, const sf::RenderStates& states) override;
+    bool draw(const sf::Drawable& drawable, const sf::RenderStates& states) override;
+    const sf::View& getView() const override;
+    sf::Vector2u getSize() const override;
+
+private:
+
+    sf::RenderTarget&  m_target;
+
+} /*class RenderTargetDevice*/;
+
+
+//! Discards every draw, leaving only the CPU cost of recording and submitting
+class NullRenderDevice : public RenderDevice {
+
+public:
+
+    explicit NullRenderDevice(sf::Vector2u size);
+
+    void draw(const sf::Vertex * vertices, std::size_t count, sf::PrimitiveType primitive, const sf::RenderStates& states) override;
+    bool draw(const sf::Drawable& drawable, const sf::RenderStates& states) override;
+    const sf::View& getView() const override;
+    sf::Vector2u getSize() const override;
+
+    void setView(const sf::View& view);
+
+private:
+
+    sf::Vector2u  m_size;
+    sf::View  m_view;
+
+} /*class NullRenderDevice*/;
@@ -0,0 +1,45 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+
+/**
+ * @brief   Packs rectangles into a fixed-size bin, bottom-left first.
+ *
+ *  The bin's free space is tracked as a skyline: a left-to-right run of
+ *  segments, each the height already filled above it.  A rectangle goes where
+ *  its top edge ends up lowest, ties going to the narrowest segment, so the
+ *  skyline stays flat and little space is wasted under overhangs.
+ */
+class SkylinePacker {
+
+public:
+
+    explicit SkylinePacker(sf::Vector2u size);
+
+    //! Top-left corner given to a `size` rectangle, or nothing when it does not fit
+    std::optional<sf::Vector2u> insert(sf::Vector2u size);
+
+    sf::Vector2u getSize() const;
+
+    //! Fraction of the bin covered by inserted rectangles
+    float getOccupancy() const;
+
+private:
+
+    struct Segment {
+        unsigned int x;
+        unsigned int y;
+        unsigned int width;
+    } /*struct Segment*/;
+
+    //! Lowest y a `size` rectangle can rest at starting from segment `i`
+    bool fits(std::size_t i, sf::Vector2u size, unsigned int& y) const;
+
+    sf::Vector2u  m_size;
+    std::vector<Segment>  m_skyline;
+    std::size_t  m_used = 0;
+
+} /*class SkylinePacker*/;
@@ -0,0 +1,76 @@
+#pragma once
+#include "RenderDevice.h"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * @brief   Rasterizes on the CPU into an in-memory RGBA framebuffer.
+ *
+ *  Needs no GPU and no window, so headless machines can run the real render
+ *  path for benchmarks and golden-image tests.  Triangles (and quads, strips
+ *  and fans) are filled with a top-left rule so shared edges are drawn once,
+ *  textured by nearest-texel lookup and blended with the full `sf::BlendMode`
+ *  equation; lines and points are one pixel wide.  Shaders are ignored.
+ *
+ *  A GPU texture's pixels can not be read back without a context, so each
+ *  texture is given its pixels with `setTextureImage`; until then it samples
+ *  as opaque white.  Opaque `sf::Drawable`s are counted and skipped.
+ */
+class SoftwareRenderDevice : public RenderDevice {
+
+public:
+
+    struct Stats {
+        std::size_t draws = 0;
+        std::size_t skippedDrawables = 0;
+        std::size_t triangles = 0;
+        std::size_t lines = 0;
+        std::size_t pixels = 0;
+    } /*struct Stats*/;
+
+    explicit SoftwareRenderDevice(sf::Vector2u size);
+
+    void setTextureImage(const sf::Texture& texture, const sf::Image& image);
+    void setView(const sf::View& view);
+    void clear(sf::Color color = sf::Color::Black);
+
+    void draw(const sf::Vertex * vertices, std::size_t count, sf::PrimitiveType primitive, const sf::RenderStates& states) override;
+    bool draw(const sf::Drawable& drawable, const sf::RenderStates& states) override;
+    const sf::View& getView() const override;
+    sf::Vector2u getSize() const override;
+
+    sf::Color getPixel(unsigned int x, unsigned int y) const;
+    sf::Image copyToImage() const;
+
+    //! FNV-1a of the framebuffer, for golden-image tests
+    std::uint64_t checksum() const;
+
+    const Stats& getStats() const;
+    void resetStats();
+
+private:
+
+    //! A vertex in framebuffer pixels
+    struct Point {
+        float x, y;
+        float r, g, b, a;
+        float u, v;
+    } /*struct Point*/;
+
+    Point project(const sf::Vertex& vertex, const sf::Transform& transform) const;
+
+    void triangle(Point a, Point b, Point c, const sf::Image * texture, const sf::BlendMode& blend);
+    void line(const Point& a, const Point& b, const sf::BlendMode& blend);
+    void plot(int x, int y, float r, float g, float b, float a, const sf::BlendMode& blend);
+
+    std::vector<std::uint8_t>  m_pixels;
+    sf::Vector2u  m_size;
+    sf::View  m_view;
+    std::unordered_map<const sf::Texture *, sf::Image>  m_textures;
+    Stats  m_stats;
+
+} /*class SoftwareRenderDevice*/;
@@ -0,0 +1,73 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+
+//! World-space rect seen through `view`, widened to cover any rotation
+sf::FloatRect viewBounds(const sf::View& view);
+
+
+/**
+ * @brief   A sparse uniform grid of bounding rects, for visibility queries.
+ *
+ *  Ids are small dense integers (e.g. component indices).  Each id is linked
+ *  into every cell its rect touches; moving an id only relinks it when the set
+ *  of cells changes, so per-frame maintenance of mostly static or slowly
+ *  moving objects is a compare and a store.  Only occupied cells are stored,
+ *  so the grid does not care how large the world is.
+ */
+class SpatialGrid {
+
+public:
+
+    using Id = std::uint32_t;
+
+    explicit SpatialGrid(float cellSize = 256.f);
+
+    //! Places or moves `id`
+    void update(Id id, const sf::FloatRect& bounds);
+
+    //! Forgets `id`; unknown ids are ignored
+    void remove(Id id);
+
+    bool contains(Id id) const;
+
+    //! Appends every id whose rect intersects `area`, once each, in ascending order
+    void query(const sf::FloatRect& area, std::vector<Id>& out) const;
+
+    //! Number of ids in the grid
+    std::size_t size() const;
+
+private:
+
+    struct Entry {
+        sf::FloatRect bounds{};
+        sf::IntRect cells{};
+        bool live = false;
+        mutable std::uint32_t stamp = 0;
+    } /*struct Entry*/;
+
+    //! Cells touched by `bounds`, as an inclusive-exclusive rect of cell coordinates
+    sf::IntRect cellsOf(const sf::FloatRect& bounds) const;
+
+    static std::uint64_t cellKey(int x, int y);
+
+    void link(Id id, const sf::IntRect& cells);
+    void unlink(Id id, const sf::IntRect& cells);
+
+    //! Calls `visit` for every id linked into the cell at `key`
+    template<typename F>
+    void visitCell(std::uint64_t key, F&& visit) const;
+
+    float  m_cellSize;
+    std::vector<Entry>  m_entries;
+    std::unordered_map<std::uint64_t, std::vector<Id>>  m_cells;
+    std::size_t  m_live = 0;
+
+    //! Marks ids already reported by the query in progress
+    mutable std::uint32_t  m_stamp = 0;
+
+} /*class SpatialGrid*/;
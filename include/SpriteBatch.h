@@ -0,0 +1,66 @@
+#pragma once
+#include "QuadTransform.h"
+#include "RenderDevice.h"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+
+//! Corners of `sprite` placed by `transform`, clockwise from its top-left
+void spriteQuad(const sf::Sprite& sprite, const sf::Transform& transform, sf::Vertex (&quad)[4]);
+
+
+/**
+ * @brief   Collapses many sprite draws into one draw per texture and blend mode.
+ *
+ *  Quads are transformed on the CPU as they are added and appended to one
+ *  `sf::VertexArray` per (texture, blend mode) pair, so `flush` issues a single
+ *  draw call for each pair no matter how many sprites share it.
+ *
+ *  N.B.:  Within one flush, quads are grouped by texture; two overlapping
+ *  sprites with different textures may therefore draw out of submission order.
+ *  Flush between anything which must stay strictly ordered.
+ */
+class SpriteBatch {
+
+public:
+
+    //! Counters accumulated since the last `resetStats`
+    struct Stats {
+        std::size_t drawCalls = 0;
+        std::size_t vertices = 0;
+        std::size_t quads = 0;
+    } /*struct Stats*/;
+
+    //! Appends `sprite`, placed by `states.transform`; ignores `states.shader`
+    void add(const sf::Sprite& sprite, const sf::RenderStates& states);
+
+    //! Appends a world-space quad given clockwise from its top-left corner
+    void addQuad(const sf::Texture * texture, const sf::BlendMode& blend, const sf::Vertex (&quad)[4]);
+
+    //! Draws and empties every batch; `states.texture` and blend are overridden
+    void flush(RenderDevice& device, sf::RenderStates states = {});
+
+    //! Accounts for a draw which bypassed the batch
+    void countDraw(std::size_t vertices);
+
+    const Stats& getStats() const;
+    void resetStats();
+
+private:
+
+    struct Batch {
+        const sf::Texture *  texture;
+        sf::BlendMode  blend;
+        sf::VertexArray  vertices{sf::Triangles};
+    } /*struct Batch*/;
+
+    Batch& batchFor(const sf::Texture * texture, const sf::BlendMode& blend);
+
+    //! Arrays are kept between flushes so their storage is reused
+    std::vector<Batch>  m_batches;
+    std::size_t  m_live = 0;
+    std::size_t  m_last = 0;
+    Stats  m_stats;
+
+} /*class SpriteBatch*/;
@@ -0,0 +1,26 @@
+#pragma once
+#include "Component.h"
+#include <SFML/Graphics.hpp>
+
+//! A textured quad which records itself as a batchable quad command
+class SpriteComp : public Component {
+
+public:
+
+    SpriteComp() = default;
+    explicit SpriteComp(const sf::Texture& texture);
+    SpriteComp(const sf::Texture& texture, const sf::IntRect& rect);
+
+    sf::Sprite& getSprite();
+    const sf::Sprite& getSprite() const;
+
+    std::optional<sf::FloatRect> getLocalBounds() const override;
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void record(CommandList& list, sf::RenderStates states) const override;
+
+private:
+
+    sf::Sprite  m_sprite;
+
+} /*class SpriteComp*/;
@@ -0,0 +1,53 @@
+#pragma once
+#include <SFML/System.hpp>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief   Where startup time went, per phase and per file.
+ *
+ *  Every entry records when it began relative to the report's creation, so
+ *  entries from different threads show how far loading overlapped.  Safe to
+ *  add to from any thread.
+ */
+class StartupReport {
+
+public:
+
+    struct Entry {
+        std::string phase;
+        //! Empty for entries that cover a whole phase
+        std::string file;
+        std::size_t bytes = 0;
+        sf::Time start{};
+        sf::Time elapsed{};
+    } /*struct Entry*/;
+
+    //! Time since the report was created; pass as an entry's `start`
+    sf::Time now() const;
+
+    void add(Entry entry);
+
+    //! Marks the first frame; the report's headline is the time until then
+    void firstFrame();
+
+    std::vector<Entry> getEntries() const;
+
+    //! `Zero` until `firstFrame`
+    sf::Time getTimeToFirstFrame() const;
+
+    //! A table of every entry, in order of their start
+    void print(std::ostream& dst) const;
+
+private:
+
+    sf::Clock  m_clock;
+    mutable std::mutex  m_mutex;
+    std::vector<Entry>  m_entries;
+    sf::Time  m_firstFrame{};
+
+} /*class StartupReport*/;
@@ -0,0 +1,101 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+//! A laid out, word-wrapped line of text, ready to be drawn as triangles
+struct GlyphRun {
+
+    //! Six per visible glyph, in reading order
+    std::vector<sf::Vertex> vertices;
+
+    //! `revealed[i]`: vertices covering the first `i + 1` characters
+    std::vector<std::uint32_t> revealed;
+
+    sf::FloatRect bounds{};
+    const sf::Texture * texture = nullptr;
+    std::size_t lines = 0;
+
+    //! How many vertices to draw to show only the first `characters` characters
+    std::size_t vertexCount(std::size_t characters) const;
+
+    std::size_t getMemoryUsage() const;
+
+} /*struct GlyphRun*/;
+
+
+/**
+ * @brief   Shapes `utf8` with `font` as `sf::Text` would, wrapping at `wrapWidth`.
+ *
+ *  Lines break at spaces where possible and mid-word only for words wider
+ *  than a whole line; a `wrapWidth` of zero never wraps.  Kerning applies.
+ */
+GlyphRun layoutText(const std::string& utf8, const sf::Font& font, unsigned int size, float wrapWidth, sf::Color color = sf::Color::White);
+
+
+/**
+ * @brief   Lays each distinct text out once and hands out the shared result.
+ *
+ *  Runs are keyed by string, font, size, wrap width and color, and kept in
+ *  least-recently-used order within a byte budget.  Handed-out runs are
+ *  shared, so an evicted run stays valid for as long as anyone draws it.
+ *  Not thread-safe; give each world its own cache.
+ */
+class TextLayoutCache {
+
+public:
+
+    struct Stats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t evictions = 0;
+        std::size_t bytes = 0;
+        std::size_t runs = 0;
+
+        double hitRate() const;
+    } /*struct Stats*/;
+
+    explicit TextLayoutCache(std::size_t budgetBytes = 4 * 1024 * 1024);
+
+    std::shared_ptr<const GlyphRun> get(const std::string& utf8, const sf::Font& font, unsigned int size, float wrapWidth, sf::Color color = sf::Color::White);
+
+    void clear();
+
+    const Stats& getStats() const;
+
+private:
+
+    struct Key {
+        std::string text;
+        const sf::Font * font;
+        unsigned int size;
+        float wrapWidth;
+        sf::Uint32 color;
+
+        bool operator==(const Key& other) const;
+    } /*struct Key*/;
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const;
+    } /*struct KeyHash*/;
+
+    struct Entry {
+        const Key *  key;
+        std::shared_ptr<const GlyphRun>  run;
+        std::size_t  bytes;
+    } /*struct Entry*/;
+
+    std::size_t  m_budget;
+
+    //! Most recently used first
+    std::list<Entry>  m_lru;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash>  m_index;
+    Stats  m_stats;
+
+} /*class TextLayoutCache*/;
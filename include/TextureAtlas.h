@@ -0,0 +1,89 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+//! One image to pack: either a file, read lazily, or pixels already in memory
+struct AtlasSource {
+
+    std::string name;
+
+    //! When set, the file's path, size and modification time key the cache; it is only read to pack
+    std::string path;
+    sf::Image image;
+
+} /*struct AtlasSource*/;
+
+
+struct AtlasOptions {
+
+    sf::Vector2u pageSize{2048, 2048};
+
+    //! Transparent pixels right of and below every region, against filtering bleed
+    unsigned int padding = 1;
+
+} /*struct AtlasOptions*/;
+
+
+/**
+ * @brief   Many source images packed into a few large pages.
+ *
+ *  Packing is a skyline pass over the sources, tallest first, opening a new
+ *  page whenever nothing left fits.  Each source keeps its pixels verbatim in
+ *  its region, so a packed tileset sheet remaps with a single offset.
+ *
+ *  `loadOrPack` keys the result by a hash of every input and the options; a
+ *  cache hit reads raw pages straight into memory with no decoding and no
+ *  packing, so the same call serves both as a build step and at startup.
+ *
+ *  N.B.:  Image files are keyed by their stamp, not their bytes, so merely
+ *  touching one repacks, and an edit which keeps both size and modification
+ *  time is not noticed.
+ */
+class TextureAtlas {
+
+public:
+
+    //! Where a source ended up: a page, its pixel rect there, and that rect normalized
+    struct Region {
+        std::uint32_t page = 0;
+        sf::IntRect rect{};
+        sf::FloatRect uv{};
+    } /*struct Region*/;
+
+    //! Hash of the sources, in order, and of `options`; reads no image file
+    static std::uint64_t cacheKey(const std::vector<AtlasSource>& sources, const AtlasOptions& options);
+
+    //! Throws if a source can not be read, is larger than a page or shares another's name
+    static TextureAtlas pack(const std::vector<AtlasSource>& sources, const AtlasOptions& options = {});
+
+    //! Reads `cacheDir`'s atlas for these inputs, packing and writing it on a miss
+    static TextureAtlas loadOrPack(const std::string& cacheDir, const std::vector<AtlasSource>& sources, const AtlasOptions& options = {});
+
+    void save(std::ostream& dst) const;
+
+    //! Throws std::runtime_error on malformed input
+    static TextureAtlas load(std::istream& src);
+
+    //! Returns nullptr for unknown names
+    const Region * find(const std::string& name) const;
+
+    //! `local`, a rect inside of source `name`, as a rect of its page
+    sf::IntRect remap(const std::string& name, const sf::IntRect& local) const;
+
+    const std::vector<sf::Image>& getPages() const;
+    const std::unordered_map<std::string, Region>& getRegions() const;
+    std::uint64_t getKey() const;
+
+private:
+
+    std::uint64_t  m_key = 0;
+    std::vector<sf::Image>  m_pages;
+    std::unordered_map<std::string, Region>  m_regions;
+
+} /*class TextureAtlas*/;
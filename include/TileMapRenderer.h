@@ -0,0 +1,80 @@
+#pragma once
+#include "Component.h"
+#include "LevelInstance.h"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * @brief   Draws a `LevelInstance`'s tile layers as fixed-size chunks.
+ *
+ *  Each chunk holds one triangle mesh per tileset with every layer's tiles of
+ *  that tileset merged into it, so a visible chunk costs one draw per tileset
+ *  it uses.  Meshes are built lazily the first time their chunk is seen and
+ *  rebuilt only after a tile inside of them changes; only chunks overlapping
+ *  the view are visited, so per-frame cost follows the view, not the map.
+ *
+ *  N.B.:  Merging layers means that within one chunk, tiles of a later tileset
+ *  always draw over those of an earlier one, whatever their layer order.
+ */
+class TileMapRenderer : public Component {
+
+public:
+
+    static constexpr unsigned int ChunkTiles = 32;
+
+    //! Chunk work done by the last `draw` or `record`
+    struct Stats {
+        std::size_t visibleChunks = 0;
+        std::size_t rebuiltChunks = 0;
+        std::size_t meshes = 0;
+    } /*struct Stats*/;
+
+    //! `level` must outlive the renderer
+    explicit TileMapRenderer(LevelInstance& level);
+
+    //! Tiles of tileset `index` sample from `texture`; tilesets without one draw untextured
+    void setTexture(std::size_t index, const sf::Texture& texture);
+
+    //! Edits the level and marks the owning chunk for rebuild
+    void setTile(std::size_t layer, unsigned int x, unsigned int y, std::uint32_t gid);
+
+    //! Marks the chunk owning tile (x, y) for rebuild after an edit made elsewhere;
+    //! throws `std::out_of_range` outside of the map
+    void invalidate(unsigned int x, unsigned int y);
+    void invalidateAll();
+
+    //! Both cull against the view they will be drawn through: the target's, or the list's
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void record(CommandList& list, sf::RenderStates states) const override;
+
+    sf::Vector2u getChunkCount() const;
+    const Stats& getStats() const;
+
+private:
+
+    struct Chunk {
+        std::vector<std::vector<sf::Vertex>>  meshes;
+        bool  dirty = true;
+    } /*struct Chunk*/;
+
+    //! Chunks overlapping `view` once placed by `transform`, as [first, last)
+    sf::IntRect visibleChunks(const sf::View& view, const sf::Transform& transform) const;
+
+    template<typename F>
+    void forEachVisibleMesh(const sf::View& view, const sf::Transform& transform, F&& f) const;
+
+    void rebuild(std::size_t cx, std::size_t cy, Chunk& chunk) const;
+    void appendTile(Chunk& chunk, unsigned int x, unsigned int y, std::uint32_t gid) const;
+
+    LevelInstance&  m_level;
+    std::vector<const sf::Texture *>  m_textures;
+    sf::Vector2u  m_chunkCount;
+
+    //! Built on demand by the const draw paths
+    mutable std::vector<Chunk>  m_chunks;
+    mutable Stats  m_stats;
+
+} /*class TileMapRenderer*/;
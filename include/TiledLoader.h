@@ -0,0 +1,30 @@
+#pragma once
+#include "LevelMap.h"
+#include <iostream>
+#include <string>
+
+
+/**
+ * @brief   Streams a Tiled map straight into a `LevelMap`.
+ *
+ *  Both readers are built on pull parsers (`XmlReader`, `JsonReader`) and
+ *  decode layer data as it streams past, so the only large allocation is each
+ *  layer's final gid array; decoding stops as soon as a layer holds more gids
+ *  than its declared size, so compressed data can not inflate past it.  Layer data may be CSV, base64, or base64 of
+ *  zlib- or gzip-compressed little-endian gids; TMX's legacy `<tile>`
+ *  elements and JSON's plain arrays are read too.  Tilesets, object layers
+ *  and groups of layers are kept; everything else is skipped.
+ *
+ *  The map is called `name` unless it has a custom string property called
+ *  "name".  Infinite maps, zstd compression and malformed input throw
+ *  `std::runtime_error`.  External tilesets are recorded by their first gid
+ *  and source path only.
+ */
+LevelMap readTmx(std::istream& src, const std::string& name);
+LevelMap readTiledJson(std::istream& src, const std::string& name);
+
+//! TMX or JSON, told apart by the first non-blank character
+LevelMap readTiledMap(std::istream& src, const std::string& name);
+
+//! Reads the map file at `path`, named after the file less its extension
+LevelMap readTiledFile(const std::string& path);
@@ -0,0 +1,110 @@
+#pragma once
+#include "InlineFunction.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief   A fixed set of threads draining one shared FIFO of jobs.
+ *
+ *  Jobs are `InlineFunction`s, so submitting one never allocates beyond the
+ *  queue's own storage.  Destroying the pool finishes every queued job before
+ *  joining its threads.
+ *
+ *  Jobs should catch their own exceptions.  One which throws on a pool thread
+ *  terminates the program, as any thread would; one run by `wait` propagates
+ *  to that waiter, whoever submitted it, with the job counted as done.
+ */
+class WorkerPool {
+
+public:
+
+    using Job_t = InlineFunction<void(), 64>;
+
+    //! Counts one caller's outstanding jobs, see `submit(Latch&, F&&)` and `wait`
+    class Latch {
+
+    public:
+
+        Latch() = default;
+        Latch(const Latch&) = delete;
+        Latch& operator=(const Latch&) = delete;
+
+    private:
+
+        friend class WorkerPool;
+
+        //! Guarded by the pool's mutex
+        std::size_t  m_pending = 0;
+
+    } /*class Latch*/;
+
+    //! Zero threads means one per hardware thread
+    explicit WorkerPool(std::size_t threads = 0);
+    ~WorkerPool();
+
+    //! Threads are bound to `this`, the pool never moves
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+
+    //! Safe from any thread, including from inside of a job
+    template<typename F>
+    void submit(F&& f)
+    {
+        push(Job_t{std::forward<F>(f)});
+    }
+
+    //! As `submit`, counting the job against `latch` until it has run
+    template<typename F>
+    void submit(Latch& latch, F&& f)
+    {
+        push(Job_t{std::forward<F>(f)}, &latch);
+    }
+
+    /**
+     * @brief   Blocks until every job submitted against `latch` has run.
+     *
+     *  Only waits for the caller's own jobs, unlike `waitIdle`.  While some
+     *  are still queued, the calling thread runs queued jobs itself instead of
+     *  sleeping, so waiting from inside of a job can not starve the pool.
+     */
+    void wait(Latch& latch);
+
+    //! Blocks until the queue is empty and every thread is idle; never call it from a job
+    void waitIdle();
+
+    std::size_t getThreadCount() const;
+
+private:
+
+    struct Queued {
+        Job_t  job;
+        Latch *  latch;
+    } /*struct Queued*/;
+
+    void push(Job_t&& job, Latch * latch = nullptr);
+    void work();
+
+    //! Pops and runs the front job, unlocking `lock` meanwhile; rethrows what the job throws
+    void runFront(std::unique_lock<std::mutex>& lock);
+
+    //! Counts a job as done, waking whoever waits on it; `m_mutex` must be held
+    void finish(Latch * latch);
+
+    std::mutex  m_mutex;
+    std::condition_variable  m_wake;
+    std::condition_variable  m_idle;
+    std::condition_variable  m_done;
+    std::deque<Queued>  m_jobs;
+    std::size_t  m_busy = 0;
+    bool  m_stopping = false;
+    std::vector<std::thread>  m_threads;
+
+} /*class WorkerPool*/;
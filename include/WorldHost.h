@@ -0,0 +1,94 @@
+#pragma once
+#include "GameContext.h"
+#include "GameSettings.h"
+#include "GameWorld.h"
+#include "WorkerPool.h"
+#include <SFML/System.hpp>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+/**
+ * @brief   Hosts many independent headless `GameWorld`s in one process.
+ *
+ *  Every world ticks at its own fixed interval.  Ticks are handed to a shared
+ *  `WorkerPool` earliest-deadline-first, one tick per job, so a slow world
+ *  can never hold a thread for longer than a single tick of its own and the
+ *  worlds which are furthest behind are always served first.  A world which
+ *  falls more than a whole interval behind drops the missed ticks instead of
+ *  bursting to catch up, and the drops are counted in its stats.
+ *
+ *  Every world is built from the same `GameContext`, so read-only game data
+ *  is loaded once and shared rather than duplicated per world.
+ */
+class WorldHost {
+
+public:
+
+    using Handle = std::size_t;
+
+    //! Per-world tick-time accounting
+    struct WorldStats {
+        std::size_t ticks = 0;
+        std::size_t dropped = 0;
+        sf::Time busy{};
+        sf::Time worstTick{};
+
+        sf::Time meanTick() const;
+    } /*struct WorldStats*/;
+
+    //! Zero threads means one per hardware thread
+    WorldHost(GameContext& context, const GameSettings& settings, std::size_t threads = 0);
+    ~WorldHost();
+
+    WorldHost(const WorldHost&) = delete;
+    WorldHost& operator=(const WorldHost&) = delete;
+
+    //! Creates a headless world which ticks every `interval`; not while running
+    Handle spawn(sf::Time interval);
+
+    //! Only safe to touch while the host is not running
+    GameWorld& getWorld(Handle h);
+
+    std::size_t getWorldCount() const;
+
+    //! Schedules ticks from the calling thread until `duration` has passed
+    void runFor(sf::Time duration);
+
+    /**
+     * @brief   Runs the ticks which `duration` holds as fast as they go, on a simulated clock.
+     *
+     *  The schedule is the one `runFor` keeps, so each world ticks exactly once
+     *  per interval begun within `duration`; a tick due while its world is
+     *  still busy waits for it rather than being dropped.
+     */
+    void runSimulated(sf::Time duration);
+
+    //! Safe from any thread, including while running
+    WorldStats getStats(Handle h) const;
+
+private:
+
+    struct Slot {
+        std::unique_ptr<GameWorld>  world;
+        sf::Time  interval;
+        sf::Time  deadline;
+        std::atomic<bool>  inFlight{false};
+        mutable std::mutex  statsMutex;
+        WorldStats  stats;
+    } /*struct Slot*/;
+
+    //! The schedule `runFor` and `runSimulated` share; `simulated` jumps to each deadline
+    void run(sf::Time duration, bool simulated);
+
+    void tickOne(Slot& slot);
+
+    GameContext&  m_context;
+    GameSettings  m_settings;
+    std::vector<std::unique_ptr<Slot>>  m_slots;
+    WorkerPool  m_pool;
+
+} /*class WorldHost*/;
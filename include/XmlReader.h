@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief   A pull parser for the subset of XML that content tools write.
+ *
+ *  Each `next` returns one event, reading the stream through a fixed-size
+ *  buffer; nothing but the current element's name and attributes, or one
+ *  piece of text, is ever held.  Long character data arrives as several
+ *  consecutive `Text` events of at most about the buffer's size, so a
+ *  multi-megabyte layer can be decoded as it streams past.
+ *
+ *  Entities and CDATA sections are decoded; declarations, comments,
+ *  processing instructions and DOCTYPEs are skipped.  Namespaces and DTDs are
+ *  not interpreted.  Malformed input throws `std::runtime_error`.
+ */
+class XmlReader {
+
+public:
+
+    enum class Event {
+        StartElement, EndElement, Text, End
+    };
+
+    using Attribute = std::pair<std::string, std::string>;
+
+    explicit XmlReader(std::istream& src, std::size_t bufferSize = 64 * 1024);
+
+    Event next();
+
+    //! The element just started or ended
+    const std::string& getName() const;
+
+    //! Attributes of the element just started
+    const std::vector<Attribute>& getAttributes() const;
+
+    //! Returns nullptr when the element just started has no such attribute
+    const std::string * findAttribute(const char * name) const;
+
+    //! The piece of character data just read
+    const std::string& getText() const;
+
+    //! After `StartElement`, consumes everything up to and including its end
+    void skipElement();
+
+private:
+
+    bool fill();
+    int peek();
+    int get();
+    void expect(char c);
+    void skipSpace();
+    void readName(std::string& out);
+    void readEntity(std::string& out);
+    void readUntil(const char * terminator, std::string * out);
+    void readText();
+
+    //! Returns false for markup which produces no event, e.g. a comment
+    bool readMarkup(Event& event);
+
+    std::istream&  m_src;
+    std::vector<char>  m_buffer;
+    std::size_t  m_pos = 0;
+    std::size_t  m_end = 0;
+
+    std::string  m_name;
+    std::vector<Attribute>  m_attributes;
+    std::string  m_text;
+    std::vector<std::string>  m_open;
+    bool  m_selfClosed = false;
+
+} /*class XmlReader*/;
@@ -0,0 +1,100 @@
+#include "AnimatedSprites.h"
+#include "CommandList.h"
+
+AnimatedSprites::AnimatedSprites(const AnimationLibrary& library, const sf::Texture& texture)
+  : m_library{library}
+  , m_texture{texture}
+{
+}
+
+AnimatedSprites::Handle AnimatedSprites::add(ClipId clip, sf::Vector2f position)
+{
+    const auto handle = static_cast<Handle>(m_clip.size());
+    m_clip.push_back(clip);
+    m_start.push_back(m_time);
+    m_frame.push_back(0);
+    m_vertices.resize(m_vertices.size() + 4);
+    m_vertices[handle * 4].position = position;
+    writeFrame(handle, 0);
+    return handle;
+}
+
+void AnimatedSprites::play(Handle handle, ClipId clip)
+{
+    m_clip[handle] = clip;
+    m_start[handle] = m_time;
+    writeFrame(handle, 0);
+}
+
+void AnimatedSprites::setPosition(Handle handle, sf::Vector2f position)
+{
+    m_vertices[handle * 4].position = position;
+    writeFrame(handle, m_frame[handle]);
+}
+
+void AnimatedSprites::remove(Handle handle)
+{
+    const std::size_t last = m_clip.size() - 1;
+    m_clip[handle] = m_clip[last];
+    m_start[handle] = m_start[last];
+    m_frame[handle] = m_frame[last];
+    for (int k = 0; k < 4; ++k) { m_vertices[handle * 4 + k] = m_vertices[last * 4 + k]; }
+    m_clip.pop_back(), m_start.pop_back(), m_frame.pop_back();
+    m_vertices.resize(last * 4);
+}
+
+std::size_t AnimatedSprites::size() const
+{
+    return m_clip.size();
+}
+
+std::size_t AnimatedSprites::getFrame(Handle handle) const
+{
+    return m_frame[handle];
+}
+
+void AnimatedSprites::update(float dt)
+{
+    m_time += dt;
+    for (std::size_t i = 0; i < m_clip.size(); ++i) {
+        const std::size_t frame = m_library.get(m_clip[i]).frameAt(m_time - m_start[i]);
+        if (frame != m_frame[i]) {
+            writeFrame(static_cast<Handle>(i), frame);
+        }
+    }
+}
+
+void AnimatedSprites::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    if (m_vertices.empty()) {
+        return;
+    }
+    states.transform *= getTransform();
+    states.texture = &m_texture;
+    target.draw(m_vertices.data(), m_vertices.size(), sf::Quads, states);
+}
+
+void AnimatedSprites::record(CommandList& list, sf::RenderStates states) const
+{
+    if (m_vertices.empty()) {
+        return;
+    }
+    states.transform *= getTransform();
+    states.texture = &m_texture;
+    list.vertices(SortKey::make(getLayer(), getDepth(), &m_texture, states.blendMode), m_vertices.data(), m_vertices.size(), sf::Quads, states);
+}
+
+void AnimatedSprites::writeFrame(Handle handle, std::size_t frame)
+{
+    // Frames may differ in size, so the quad is rebuilt from its top-left corner
+    const sf::IntRect& rect = m_library.get(m_clip[handle]).frames[frame];
+    const float u0 = static_cast<float>(rect.left), u1 = u0 + rect.width;
+    const float v0 = static_cast<float>(rect.top), v1 = v0 + rect.height;
+    sf::Vertex * quad = &m_vertices[handle * 4];
+    const sf::Vector2f p = quad[0].position;
+    quad[0].texCoords = {u0, v0};
+    quad[1].position = {p.x + rect.width, p.y}, quad[1].texCoords = {u1, v0};
+    quad[2].position = {p.x + rect.width, p.y + rect.height}, quad[2].texCoords = {u1, v1};
+    quad[3].position = {p.x, p.y + rect.height}, quad[3].texCoords = {u0, v1};
+    m_frame[handle] = static_cast<std::uint16_t>(frame);
+}
@@ -0,0 +1,101 @@
+#include "Animation.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+std::size_t AnimationClip::frameAt(float t) const
+{
+    const std::size_t count = frames.size();
+    if (count < 2 || t <= 0.f) {
+        return 0;
+    }
+
+    switch (loop) {
+    case Loop::Once:
+        if (t >= m_length) { return count - 1; }
+        break;
+    case Loop::Repeat:
+        t = std::fmod(t, m_length);
+        break;
+    case Loop::PingPong: {
+        // Forward through every frame, then back through the inner ones only
+        const float back = m_ends[count - 2] - m_ends[0];
+        t = std::fmod(t, m_length + back);
+        if (t >= m_length) {
+            // Playing backwards from the end of the second-to-last frame
+            t = std::nextafter(m_ends[count - 2] - (t - m_length), 0.f);
+        }
+        break;
+    }
+    }
+
+    if (m_uniform > 0.f) {
+        return std::min(static_cast<std::size_t>(t / m_uniform), count - 1);
+    }
+    return std::min(static_cast<std::size_t>(std::upper_bound(m_ends.begin(), m_ends.end(), t) - m_ends.begin()), count - 1);
+}
+
+float AnimationClip::getLength() const
+{
+    return m_length;
+}
+
+void AnimationClip::freeze()
+{
+    if (frames.empty() || durations.empty()) {
+        throw std::invalid_argument{"an animation clip needs frames and durations"};
+    }
+    if (durations.size() != 1 && durations.size() != frames.size()) {
+        throw std::invalid_argument{"an animation clip needs one duration, or one per frame"};
+    }
+    if (!std::all_of(durations.begin(), durations.end(), [](float d) { return d > 0.f && std::isfinite(d); })) {
+        throw std::invalid_argument{"an animation clip's frames must each last a positive, finite time"};
+    }
+
+    m_ends.resize(frames.size());
+    float end{0};
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        end += durations.size() == 1 ? durations[0] : durations[i];
+        m_ends[i] = end;
+    }
+    m_length = end;
+
+    const bool uniform = std::all_of(durations.begin(), durations.end(), [&](float d) { return d == durations[0]; });
+    m_uniform = uniform ? durations[0] : 0.f;
+}
+
+
+ClipId AnimationLibrary::add(const std::string& name, AnimationClip clip)
+{
+    if (m_clips.size() > std::numeric_limits<ClipId>::max()) {
+        throw std::length_error{"too many animation clips"};
+    }
+    if (m_names.count(name)) {
+        throw std::invalid_argument{"two animation clips are named '" + name + "'"};
+    }
+    clip.freeze();
+    const auto id = static_cast<ClipId>(m_clips.size());
+    m_clips.push_back(std::move(clip));
+    m_names.emplace(name, id);
+    return id;
+}
+
+const AnimationClip& AnimationLibrary::get(ClipId id) const
+{
+    return m_clips[id];
+}
+
+ClipId AnimationLibrary::find(const std::string& name) const
+{
+    const auto it = m_names.find(name);
+    if (it == m_names.end()) {
+        throw std::out_of_range{"no animation clip named '" + name + "'"};
+    }
+    return it->second;
+}
+
+std::size_t AnimationLibrary::size() const
+{
+    return m_clips.size();
+}
@@ -0,0 +1,5 @@
+#include "BattleStats.h"
+
+BattleStats::BattleStats()
+{
+}
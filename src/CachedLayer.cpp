@@ -0,0 +1,80 @@
+#include "CachedLayer.h"
+#include "CommandList.h"
+#include "RenderDevice.h"
+#include "SpriteBatch.h"
+#include <cmath>
+
+CachedLayer::CachedLayer(LayerCache& cache, sf::FloatRect area) : m_cache{cache}, m_area{area}
+{
+}
+
+CachedLayer::~CachedLayer()
+{
+    m_cache.release(this);
+}
+
+void CachedLayer::invalidate()
+{
+    m_dirty = true;
+}
+
+void CachedLayer::update(float dt)
+{
+    for (auto& child : m_children) {
+        child->update(dt);
+    }
+}
+
+std::optional<sf::FloatRect> CachedLayer::getLocalBounds() const
+{
+    return m_area;
+}
+
+void CachedLayer::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    states.transform *= getTransform();
+    target.draw(quad(refresh()), states);
+}
+
+void CachedLayer::record(CommandList& list, sf::RenderStates states) const
+{
+    states.transform *= getTransform();
+    list.sprite(getLayer(), getDepth(), quad(refresh()), states);
+}
+
+const sf::Texture& CachedLayer::refresh() const
+{
+    sf::RenderTexture * texture = m_cache.find(this);
+    if (!texture) {
+        const sf::Vector2u size{
+            static_cast<unsigned int>(std::ceil(m_area.width))
+          , static_cast<unsigned int>(std::ceil(m_area.height))
+        };
+        texture = &m_cache.acquire(this, size);
+        m_dirty = true;
+    }
+    if (m_dirty) {
+        CommandList list{};
+        SpriteBatch batch{};
+        for (const auto& child : m_children) {
+            child->record(list, {});
+        }
+        list.sort();
+        const sf::Vector2u size = texture->getSize();
+        texture->setView(sf::View{{m_area.left, m_area.top, static_cast<float>(size.x), static_cast<float>(size.y)}});
+        texture->clear(sf::Color::Transparent);
+        RenderTargetDevice device{*texture};
+        list.submit(device, batch);
+        texture->display();
+        m_cache.countRedraw();
+        m_dirty = false;
+    }
+    return texture->getTexture();
+}
+
+sf::Sprite CachedLayer::quad(const sf::Texture& texture) const
+{
+    sf::Sprite sprite{texture};
+    sprite.setPosition(m_area.left, m_area.top);
+    return sprite;
+}
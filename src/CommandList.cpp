@@ -0,0 +1,308 @@
+#include "CommandList.h"
+#include "RenderDevice.h"
+#include "SpriteBatch.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+//! Interned blend modes; indices 0-3 are SFML's built-ins
+struct BlendTable {
+
+    std::array<sf::BlendMode, 256>  modes{{sf::BlendAlpha, sf::BlendAdd, sf::BlendMultiply, sf::BlendNone}};
+    std::atomic<std::size_t>  count{4};
+    std::mutex  mutex;
+
+} /*struct BlendTable*/;
+
+BlendTable& blendTable()
+{
+    static BlendTable table{};
+    return table;
+}
+
+bool before(std::uint64_t key, std::uint32_t source, std::uint64_t otherKey, std::uint32_t otherSource)
+{
+    const std::uint32_t order = SortKey::orderOf(key), otherOrder = SortKey::orderOf(otherKey);
+    return order < otherOrder || (order == otherOrder && source < otherSource);
+}
+
+} /*namespace*/;
+
+
+std::uint64_t SortKey::make(std::uint8_t layer, float depth, const sf::Texture * texture, const sf::BlendMode& blend)
+{
+    // Flip floats so that their bit patterns sort in numeric order
+    std::uint32_t bits;
+    std::memcpy(&bits, &depth, sizeof bits);
+    bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+
+    const std::uint64_t tex = (static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(texture)) * 0x9E3779B97F4A7C15ull) >> 40;
+    return static_cast<std::uint64_t>(layer) << 56
+        | static_cast<std::uint64_t>(bits >> 8) << 32
+        | tex << 8
+        | blendIndex(blend);
+}
+
+std::uint8_t SortKey::blendIndex(const sf::BlendMode& blend)
+{
+    BlendTable& table = blendTable();
+    std::size_t count = table.count.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (table.modes[i] == blend) { return static_cast<std::uint8_t>(i); }
+    }
+
+    std::lock_guard<std::mutex> lock{table.mutex};
+    count = table.count.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (table.modes[i] == blend) { return static_cast<std::uint8_t>(i); }
+    }
+    if (count == table.modes.size()) {
+        throw std::length_error{"too many distinct blend modes"};
+    }
+    table.modes[count] = blend;
+    table.count.store(count + 1, std::memory_order_release);
+    return static_cast<std::uint8_t>(count);
+}
+
+const sf::BlendMode& SortKey::blendMode(std::uint8_t index)
+{
+    return blendTable().modes[index];
+}
+
+
+CommandList::CommandList(std::size_t arenaBlock) : m_arena{arenaBlock}
+{
+}
+
+RenderCommand * CommandList::push(std::uint64_t key, RenderCommand::Kind kind)
+{
+    RenderCommand * cmd = m_arena.create<RenderCommand>();
+    *cmd = RenderCommand{kind, 0, sf::Triangles, 0, m_source, nullptr, nullptr, nullptr, nullptr};
+    m_entries.push_back({key, cmd, m_source});
+    return cmd;
+}
+
+void CommandList::quad(std::uint64_t key, const sf::Texture * texture, const sf::BlendMode& blend, const sf::Vertex (&quad)[4])
+{
+    RenderCommand * cmd = push(key, RenderCommand::Kind::Quad);
+    sf::Vertex * copy = m_arena.createArray<sf::Vertex>(4);
+    std::copy(quad, quad + 4, copy);
+    cmd->blend = SortKey::blendIndex(blend);
+    cmd->count = 4;
+    cmd->texture = texture;
+    cmd->vertices = copy;
+}
+
+void CommandList::sprite(std::uint8_t layer, float depth, const sf::Sprite& sprite, const sf::RenderStates& states)
+{
+    RenderCommand * cmd = push(SortKey::make(layer, depth, sprite.getTexture(), states.blendMode), RenderCommand::Kind::Quad);
+    cmd->blend = SortKey::blendIndex(states.blendMode);
+    cmd->count = 4;
+    cmd->texture = sprite.getTexture();
+    m_spriteTransforms.push_back(states.transform * sprite.getTransform());
+    m_spriteQuads.push_back(localQuad(sprite));
+    m_spriteCommands.push_back(cmd);
+}
+
+void CommandList::vertices(std::uint64_t key, const sf::Vertex * vertices, std::size_t count, sf::PrimitiveType primitive, const sf::RenderStates& states)
+{
+    RenderCommand * cmd = push(key, RenderCommand::Kind::Vertices);
+    cmd->primitive = primitive;
+    cmd->count = static_cast<std::uint32_t>(count);
+    cmd->texture = states.texture;
+    cmd->vertices = vertices;
+    cmd->states = m_arena.create<sf::RenderStates>(states);
+}
+
+void CommandList::drawable(std::uint64_t key, const sf::Drawable& drawable, const sf::RenderStates& states)
+{
+    RenderCommand * cmd = push(key, RenderCommand::Kind::Drawable);
+    cmd->texture = states.texture;
+    cmd->drawable = &drawable;
+    cmd->states = m_arena.create<sf::RenderStates>(states);
+}
+
+void CommandList::merge(const CommandList& other)
+{
+    // Sprites the lender has not sorted yet get their vertices from this list's `sort`
+    m_spriteTransforms.insert(m_spriteTransforms.end(), other.m_spriteTransforms.begin(), other.m_spriteTransforms.end());
+    m_spriteQuads.insert(m_spriteQuads.end(), other.m_spriteQuads.begin(), other.m_spriteQuads.end());
+    m_spriteCommands.insert(m_spriteCommands.end(), other.m_spriteCommands.begin(), other.m_spriteCommands.end());
+    m_entries.insert(m_entries.end(), other.m_entries.begin(), other.m_entries.end());
+}
+
+void CommandList::setSource(std::uint32_t source)
+{
+    m_source = source;
+}
+
+void CommandList::setView(const sf::View& view)
+{
+    m_view = view;
+}
+
+const sf::View& CommandList::getView() const
+{
+    return m_view;
+}
+
+void CommandList::sort()
+{
+    expandSprites();
+    sf::Clock clock{};
+    const std::size_t n = m_entries.size();
+
+    std::size_t descents{0};
+    for (std::size_t i = 1; i < n; ++i) {
+        descents += before(m_entries[i].key, m_entries[i].source, m_entries[i - 1].key, m_entries[i - 1].source);
+    }
+
+    m_stats.moves = 0;
+    if (descents == 0) {
+        m_stats.sortMethod = SortMethod::None;
+    } else if (descents <= n / 16 && insertionSort(4 * n)) {
+        m_stats.sortMethod = SortMethod::Insertion;
+    } else {
+        m_stats.sortMethod = SortMethod::Radix;
+        radixSort();
+    }
+
+    m_stats.commands = n;
+    m_stats.arenaBytes = m_arena.getBytesUsed();
+    m_stats.sortTime = clock.getElapsedTime();
+}
+
+void CommandList::expandSprites()
+{
+    const std::size_t n = m_spriteCommands.size();
+    if (n == 0) {
+        return;
+    }
+    sf::Vertex * vertices = m_arena.createArray<sf::Vertex>(4 * n);
+    transformQuads(m_spriteTransforms.data(), m_spriteQuads.data(), n, vertices);
+    for (std::size_t i = 0; i < n; ++i) {
+        m_spriteCommands[i]->vertices = vertices + 4 * i;
+    }
+    m_spriteTransforms.clear();
+    m_spriteQuads.clear();
+    m_spriteCommands.clear();
+}
+
+void CommandList::requireExpanded() const
+{
+    if (!m_spriteCommands.empty()) {
+        throw std::logic_error{"CommandList: sprites were recorded since the last sort"};
+    }
+}
+
+bool CommandList::insertionSort(std::size_t budget)
+{
+    for (std::size_t i = 1; i < m_entries.size(); ++i) {
+        const Entry e = m_entries[i];
+        std::size_t j = i;
+        while (j > 0 && before(e.key, e.source, m_entries[j - 1].key, m_entries[j - 1].source)) {
+            m_entries[j] = m_entries[j - 1];
+            --j;
+        }
+        m_entries[j] = e;
+        m_stats.moves += i - j;
+        if (m_stats.moves > budget) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CommandList::radixSort()
+{
+    const std::size_t n = m_entries.size();
+
+    // Least significant digits first: the source's 4 bytes, then layer and depth's 4
+    auto digit = [](const Entry& e, int b) -> std::size_t {
+        return b < 4 ? (e.source >> (8 * b)) & 0xff : (SortKey::orderOf(e.key) >> (8 * (b - 4))) & 0xff;
+    };
+
+    // Histogram every byte in one pass, then scatter once per byte that varies
+    std::array<std::array<std::size_t, 256>, 8> counts{};
+    for (const auto& e : m_entries) {
+        for (int b = 0; b < 8; ++b) { ++counts[b][digit(e, b)]; }
+    }
+    m_scratch.resize(n);
+    for (int b = 0; b < 8; ++b) {
+        auto& count = counts[b];
+        if (n == 0 || count[digit(m_entries[0], b)] == n) {
+            continue;
+        }
+        std::size_t offset{0};
+        for (auto& c : count) {
+            const std::size_t here = c;
+            c = offset;
+            offset += here;
+        }
+        for (const auto& e : m_entries) {
+            m_scratch[count[digit(e, b)]++] = e;
+        }
+        m_entries.swap(m_scratch);
+    }
+}
+
+void CommandList::submit(RenderDevice& device, SpriteBatch& batch) const
+{
+    requireExpanded();
+    const sf::Texture * texture{nullptr};
+    std::uint8_t blend{0};
+    bool open{false};
+
+    for (const auto& e : m_entries) {
+        const RenderCommand& cmd = *e.cmd;
+        switch (cmd.kind) {
+        case RenderCommand::Kind::Quad:
+            if (!open || cmd.texture != texture || cmd.blend != blend) {
+                batch.flush(device);
+                texture = cmd.texture, blend = cmd.blend, open = true;
+            }
+            batch.addQuad(cmd.texture, SortKey::blendMode(cmd.blend), *reinterpret_cast<const sf::Vertex (*)[4]>(cmd.vertices));
+            break;
+        case RenderCommand::Kind::Vertices:
+            if (cmd.count == 0) {
+                break;
+            }
+            batch.flush(device), open = false;
+            device.draw(cmd.vertices, cmd.count, cmd.primitive, *cmd.states);
+            batch.countDraw(cmd.count);
+            break;
+        case RenderCommand::Kind::Drawable:
+            batch.flush(device), open = false;
+            if (device.draw(*cmd.drawable, *cmd.states)) {
+                batch.countDraw(0);
+            }
+            break;
+        }
+    }
+    batch.flush(device);
+}
+
+void CommandList::clear()
+{
+    m_spriteTransforms.clear();
+    m_spriteQuads.clear();
+    m_spriteCommands.clear();
+    m_entries.clear();
+    m_arena.reset();
+    m_source = NoSource;
+}
+
+std::size_t CommandList::size() const
+{
+    return m_entries.size();
+}
+
+const CommandList::Stats& CommandList::getStats() const
+{
+    return m_stats;
+}
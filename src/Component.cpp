@@ -0,0 +1,64 @@
+#include "Component.h"
+#include "CommandList.h"
+#include "Hash.h"
+
+void Component::update(float ft)
+{
+}
+
+void Component::draw(sf::RenderTarget&, sf::RenderStates) const
+{
+}
+
+void Component::record(CommandList& list, sf::RenderStates states) const
+{
+    list.drawable(SortKey::make(m_layer, getDepth(), states.texture, states.blendMode), *this, states);
+}
+
+std::optional<sf::FloatRect> Component::getLocalBounds() const
+{
+    return std::nullopt;
+}
+
+std::optional<sf::FloatRect> Component::getBounds() const
+{
+    const auto local = getLocalBounds();
+    if (!local) {
+        return std::nullopt;
+    }
+    return getTransform().transformRect(*local);
+}
+
+void Component::setLayer(std::uint8_t layer)
+{
+    m_layer = layer;
+}
+
+std::uint8_t Component::getLayer() const
+{
+    return m_layer;
+}
+
+void Component::setYSorted(bool ySorted)
+{
+    m_ySorted = ySorted;
+}
+
+bool Component::isYSorted() const
+{
+    return m_ySorted;
+}
+
+float Component::getDepth() const
+{
+    if (!m_ySorted) {
+        return 0.f;
+    }
+    const auto bounds = getBounds();
+    return bounds ? bounds->top + bounds->height : getPosition().y;
+}
+
+void Component::hashState(StateHasher& h) const
+{
+    h << getPosition() << getRotation() << getScale() << getOrigin();
+}
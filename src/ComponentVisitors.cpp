@@ -4,6 +4,9 @@ UpdateVisitor::UpdateVisitor(float dtIn) : m_dt{dtIn}
 {
 }
 
-DrawVisitor::DrawVisitor(sf::RenderTarget& targetIn, sf::RenderStates states) : m_target{targetIn}, m_states{states}
+DrawVisitor::DrawVisitor(CommandList& listIn, sf::RenderStates states, std::optional<sf::FloatRect> cullIn)
+  : m_list{listIn}
+  , m_states{states}
+  , m_cull{cullIn}
 {
 }
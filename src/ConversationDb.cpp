@@ -0,0 +1,501 @@
+#include "ConversationDb.h"
+#include "Hash.h"
+#include "JsonReader.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const char Magic[8] = {'M', 'I', 'N', 'T', 'C', 'O', 'N', 'V'};
+const std::uint32_t Version = 1;
+
+const std::size_t HeaderBytes = 48;
+
+// Record sizes in words; text references are an offset and a length
+const std::size_t SceneWords = 6;
+const std::size_t NodeWords = 4;
+const std::size_t LineWords = 3;
+const std::size_t SpeakerWords = 2;
+
+//! Speaker names are looked for this far into a line
+const std::size_t SpeakerLimit = 64;
+
+const std::size_t ChunkBytes = 64 * 1024;
+
+[[noreturn]] void fail(const std::string& what)
+{
+    throw std::runtime_error{"conversations: " + what};
+}
+
+std::uint32_t get32(const unsigned char * p)
+{
+    return static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8
+        | static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+}
+
+std::uint64_t get64(const unsigned char * p)
+{
+    return static_cast<std::uint64_t>(get32(p)) | static_cast<std::uint64_t>(get32(p + 4)) << 32;
+}
+
+void put32(std::vector<unsigned char>& dst, std::uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) { dst.push_back(static_cast<unsigned char>(v >> (8 * i))); }
+}
+
+void put64(std::vector<unsigned char>& dst, std::uint64_t v)
+{
+    for (int i = 0; i < 8; ++i) { dst.push_back(static_cast<unsigned char>(v >> (8 * i))); }
+}
+
+std::uint64_t hashId(std::string_view id)
+{
+    return fnv1a(id.data(), id.size());
+}
+
+} /*namespace*/;
+
+
+ConversationDb::ConversationDb() : ConversationDb{ConversationBuilder{}.build()}
+{
+}
+
+ConversationDb::ConversationDb(std::shared_ptr<const unsigned char> image, std::size_t size)
+  : m_image{std::move(image)}
+  , m_size{size}
+{
+    const unsigned char * p = m_image.get();
+    if (m_size < HeaderBytes || std::memcmp(p, Magic, sizeof Magic) != 0) {
+        fail("not a conversation database");
+    }
+    if (get32(p + 8) != Version) {
+        fail("version " + std::to_string(get32(p + 8)) + ", expected " + std::to_string(Version));
+    }
+    m_scenes = get32(p + 12), m_nodes = get32(p + 16), m_lines = get32(p + 20);
+    m_speakers = get32(p + 24), m_steps = get32(p + 28), m_slots = get32(p + 32), m_textBytes = get32(p + 36);
+
+    const std::uint64_t words = std::uint64_t{m_scenes} * SceneWords + std::uint64_t{m_nodes} * NodeWords
+        + std::uint64_t{m_lines} * LineWords + std::uint64_t{m_speakers} * SpeakerWords + m_steps + m_slots;
+    if (get64(p + 40) != m_size || HeaderBytes + 4 * words + m_textBytes != m_size) {
+        fail("truncated");
+    }
+    if ((m_slots & (m_slots - 1)) != 0 || (m_scenes > 0 && m_slots <= m_scenes)) {
+        fail("bad scene table");
+    }
+    m_sceneTable = p + HeaderBytes;
+    m_nodeTable = m_sceneTable + 4 * SceneWords * m_scenes;
+    m_lineTable = m_nodeTable + 4 * NodeWords * m_nodes;
+    m_speakerTable = m_lineTable + 4 * LineWords * m_lines;
+    m_stepTable = m_speakerTable + 4 * SpeakerWords * m_speakers;
+    m_slotTable = m_stepTable + 4 * std::size_t{m_steps};
+    m_text = reinterpret_cast<const char *>(m_slotTable + 4 * std::size_t{m_slots});
+
+    // One pass over every record, so that accessors can trust the image
+    auto checkText = [this](const unsigned char * ref) {
+        if (get32(ref) > m_textBytes || get32(ref + 4) > m_textBytes - get32(ref)) { fail("text out of bounds"); }
+    };
+    auto checkRange = [](std::uint32_t first, std::uint32_t count, std::uint32_t size) {
+        if (first > size || count > size - first) { fail("record out of bounds"); }
+    };
+    for (std::uint32_t i = 0; i < m_scenes; ++i) {
+        const unsigned char * r = m_sceneTable + 4 * SceneWords * i;
+        checkText(r);
+        checkRange(get32(r + 8), get32(r + 12), m_nodes);
+        checkRange(get32(r + 16), get32(r + 20), m_steps);
+    }
+    for (std::uint32_t i = 0; i < m_nodes; ++i) {
+        const unsigned char * r = m_nodeTable + 4 * NodeWords * i;
+        checkText(r);
+        checkRange(get32(r + 8), get32(r + 12), m_lines);
+    }
+    for (std::uint32_t i = 0; i < m_lines; ++i) {
+        const unsigned char * r = m_lineTable + 4 * LineWords * i;
+        if (get32(r) != NoSpeaker && get32(r) >= m_speakers) { fail("speaker out of bounds"); }
+        checkText(r + 4);
+    }
+    for (std::uint32_t i = 0; i < m_speakers; ++i) { checkText(m_speakerTable + 4 * SpeakerWords * i); }
+    for (std::uint32_t i = 0; i < m_steps; ++i) {
+        if (word(m_stepTable, i) >= m_nodes) { fail("step out of bounds"); }
+    }
+    for (std::uint32_t i = 0; i < m_slots; ++i) {
+        if (word(m_slotTable, i) > m_scenes) { fail("scene table out of bounds"); }
+    }
+}
+
+ConversationDb ConversationDb::map(const std::string& path)
+{
+    auto file = std::make_shared<MappedFile>(path);
+    const std::size_t size = file->size();
+    return {std::shared_ptr<const unsigned char>{file, file->data()}, size};
+}
+
+ConversationDb ConversationDb::read(std::istream& src)
+{
+    auto bytes = std::make_shared<std::vector<unsigned char>>();
+    char buffer[64 * 1024];
+    while (src.read(buffer, sizeof buffer) || src.gcount() > 0) {
+        bytes->insert(bytes->end(), buffer, buffer + src.gcount());
+    }
+    const std::size_t size = bytes->size();
+    return {std::shared_ptr<const unsigned char>{bytes, bytes->data()}, size};
+}
+
+void ConversationDb::write(std::ostream& dst) const
+{
+    dst.write(reinterpret_cast<const char *>(m_image.get()), static_cast<std::streamsize>(m_size));
+    if (!dst) {
+        fail("write failed");
+    }
+}
+
+std::uint32_t ConversationDb::findScene(std::string_view id) const
+{
+    if (m_slots == 0) {
+        return NoScene;
+    }
+    const std::uint32_t mask = m_slots - 1;
+    for (std::uint32_t i = static_cast<std::uint32_t>(hashId(id)) & mask, probes = 0; probes < m_slots; i = (i + 1) & mask, ++probes) {
+        const std::uint32_t slot = word(m_slotTable, i);
+        if (slot == 0) {
+            break;
+        }
+        if (getSceneId(slot - 1) == id) {
+            return slot - 1;
+        }
+    }
+    return NoScene;
+}
+
+std::size_t ConversationDb::getSceneCount() const
+{
+    return m_scenes;
+}
+
+std::string_view ConversationDb::getSceneId(std::uint32_t scene) const
+{
+    return text(m_sceneTable + 4 * SceneWords * scene);
+}
+
+std::size_t ConversationDb::getStepCount(std::uint32_t scene) const
+{
+    return word(m_sceneTable, SceneWords * scene + 5);
+}
+
+std::uint32_t ConversationDb::getStep(std::uint32_t scene, std::size_t step) const
+{
+    return word(m_stepTable, word(m_sceneTable, SceneWords * scene + 4) + step);
+}
+
+std::uint32_t ConversationDb::findNode(std::uint32_t scene, std::string_view id) const
+{
+    const std::uint32_t first = getFirstNode(scene);
+    for (std::uint32_t node = first; node < first + getNodeCount(scene); ++node) {
+        if (getNodeId(node) == id) {
+            return node;
+        }
+    }
+    return NoNode;
+}
+
+std::uint32_t ConversationDb::getFirstNode(std::uint32_t scene) const
+{
+    return word(m_sceneTable, SceneWords * scene + 2);
+}
+
+std::size_t ConversationDb::getNodeCount(std::uint32_t scene) const
+{
+    return word(m_sceneTable, SceneWords * scene + 3);
+}
+
+std::string_view ConversationDb::getNodeId(std::uint32_t node) const
+{
+    return text(m_nodeTable + 4 * NodeWords * node);
+}
+
+std::size_t ConversationDb::getLineCount(std::uint32_t node) const
+{
+    return word(m_nodeTable, NodeWords * node + 3);
+}
+
+ConversationDb::Line ConversationDb::getLine(std::uint32_t node, std::size_t line) const
+{
+    const unsigned char * r = m_lineTable + 4 * LineWords * (word(m_nodeTable, NodeWords * node + 2) + line);
+    return {get32(r), text(r + 4)};
+}
+
+std::uint32_t ConversationDb::findSpeaker(std::string_view name) const
+{
+    for (std::uint32_t speaker = 0; speaker < m_speakers; ++speaker) {
+        if (getSpeakerName(speaker) == name) {
+            return speaker;
+        }
+    }
+    return NoSpeaker;
+}
+
+std::size_t ConversationDb::getSpeakerCount() const
+{
+    return m_speakers;
+}
+
+std::string_view ConversationDb::getSpeakerName(std::uint32_t speaker) const
+{
+    return text(m_speakerTable + 4 * SpeakerWords * speaker);
+}
+
+std::size_t ConversationDb::getMemoryUsage() const
+{
+    return m_size;
+}
+
+std::uint32_t ConversationDb::word(const unsigned char * table, std::size_t index) const
+{
+    return get32(table + 4 * index);
+}
+
+std::string_view ConversationDb::text(const unsigned char * ref) const
+{
+    return {m_text + get32(ref), get32(ref + 4)};
+}
+
+
+ConversationBuilder::ConversationBuilder()
+{
+}
+
+void ConversationBuilder::read(std::istream& json)
+{
+    JsonReader reader{json};
+    const JsonReader::Token first = reader.next();
+    if (first == JsonReader::Token::BeginObject) {
+        readScene(reader);
+    } else if (first == JsonReader::Token::BeginArray) {
+        for (auto t = reader.next(); t != JsonReader::Token::EndArray; t = reader.next()) {
+            if (t != JsonReader::Token::BeginObject) {
+                fail("expected a scene");
+            }
+            readScene(reader);
+        }
+    } else {
+        fail("expected a scene or an array of scenes");
+    }
+}
+
+void ConversationBuilder::readScene(JsonReader& json)
+{
+    using Token = JsonReader::Token;
+    const std::size_t nodes = m_nodes.size(), lines = m_lines.size(), steps = m_steps.size();
+    try {
+        std::string id;
+        bool named{false};
+        std::vector<std::string> sequence;
+
+        for (Token t = json.next(); t != Token::EndObject; t = json.next()) {
+            if (t != Token::Key) {
+                fail("expected a key");
+            }
+            const std::string key = json.getString();
+            if (key == "id") {
+                if (json.next() != Token::String) { fail("scene ids are strings"); }
+                id = json.getString(), named = true;
+            } else if (key == "sequence") {
+                if (json.next() != Token::BeginArray) { fail("a sequence is an array of node ids"); }
+                for (Token s = json.next(); s != Token::EndArray; s = json.next()) {
+                    if (s != Token::String) { fail("a sequence is an array of node ids"); }
+                    sequence.push_back(json.getString());
+                }
+            } else if (key == "data") {
+                if (json.next() != Token::BeginObject) { fail("scene data is an object of nodes"); }
+                for (Token n = json.next(); n != Token::EndObject; n = json.next()) {
+                    if (n != Token::Key) { fail("expected a node id"); }
+                    m_nodes.push_back({intern(json.getString()), static_cast<std::uint32_t>(m_lines.size()), 0});
+                    const Token value = json.next();
+                    if (value == Token::String) {
+                        addLine(json.getString());
+                    } else if (value == Token::BeginArray) {
+                        for (Token l = json.next(); l != Token::EndArray; l = json.next()) {
+                            if (l != Token::String) { fail("a node's lines are strings"); }
+                            addLine(json.getString());
+                        }
+                    } else {
+                        fail("a node is a line or an array of lines");
+                    }
+                    m_nodes.back().lineCount = static_cast<std::uint32_t>(m_lines.size() - m_nodes.back().firstLine);
+                }
+            } else {
+                json.skipValue(json.next());
+            }
+        }
+
+        if (!named) {
+            id = "scene" + std::to_string(m_scenes.size());
+        }
+        if (m_sceneIndex.count(id)) {
+            fail("duplicate scene '" + id + "'");
+        }
+        std::unordered_map<std::string_view, std::uint32_t> local;
+        for (std::size_t node = nodes; node < m_nodes.size(); ++node) {
+            local.emplace(view(m_nodes[node].id), static_cast<std::uint32_t>(node));
+        }
+        for (const auto& name : sequence) {
+            const auto found = local.find(name);
+            if (found == local.end()) {
+                fail("scene '" + id + "' has no node '" + name + "'");
+            }
+            m_steps.push_back(found->second);
+        }
+
+        const Ref ref = intern(id);
+        m_sceneIndex.emplace(view(ref), static_cast<std::uint32_t>(m_scenes.size()));
+        m_scenes.push_back({ref, static_cast<std::uint32_t>(nodes), static_cast<std::uint32_t>(m_nodes.size() - nodes),
+            static_cast<std::uint32_t>(steps), static_cast<std::uint32_t>(m_steps.size() - steps)});
+
+    } catch (...) {
+        // Scenes read before this one stay; interned strings are merely unused
+        m_nodes.resize(nodes), m_lines.resize(lines), m_steps.resize(steps);
+        throw;
+    }
+}
+
+void ConversationBuilder::add(const ConversationDb& db)
+{
+    for (std::uint32_t scene = 0; scene < db.getSceneCount(); ++scene) {
+        const std::string_view id = db.getSceneId(scene);
+        if (m_sceneIndex.count(id)) {
+            fail("duplicate scene '" + std::string{id} + "'");
+        }
+        const std::uint32_t nodes = static_cast<std::uint32_t>(m_nodes.size()), steps = static_cast<std::uint32_t>(m_steps.size());
+        const std::uint32_t first = db.getFirstNode(scene);
+        for (std::uint32_t node = first; node < first + db.getNodeCount(scene); ++node) {
+            m_nodes.push_back({intern(db.getNodeId(node)), static_cast<std::uint32_t>(m_lines.size()), static_cast<std::uint32_t>(db.getLineCount(node))});
+            for (std::size_t i = 0; i < db.getLineCount(node); ++i) {
+                const ConversationDb::Line line = db.getLine(node, i);
+                const std::uint32_t speaker = line.speaker == ConversationDb::NoSpeaker
+                    ? ConversationDb::NoSpeaker : internSpeaker(db.getSpeakerName(line.speaker));
+                m_lines.push_back({speaker, intern(line.text)});
+            }
+        }
+        for (std::size_t step = 0; step < db.getStepCount(scene); ++step) {
+            m_steps.push_back(nodes + (db.getStep(scene, step) - first));
+        }
+        const Ref ref = intern(id);
+        m_sceneIndex.emplace(view(ref), static_cast<std::uint32_t>(m_scenes.size()));
+        m_scenes.push_back({ref, nodes, static_cast<std::uint32_t>(m_nodes.size()) - nodes, steps, static_cast<std::uint32_t>(m_steps.size()) - steps});
+    }
+}
+
+ConversationDb ConversationBuilder::build() const
+{
+    std::uint32_t slots{0};
+    if (!m_scenes.empty()) {
+        // At most half full, so probe runs stay short
+        for (slots = 1; slots < 2 * m_scenes.size(); slots <<= 1) {}
+    }
+    std::vector<std::uint32_t> table(slots, 0);
+    for (std::uint32_t scene = 0; scene < m_scenes.size(); ++scene) {
+        std::uint32_t i = static_cast<std::uint32_t>(hashId(view(m_scenes[scene].id))) & (slots - 1);
+        while (table[i] != 0) { i = (i + 1) & (slots - 1); }
+        table[i] = scene + 1;
+    }
+
+    const std::uint64_t size = HeaderBytes + 4 * (m_scenes.size() * SceneWords + m_nodes.size() * NodeWords
+        + m_lines.size() * LineWords + m_speakers.size() * SpeakerWords + m_steps.size() + slots) + m_textBytes;
+    auto image = std::make_shared<std::vector<unsigned char>>();
+    image->reserve(size);
+    std::vector<unsigned char>& out = *image;
+
+    for (char c : Magic) { out.push_back(static_cast<unsigned char>(c)); }
+    put32(out, Version);
+    put32(out, static_cast<std::uint32_t>(m_scenes.size()));
+    put32(out, static_cast<std::uint32_t>(m_nodes.size()));
+    put32(out, static_cast<std::uint32_t>(m_lines.size()));
+    put32(out, static_cast<std::uint32_t>(m_speakers.size()));
+    put32(out, static_cast<std::uint32_t>(m_steps.size()));
+    put32(out, slots);
+    put32(out, static_cast<std::uint32_t>(m_textBytes));
+    put64(out, size);
+
+    for (const auto& scene : m_scenes) {
+        put32(out, scene.id.offset), put32(out, scene.id.length);
+        put32(out, scene.firstNode), put32(out, scene.nodeCount);
+        put32(out, scene.firstStep), put32(out, scene.stepCount);
+    }
+    for (const auto& node : m_nodes) {
+        put32(out, node.id.offset), put32(out, node.id.length);
+        put32(out, node.firstLine), put32(out, node.lineCount);
+    }
+    for (const auto& line : m_lines) {
+        put32(out, line.speaker), put32(out, line.text.offset), put32(out, line.text.length);
+    }
+    for (const auto& speaker : m_speakers) {
+        put32(out, speaker.offset), put32(out, speaker.length);
+    }
+    for (std::uint32_t step : m_steps) { put32(out, step); }
+    for (std::uint32_t slot : table) { put32(out, slot); }
+    for (const auto& chunk : m_chunks) {
+        out.insert(out.end(), chunk.bytes.get(), chunk.bytes.get() + chunk.used);
+    }
+    return {std::shared_ptr<const unsigned char>{image, image->data()}, image->size()};
+}
+
+std::size_t ConversationBuilder::getSceneCount() const
+{
+    return m_scenes.size();
+}
+
+ConversationBuilder::Ref ConversationBuilder::intern(std::string_view s)
+{
+    const auto found = m_strings.find(s);
+    if (found != m_strings.end()) {
+        return found->second;
+    }
+    if (m_textBytes + s.size() > 0xffffffffu) {
+        fail("more than 4 GiB of text");
+    }
+    if (m_chunks.empty() || m_chunks.back().capacity - m_chunks.back().used < s.size()) {
+        const std::size_t capacity = std::max(ChunkBytes, s.size());
+        m_chunks.push_back({std::make_unique<char[]>(capacity), m_textBytes, 0, capacity});
+    }
+    Chunk& chunk = m_chunks.back();
+    char * at = chunk.bytes.get() + chunk.used;
+    std::copy(s.begin(), s.end(), at);
+    chunk.used += s.size();
+
+    const Ref ref{static_cast<std::uint32_t>(m_textBytes), static_cast<std::uint32_t>(s.size())};
+    m_textBytes += s.size();
+    m_strings.emplace(std::string_view{at, s.size()}, ref);
+    return ref;
+}
+
+std::uint32_t ConversationBuilder::internSpeaker(std::string_view name)
+{
+    const auto found = m_speakerIndex.find(name);
+    if (found != m_speakerIndex.end()) {
+        return found->second;
+    }
+    const Ref ref = intern(name);
+    const auto speaker = static_cast<std::uint32_t>(m_speakers.size());
+    m_speakers.push_back(ref);
+    m_speakerIndex.emplace(view(ref), speaker);
+    return speaker;
+}
+
+void ConversationBuilder::addLine(std::string_view utf8)
+{
+    std::uint32_t speaker{ConversationDb::NoSpeaker};
+    const std::size_t colon = utf8.substr(0, SpeakerLimit).find(": ");
+    if (colon != std::string_view::npos && colon > 0) {
+        speaker = internSpeaker(utf8.substr(0, colon));
+        utf8.remove_prefix(colon + 2);
+    }
+    m_lines.push_back({speaker, intern(utf8)});
+}
+
+std::string_view ConversationBuilder::view(Ref ref) const
+{
+    const auto chunk = std::upper_bound(m_chunks.begin(), m_chunks.end(), ref.offset,
+        [](std::uint64_t offset, const Chunk& c) { return offset < c.offset; }) - 1;
+    return {chunk->bytes.get() + (ref.offset - chunk->offset), ref.length};
+}
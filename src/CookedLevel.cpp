@@ -0,0 +1,400 @@
+#include "CookedLevel.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <sys/stat.h>
+
+namespace {
+
+const char Magic[8] = {'M', 'I', 'N', 'T', 'L', 'E', 'V', 'L'};
+const std::uint32_t Version = 1;
+
+const std::size_t HeaderBytes = 32;
+const std::size_t SectionEntryBytes = 24;
+const std::size_t Alignment = 64;
+
+enum class Section : std::uint32_t {
+    Map = 1, Strings = 2, Tilesets = 3, Layers = 4, Objects = 5, Tiles = 6
+};
+
+// Record sizes; strings are a u32 offset and a u32 length
+const std::size_t MapBytes = 8 + 4 * 4;
+const std::size_t TilesetBytes = 4 + 8 + 8 + 8 * 4;
+const std::size_t LayerBytes = 8 + 2 * 4 + 8;
+const std::size_t ObjectBytes = 4 + 8 + 8 + 4 * 4 + 4;
+
+[[noreturn]] void fail(const std::string& what)
+{
+    throw std::runtime_error{"cooked level: " + what};
+}
+
+std::size_t aligned(std::size_t offset)
+{
+    return (offset + Alignment - 1) / Alignment * Alignment;
+}
+
+//! Saving a map moments after cooking it must not leave the cooked level looking fresh
+std::int64_t modifiedNs(const struct stat& st)
+{
+#if defined(__APPLE__)
+    const timespec& t = st.st_mtimespec;
+#else
+    const timespec& t = st.st_mtim;
+#endif
+    return static_cast<std::int64_t>(t.tv_sec) * 1000000000 + t.tv_nsec;
+}
+
+bool hostIsLittleEndian()
+{
+    const std::uint32_t one = 1;
+    unsigned char first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+
+void put32(std::string& dst, std::uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) { dst.push_back(static_cast<char>(v >> (8 * i))); }
+}
+
+void put64(std::string& dst, std::uint64_t v)
+{
+    for (int i = 0; i < 8; ++i) { dst.push_back(static_cast<char>(v >> (8 * i))); }
+}
+
+void putFloat(std::string& dst, float f)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &f, sizeof bits);
+    put32(dst, bits);
+}
+
+//! Appends `s` to the string section and writes its reference to `dst`
+void putString(std::string& dst, std::string& strings, const std::string& s)
+{
+    put32(dst, static_cast<std::uint32_t>(strings.size()));
+    put32(dst, static_cast<std::uint32_t>(s.size()));
+    strings += s;
+}
+
+
+std::uint32_t get32(const unsigned char * p)
+{
+    return static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8
+        | static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+}
+
+std::uint64_t get64(const unsigned char * p)
+{
+    return static_cast<std::uint64_t>(get32(p)) | static_cast<std::uint64_t>(get32(p + 4)) << 32;
+}
+
+float getFloat(const unsigned char * p)
+{
+    const std::uint32_t bits = get32(p);
+    float f;
+    std::memcpy(&f, &bits, sizeof f);
+    return f;
+}
+
+
+//! A section's records, bounds-checked against the file when found
+struct SectionView {
+    const unsigned char * data = nullptr;
+    std::uint64_t bytes = 0;
+    std::uint32_t records = 0;
+} /*struct SectionView*/;
+
+//! Reads a cooked image of `size` bytes kept alive by `owner`
+class Parser {
+
+public:
+
+    Parser(std::shared_ptr<const unsigned char> owner, std::size_t size)
+      : m_owner{std::move(owner)}
+      , m_size{size}
+    {
+        const unsigned char * p = m_owner.get();
+        if (m_size < HeaderBytes || std::memcmp(p, Magic, sizeof Magic) != 0) {
+            fail("not a cooked level");
+        }
+        if (get32(p + 8) != Version) {
+            fail("version " + std::to_string(get32(p + 8)) + ", expected " + std::to_string(Version));
+        }
+        if (get64(p + 16) != m_size) {
+            fail("truncated");
+        }
+        const std::uint64_t count = get32(p + 12);
+        if (count > (m_size - HeaderBytes) / SectionEntryBytes) {
+            fail("bad section table");
+        }
+        for (std::uint64_t i = 0; i < count; ++i) {
+            const unsigned char * entry = p + HeaderBytes + i * SectionEntryBytes;
+            const std::uint32_t kind = get32(entry);
+            const std::uint64_t offset = get64(entry + 8), bytes = get64(entry + 16);
+            if (offset > m_size || bytes > m_size - offset) {
+                fail("section out of bounds");
+            }
+            if (kind == static_cast<std::uint32_t>(Section::Tiles) && offset % Alignment != 0) {
+                fail("tile section misaligned");
+            }
+            if (kind >= static_cast<std::uint32_t>(Section::Map) && kind <= static_cast<std::uint32_t>(Section::Tiles)) {
+                m_sections[kind] = {p + offset, bytes, get32(entry + 4)};
+            }
+        }
+    }
+
+    LevelMap parse()
+    {
+        LevelMap map{};
+        const SectionView& info = records(Section::Map, MapBytes);
+        if (info.records != 1) {
+            fail("expected one map record");
+        }
+        map.name = string(info.data);
+        map.size = {get32(info.data + 8), get32(info.data + 12)};
+        map.tileSize = {get32(info.data + 16), get32(info.data + 20)};
+
+        const SectionView& tilesets = records(Section::Tilesets, TilesetBytes);
+        map.tilesets.reserve(tilesets.records);
+        for (std::uint32_t i = 0; i < tilesets.records; ++i) {
+            const unsigned char * r = tilesets.data + i * TilesetBytes;
+            Tileset ts{};
+            ts.firstGid = get32(r);
+            ts.name = string(r + 4);
+            ts.image = string(r + 12);
+            ts.tileSize = {get32(r + 20), get32(r + 24)};
+            ts.imageSize = {get32(r + 28), get32(r + 32)};
+            ts.columns = get32(r + 36);
+            ts.tileCount = get32(r + 40);
+            ts.margin = get32(r + 44);
+            ts.spacing = get32(r + 48);
+            map.tilesets.push_back(std::move(ts));
+        }
+
+        const SectionView& layers = records(Section::Layers, LayerBytes);
+        const SectionView& tiles = section(Section::Tiles);
+        map.layers.reserve(layers.records);
+        for (std::uint32_t i = 0; i < layers.records; ++i) {
+            const unsigned char * r = layers.data + i * LayerBytes;
+            const sf::Vector2u size{get32(r + 8), get32(r + 12)};
+            const std::uint64_t offset = get64(r + 16);
+            const std::uint64_t count = static_cast<std::uint64_t>(size.x) * size.y;
+            if (offset % Alignment != 0 || offset > tiles.bytes || count > (tiles.bytes - offset) / 4) {
+                fail("layer out of bounds");
+            }
+            map.layers.emplace_back(string(r), size, gids(tiles.data + offset, count));
+        }
+
+        const SectionView& objects = records(Section::Objects, ObjectBytes);
+        map.objects.reserve(objects.records);
+        for (std::uint32_t i = 0; i < objects.records; ++i) {
+            const unsigned char * r = objects.data + i * ObjectBytes;
+            LevelObject obj{};
+            obj.id = get32(r);
+            obj.name = string(r + 4);
+            obj.type = string(r + 12);
+            obj.bounds = {getFloat(r + 20), getFloat(r + 24), getFloat(r + 28), getFloat(r + 32)};
+            obj.gid = get32(r + 36);
+            map.objects.push_back(std::move(obj));
+        }
+        map.indexObjects();
+        return map;
+    }
+
+private:
+
+    const SectionView& section(Section kind) const
+    {
+        return m_sections[static_cast<std::uint32_t>(kind)];
+    }
+
+    //! `kind`, checked to hold its records; absent sections have none
+    const SectionView& records(Section kind, std::size_t recordBytes) const
+    {
+        const SectionView& s = section(kind);
+        if (s.records > s.bytes / recordBytes) {
+            fail("section too small for its records");
+        }
+        return s;
+    }
+
+    std::string string(const unsigned char * ref) const
+    {
+        const SectionView& strings = section(Section::Strings);
+        const std::uint64_t offset = get32(ref), length = get32(ref + 4);
+        if (offset > strings.bytes || length > strings.bytes - offset) {
+            fail("string out of bounds");
+        }
+        return {reinterpret_cast<const char *>(strings.data + offset), static_cast<std::size_t>(length)};
+    }
+
+    //! A view of the image, or a swapped copy on big-endian hosts
+    std::shared_ptr<const std::uint32_t> gids(const unsigned char * p, std::uint64_t count) const
+    {
+        if (hostIsLittleEndian()) {
+            return {m_owner, reinterpret_cast<const std::uint32_t *>(p)};
+        }
+        auto copy = std::make_shared<std::vector<std::uint32_t>>(count);
+        for (std::uint64_t i = 0; i < count; ++i) { (*copy)[i] = get32(p + 4 * i); }
+        return {copy, copy->data()};
+    }
+
+    std::shared_ptr<const unsigned char>  m_owner;
+    std::size_t  m_size;
+    SectionView  m_sections[static_cast<std::uint32_t>(Section::Tiles) + 1];
+
+} /*class Parser*/;
+
+
+} /*namespace*/;
+
+
+void cookLevel(const LevelMap& map, std::ostream& dst)
+{
+    std::string strings;
+
+    std::string info;
+    putString(info, strings, map.name);
+    put32(info, map.size.x), put32(info, map.size.y);
+    put32(info, map.tileSize.x), put32(info, map.tileSize.y);
+
+    std::string tilesets;
+    for (const auto& ts : map.tilesets) {
+        put32(tilesets, ts.firstGid);
+        putString(tilesets, strings, ts.name);
+        putString(tilesets, strings, ts.image);
+        put32(tilesets, ts.tileSize.x), put32(tilesets, ts.tileSize.y);
+        put32(tilesets, ts.imageSize.x), put32(tilesets, ts.imageSize.y);
+        put32(tilesets, ts.columns), put32(tilesets, ts.tileCount);
+        put32(tilesets, ts.margin), put32(tilesets, ts.spacing);
+    }
+
+    std::string layers;
+    std::uint64_t tileBytes{0};
+    for (const auto& layer : map.layers) {
+        putString(layers, strings, layer.getName());
+        put32(layers, layer.getSize().x), put32(layers, layer.getSize().y);
+        put64(layers, tileBytes);
+        tileBytes = aligned(tileBytes + static_cast<std::uint64_t>(layer.getSize().x) * layer.getSize().y * 4);
+    }
+
+    std::string objects;
+    for (const auto& obj : map.objects) {
+        put32(objects, obj.id);
+        putString(objects, strings, obj.name);
+        putString(objects, strings, obj.type);
+        putFloat(objects, obj.bounds.left), putFloat(objects, obj.bounds.top);
+        putFloat(objects, obj.bounds.width), putFloat(objects, obj.bounds.height);
+        put32(objects, obj.gid);
+    }
+
+    struct Entry { Section kind; std::size_t records; const std::string * bytes; std::uint64_t size; };
+    const Entry entries[] = {
+        {Section::Map, 1, &info, info.size()},
+        {Section::Strings, 0, &strings, strings.size()},
+        {Section::Tilesets, map.tilesets.size(), &tilesets, tilesets.size()},
+        {Section::Layers, map.layers.size(), &layers, layers.size()},
+        {Section::Objects, map.objects.size(), &objects, objects.size()},
+        {Section::Tiles, 0, nullptr, tileBytes},
+    };
+
+    std::string head(Magic, sizeof Magic);
+    put32(head, Version);
+    put32(head, static_cast<std::uint32_t>(std::size(entries)));
+    std::uint64_t offset = aligned(HeaderBytes + std::size(entries) * SectionEntryBytes);
+    std::string table;
+    for (const auto& e : entries) {
+        put32(table, static_cast<std::uint32_t>(e.kind));
+        put32(table, static_cast<std::uint32_t>(e.records));
+        put64(table, offset);
+        put64(table, e.size);
+        offset = aligned(offset + e.size);
+    }
+    put64(head, offset);
+    put64(head, 0);
+
+    std::uint64_t written{0};
+    auto write = [&](const char * p, std::size_t n) { dst.write(p, static_cast<std::streamsize>(n)), written += n; };
+    auto pad = [&] {
+        static const char zeros[Alignment] = {};
+        write(zeros, aligned(written) - written);
+    };
+
+    write(head.data(), head.size());
+    write(table.data(), table.size());
+    for (const auto& e : entries) {
+        pad();
+        if (e.bytes) {
+            write(e.bytes->data(), e.bytes->size());
+            continue;
+        }
+        std::string swapped;
+        for (const auto& layer : map.layers) {
+            pad();
+            const std::size_t count = static_cast<std::size_t>(layer.getSize().x) * layer.getSize().y;
+            if (hostIsLittleEndian()) {
+                write(reinterpret_cast<const char *>(layer.data()), count * 4);
+            } else {
+                swapped.clear();
+                for (std::size_t i = 0; i < count; ++i) { put32(swapped, layer.data()[i]); }
+                write(swapped.data(), swapped.size());
+            }
+        }
+    }
+    pad();
+    if (!dst) {
+        throw std::runtime_error{"cooked level: write failed"};
+    }
+}
+
+LevelMap mapCookedLevel(const std::string& path)
+{
+    auto file = std::make_shared<MappedFile>(path);
+    const std::size_t size = file->size();
+    return Parser{std::shared_ptr<const unsigned char>{file, file->data()}, size}.parse();
+}
+
+LevelMap readCookedLevel(std::istream& src)
+{
+    auto bytes = std::make_shared<std::vector<unsigned char>>();
+    const auto start = src.tellg();
+    if (start != std::istream::pos_type(-1) && src.seekg(0, std::ios::end)) {
+        bytes->reserve(static_cast<std::size_t>(src.tellg() - start));
+        src.seekg(start);
+    }
+    src.clear();
+    // One read per chunk; streams which can not seek just grow the buffer
+    const std::size_t Chunk = 1 << 20;
+    do {
+        const std::size_t used = bytes->size();
+        bytes->resize(used + std::max(Chunk, bytes->capacity() - used));
+        src.read(reinterpret_cast<char *>(bytes->data() + used), static_cast<std::streamsize>(bytes->size() - used));
+        bytes->resize(used + static_cast<std::size_t>(src.gcount()));
+    } while (src && src.peek() != std::char_traits<char>::eof());
+    const std::size_t size = bytes->size();
+    return Parser{std::shared_ptr<const unsigned char>{bytes, bytes->data()}, size}.parse();
+}
+
+std::string cookedLevelPath(const std::string& source)
+{
+    const std::size_t slash = source.find_last_of("/\\");
+    const std::size_t dot = source.find_last_of('.');
+    const bool hasExtension = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+    return (hasExtension ? source.substr(0, dot) : source) + ".mlvl";
+}
+
+bool isCookedLevelFresh(const std::string& cooked, const std::string& source)
+{
+    struct stat cookedStat, sourceStat;
+    if (::stat(cooked.c_str(), &cookedStat) != 0) {
+        return false;
+    }
+    return ::stat(source.c_str(), &sourceStat) != 0 || modifiedNs(cookedStat) > modifiedNs(sourceStat);
+}
@@ -0,0 +1,253 @@
+#include "DebugDraw.h"
+#ifndef NDEBUG
+#include "TextLayout.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct Label {
+    sf::Vector2f at;
+    std::string utf8;
+    sf::Color color;
+} /*struct Label*/;
+
+//! One thread's pending shapes; only `flush` ever touches another thread's
+struct Buffer {
+    std::mutex mutex;
+    std::vector<sf::Vertex> lines;
+    std::vector<sf::Vertex> triangles;
+    std::vector<Label> labels;
+} /*struct Buffer*/;
+
+//! What one flush draws; kept between flushes so their storage is reused
+struct Scratch {
+    std::vector<sf::Vertex> lines, triangles, glyphs;
+    const sf::Texture * glyphPage = nullptr;
+} /*struct Scratch*/;
+
+struct Registry {
+    std::mutex mutex;
+    //! A buffer whose thread has exited is only held here, and is dropped once drained
+    std::vector<std::shared_ptr<Buffer>> buffers;
+    const sf::Font * font = nullptr;
+    unsigned int fontSize = 12;
+    DebugDraw::Stats stats;
+    Scratch scratch;
+} /*struct Registry*/;
+
+Registry& registry()
+{
+    static Registry r{};
+    return r;
+}
+
+Buffer& local()
+{
+    thread_local std::shared_ptr<Buffer> buffer = [] {
+        auto b = std::make_shared<Buffer>();
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock{r.mutex};
+        r.buffers.push_back(b);
+        return b;
+    }();
+    return *buffer;
+}
+
+//! The canvas of the calling thread's innermost `Scope`, if any
+DebugDraw::Canvas *& scoped()
+{
+    thread_local DebugDraw::Canvas * canvas = nullptr;
+    return canvas;
+}
+
+Buffer& target(Buffer * canvas)
+{
+    return canvas ? *canvas : local();
+}
+
+//! Moves `buffer`'s shapes into `out`, laying out labels with `r`'s font
+void gather(Registry& r, Buffer& buffer, Scratch& out)
+{
+    std::lock_guard<std::mutex> hold{buffer.mutex};
+    out.lines.insert(out.lines.end(), buffer.lines.begin(), buffer.lines.end());
+    out.triangles.insert(out.triangles.end(), buffer.triangles.begin(), buffer.triangles.end());
+    for (const auto& l : buffer.labels) {
+        if (!r.font) {
+            break;
+        }
+        GlyphRun run = layoutText(l.utf8, *r.font, r.fontSize, 0.f, l.color);
+        for (auto& v : run.vertices) { v.position += l.at; }
+        out.glyphs.insert(out.glyphs.end(), run.vertices.begin(), run.vertices.end());
+        out.glyphPage = run.texture;
+        ++r.stats.labels;
+    }
+    buffer.lines.clear(), buffer.triangles.clear(), buffer.labels.clear();
+}
+
+//! Moves every thread's shapes into `out`, dropping the buffers of threads which have exited
+void gatherShared(Registry& r, Scratch& out)
+{
+    for (const auto& buffer : r.buffers) {
+        gather(r, *buffer, out);
+    }
+    r.buffers.erase(std::remove_if(r.buffers.begin(), r.buffers.end()
+        , [](const std::shared_ptr<Buffer>& b) { return b.use_count() == 1; }), r.buffers.end());
+}
+
+//! Draws everything gathered into `in` and empties it
+void draw(Registry& r, Scratch& in, RenderDevice& device, const sf::RenderStates& states)
+{
+    if (!in.triangles.empty()) {
+        device.draw(in.triangles.data(), in.triangles.size(), sf::Triangles, states);
+        ++r.stats.draws;
+    }
+    if (!in.lines.empty()) {
+        device.draw(in.lines.data(), in.lines.size(), sf::Lines, states);
+        ++r.stats.draws;
+    }
+    if (!in.glyphs.empty()) {
+        sf::RenderStates text{states};
+        text.texture = in.glyphPage;
+        device.draw(in.glyphs.data(), in.glyphs.size(), sf::Triangles, text);
+        ++r.stats.draws;
+    }
+    r.stats.lines = in.lines.size() / 2;
+    r.stats.triangles = in.triangles.size() / 3;
+    in.lines.clear(), in.triangles.clear(), in.glyphs.clear();
+    in.glyphPage = nullptr;
+}
+
+//! Segments per circle, enough to look round at typical debug sizes
+const int CircleSegments = 24;
+
+} /*namespace*/;
+
+
+//! A canvas is one buffer, which every thread in its scope shares
+struct DebugDraw::Canvas::Impl : public Buffer {
+    Scratch scratch;
+} /*struct DebugDraw::Canvas::Impl*/;
+
+
+void DebugDraw::line(sf::Vector2f from, sf::Vector2f to, sf::Color color)
+{
+    Buffer& b = target(scoped() ? scoped()->m_impl.get() : nullptr);
+    std::lock_guard<std::mutex> lock{b.mutex};
+    b.lines.emplace_back(from, color);
+    b.lines.emplace_back(to, color);
+}
+
+void DebugDraw::box(const sf::FloatRect& rect, sf::Color color, bool filled)
+{
+    const sf::Vector2f c[4] = {
+        {rect.left, rect.top}, {rect.left + rect.width, rect.top}
+      , {rect.left + rect.width, rect.top + rect.height}, {rect.left, rect.top + rect.height}
+    };
+    Buffer& b = target(scoped() ? scoped()->m_impl.get() : nullptr);
+    std::lock_guard<std::mutex> lock{b.mutex};
+    if (filled) {
+        for (const int i : {0, 1, 2, 0, 2, 3}) { b.triangles.emplace_back(c[i], color); }
+        return;
+    }
+    for (int i = 0; i < 4; ++i) {
+        b.lines.emplace_back(c[i], color);
+        b.lines.emplace_back(c[(i + 1) % 4], color);
+    }
+}
+
+void DebugDraw::circle(sf::Vector2f center, float radius, sf::Color color, bool filled)
+{
+    sf::Vector2f rim[CircleSegments + 1];
+    for (int i = 0; i <= CircleSegments; ++i) {
+        const float a = 6.2831853f * i / CircleSegments;
+        rim[i] = center + sf::Vector2f{std::cos(a), std::sin(a)} * radius;
+    }
+    Buffer& b = target(scoped() ? scoped()->m_impl.get() : nullptr);
+    std::lock_guard<std::mutex> lock{b.mutex};
+    std::vector<sf::Vertex>& out = filled ? b.triangles : b.lines;
+    for (int i = 0; i < CircleSegments; ++i) {
+        if (filled) {
+            out.emplace_back(center, color);
+        }
+        out.emplace_back(rim[i], color);
+        out.emplace_back(rim[i + 1], color);
+    }
+}
+
+void DebugDraw::label(sf::Vector2f at, const std::string& utf8, sf::Color color)
+{
+    Buffer& b = target(scoped() ? scoped()->m_impl.get() : nullptr);
+    std::lock_guard<std::mutex> lock{b.mutex};
+    b.labels.push_back(Label{at, utf8, color});
+}
+
+void DebugDraw::setFont(const sf::Font * font, unsigned int size)
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    r.font = font;
+    r.fontSize = size;
+}
+
+void DebugDraw::flush(RenderDevice& device, const sf::RenderStates& states)
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    r.stats = {};
+    gatherShared(r, r.scratch);
+    draw(r, r.scratch, device, states);
+}
+
+DebugDraw::Stats DebugDraw::getStats()
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    return r.stats;
+}
+
+
+DebugDraw::Canvas::Canvas() : m_impl{std::make_unique<Impl>()}
+{
+}
+
+DebugDraw::Canvas::~Canvas()
+{
+}
+
+void DebugDraw::Canvas::flush(RenderDevice& device, const sf::RenderStates& states)
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    r.stats = {};
+    gatherShared(r, m_impl->scratch);
+    gather(r, *m_impl, m_impl->scratch);
+    draw(r, m_impl->scratch, device, states);
+}
+
+void DebugDraw::Canvas::discard()
+{
+    std::lock_guard<std::mutex> lock{m_impl->mutex};
+    m_impl->lines.clear(), m_impl->triangles.clear(), m_impl->labels.clear();
+}
+
+std::size_t DebugDraw::Canvas::getPending() const
+{
+    std::lock_guard<std::mutex> lock{m_impl->mutex};
+    return m_impl->lines.size() + m_impl->triangles.size() + m_impl->labels.size();
+}
+
+
+DebugDraw::Scope::Scope(Canvas& canvas) : m_previous{scoped()}
+{
+    scoped() = &canvas;
+}
+
+DebugDraw::Scope::~Scope()
+{
+    scoped() = m_previous;
+}
+#endif
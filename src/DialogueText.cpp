@@ -0,0 +1,94 @@
+#include "DialogueText.h"
+#include "CommandList.h"
+#include <algorithm>
+
+DialogueText::DialogueText(TextLayoutCache& cache, const sf::Font& font, unsigned int size, float wrapWidth)
+  : m_cache{cache}
+  , m_font{font}
+  , m_size{size}
+  , m_wrapWidth{wrapWidth}
+{
+}
+
+void DialogueText::setString(std::string_view utf8)
+{
+    m_string.assign(utf8.data(), utf8.size());
+    m_revealed = 0.f;
+    relayout();
+}
+
+void DialogueText::setColor(sf::Color color)
+{
+    m_color = color;
+    relayout();
+}
+
+void DialogueText::setRevealRate(float charactersPerSecond)
+{
+    m_revealRate = charactersPerSecond;
+}
+
+void DialogueText::skipReveal()
+{
+    m_revealed = static_cast<float>(getCharacterCount());
+}
+
+bool DialogueText::isRevealed() const
+{
+    return getRevealedCount() == getCharacterCount();
+}
+
+std::size_t DialogueText::getCharacterCount() const
+{
+    return m_run ? m_run->revealed.size() : 0;
+}
+
+std::size_t DialogueText::getRevealedCount() const
+{
+    if (m_revealRate <= 0.f) {
+        return getCharacterCount();
+    }
+    return std::min(static_cast<std::size_t>(m_revealed), getCharacterCount());
+}
+
+void DialogueText::update(float dt)
+{
+    if (m_revealRate > 0.f && !isRevealed()) {
+        m_revealed += m_revealRate * dt;
+    }
+}
+
+std::optional<sf::FloatRect> DialogueText::getLocalBounds() const
+{
+    if (!m_run) {
+        return std::nullopt;
+    }
+    return m_run->bounds;
+}
+
+void DialogueText::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    const std::size_t count = m_run ? m_run->vertexCount(getRevealedCount()) : 0;
+    if (count == 0) {
+        return;
+    }
+    states.transform *= getTransform();
+    states.texture = m_run->texture;
+    target.draw(m_run->vertices.data(), count, sf::Triangles, states);
+}
+
+void DialogueText::record(CommandList& list, sf::RenderStates states) const
+{
+    const std::size_t count = m_run ? m_run->vertexCount(getRevealedCount()) : 0;
+    if (count == 0) {
+        return;
+    }
+    states.transform *= getTransform();
+    states.texture = m_run->texture;
+    list.vertices(SortKey::make(getLayer(), getDepth(), states.texture, states.blendMode), m_run->vertices.data(), count, sf::Triangles, states);
+}
+
+void DialogueText::relayout()
+{
+    m_run = m_cache.get(m_string, m_font, m_size, m_wrapWidth, m_color);
+}
@@ -0,0 +1,302 @@
+#include "DrawCapture.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const char Magic[8] = {'M', 'I', 'N', 'T', 'D', 'R', 'A', 'W'};
+const std::uint64_t Version = 2;
+
+//! The 3x3 affine part of SFML's 4x4 column-major matrix
+const int AffineCells[9] = {0, 4, 12, 1, 5, 13, 3, 7, 15};
+
+
+void putByte(std::string& dst, std::uint8_t b)
+{
+    dst.push_back(static_cast<char>(b));
+}
+
+void putVarint(std::string& dst, std::uint64_t v)
+{
+    while (v >= 0x80) {
+        putByte(dst, static_cast<std::uint8_t>(v) | 0x80);
+        v >>= 7;
+    }
+    putByte(dst, static_cast<std::uint8_t>(v));
+}
+
+void putFixed(std::string& dst, std::uint64_t v, int bytes)
+{
+    for (int i = 0; i < bytes; ++i) { putByte(dst, static_cast<std::uint8_t>(v >> (8 * i))); }
+}
+
+void putFloat(std::string& dst, float f)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &f, sizeof bits);
+    putFixed(dst, bits, 4);
+}
+
+void putVertex(std::string& dst, const sf::Vertex& v)
+{
+    putFloat(dst, v.position.x), putFloat(dst, v.position.y);
+    putByte(dst, v.color.r), putByte(dst, v.color.g), putByte(dst, v.color.b), putByte(dst, v.color.a);
+    putFloat(dst, v.texCoords.x), putFloat(dst, v.texCoords.y);
+}
+
+void putBlend(std::string& dst, const sf::BlendMode& blend)
+{
+    putByte(dst, static_cast<std::uint8_t>(blend.colorSrcFactor));
+    putByte(dst, static_cast<std::uint8_t>(blend.colorDstFactor));
+    putByte(dst, static_cast<std::uint8_t>(blend.colorEquation));
+    putByte(dst, static_cast<std::uint8_t>(blend.alphaSrcFactor));
+    putByte(dst, static_cast<std::uint8_t>(blend.alphaDstFactor));
+    putByte(dst, static_cast<std::uint8_t>(blend.alphaEquation));
+}
+
+
+std::uint8_t getByte(std::istream& src)
+{
+    const auto c = src.get();
+    if (c == std::char_traits<char>::eof()) {
+        throw std::runtime_error{"draw capture is truncated"};
+    }
+    return static_cast<std::uint8_t>(c);
+}
+
+std::uint64_t getVarint(std::istream& src)
+{
+    std::uint64_t v{0};
+    for (int shift = 0; shift < 64; shift += 7) {
+        const std::uint8_t b = getByte(src);
+        v |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+        if (!(b & 0x80)) { return v; }
+    }
+    throw std::runtime_error{"draw capture has a malformed varint"};
+}
+
+std::uint64_t getFixed(std::istream& src, int bytes)
+{
+    std::uint64_t v{0};
+    for (int i = 0; i < bytes; ++i) { v |= static_cast<std::uint64_t>(getByte(src)) << (8 * i); }
+    return v;
+}
+
+float getFloat(std::istream& src)
+{
+    const std::uint32_t bits = static_cast<std::uint32_t>(getFixed(src, 4));
+    float f;
+    std::memcpy(&f, &bits, sizeof f);
+    return f;
+}
+
+sf::Vertex getVertex(std::istream& src)
+{
+    sf::Vertex v{};
+    v.position.x = getFloat(src), v.position.y = getFloat(src);
+    v.color.r = getByte(src), v.color.g = getByte(src), v.color.b = getByte(src), v.color.a = getByte(src);
+    v.texCoords.x = getFloat(src), v.texCoords.y = getFloat(src);
+    return v;
+}
+
+template<typename E>
+E getEnum(std::istream& src, int count)
+{
+    const std::uint8_t b = getByte(src);
+    if (b >= count) {
+        throw std::runtime_error{"draw capture has an unknown enumerator"};
+    }
+    return static_cast<E>(b);
+}
+
+sf::BlendMode getBlend(std::istream& src)
+{
+    sf::BlendMode blend{};
+    blend.colorSrcFactor = getEnum<sf::BlendMode::Factor>(src, 10);
+    blend.colorDstFactor = getEnum<sf::BlendMode::Factor>(src, 10);
+    blend.colorEquation = getEnum<sf::BlendMode::Equation>(src, 3);
+    blend.alphaSrcFactor = getEnum<sf::BlendMode::Factor>(src, 10);
+    blend.alphaDstFactor = getEnum<sf::BlendMode::Factor>(src, 10);
+    blend.alphaEquation = getEnum<sf::BlendMode::Equation>(src, 3);
+    return blend;
+}
+
+} /*namespace*/;
+
+
+DrawRecorder::DrawRecorder(std::ostream& dst) : m_dst{dst}
+{
+    std::string header{Magic, sizeof Magic};
+    putVarint(header, Version);
+    m_dst.write(header.data(), static_cast<std::streamsize>(header.size()));
+}
+
+void DrawRecorder::recordFrame(const CommandList& list, const sf::View& view)
+{
+    std::string commands;
+    std::string textures;
+    std::size_t newTextures{0};
+    std::size_t count{0};
+
+    auto textureId = [&](const sf::Texture * texture) -> std::uint64_t {
+        if (!texture) {
+            return 0;
+        }
+        const auto inserted = m_textures.emplace(texture, static_cast<std::uint32_t>(m_textures.size()));
+        if (inserted.second) {
+            putVarint(textures, texture->getSize().x), putVarint(textures, texture->getSize().y);
+            ++newTextures;
+        }
+        return inserted.first->second + 1;
+    };
+
+    list.forEach([&](std::uint64_t key, const RenderCommand& cmd) {
+        if (cmd.kind == RenderCommand::Kind::Drawable) {
+            ++m_skipped;
+            return;
+        }
+        ++count;
+        putFixed(commands, key, 8);
+        // Untagged commands are stored as 0, so the usual tags stay one byte
+        putVarint(commands, cmd.source == CommandList::NoSource ? 0 : std::uint64_t{cmd.source} + 1);
+        putByte(commands, static_cast<std::uint8_t>(cmd.kind));
+        if (cmd.kind == RenderCommand::Kind::Quad) {
+            putBlend(commands, SortKey::blendMode(cmd.blend));
+            putVarint(commands, textureId(cmd.texture));
+            for (int i = 0; i < 4; ++i) { putVertex(commands, cmd.vertices[i]); }
+            return;
+        }
+        putBlend(commands, cmd.states->blendMode);
+        putVarint(commands, textureId(cmd.texture));
+        putByte(commands, static_cast<std::uint8_t>(cmd.primitive));
+        const float * matrix = cmd.states->transform.getMatrix();
+        for (const int cell : AffineCells) { putFloat(commands, matrix[cell]); }
+        putVarint(commands, cmd.count);
+        for (std::uint32_t i = 0; i < cmd.count; ++i) { putVertex(commands, cmd.vertices[i]); }
+    });
+
+    m_frame.clear();
+    putFloat(m_frame, view.getCenter().x), putFloat(m_frame, view.getCenter().y);
+    putFloat(m_frame, view.getSize().x), putFloat(m_frame, view.getSize().y);
+    putFloat(m_frame, view.getRotation());
+    const sf::FloatRect& port = view.getViewport();
+    putFloat(m_frame, port.left), putFloat(m_frame, port.top), putFloat(m_frame, port.width), putFloat(m_frame, port.height);
+    putVarint(m_frame, newTextures);
+    m_frame += textures;
+    putVarint(m_frame, count);
+    m_frame += commands;
+    m_dst.write(m_frame.data(), static_cast<std::streamsize>(m_frame.size()));
+    ++m_frames;
+}
+
+std::size_t DrawRecorder::getFrameCount() const
+{
+    return m_frames;
+}
+
+std::size_t DrawRecorder::getSkippedDrawables() const
+{
+    return m_skipped;
+}
+
+
+void DrawFrame::record(CommandList& list) const
+{
+    for (const auto& c : m_commands) {
+        list.setSource(c.source);
+        if (c.kind == RenderCommand::Kind::Quad) {
+            list.quad(c.key, c.texture, c.blend, *reinterpret_cast<const sf::Vertex (*)[4]>(&m_vertices[c.first]));
+            continue;
+        }
+        sf::RenderStates states{c.blend, c.transform, c.texture, nullptr};
+        list.vertices(c.key, &m_vertices[c.first], c.count, c.primitive, states);
+    }
+    list.setSource(CommandList::NoSource);
+}
+
+const sf::View& DrawFrame::getView() const
+{
+    return m_view;
+}
+
+std::size_t DrawFrame::size() const
+{
+    return m_commands.size();
+}
+
+
+DrawReplayer::DrawReplayer(std::istream& src) : m_src{src}
+{
+    char magic[sizeof Magic];
+    if (!m_src.read(magic, sizeof magic) || std::memcmp(magic, Magic, sizeof Magic) != 0) {
+        throw std::runtime_error{"not a draw capture"};
+    }
+    if (getVarint(m_src) != Version) {
+        throw std::runtime_error{"unsupported draw capture version"};
+    }
+}
+
+bool DrawReplayer::nextFrame(DrawFrame& frame)
+{
+    if (m_src.peek() == std::char_traits<char>::eof()) {
+        return false;
+    }
+
+    const float cx = getFloat(m_src), cy = getFloat(m_src);
+    const float w = getFloat(m_src), h = getFloat(m_src);
+    frame.m_view = sf::View{{cx, cy}, {w, h}};
+    frame.m_view.setRotation(getFloat(m_src));
+    sf::FloatRect port{};
+    port.left = getFloat(m_src), port.top = getFloat(m_src), port.width = getFloat(m_src), port.height = getFloat(m_src);
+    frame.m_view.setViewport(port);
+
+    for (std::uint64_t n = getVarint(m_src); n > 0; --n) {
+        const auto x = static_cast<unsigned int>(getVarint(m_src));
+        const auto y = static_cast<unsigned int>(getVarint(m_src));
+        m_sizes.emplace_back(x, y);
+        m_textures.emplace_back();
+    }
+
+    frame.m_commands.clear();
+    frame.m_vertices.clear();
+    for (std::uint64_t n = getVarint(m_src); n > 0; --n) {
+        DrawFrame::Command c{};
+        c.key = getFixed(m_src, 8);
+        const std::uint64_t source = getVarint(m_src);
+        if (source > CommandList::NoSource) {
+            throw std::runtime_error{"draw capture has an out-of-range source"};
+        }
+        c.source = source == 0 ? CommandList::NoSource : static_cast<std::uint32_t>(source - 1);
+        c.kind = getEnum<RenderCommand::Kind>(m_src, 2);
+        c.blend = getBlend(m_src);
+        const std::uint64_t texture = getVarint(m_src);
+        if (texture > m_textures.size()) {
+            throw std::runtime_error{"draw capture refers to an undeclared texture"};
+        }
+        c.texture = texture ? &m_textures[texture - 1] : nullptr;
+        c.first = frame.m_vertices.size();
+        if (c.kind == RenderCommand::Kind::Quad) {
+            c.primitive = sf::Quads;
+            c.count = 4;
+        } else {
+            c.primitive = getEnum<sf::PrimitiveType>(m_src, sf::Quads + 1);
+            float m[9];
+            for (auto& cell : m) { cell = getFloat(m_src); }
+            c.transform = sf::Transform{m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8]};
+            c.count = getVarint(m_src);
+        }
+        for (std::size_t i = 0; i < c.count; ++i) { frame.m_vertices.push_back(getVertex(m_src)); }
+        frame.m_commands.push_back(c);
+    }
+    return true;
+}
+
+sf::Texture& DrawReplayer::getTexture(std::size_t index)
+{
+    return m_textures.at(index);
+}
+
+const std::vector<sf::Vector2u>& DrawReplayer::getTextureSizes() const
+{
+    return m_sizes;
+}
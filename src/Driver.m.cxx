@@ -1,7 +1,18 @@
+#include "CookedLevel.h"
 #include "GameContext.h"
 #include "GameWorld.h"
+#include "InputLog.h"
+#include "StartupReport.h"
+#include "TiledLoader.h"
+#include "WorkerPool.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <exception>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <SFML/Graphics.hpp>
@@ -9,9 +20,97 @@
 
 int main(int argc, char ** argv)
 {
+    StartupReport startup{};
+
+    // --record FILE  writes every polled event and frame dt to FILE
+    // --replay FILE  replays FILE headlessly, printing timing and state hashes
+    // --realtime     paces a replay by its recorded dt instead of running flat out
+    // --headless     runs without a window, as fast as possible, and reports ticks/s
+    // --ticks N      stops a headless run after N ticks
+    // --seconds S    stops a headless run after S seconds of wall-clock time
+    // --cook MAP     writes MAP's cooked sibling, see cookedLevelPath, and exits; repeatable
+    // --equipment FILE, --level FILE, --conversations FILE
+    //                loads FILE, in parallel with the others; repeatable, merged in order
+    // --startup      prints where startup time went, per phase and per file
+    const char * recordPath{nullptr};
+    const char * replayPath{nullptr};
+    bool realTime{false};
+    bool headless{false};
+    std::size_t ticks{0};
+    float seconds{0};
+    std::vector<std::string> cook;
+    std::vector<GameContext::Source> sources;
+    bool startupReport{false};
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--record") && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (!std::strcmp(argv[i], "--replay") && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (!std::strcmp(argv[i], "--realtime")) {
+            realTime = true;
+        } else if (!std::strcmp(argv[i], "--headless")) {
+            headless = true;
+        } else if (!std::strcmp(argv[i], "--ticks") && i + 1 < argc) {
+            headless = true, ticks = std::strtoull(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            headless = true, seconds = std::strtof(argv[++i], nullptr);
+        } else if (!std::strcmp(argv[i], "--cook") && i + 1 < argc) {
+            cook.push_back(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--equipment") && i + 1 < argc) {
+            sources.push_back({GameContext::DataType::EquipmentData, argv[++i]});
+        } else if (!std::strcmp(argv[i], "--level") && i + 1 < argc) {
+            sources.push_back({GameContext::DataType::LevelMap, argv[++i]});
+        } else if (!std::strcmp(argv[i], "--conversations") && i + 1 < argc) {
+            sources.push_back({GameContext::DataType::Conversation, argv[++i]});
+        } else if (!std::strcmp(argv[i], "--startup")) {
+            startupReport = true;
+        } else {
+            std::cerr << "Unknown argument: " << argv[i] << '\n';
+            return 1;
+        }
+    }
+
+    if (!cook.empty()) {
+        try {
+            for (const auto& path : cook) {
+                const LevelMap map = readTiledFile(path);
+                const std::string cooked = cookedLevelPath(path);
+                // Written aside and renamed, so a running game never maps a half-written file
+                const std::string partial = cooked + ".partial";
+                {
+                    std::ofstream dst{partial, std::ios::binary};
+                    if (!dst) { throw std::runtime_error{"Could not open " + partial}; }
+                    // Checked once closed, so a failed final flush is caught too
+                    try {
+                        cookLevel(map, dst);
+                        dst.close();
+                    } catch (std::exception&) {
+                        dst.setstate(std::ios::failbit);
+                    }
+                    if (!dst) {
+                        dst.close();
+                        std::remove(partial.c_str());
+                        throw std::runtime_error{"Could not write " + partial};
+                    }
+                }
+                if (std::rename(partial.c_str(), cooked.c_str()) != 0) {
+                    throw std::runtime_error{"Could not write " + cooked};
+                }
+                std::cout << path << " -> " << cooked << '\n';
+            }
+        } catch (std::exception& ex) {
+            std::cerr << "Could not cook level: \n" << ex.what() << '\n';
+            return 1;
+        }
+        return 0;
+    }
+
+    // Outlives loading, since conversations are still compiling on it afterwards
+    WorkerPool pool{};
     GameContext context{};
+    context.setStartupReport(&startup);
     try {
-        // TODO
+        context.loadFiles(sources, pool);
 
     } catch (std::exception& ex) {
         std::cerr << "Could not initialize context: \n" << ex.what() << '\n';
@@ -21,6 +120,7 @@ int main(int argc, char ** argv)
     GameSettings settings{};
     try {
         settings = context.generateSettings();
+        settings.setHeadless(headless || replayPath != nullptr);
 
     } catch (std::exception& ex) {
         std::cerr << "Could not generate settings: \n" << ex.what() << '\n';
@@ -29,15 +129,45 @@ int main(int argc, char ** argv)
 
     sf::Clock timer{};
     try {
+        const sf::Time building = startup.now();
         GameWorld world{context, settings};
-        world.run(); 
+        startup.add({"world", "", 0, building, startup.now() - building});
+        world.setStartupReport(&startup);
+        if (replayPath) {
+            std::ifstream src{replayPath, std::ios::binary};
+            if (!src) { throw std::runtime_error{std::string{"Could not open "} + replayPath}; }
+            InputReplayer replayer{src};
+            world.replay(replayer, realTime, std::cout);
+
+        } else if (headless) {
+            const float dt = settings.getFixedTimestep().asSeconds();
+            const auto report = seconds > 0
+                ? world.runFor(sf::seconds(seconds), dt)
+                : world.runTicks(ticks ? ticks : 3600, dt);
+            std::cout << report.ticks << " ticks in " << report.elapsed.asMilliseconds() << "ms, "
+                << report.ticksPerSecond() << " ticks/s, worst tick "
+                << report.worstTick.asMicroseconds() << "us\n";
+
+        } else {
+            std::ofstream dst{};
+            std::unique_ptr<InputRecorder> recorder{};
+            if (recordPath) {
+                dst.open(recordPath, std::ios::binary);
+                if (!dst) { throw std::runtime_error{std::string{"Could not open "} + recordPath}; }
+                recorder = std::make_unique<InputRecorder>(dst);
+                world.setRecorder(recorder.get());
+            }
+            world.run(); 
+        }
 
     } catch (std::exception& ex) {
         std::cerr << "Unhandled exception!!\n" << ex.what() << '\n';
         return 1;
     }
 
+    if (startupReport) {
+        startup.print(std::cout);
+    }
     std::cout << timer.getElapsedTime().asMilliseconds() << "ms\n";
     return 0;
 }
-
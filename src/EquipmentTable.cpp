@@ -0,0 +1,330 @@
+#include "EquipmentTable.h"
+#include "JsonReader.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const char * ColumnNames[] = {"level", "price", "hpMax", "mpMax", "att", "def", "mag", "magdef", "spd"};
+const char * SlotNames[] = {"weapon", "head", "body", "hands", "feet", "accessory"};
+
+//! Eight bytes a round; names are short, so fnv1a's byte loop would dominate a lookup
+std::uint64_t nameHash(std::string_view name)
+{
+    std::uint64_t hash = name.size();
+    std::size_t i{0};
+    for (; i + 8 <= name.size(); i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, name.data() + i, sizeof word);
+        hash = PerfectHash::mix(hash ^ word);
+    }
+    std::uint64_t tail{0};
+    if (i < name.size()) { std::memcpy(&tail, name.data() + i, name.size() - i); }
+    return PerfectHash::mix(hash ^ tail);
+}
+
+//! Bit `i` set if `min <= values[i] <= max`, for the first `n` (at most 64) values
+std::uint64_t rangeMask(const std::int32_t * values, std::size_t n, std::int32_t min, std::int32_t max)
+{
+    std::uint64_t mask{0};
+    std::size_t i{0};
+#if defined(__AVX2__)
+    const __m256i lo = _mm256_set1_epi32(min), hi = _mm256_set1_epi32(max);
+    for (; i + 8 <= n; i += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+        const __m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(lo, v), _mm256_cmpgt_epi32(v, hi));
+        mask |= static_cast<std::uint64_t>(~_mm256_movemask_ps(_mm256_castsi256_ps(out)) & 0xff) << i;
+    }
+#elif defined(__SSE2__)
+    const __m128i lo = _mm_set1_epi32(min), hi = _mm_set1_epi32(max);
+    for (; i + 4 <= n; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+        const __m128i out = _mm_or_si128(_mm_cmpgt_epi32(lo, v), _mm_cmpgt_epi32(v, hi));
+        mask |= static_cast<std::uint64_t>(~_mm_movemask_ps(_mm_castsi128_ps(out)) & 0xf) << i;
+    }
+#endif
+    // The scalar loop handles the tail, and everything on other targets
+    for (; i < n; ++i) {
+        mask |= static_cast<std::uint64_t>(values[i] >= min && values[i] <= max) << i;
+    }
+    return mask;
+}
+
+//! Bit `i` set if `bits[i]` shares a bit with `set`, for the first `n` (at most 64) rows
+std::uint64_t slotMask(const std::uint8_t * bits, std::size_t n, std::uint8_t set)
+{
+    std::uint64_t mask{0};
+    std::size_t i{0};
+#if defined(__AVX2__)
+    const __m256i want = _mm256_set1_epi8(static_cast<char>(set)), zero = _mm256_setzero_si256();
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bits + i));
+        const __m256i none = _mm256_cmpeq_epi8(_mm256_and_si256(v, want), zero);
+        mask |= static_cast<std::uint64_t>(~static_cast<std::uint32_t>(_mm256_movemask_epi8(none))) << i;
+    }
+#elif defined(__SSE2__)
+    const __m128i want = _mm_set1_epi8(static_cast<char>(set)), zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bits + i));
+        const __m128i none = _mm_cmpeq_epi8(_mm_and_si128(v, want), zero);
+        mask |= static_cast<std::uint64_t>(~_mm_movemask_epi8(none) & 0xffff) << i;
+    }
+#endif
+    for (; i < n; ++i) {
+        mask |= static_cast<std::uint64_t>((bits[i] & set) != 0) << i;
+    }
+    return mask;
+}
+
+unsigned int countTrailingZeros(std::uint64_t mask)
+{
+    return static_cast<unsigned int>(__builtin_ctzll(mask));
+}
+
+unsigned int popCount(std::uint64_t mask)
+{
+    return static_cast<unsigned int>(__builtin_popcountll(mask));
+}
+
+} /*namespace*/;
+
+
+EquipmentTable::Query::Query()
+{
+    m_min.fill(std::numeric_limits<std::int32_t>::min());
+    m_max.fill(std::numeric_limits<std::int32_t>::max());
+}
+
+EquipmentTable::Query& EquipmentTable::Query::slot(Slot slot)
+{
+    m_slots |= static_cast<std::uint8_t>(1u << static_cast<unsigned int>(slot));
+    return *this;
+}
+
+EquipmentTable::Query& EquipmentTable::Query::atLeast(Column column, std::int32_t min)
+{
+    const auto c = static_cast<std::size_t>(column);
+    m_min[c] = std::max(m_min[c], min);
+    m_constrained |= 1u << c;
+    return *this;
+}
+
+EquipmentTable::Query& EquipmentTable::Query::atMost(Column column, std::int32_t max)
+{
+    const auto c = static_cast<std::size_t>(column);
+    m_max[c] = std::min(m_max[c], max);
+    m_constrained |= 1u << c;
+    return *this;
+}
+
+
+EquipmentTable::EquipmentTable() : m_nameOffsets(1, 0u)
+{
+}
+
+EquipmentTable::EquipmentTable(const std::vector<Item>& items)
+{
+    const std::size_t n = items.size();
+    m_ids.reserve(n), m_slotBits.reserve(n), m_nameOffsets.reserve(n + 1);
+    for (auto& column : m_columns) { column.reserve(n); }
+
+    std::vector<std::uint64_t> idHashes, nameHashes;
+    idHashes.reserve(n), nameHashes.reserve(n);
+    m_nameOffsets.push_back(0);
+    for (const Item& item : items) {
+        m_ids.push_back(item.id);
+        m_names += item.name;
+        m_nameOffsets.push_back(static_cast<std::uint32_t>(m_names.size()));
+        m_slotBits.push_back(static_cast<std::uint8_t>(1u << static_cast<unsigned int>(item.slot)));
+        for (std::size_t c = 0; c < ColumnCount; ++c) { m_columns[c].push_back(item.stats[c]); }
+        idHashes.push_back(item.id);
+        nameHashes.push_back(nameHash(item.name));
+    }
+
+    try {
+        m_idHash = PerfectHash{idHashes};
+    } catch (const std::invalid_argument&) {
+        throw std::invalid_argument{"equipment: duplicate item ids"};
+    }
+    try {
+        m_nameHash = PerfectHash{nameHashes};
+    } catch (const std::invalid_argument&) {
+        throw std::invalid_argument{"equipment: duplicate item names"};
+    }
+    m_idRows.assign(m_idHash.getSlotCount(), NoRow);
+    m_nameRows.assign(m_nameHash.getSlotCount(), NoRow);
+    for (std::uint32_t row = 0; row < n; ++row) {
+        m_idRows[m_idHash.slot(idHashes[row])] = row;
+        m_nameRows[m_nameHash.slot(nameHashes[row])] = row;
+    }
+}
+
+std::size_t EquipmentTable::size() const
+{
+    return m_ids.size();
+}
+
+std::uint32_t EquipmentTable::findId(std::uint32_t id) const
+{
+    if (m_idRows.empty()) {
+        return NoRow;
+    }
+    const std::uint32_t row = m_idRows[m_idHash.slot(id)];
+    return row != NoRow && m_ids[row] == id ? row : NoRow;
+}
+
+std::uint32_t EquipmentTable::findName(std::string_view name) const
+{
+    if (m_nameRows.empty()) {
+        return NoRow;
+    }
+    const std::uint32_t row = m_nameRows[m_nameHash.slot(nameHash(name))];
+    return row != NoRow && getName(row) == name ? row : NoRow;
+}
+
+EquipmentTable::Item EquipmentTable::getItem(std::uint32_t row) const
+{
+    Item item{};
+    item.id = getId(row);
+    item.name = std::string{getName(row)};
+    item.slot = getSlot(row);
+    for (std::size_t c = 0; c < ColumnCount; ++c) { item.stats[c] = m_columns[c][row]; }
+    return item;
+}
+
+std::uint32_t EquipmentTable::getId(std::uint32_t row) const
+{
+    return m_ids[row];
+}
+
+std::string_view EquipmentTable::getName(std::uint32_t row) const
+{
+    return std::string_view{m_names}.substr(m_nameOffsets[row], m_nameOffsets[row + 1] - m_nameOffsets[row]);
+}
+
+EquipmentTable::Slot EquipmentTable::getSlot(std::uint32_t row) const
+{
+    return static_cast<Slot>(countTrailingZeros(m_slotBits[row]));
+}
+
+std::int32_t EquipmentTable::get(std::uint32_t row, Column column) const
+{
+    return m_columns[static_cast<std::size_t>(column)][row];
+}
+
+const std::int32_t * EquipmentTable::column(Column column) const
+{
+    return m_columns[static_cast<std::size_t>(column)].data();
+}
+
+template<typename F>
+void EquipmentTable::scan(const Query& query, F&& visit) const
+{
+    const std::size_t n = size();
+    for (std::size_t first = 0; first < n; first += 64) {
+        const std::size_t count = std::min<std::size_t>(64, n - first);
+        std::uint64_t mask = count == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << count) - 1;
+        if (query.m_slots) {
+            mask &= slotMask(m_slotBits.data() + first, count, query.m_slots);
+        }
+        for (std::uint32_t left = query.m_constrained; left && mask; left &= left - 1) {
+            const std::size_t c = countTrailingZeros(left);
+            mask &= rangeMask(m_columns[c].data() + first, count, query.m_min[c], query.m_max[c]);
+        }
+        if (mask) {
+            visit(first, mask);
+        }
+    }
+}
+
+void EquipmentTable::select(const Query& query, std::vector<std::uint32_t>& rows) const
+{
+    scan(query, [&rows](std::size_t first, std::uint64_t mask) {
+        for (; mask; mask &= mask - 1) { rows.push_back(static_cast<std::uint32_t>(first + countTrailingZeros(mask))); }
+    });
+}
+
+std::size_t EquipmentTable::count(const Query& query) const
+{
+    std::size_t matches{0};
+    scan(query, [&matches](std::size_t, std::uint64_t mask) { matches += popCount(mask); });
+    return matches;
+}
+
+void EquipmentTable::applyTo(std::uint32_t row, BattleStats& stats) const
+{
+    auto add = [this, row](uint& stat, Column column) {
+        const std::int64_t value = static_cast<std::int64_t>(stat) + get(row, column);
+        stat = static_cast<uint>(std::max<std::int64_t>(0, value));
+    };
+    add(stats.hpMax, Column::HpMax), add(stats.mpMax, Column::MpMax);
+    add(stats.att, Column::Att), add(stats.def, Column::Def);
+    add(stats.mag, Column::Mag), add(stats.magdef, Column::MagDef);
+    add(stats.spd, Column::Spd);
+}
+
+const char * EquipmentTable::getColumnName(Column column)
+{
+    return ColumnNames[static_cast<std::size_t>(column)];
+}
+
+const char * EquipmentTable::getSlotName(Slot slot)
+{
+    return SlotNames[static_cast<std::size_t>(slot)];
+}
+
+
+std::vector<EquipmentTable::Item> readEquipment(std::istream& json)
+{
+    using Token = JsonReader::Token;
+    auto fail = [](const std::string& what) { throw std::runtime_error{"equipment: " + what}; };
+
+    JsonReader reader{json};
+    std::vector<EquipmentTable::Item> items;
+    if (reader.next() != Token::BeginArray) {
+        fail("expected an array of items");
+    }
+    for (Token t = reader.next(); t != Token::EndArray; t = reader.next()) {
+        if (t != Token::BeginObject) {
+            fail("expected an item");
+        }
+        EquipmentTable::Item item{};
+        bool hasId{false};
+        for (Token k = reader.next(); k != Token::EndObject; k = reader.next()) {
+            const std::string key = reader.getString();
+            const Token value = reader.next();
+            if (key == "id" && value == Token::Number) {
+                item.id = static_cast<std::uint32_t>(reader.getUnsigned()), hasId = true;
+                continue;
+            }
+            if (key == "name" && value == Token::String) {
+                item.name = reader.getString();
+                continue;
+            }
+            if (key == "slot" && value == Token::String) {
+                const auto found = std::find(std::begin(SlotNames), std::end(SlotNames), reader.getString());
+                if (found == std::end(SlotNames)) {
+                    fail("unknown slot '" + reader.getString() + "'");
+                }
+                item.slot = static_cast<EquipmentTable::Slot>(found - std::begin(SlotNames));
+                continue;
+            }
+            const auto column = std::find(std::begin(ColumnNames), std::end(ColumnNames), key);
+            if (column != std::end(ColumnNames) && value == Token::Number) {
+                item.stats[column - std::begin(ColumnNames)] = static_cast<std::int32_t>(reader.getNumber());
+                continue;
+            }
+            reader.skipValue(value);
+        }
+        if (!hasId) {
+            fail("item '" + item.name + "' has no id");
+        }
+        items.push_back(std::move(item));
+    }
+    return items;
+}
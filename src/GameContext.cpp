@@ -1,7 +1,121 @@
 #include "GameContext.h"
+#include "Animation.h"
+#include "ConversationDb.h"
+#include "CookedLevel.h"
+#include "EquipmentTable.h"
+#include "LevelAtlas.h"
+#include "StartupReport.h"
+#include "TiledLoader.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace {
+
+//! `path`, or its cooked sibling instead when that is up to date
+LevelMap readLevel(const std::string& path)
+{
+    const std::string cooked = cookedLevelPath(path);
+    if (isCookedLevelFresh(cooked, path)) {
+        try {
+            return mapCookedLevel(cooked);
+        } catch (const std::runtime_error&) {
+            // Most likely cooked by an older build; the source still loads
+        }
+    }
+    return readTiledFile(path);
+}
+
+std::size_t fileSize(const std::string& path)
+{
+    std::ifstream src{path, std::ios::binary | std::ios::ate};
+    return src ? static_cast<std::size_t>(src.tellg()) : 0;
+}
+
+sf::Time reportNow(const StartupReport * report)
+{
+    return report ? report->now() : sf::Time::Zero;
+}
+
+void record(StartupReport * report, const char * phase, const std::string& file, std::size_t bytes, sf::Time start)
+{
+    if (report) {
+        report->add({phase, file, bytes, start, report->now() - start});
+    }
+}
+
+//! As `record`, sizing `path` only when there is a report to record it in
+void recordFile(StartupReport * report, const char * phase, const std::string& path, sf::Time start)
+{
+    if (report) {
+        report->add({phase, path, fileSize(path), start, report->now() - start});
+    }
+}
+
+} /*namespace*/;
+
+
+//! Every item loaded, in order, and their keys; the table is built from these
+struct GameContext::EquipmentSource {
+
+    std::vector<EquipmentTable::Item>  items;
+    std::unordered_set<std::uint32_t>  ids;
+    std::unordered_set<std::string>  names;
+
+    //! Takes the ids and names of `loaded`; throws `std::invalid_argument`, having taken none, if any is taken already
+    void claim(const std::vector<EquipmentTable::Item>& loaded)
+    {
+        for (std::size_t i = 0; i < loaded.size(); ++i) {
+            const bool idTaken = ids.count(loaded[i].id) != 0;
+            if (idTaken || names.count(loaded[i].name)) {
+                release(loaded, i);
+                throw std::invalid_argument{idTaken
+                    ? "equipment: duplicate item ids (" + std::to_string(loaded[i].id) + ")"
+                    : "equipment: duplicate item names ('" + loaded[i].name + "')"};
+            }
+            ids.insert(loaded[i].id);
+            names.insert(loaded[i].name);
+        }
+    }
+
+    //! Gives back the keys `claim` took for the first `count` of `loaded`
+    void release(const std::vector<EquipmentTable::Item>& loaded, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            ids.erase(loaded[i].id);
+            names.erase(loaded[i].name);
+        }
+    }
+
+    //! Appends `loaded`, whose keys are claimed; true if there was anything to append
+    bool append(std::vector<EquipmentTable::Item>&& loaded)
+    {
+        const bool any = !loaded.empty();
+        items.insert(items.end(), std::make_move_iterator(loaded.begin()), std::make_move_iterator(loaded.end()));
+        return any;
+    }
+
+} /*struct GameContext::EquipmentSource*/;
+
 
 GameContext::GameContext()
+  : m_levels{std::make_unique<LevelAtlas>()}
+  , m_animations{std::make_unique<AnimationLibrary>()}
+  , m_equipmentSource{std::make_unique<EquipmentSource>()}
+  , m_equipment{std::make_unique<EquipmentTable>()}
+  , m_conversationSource{std::make_unique<ConversationBuilder>()}
+{
+}
+
+GameContext::~GameContext()
 {
+    // A pool may still be compiling conversations into this context
+    std::unique_lock<std::mutex> lock{m_conversationMutex};
+    waitForConversations(lock);
 }
 
 GameSettings GameContext::generateSettings()
@@ -11,17 +125,264 @@ GameSettings GameContext::generateSettings()
 
 void GameContext::loadEquipment(std::istream& src)
 {
+    std::vector<EquipmentTable::Item> items = readEquipment(src);
+    m_equipmentSource->claim(items);
+    if (m_equipmentSource->append(std::move(items))) {
+        dropEquipmentIndex();
+    }
+}
+
+const EquipmentTable& GameContext::getEquipment() const
+{
+    std::lock_guard<std::mutex> lock{m_equipmentMutex};
+    if (!m_equipment) {
+        const sf::Time start = reportNow(m_report);
+        m_equipment = std::make_unique<EquipmentTable>(m_equipmentSource->items);
+        record(m_report, "equipment-index", "", 0, start);
+    }
+    return *m_equipment;
+}
+
+void GameContext::dropEquipmentIndex()
+{
+    std::lock_guard<std::mutex> lock{m_equipmentMutex};
+    m_equipment.reset();
 }
 
 void GameContext::loadLevelMaps(std::istream& src)
 {
+    if (src.peek() == 'M') {
+        m_levels->add(readCookedLevel(src));
+        return;
+    }
+    m_levels->add(readTiledMap(src, "level" + std::to_string(m_levels->size())));
+}
+
+void GameContext::loadLevelFile(const std::string& path)
+{
+    m_levels->add(readLevel(path));
+}
+
+void GameContext::loadFiles(const std::vector<Source>& sources, WorkerPool& pool)
+{
+    const sf::Time begin = reportNow(m_report);
+    const std::size_t n = sources.size();
+    std::vector<std::vector<EquipmentTable::Item>> items(n);
+    std::vector<LevelMap> levels(n);
+    std::vector<std::exception_ptr> errors(n);
+
+    WorkerPool::Latch parsed{};
+    for (std::size_t i = 0; i < n; ++i) {
+        if (sources[i].type == DataType::Conversation) {
+            continue;
+        }
+        pool.submit(parsed, [this, &sources, &items, &levels, &errors, i] {
+            const Source& source = sources[i];
+            const sf::Time start = reportNow(m_report);
+            try {
+                if (source.type == DataType::EquipmentData) {
+                    std::ifstream src{source.path, std::ios::binary};
+                    if (!src) { throw std::runtime_error{"could not open"}; }
+                    items[i] = readEquipment(src);
+                } else {
+                    levels[i] = readLevel(source.path);
+                }
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+            recordFile(m_report, source.type == DataType::EquipmentData ? "equipment" : "level", source.path, start);
+        });
+    }
+
+    // Meanwhile, conversations only have to exist
+    std::vector<std::string> conversations;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (sources[i].type != DataType::Conversation) {
+            continue;
+        }
+        const sf::Time start = reportNow(m_report);
+        if (!std::ifstream{sources[i].path, std::ios::binary}) {
+            errors[i] = std::make_exception_ptr(std::runtime_error{"could not open"});
+        }
+        conversations.push_back(sources[i].path);
+        recordFile(m_report, "deferred", sources[i].path, start);
+    }
+    pool.wait(parsed);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!errors[i]) {
+            continue;
+        }
+        try {
+            std::rethrow_exception(errors[i]);
+        } catch (const std::exception& ex) {
+            throw std::runtime_error{sources[i].path + ": " + ex.what()};
+        }
+    }
+
+    // Keys are claimed in source order, so a clash names the later file
+    for (std::size_t i = 0; i < n; ++i) {
+        try {
+            m_equipmentSource->claim(items[i]);
+        } catch (const std::invalid_argument& ex) {
+            for (std::size_t k = 0; k < i; ++k) { m_equipmentSource->release(items[k], items[k].size()); }
+            throw std::runtime_error{sources[i].path + ": " + ex.what()};
+        }
+    }
+
+    // Merged in source order, only once nothing else can fail
+    bool newItems{false};
+    for (std::size_t i = 0; i < n; ++i) {
+        if (sources[i].type == DataType::LevelMap) {
+            m_levels->add(std::move(levels[i]));
+        } else {
+            newItems = m_equipmentSource->append(std::move(items[i])) || newItems;
+        }
+    }
+    if (newItems) {
+        dropEquipmentIndex();
+    }
+    if (!conversations.empty()) {
+        std::unique_lock<std::mutex> lock{m_conversationMutex};
+        waitForConversations(lock);
+        m_pendingConversations.insert(m_pendingConversations.end(), conversations.begin(), conversations.end());
+        m_conversations.reset();
+        m_compiling = true;
+        pool.submit([this] { compileConversations(); });
+    }
+    record(m_report, "load", "", 0, begin);
+}
+
+void GameContext::setStartupReport(StartupReport * report)
+{
+    m_report = report;
 }
 
 void GameContext::loadConversations(std::istream& src)
 {
+    std::unique_lock<std::mutex> lock{m_conversationMutex};
+    waitForConversations(lock);
+    // Deferred files came first, and stay first
+    readPendingConversations();
+    // Compiled databases start with their magic, scenes with '{' or '['
+    if (src.peek() == 'M') {
+        addConversations(ConversationDb::read(src));
+    } else {
+        readConversations(src);
+    }
+    m_conversations.reset();
+}
+
+const ConversationDb& GameContext::getConversations() const
+{
+    std::unique_lock<std::mutex> lock{m_conversationMutex};
+    waitForConversations(lock);
+    // Only when nothing was compiled, or compiling failed and left the failing file pending
+    if (!m_conversations) {
+        readPendingConversations();
+        m_conversations = std::make_unique<ConversationDb>(buildConversations());
+    }
+    return *m_conversations;
+}
+
+void GameContext::readPendingConversations() const
+{
+    // Each file is dropped once read, so a failure is retried from that file on
+    while (!m_pendingConversations.empty()) {
+        const std::string path = m_pendingConversations.front();
+        const sf::Time start = reportNow(m_report);
+        std::ifstream src{path, std::ios::binary};
+        if (!src) {
+            throw std::runtime_error{path + ": could not open"};
+        }
+        try {
+            if (src.peek() == 'M') {
+                addConversations(ConversationDb::map(path));
+            } else {
+                readConversations(src);
+            }
+        } catch (const std::exception& ex) {
+            throw std::runtime_error{path + ": " + ex.what()};
+        }
+        m_pendingConversations.erase(m_pendingConversations.begin());
+        recordFile(m_report, "conversation", path, start);
+    }
+}
+
+void GameContext::compileConversations()
+{
+    // While `m_compiling`, nothing else touches the builder or the pending files
+    std::unique_ptr<ConversationDb> db;
+    try {
+        readPendingConversations();
+        db = std::make_unique<ConversationDb>(buildConversations());
+    } catch (const std::exception&) {
+        // Left for `getConversations`, which retries from the failing file and throws
+    }
+
+    std::lock_guard<std::mutex> lock{m_conversationMutex};
+    m_conversations = std::move(db);
+    m_compiling = false;
+    m_conversationsCompiled.notify_all();
+}
+
+void GameContext::addConversations(ConversationDb&& db) const
+{
+    if (!m_heldConversations && m_conversationSource->getSceneCount() == 0) {
+        m_heldConversations = std::make_unique<ConversationDb>(std::move(db));
+        return;
+    }
+    foldHeldConversations();
+    m_conversationSource->add(db);
+}
+
+void GameContext::readConversations(std::istream& src) const
+{
+    foldHeldConversations();
+    m_conversationSource->read(src);
+}
+
+ConversationDb GameContext::buildConversations() const
+{
+    if (m_heldConversations) {
+        // Shares the held image; nothing is copied or rebuilt
+        return *m_heldConversations;
+    }
+    const sf::Time start = reportNow(m_report);
+    ConversationDb db = m_conversationSource->build();
+    record(m_report, "conversation-db", "", db.getMemoryUsage(), start);
+    return db;
+}
+
+void GameContext::foldHeldConversations() const
+{
+    if (m_heldConversations) {
+        m_conversationSource->add(*m_heldConversations);
+        m_heldConversations.reset();
+    }
+}
+
+void GameContext::waitForConversations(std::unique_lock<std::mutex>& lock) const
+{
+    m_conversationsCompiled.wait(lock, [this] { return !m_compiling; });
 }
 
 const char * GameContext::getWindowTitle() const
 {
     return "mint-engine";
 }
+
+const LevelAtlas& GameContext::getLevelAtlas() const
+{
+    return *m_levels;
+}
+
+AnimationLibrary& GameContext::getAnimationLibrary()
+{
+    return *m_animations;
+}
+
+const AnimationLibrary& GameContext::getAnimationLibrary() const
+{
+    return *m_animations;
+}
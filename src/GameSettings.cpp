@@ -5,11 +5,11 @@ GameSettings::GameSettings()
 {
 }
 
-GameSettings::GameSettings(const GameSettings& src)
+GameSettings::GameSettings(const GameSettings& src) : m_headless{src.m_headless}
 {
 }
 
-GameSettings::GameSettings(GameSettings&& src)
+GameSettings::GameSettings(GameSettings&& src) : m_headless{src.m_headless}
 {
 }
 
@@ -19,11 +19,13 @@ GameSettings::~GameSettings()
 
 GameSettings& GameSettings::operator=(const GameSettings& src)
 {
+    m_headless = src.m_headless;
     return *this;
 }
 
 GameSettings& GameSettings::operator=(GameSettings&& src)
 {
+    m_headless = src.m_headless;
     return *this;
 }
 
@@ -31,3 +33,34 @@ sf::Vector2u GameSettings::getWindowDim() const
 {
     return {800, 600};
 }
+
+bool GameSettings::isHeadless() const
+{
+    return m_headless;
+}
+
+void GameSettings::setHeadless(bool headless)
+{
+    m_headless = headless;
+}
+
+sf::Time GameSettings::getFixedTimestep() const
+{
+    return sf::seconds(1.f / 60.f);
+}
+
+std::size_t GameSettings::getPostQueueCapacity() const
+{
+    return 1024;
+}
+
+sf::Time GameSettings::getPostBudget() const
+{
+    return sf::milliseconds(2);
+}
+
+
+std::size_t GameSettings::getLayerCacheBudget() const
+{
+    return 64 * 1024 * 1024;
+}
@@ -16,54 +16,367 @@
  * =====================================================================================
  */
 #include <stdlib.h>
+#include <algorithm>
+#include <iomanip>
 #include "GameWorld.h"
+#include "DebugDraw.h"
+#include "DrawCapture.h"
 #include "GameSettings.h"
+#include "Hash.h"
+#include "InputLog.h"
+#include "StartupReport.h"
 #include <SFML/Graphics.hpp>
 
 
 GameWorld::GameWorld(GameContext& context, GameSettings& settings)
-  : m_window{
-        sf::VideoMode{settings.getWindowDim().x, settings.getWindowDim().y}
-      , context.getWindowTitle()
-    }
+  : m_context{context}
+  , m_layerCache{settings.getLayerCacheBudget()}
+  , m_posted{settings.getPostQueueCapacity()}
+  , m_postBudget{settings.getPostBudget()}
 {
-    subscribe(sf::Event::EventType::Closed, [&](...) { m_window.close(); });
+    if (!settings.isHeadless()) {
+        m_window = std::make_unique<sf::RenderWindow>(
+            sf::VideoMode{settings.getWindowDim().x, settings.getWindowDim().y}
+          , context.getWindowTitle()
+        );
+    }
+    subscribe(sf::Event::EventType::Closed, [&](...) { if (m_window) { m_window->close(); } });
 }
 
 
 void GameWorld::processInput()
 {
+    if (!m_window) {
+        return;
+    }
     sf::Event event{};
-    while (m_window.pollEvent(event)) {
+    while (m_window->pollEvent(event)) {
+        if (m_recorder) { m_recorder->recordEvent(event); }
+        for (auto& subj : m_callbacks[event.type]) { subj(event); }
+    }
+}
+
+
+void GameWorld::processInput(const std::vector<sf::Event>& events)
+{
+    for (const auto& event : events) {
         for (auto& subj : m_callbacks[event.type]) { subj(event); }
     }
 }
 
 
+std::size_t GameWorld::drainPosted(sf::Time budget)
+{
+    sf::Clock clock{};
+    std::size_t ran{0};
+    Task_t task{};
+    while (clock.getElapsedTime() < budget && m_posted.tryPop(task)) {
+        task(*this);
+        task.reset();
+        ++ran;
+    }
+    return ran;
+}
+
+
 void GameWorld::update(float dt)
 {
-    for (auto& comp_ptr : m_components) {
-        comp_ptr->update(dt);
+    // Shapes of an update which was never rendered are dropped, not kept forever
+    if (!m_debugDrawn) {
+        m_debugDraw.discard();
+    }
+    m_debugDrawn = false;
+    DebugDraw::Scope scope{m_debugDraw};
+    for (std::size_t i = 0; i < m_components.size(); ++i) {
+        m_components[i]->update(dt);
+        refreshBounds(i);
+    }
+}
+
+
+void GameWorld::refreshBounds(std::size_t i)
+{
+    const auto id = static_cast<std::uint32_t>(i);
+    const auto bounds = m_components[i]->getBounds();
+    const auto unbounded = std::lower_bound(m_unbounded.begin(), m_unbounded.end(), id);
+    const bool wasUnbounded = unbounded != m_unbounded.end() && *unbounded == id;
+    if (bounds) {
+        m_grid.update(id, *bounds);
+        if (wasUnbounded) { m_unbounded.erase(unbounded); }
+    } else if (!wasUnbounded) {
+        m_grid.remove(id);
+        m_unbounded.insert(unbounded, id);
     }
 }
 
 
+void GameWorld::queryVisible(const sf::FloatRect& area, std::vector<std::uint32_t>& out) const
+{
+    const std::size_t first = out.size();
+    m_grid.query(area, out);
+    const std::size_t middle = out.size();
+    out.insert(out.end(), m_unbounded.begin(), m_unbounded.end());
+    std::inplace_merge(out.begin() + first, out.begin() + middle, out.end());
+}
+
+
 void GameWorld::render(sf::RenderStates stt)
 {
-    m_window.setActive();
-    for (const auto& comp_ptr : m_components) {
-        comp_ptr->draw(m_window, stt);
+    if (!m_window) {
+        return;
+    }
+    m_window->setActive();
+    RenderTargetDevice device{*m_window};
+    render(device, stt);
+    m_window->display();
+}
+
+
+void GameWorld::render(RenderDevice& device, sf::RenderStates stt)
+{
+    DebugDraw::Scope scope{m_debugDraw};
+    m_layerCache.beginFrame();
+
+    // Bounds are in world space; take the view back through `stt` to meet them
+    const sf::FloatRect area = stt.transform.getInverse().transformRect(viewBounds(device.getView()));
+    m_visible.clear();
+    queryVisible(area, m_visible);
+    orderVisible();
+    m_commands.setView(device.getView());
+    for (const auto i : m_order) {
+        m_commands.setSource(i);
+        m_components[i]->record(m_commands, stt);
     }
-    m_window.display();
+    m_commands.setSource(CommandList::NoSource);
+    m_cullStats.visible = m_visible.size();
+    m_cullStats.culled = m_components.size() - m_visible.size();
+
+    // Captures keep recording order, so replaying them still measures the sort
+    m_commands.expandSprites();
+    if (m_drawRecorder) {
+        m_drawRecorder->recordFrame(m_commands, device.getView());
+    }
+    m_commands.sort();
+    rememberOrder();
+    m_batch.resetStats();
+    m_commands.submit(device, m_batch);
+    m_renderStats = m_batch.getStats();
+    m_commands.clear();
+    m_debugDraw.flush(device, stt);
+    m_debugDrawn = true;
+}
+
+
+void GameWorld::orderVisible()
+{
+    if (m_orderEpoch > 0xffffffffu - 3) {
+        std::fill(m_orderMark.begin(), m_orderMark.end(), 0u);
+        m_orderEpoch = 0;
+    }
+    m_orderEpoch += 3;
+    m_orderMark.resize(m_components.size(), 0u);
+    for (const auto i : m_visible) {
+        m_orderMark[i] = m_orderEpoch;
+    }
+
+    m_order.clear();
+    for (const auto i : m_drawOrder) {
+        if (i < m_orderMark.size() && m_orderMark[i] == m_orderEpoch) {
+            m_order.push_back(i);
+            m_orderMark[i] = m_orderEpoch + 1;
+        }
+    }
+    for (const auto i : m_visible) {
+        if (m_orderMark[i] == m_orderEpoch) {
+            m_order.push_back(i);
+            m_orderMark[i] = m_orderEpoch + 1;
+        }
+    }
+}
+
+void GameWorld::rememberOrder()
+{
+    m_drawOrder.clear();
+    m_commands.forEach([this](std::uint64_t, const RenderCommand& cmd) {
+        if (cmd.source < m_orderMark.size() && m_orderMark[cmd.source] == m_orderEpoch + 1) {
+            m_drawOrder.push_back(cmd.source);
+            m_orderMark[cmd.source] = m_orderEpoch + 2;
+        }
+    });
+}
+
+void GameWorld::queueCommands(const CommandList& list)
+{
+    m_commands.merge(list);
+}
+
+
+const SpriteBatch::Stats& GameWorld::getRenderStats() const
+{
+    return m_renderStats;
+}
+
+
+const CommandList::Stats& GameWorld::getCommandStats() const
+{
+    return m_commands.getStats();
+}
+
+
+const GameWorld::CullStats& GameWorld::getCullStats() const
+{
+    return m_cullStats;
+}
+
+
+LayerCache& GameWorld::getLayerCache()
+{
+    return m_layerCache;
 }
 
 
 void GameWorld::run()
 {
     sf::Clock clock{};
-    while (m_window.isOpen()) {
+    while (m_window && m_window->isOpen()) {
         processInput();
-        update(clock.restart().asSeconds());
+        const float dt = clock.restart().asSeconds();
+        if (m_recorder) { m_recorder->endFrame(dt); }
+        tick(dt);
         render();
+        markFirstFrame();
+    }
+}
+
+
+double GameWorld::TickReport::ticksPerSecond() const
+{
+    return elapsed > sf::Time::Zero ? ticks / static_cast<double>(elapsed.asSeconds()) : 0.0;
+}
+
+
+void GameWorld::tick(float dt)
+{
+    drainPosted(m_postBudget);
+    update(dt);
+}
+
+
+GameWorld::TickReport GameWorld::runTicks(std::size_t ticks, float dt)
+{
+    TickReport report{};
+    sf::Clock total{}, clock{};
+    for (; report.ticks < ticks; ++report.ticks) {
+        processInput();
+        tick(dt);
+        markFirstFrame();
+        report.worstTick = std::max(report.worstTick, clock.restart());
+    }
+    report.elapsed = total.getElapsedTime();
+    return report;
+}
+
+
+GameWorld::TickReport GameWorld::runFor(sf::Time duration, float dt)
+{
+    TickReport report{};
+    sf::Clock total{}, clock{};
+    while (total.getElapsedTime() < duration) {
+        processInput();
+        tick(dt);
+        markFirstFrame();
+        report.worstTick = std::max(report.worstTick, clock.restart());
+        ++report.ticks;
+    }
+    report.elapsed = total.getElapsedTime();
+    return report;
+}
+
+
+bool GameWorld::isHeadless() const
+{
+    return !m_window;
+}
+
+
+const DebugDraw::Canvas& GameWorld::getDebugDraw() const
+{
+    return m_debugDraw;
+}
+
+
+const GameContext& GameWorld::getContext() const
+{
+    return m_context;
+}
+
+
+void GameWorld::setRecorder(InputRecorder * recorder)
+{
+    m_recorder = recorder;
+}
+
+void GameWorld::setDrawRecorder(DrawRecorder * recorder)
+{
+    m_drawRecorder = recorder;
+}
+
+
+void GameWorld::setStartupReport(StartupReport * report)
+{
+    m_startupReport = report;
+}
+
+
+void GameWorld::markFirstFrame()
+{
+    if (m_startupReport) {
+        m_startupReport->firstFrame();
+        m_startupReport = nullptr;
+    }
+}
+
+
+void GameWorld::replay(InputReplayer& log, bool realTime, std::ostream& report)
+{
+    float dt{0};
+    std::vector<sf::Event> events{};
+    std::size_t frame{0};
+    sf::Time total{}, worst{};
+    sf::Clock wall{};
+    sf::Time scheduled{};
+
+    report << "frame\tdt_ms\tevents\tupdate_us\thash\n";
+    while (log.nextFrame(dt, events)) {
+        if (realTime) {
+            scheduled += sf::seconds(dt);
+            const sf::Time ahead = scheduled - wall.getElapsedTime();
+            if (ahead > sf::Time::Zero) { sf::sleep(ahead); }
+        }
+
+        sf::Clock clock{};
+        processInput(events);
+        update(dt);
+        const sf::Time spent = clock.getElapsedTime();
+        total += spent;
+        worst = std::max(worst, spent);
+
+        report << frame++ << '\t' << dt * 1000.f << '\t' << events.size() << '\t'
+            << spent.asMicroseconds() << '\t'
+            << std::hex << std::setw(16) << std::setfill('0') << stateHash()
+            << std::dec << std::setfill(' ') << '\n';
+    }
+    report << "# " << frame << " frames, " << total.asMicroseconds() << "us total, "
+        << (frame ? total.asMicroseconds() / static_cast<sf::Int64>(frame) : 0) << "us mean, "
+        << worst.asMicroseconds() << "us worst\n";
+}
+
+
+std::uint64_t GameWorld::stateHash() const
+{
+    StateHasher h{};
+    for (const auto& comp_ptr : m_components) {
+        comp_ptr->hashState(h);
     }
+    return h.value();
 }
@@ -0,0 +1,263 @@
+#include "InputLog.h"
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const char Magic[8] = {'M', 'I', 'N', 'T', 'I', 'N', 'P', 'T'};
+const std::uint64_t Version = 1;
+
+
+void putByte(std::string& dst, std::uint8_t b)
+{
+    dst.push_back(static_cast<char>(b));
+}
+
+void putVarint(std::string& dst, std::uint64_t v)
+{
+    while (v >= 0x80) {
+        putByte(dst, static_cast<std::uint8_t>(v) | 0x80);
+        v >>= 7;
+    }
+    putByte(dst, static_cast<std::uint8_t>(v));
+}
+
+void putSigned(std::string& dst, std::int64_t v)
+{
+    putVarint(dst, (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63));
+}
+
+void putFloat(std::string& dst, float f)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &f, sizeof bits);
+    for (int i = 0; i < 4; ++i) { putByte(dst, static_cast<std::uint8_t>(bits >> (8 * i))); }
+}
+
+
+std::uint8_t getByte(std::istream& src)
+{
+    const auto c = src.get();
+    if (c == std::char_traits<char>::eof()) {
+        throw std::runtime_error{"input log is truncated"};
+    }
+    return static_cast<std::uint8_t>(c);
+}
+
+std::uint64_t getVarint(std::istream& src)
+{
+    std::uint64_t v{0};
+    for (int shift = 0; shift < 64; shift += 7) {
+        const std::uint8_t b = getByte(src);
+        v |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+        if (!(b & 0x80)) { return v; }
+    }
+    throw std::runtime_error{"input log has a malformed varint"};
+}
+
+std::int64_t getSigned(std::istream& src)
+{
+    const std::uint64_t v = getVarint(src);
+    return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+float getFloat(std::istream& src)
+{
+    std::uint32_t bits{0};
+    for (int i = 0; i < 4; ++i) { bits |= static_cast<std::uint32_t>(getByte(src)) << (8 * i); }
+    float f;
+    std::memcpy(&f, &bits, sizeof f);
+    return f;
+}
+
+
+void putEvent(std::string& dst, const sf::Event& e)
+{
+    putByte(dst, static_cast<std::uint8_t>(e.type));
+    switch (e.type) {
+    case sf::Event::Resized:
+        putVarint(dst, e.size.width), putVarint(dst, e.size.height);
+        break;
+    case sf::Event::TextEntered:
+        putVarint(dst, e.text.unicode);
+        break;
+    case sf::Event::KeyPressed:
+    case sf::Event::KeyReleased:
+        putSigned(dst, e.key.code);
+        putByte(dst, e.key.alt | e.key.control << 1 | e.key.shift << 2 | e.key.system << 3);
+        break;
+    case sf::Event::MouseWheelMoved:
+        putSigned(dst, e.mouseWheel.delta), putSigned(dst, e.mouseWheel.x), putSigned(dst, e.mouseWheel.y);
+        break;
+    case sf::Event::MouseWheelScrolled:
+        putByte(dst, e.mouseWheelScroll.wheel), putFloat(dst, e.mouseWheelScroll.delta);
+        putSigned(dst, e.mouseWheelScroll.x), putSigned(dst, e.mouseWheelScroll.y);
+        break;
+    case sf::Event::MouseButtonPressed:
+    case sf::Event::MouseButtonReleased:
+        putByte(dst, e.mouseButton.button);
+        putSigned(dst, e.mouseButton.x), putSigned(dst, e.mouseButton.y);
+        break;
+    case sf::Event::MouseMoved:
+        putSigned(dst, e.mouseMove.x), putSigned(dst, e.mouseMove.y);
+        break;
+    case sf::Event::JoystickButtonPressed:
+    case sf::Event::JoystickButtonReleased:
+        putVarint(dst, e.joystickButton.joystickId), putVarint(dst, e.joystickButton.button);
+        break;
+    case sf::Event::JoystickMoved:
+        putVarint(dst, e.joystickMove.joystickId), putByte(dst, e.joystickMove.axis);
+        putFloat(dst, e.joystickMove.position);
+        break;
+    case sf::Event::JoystickConnected:
+    case sf::Event::JoystickDisconnected:
+        putVarint(dst, e.joystickConnect.joystickId);
+        break;
+    case sf::Event::TouchBegan:
+    case sf::Event::TouchMoved:
+    case sf::Event::TouchEnded:
+        putVarint(dst, e.touch.finger), putSigned(dst, e.touch.x), putSigned(dst, e.touch.y);
+        break;
+    case sf::Event::SensorChanged:
+        putByte(dst, e.sensor.type);
+        putFloat(dst, e.sensor.x), putFloat(dst, e.sensor.y), putFloat(dst, e.sensor.z);
+        break;
+    default:
+        break;
+    }
+}
+
+
+sf::Event getEvent(std::istream& src)
+{
+    sf::Event e{};
+    const std::uint8_t type = getByte(src);
+    if (type >= sf::Event::Count) {
+        throw std::runtime_error{"input log has an unknown event type"};
+    }
+    e.type = static_cast<sf::Event::EventType>(type);
+    switch (e.type) {
+    case sf::Event::Resized:
+        e.size.width = static_cast<unsigned int>(getVarint(src));
+        e.size.height = static_cast<unsigned int>(getVarint(src));
+        break;
+    case sf::Event::TextEntered:
+        e.text.unicode = static_cast<sf::Uint32>(getVarint(src));
+        break;
+    case sf::Event::KeyPressed:
+    case sf::Event::KeyReleased: {
+        e.key.code = static_cast<sf::Keyboard::Key>(getSigned(src));
+        const std::uint8_t mods = getByte(src);
+        e.key.alt = mods & 1, e.key.control = mods & 2, e.key.shift = mods & 4, e.key.system = mods & 8;
+        break;
+    }
+    case sf::Event::MouseWheelMoved:
+        e.mouseWheel.delta = static_cast<int>(getSigned(src));
+        e.mouseWheel.x = static_cast<int>(getSigned(src));
+        e.mouseWheel.y = static_cast<int>(getSigned(src));
+        break;
+    case sf::Event::MouseWheelScrolled:
+        e.mouseWheelScroll.wheel = static_cast<sf::Mouse::Wheel>(getByte(src));
+        e.mouseWheelScroll.delta = getFloat(src);
+        e.mouseWheelScroll.x = static_cast<int>(getSigned(src));
+        e.mouseWheelScroll.y = static_cast<int>(getSigned(src));
+        break;
+    case sf::Event::MouseButtonPressed:
+    case sf::Event::MouseButtonReleased:
+        e.mouseButton.button = static_cast<sf::Mouse::Button>(getByte(src));
+        e.mouseButton.x = static_cast<int>(getSigned(src));
+        e.mouseButton.y = static_cast<int>(getSigned(src));
+        break;
+    case sf::Event::MouseMoved:
+        e.mouseMove.x = static_cast<int>(getSigned(src));
+        e.mouseMove.y = static_cast<int>(getSigned(src));
+        break;
+    case sf::Event::JoystickButtonPressed:
+    case sf::Event::JoystickButtonReleased:
+        e.joystickButton.joystickId = static_cast<unsigned int>(getVarint(src));
+        e.joystickButton.button = static_cast<unsigned int>(getVarint(src));
+        break;
+    case sf::Event::JoystickMoved:
+        e.joystickMove.joystickId = static_cast<unsigned int>(getVarint(src));
+        e.joystickMove.axis = static_cast<sf::Joystick::Axis>(getByte(src));
+        e.joystickMove.position = getFloat(src);
+        break;
+    case sf::Event::JoystickConnected:
+    case sf::Event::JoystickDisconnected:
+        e.joystickConnect.joystickId = static_cast<unsigned int>(getVarint(src));
+        break;
+    case sf::Event::TouchBegan:
+    case sf::Event::TouchMoved:
+    case sf::Event::TouchEnded:
+        e.touch.finger = static_cast<unsigned int>(getVarint(src));
+        e.touch.x = static_cast<int>(getSigned(src));
+        e.touch.y = static_cast<int>(getSigned(src));
+        break;
+    case sf::Event::SensorChanged:
+        e.sensor.type = static_cast<sf::Sensor::Type>(getByte(src));
+        e.sensor.x = getFloat(src), e.sensor.y = getFloat(src), e.sensor.z = getFloat(src);
+        break;
+    default:
+        break;
+    }
+    return e;
+}
+
+} /*namespace*/;
+
+
+InputRecorder::InputRecorder(std::ostream& dst) : m_dst{dst}
+{
+    std::string header{Magic, sizeof Magic};
+    putVarint(header, Version);
+    m_dst.write(header.data(), header.size());
+}
+
+void InputRecorder::recordEvent(const sf::Event& e)
+{
+    putEvent(m_frame, e);
+    ++m_pendingEvents;
+}
+
+void InputRecorder::endFrame(float dt)
+{
+    std::string head{};
+    putFloat(head, dt);
+    putVarint(head, m_pendingEvents);
+    m_dst.write(head.data(), head.size());
+    m_dst.write(m_frame.data(), m_frame.size());
+    m_frame.clear();
+    m_pendingEvents = 0;
+    ++m_frames;
+}
+
+std::size_t InputRecorder::getFrameCount() const
+{
+    return m_frames;
+}
+
+
+InputReplayer::InputReplayer(std::istream& src) : m_src{src}
+{
+    char magic[sizeof Magic];
+    if (!m_src.read(magic, sizeof magic) || std::memcmp(magic, Magic, sizeof Magic) != 0) {
+        throw std::runtime_error{"not an input log"};
+    }
+    if (getVarint(m_src) != Version) {
+        throw std::runtime_error{"unsupported input log version"};
+    }
+}
+
+bool InputReplayer::nextFrame(float& dt, std::vector<sf::Event>& events)
+{
+    if (m_src.peek() == std::char_traits<char>::eof()) {
+        return false;
+    }
+    dt = getFloat(m_src);
+    // The count is only a claim; reading one event at a time, a damaged log
+    // runs out of data before it can ask for much memory
+    events.clear();
+    for (std::uint64_t n = getVarint(m_src); n > 0; --n) { events.push_back(getEvent(m_src)); }
+    return true;
+}
@@ -0,0 +1,480 @@
+#include "JsonReader.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const int Eof = -1;
+
+[[noreturn]] void fail(const char * what)
+{
+    throw std::runtime_error{std::string{"json: "} + what};
+}
+
+void appendUtf8(std::string& out, std::uint32_t cp)
+{
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+//! Index of the first '"' or '\\' of `p[0, n)`, or `n`
+std::size_t findQuoteOrEscape(const char * p, std::size_t n)
+{
+    std::size_t i{0};
+#if defined(__AVX2__)
+    const __m256i quote = _mm256_set1_epi8('"'), escape = _mm256_set1_epi8('\\');
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+        const unsigned int hits = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, escape))));
+        if (hits) {
+            return i + static_cast<std::size_t>(__builtin_ctz(hits));
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"'), escape = _mm_set1_epi8('\\');
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        const unsigned int hits = static_cast<unsigned int>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, escape))));
+        if (hits) {
+            return i + static_cast<std::size_t>(__builtin_ctz(hits));
+        }
+    }
+#endif
+    // The scalar loop handles the tail, and everything on other targets
+    while (i < n && p[i] != '"' && p[i] != '\\') { ++i; }
+    return i;
+}
+
+bool isSeparator(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',';
+}
+
+//! Index of the first byte of `p[0, n)` which is neither whitespace nor a comma, or `n`
+std::size_t skipSeparatorRun(const char * p, std::size_t n)
+{
+    std::size_t i{0};
+    // Most runs are a single space or comma; only indentation is worth a vector
+    while (i < n && i < 4 && isSeparator(p[i])) { ++i; }
+    if (i < 4) {
+        return i;
+    }
+#if defined(__SSE2__)
+    const __m128i space = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t'), lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r'), comma = _mm_set1_epi8(',');
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        const __m128i sep = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)), _mm_cmpeq_epi8(v, comma)));
+        const unsigned int other = ~static_cast<unsigned int>(_mm_movemask_epi8(sep)) & 0xffff;
+        if (other) {
+            return i + static_cast<std::size_t>(__builtin_ctz(other));
+        }
+    }
+#endif
+    while (i < n && isSeparator(p[i])) { ++i; }
+    return i;
+}
+
+//! One 64-byte block's structural characters, bit `i` standing for byte `i`
+struct Block {
+    std::uint64_t quote;
+    std::uint64_t escape;
+    std::uint64_t open;
+    std::uint64_t close;
+} /*struct Block*/;
+
+Block classify(const char * p)
+{
+    // '[' and '{' differ only in bit 5, as do ']' and '}'
+    Block b{0, 0, 0, 0};
+#if defined(__AVX2__)
+    for (int i = 0; i < 64; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+        const __m256i folded = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        auto bits = [i](__m256i eq) { return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(eq))) << i; };
+        b.quote |= bits(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')));
+        b.escape |= bits(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')));
+        b.open |= bits(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')));
+        b.close |= bits(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}')));
+    }
+#elif defined(__SSE2__)
+    for (int i = 0; i < 64; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        const __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        auto bits = [i](__m128i eq) { return static_cast<std::uint64_t>(_mm_movemask_epi8(eq)) << i; };
+        b.quote |= bits(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+        b.escape |= bits(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+        b.open |= bits(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')));
+        b.close |= bits(_mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+    }
+#else
+    for (int i = 0; i < 64; ++i) {
+        const char folded = static_cast<char>(p[i] | 0x20);
+        b.quote |= static_cast<std::uint64_t>(p[i] == '"') << i;
+        b.escape |= static_cast<std::uint64_t>(p[i] == '\\') << i;
+        b.open |= static_cast<std::uint64_t>(folded == '{') << i;
+        b.close |= static_cast<std::uint64_t>(folded == '}') << i;
+    }
+#endif
+    return b;
+}
+
+/**
+ * @brief   Bytes of the first `n` which a backslash escapes.
+ *
+ *  `carry` says whether the previous block ended in an unpaired backslash,
+ *  and is updated for the next.  Backslashes are rare, so they are visited
+ *  one at a time.
+ */
+std::uint64_t escapedBytes(std::uint64_t escape, std::size_t n, bool& carry)
+{
+    std::uint64_t escaped = carry ? 1u : 0u;
+    carry = false;
+    for (; escape; escape &= escape - 1) {
+        const unsigned int i = static_cast<unsigned int>(__builtin_ctzll(escape));
+        if ((escaped >> i) & 1) {
+            continue;
+        }
+        if (i + 1 == n) {
+            carry = true;
+        } else {
+            escaped |= std::uint64_t{1} << (i + 1);
+        }
+    }
+    return escaped;
+}
+
+//! Bit `i` is the parity of bits [0, i] of `x`
+std::uint64_t prefixXor(std::uint64_t x)
+{
+    x ^= x << 1, x ^= x << 2, x ^= x << 4;
+    x ^= x << 8, x ^= x << 16, x ^= x << 32;
+    return x;
+}
+
+} /*namespace*/;
+
+
+JsonReader::JsonReader(std::istream& src, std::size_t bufferSize)
+  : m_src{src}
+  , m_buffer(bufferSize ? bufferSize : 1)
+{
+}
+
+JsonReader::Token JsonReader::next()
+{
+    skipSeparators();
+    const int c = peek();
+
+    if (m_expectKey && c != '}') {
+        if (c != '"') {
+            fail("expected a key");
+        }
+        readString();
+        skipSeparators();
+        if (get() != ':') {
+            fail("expected ':' after a key");
+        }
+        m_expectKey = false;
+        return Token::Key;
+    }
+
+    switch (c) {
+    case Eof:
+        if (!m_open.empty()) {
+            fail("unexpected end of input");
+        }
+        return Token::End;
+    case '{':
+        ++m_pos;
+        m_open.push_back('{');
+        m_expectKey = true;
+        return Token::BeginObject;
+    case '[':
+        ++m_pos;
+        m_open.push_back('[');
+        return Token::BeginArray;
+    case '}':
+    case ']':
+        ++m_pos;
+        if (m_open.empty() || m_open.back() != (c == '}' ? '{' : '[')) {
+            fail("mismatched bracket");
+        }
+        m_open.pop_back();
+        valueDone();
+        return c == '}' ? Token::EndObject : Token::EndArray;
+    case '"':
+        readString();
+        valueDone();
+        return Token::String;
+    case 't':
+        readLiteral("true");
+        return Token::True;
+    case 'f':
+        readLiteral("false");
+        return Token::False;
+    case 'n':
+        readLiteral("null");
+        return Token::Null;
+    default:
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            readNumber();
+            valueDone();
+            return Token::Number;
+        }
+        fail("unexpected character");
+    }
+}
+
+const std::string& JsonReader::getString() const
+{
+    return m_string;
+}
+
+double JsonReader::getNumber() const
+{
+    return std::strtod(m_string.c_str(), nullptr);
+}
+
+std::uint64_t JsonReader::getUnsigned() const
+{
+    std::uint64_t v{0};
+    for (const char c : m_string) {
+        if (c < '0' || c > '9') {
+            fail("expected a non-negative integer");
+        }
+        v = v * 10 + static_cast<std::uint64_t>(c - '0');
+    }
+    return v;
+}
+
+void JsonReader::skipValue(Token first)
+{
+    if (first != Token::BeginObject && first != Token::BeginArray) {
+        return;
+    }
+
+    // Scans 64 bytes at a time for brackets outside strings, see the class notes
+    std::size_t depth{1};
+    bool inString{false};
+    bool escapeCarry{false};
+    char padded[64];
+    for (;;) {
+        if (m_pos == m_end && !fill()) {
+            fail("unexpected end of input");
+        }
+        const std::size_t n = std::min<std::size_t>(64, m_end - m_pos);
+        const char * p = m_buffer.data() + m_pos;
+        if (n < 64) {
+            std::memset(padded, ' ', sizeof padded);
+            std::memcpy(padded, p, n);
+            p = padded;
+        }
+        const Block block = classify(p);
+        const std::uint64_t valid = n == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1;
+
+        const std::uint64_t quotes = block.quote & ~escapedBytes(block.escape & valid, n, escapeCarry) & valid;
+        // Set from an opening quote up to, not including, its closing quote
+        const std::uint64_t strings = prefixXor(quotes) ^ (inString ? ~std::uint64_t{0} : 0);
+        inString = (strings >> (n - 1)) & 1;
+        std::uint64_t open = block.open & ~strings & valid;
+        std::uint64_t close = block.close & ~strings & valid;
+
+        const std::size_t closing = static_cast<std::size_t>(__builtin_popcountll(close));
+        if (closing < depth) {
+            depth = depth + static_cast<std::size_t>(__builtin_popcountll(open)) - closing;
+            m_pos += n;
+            continue;
+        }
+        for (std::uint64_t brackets = open | close; brackets; brackets &= brackets - 1) {
+            const unsigned int i = static_cast<unsigned int>(__builtin_ctzll(brackets));
+            if ((open >> i) & 1) {
+                ++depth;
+            } else if (--depth == 0) {
+                m_pos += i + 1;
+                m_open.pop_back();
+                valueDone();
+                return;
+            }
+        }
+        m_pos += n;
+    }
+}
+
+std::size_t JsonReader::getDepth() const
+{
+    return m_open.size();
+}
+
+bool JsonReader::fill()
+{
+    m_src.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_pos = 0;
+    m_end = static_cast<std::size_t>(m_src.gcount());
+    return m_end > 0;
+}
+
+int JsonReader::peek()
+{
+    if (m_pos == m_end && !fill()) {
+        return Eof;
+    }
+    return static_cast<unsigned char>(m_buffer[m_pos]);
+}
+
+int JsonReader::get()
+{
+    const int c = peek();
+    if (c != Eof) {
+        ++m_pos;
+    }
+    return c;
+}
+
+void JsonReader::skipSeparators()
+{
+    while (peek() != Eof) {
+        m_pos += skipSeparatorRun(m_buffer.data() + m_pos, m_end - m_pos);
+        if (m_pos != m_end) {
+            return;
+        }
+    }
+}
+
+void JsonReader::readString()
+{
+    ++m_pos;
+    std::string whole;
+    bool more = readStringPiece();
+    if (!more) {
+        return;
+    }
+    whole.swap(m_string);
+    while (more) {
+        more = readStringPiece();
+        whole += m_string;
+    }
+    m_string.swap(whole);
+}
+
+bool JsonReader::beginString()
+{
+    skipSeparators();
+    if (m_expectKey || peek() != '"') {
+        return false;
+    }
+    ++m_pos;
+    return true;
+}
+
+bool JsonReader::readStringPiece()
+{
+    m_string.clear();
+    while (m_string.size() < m_buffer.size()) {
+        if (m_pos == m_end && !fill()) {
+            fail("unterminated string");
+        }
+        const char * begin = m_buffer.data() + m_pos;
+        const char * end = m_buffer.data() + m_end;
+        const char * stop = begin + findQuoteOrEscape(begin, m_end - m_pos);
+        m_string.append(begin, stop);
+        m_pos += static_cast<std::size_t>(stop - begin);
+        if (stop == end) {
+            continue;
+        }
+        ++m_pos;
+        if (*stop == '"') {
+            return false;
+        }
+
+        const int e = get();
+        switch (e) {
+        case '"': case '\\': case '/': m_string += static_cast<char>(e); break;
+        case 'b': m_string += '\b'; break;
+        case 'f': m_string += '\f'; break;
+        case 'n': m_string += '\n'; break;
+        case 'r': m_string += '\r'; break;
+        case 't': m_string += '\t'; break;
+        case 'u': {
+            auto hex4 = [this] {
+                std::uint32_t v{0};
+                for (int i = 0; i < 4; ++i) {
+                    const int h = get();
+                    v <<= 4;
+                    if (h >= '0' && h <= '9') { v |= static_cast<std::uint32_t>(h - '0'); }
+                    else if (h >= 'a' && h <= 'f') { v |= static_cast<std::uint32_t>(h - 'a' + 10); }
+                    else if (h >= 'A' && h <= 'F') { v |= static_cast<std::uint32_t>(h - 'A' + 10); }
+                    else { fail("malformed \\u escape"); }
+                }
+                return v;
+            };
+            std::uint32_t cp = hex4();
+            if (cp >= 0xD800 && cp < 0xDC00) {
+                if (get() != '\\' || get() != 'u') {
+                    fail("unpaired surrogate");
+                }
+                const std::uint32_t low = hex4();
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            }
+            appendUtf8(m_string, cp);
+            break;
+        }
+        default:
+            fail("unknown escape");
+        }
+    }
+    return true;
+}
+
+void JsonReader::readNumber()
+{
+    auto isNumeric = [](char c) {
+        return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+    };
+    m_string.clear();
+    while (peek() != Eof) {
+        const char * begin = m_buffer.data() + m_pos;
+        const char * end = m_buffer.data() + m_end;
+        const char * stop = std::find_if_not(begin, end, isNumeric);
+        m_string.append(begin, stop);
+        m_pos += static_cast<std::size_t>(stop - begin);
+        if (m_pos != m_end) {
+            return;
+        }
+    }
+}
+
+void JsonReader::readLiteral(const char * word)
+{
+    for (const char * p = word; *p; ++p) {
+        if (get() != static_cast<unsigned char>(*p)) {
+            fail("unknown literal");
+        }
+    }
+    valueDone();
+}
+
+void JsonReader::valueDone()
+{
+    m_expectKey = !m_open.empty() && m_open.back() == '{';
+}
@@ -0,0 +1,95 @@
+#include "LayerCache.h"
+#include <stdexcept>
+#include <utility>
+
+LayerCache::LayerCache(std::size_t budgetBytes, TextureFactory factory)
+  : m_budget{budgetBytes}
+  , m_factory{std::move(factory)}
+{
+}
+
+sf::RenderTexture * LayerCache::find(const CachedLayer * owner)
+{
+    const auto it = m_index.find(owner);
+    if (it == m_index.end()) {
+        return nullptr;
+    }
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    it->second->lastFrame = m_frame;
+    ++m_stats.hits;
+    return it->second->texture.get();
+}
+
+sf::RenderTexture& LayerCache::acquire(const CachedLayer * owner, sf::Vector2u size)
+{
+    release(owner);
+    const std::size_t bytes = static_cast<std::size_t>(size.x) * size.y * 4;
+    makeRoom(bytes);
+
+    m_lru.push_front(Entry{owner, m_factory(size), bytes, m_frame});
+    m_index[owner] = m_lru.begin();
+    m_stats.bytes += bytes;
+    return *m_lru.front().texture;
+}
+
+void LayerCache::release(const CachedLayer * owner)
+{
+    const auto it = m_index.find(owner);
+    if (it == m_index.end()) {
+        return;
+    }
+    m_stats.bytes -= it->second->bytes;
+    m_lru.erase(it->second);
+    m_index.erase(it);
+}
+
+void LayerCache::beginFrame()
+{
+    ++m_frame;
+}
+
+void LayerCache::countRedraw()
+{
+    ++m_stats.redraws;
+}
+
+std::size_t LayerCache::getBudget() const
+{
+    return m_budget;
+}
+
+void LayerCache::setBudget(std::size_t budgetBytes)
+{
+    m_budget = budgetBytes;
+    makeRoom(0);
+}
+
+const LayerCache::Stats& LayerCache::getStats() const
+{
+    return m_stats;
+}
+
+std::unique_ptr<sf::RenderTexture> LayerCache::createTexture(sf::Vector2u size)
+{
+    auto texture = std::make_unique<sf::RenderTexture>();
+    if (!texture->create(size.x, size.y)) {
+        throw std::runtime_error{"Could not create a layer texture"};
+    }
+    return texture;
+}
+
+void LayerCache::makeRoom(std::size_t incoming)
+{
+    auto it = m_lru.end();
+    while (m_stats.bytes + incoming > m_budget && it != m_lru.begin()) {
+        --it;
+        if (it->lastFrame == m_frame) {
+            // Everything more recent was used this frame too
+            break;
+        }
+        m_stats.bytes -= it->bytes;
+        m_index.erase(it->owner);
+        it = m_lru.erase(it);
+        ++m_stats.evictions;
+    }
+}
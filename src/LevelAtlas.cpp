@@ -0,0 +1,31 @@
+#include "LevelAtlas.h"
+#include <stdexcept>
+#include <utility>
+
+std::shared_ptr<const LevelMap> LevelAtlas::add(LevelMap map)
+{
+    map.indexObjects();
+    auto frozen = std::make_shared<const LevelMap>(std::move(map));
+    m_levels[frozen->name] = frozen;
+    return frozen;
+}
+
+std::shared_ptr<const LevelMap> LevelAtlas::find(const std::string& name) const
+{
+    const auto found = m_levels.find(name);
+    return found == m_levels.end() ? nullptr : found->second;
+}
+
+LevelInstance LevelAtlas::instantiate(const std::string& name) const
+{
+    auto base = find(name);
+    if (!base) {
+        throw std::out_of_range{"no level named " + name};
+    }
+    return LevelInstance{std::move(base)};
+}
+
+std::size_t LevelAtlas::size() const
+{
+    return m_levels.size();
+}
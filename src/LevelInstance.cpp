@@ -0,0 +1,104 @@
+#include "LevelInstance.h"
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+//! Rough per-node cost of an unordered_map entry: payload plus chaining
+template<typename M>
+std::size_t hashMapBytes(const M& m)
+{
+    return m.size() * (sizeof(typename M::value_type) + 2 * sizeof(void*)) + m.bucket_count() * sizeof(void*);
+}
+
+} /*namespace*/;
+
+
+LevelInstance::LevelInstance(std::shared_ptr<const LevelMap> base) : m_base{std::move(base)}
+{
+}
+
+const LevelMap& LevelInstance::getBase() const
+{
+    return *m_base;
+}
+
+std::uint32_t LevelInstance::getTile(std::size_t layer, unsigned int x, unsigned int y) const
+{
+    const TileLayer& base = layerAt(layer, x, y);
+    if (!m_tileEdits.empty()) {
+        const auto edit = m_tileEdits.find(tileKey(layer, static_cast<std::size_t>(y) * base.getSize().x + x));
+        if (edit != m_tileEdits.end()) {
+            return edit->second;
+        }
+    }
+    return base.at(x, y);
+}
+
+void LevelInstance::setTile(std::size_t layer, unsigned int x, unsigned int y, std::uint32_t gid)
+{
+    const TileLayer& base = layerAt(layer, x, y);
+    const std::uint64_t key = tileKey(layer, static_cast<std::size_t>(y) * base.getSize().x + x);
+    if (base.at(x, y) == gid) {
+        m_tileEdits.erase(key);
+    } else {
+        m_tileEdits[key] = gid;
+    }
+}
+
+const LevelObject * LevelInstance::findObject(std::uint32_t id) const
+{
+    const auto edit = m_objectEdits.find(id);
+    if (edit != m_objectEdits.end()) {
+        return edit->second ? &*edit->second : nullptr;
+    }
+    return m_base->findObject(id);
+}
+
+void LevelInstance::setObject(const LevelObject& obj)
+{
+    m_objectEdits[obj.id] = obj;
+}
+
+void LevelInstance::removeObject(std::uint32_t id)
+{
+    if (m_base->findObject(id)) {
+        m_objectEdits[id] = std::nullopt;
+    } else {
+        m_objectEdits.erase(id);
+    }
+}
+
+std::size_t LevelInstance::getEditCount() const
+{
+    return m_tileEdits.size() + m_objectEdits.size();
+}
+
+std::size_t LevelInstance::getMemoryUsage() const
+{
+    return sizeof(LevelInstance) + hashMapBytes(m_tileEdits) + hashMapBytes(m_objectEdits);
+}
+
+void LevelInstance::reset()
+{
+    m_tileEdits = {};
+    m_objectEdits = {};
+}
+
+const TileLayer& LevelInstance::layerAt(std::size_t layer, unsigned int x, unsigned int y) const
+{
+    if (layer >= m_base->layers.size()) {
+        throw std::out_of_range{"no layer " + std::to_string(layer) + " in level " + m_base->name};
+    }
+    const TileLayer& base = m_base->layers[layer];
+    if (x >= base.getSize().x || y >= base.getSize().y) {
+        throw std::out_of_range{"no tile (" + std::to_string(x) + ", " + std::to_string(y) + ") in layer " + base.getName()};
+    }
+    return base;
+}
+
+std::uint64_t LevelInstance::tileKey(std::size_t layer, std::size_t index)
+{
+    return static_cast<std::uint64_t>(layer) << 40 | static_cast<std::uint64_t>(index);
+}
@@ -0,0 +1,80 @@
+#include "LevelMap.h"
+
+sf::IntRect Tileset::getTextureRect(std::uint32_t gid) const
+{
+    const std::uint32_t local = (gid & ~GidFlipMask) - firstGid;
+    const std::uint32_t cols = columns ? columns : 1;
+    return {
+        static_cast<int>(margin + (local % cols) * (tileSize.x + spacing))
+      , static_cast<int>(margin + (local / cols) * (tileSize.y + spacing))
+      , static_cast<int>(tileSize.x)
+      , static_cast<int>(tileSize.y)
+    };
+}
+
+
+TileLayer::TileLayer(std::string name, sf::Vector2u size, std::vector<std::uint32_t> gids)
+  : m_name{std::move(name)}
+  , m_size{size}
+{
+    auto owner = std::make_shared<std::vector<std::uint32_t>>(std::move(gids));
+    owner->resize(static_cast<std::size_t>(size.x) * size.y);
+    m_gids = std::shared_ptr<const std::uint32_t>{owner, owner->data()};
+}
+
+TileLayer::TileLayer(std::string name, sf::Vector2u size, std::shared_ptr<const std::uint32_t> gids)
+  : m_name{std::move(name)}
+  , m_size{size}
+  , m_gids{std::move(gids)}
+{
+}
+
+const std::string& TileLayer::getName() const
+{
+    return m_name;
+}
+
+sf::Vector2u TileLayer::getSize() const
+{
+    return m_size;
+}
+
+
+void LevelMap::indexObjects()
+{
+    objectIndex.clear();
+    objectIndex.reserve(objects.size());
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        objectIndex[objects[i].id] = i;
+    }
+}
+
+const LevelObject * LevelMap::findObject(std::uint32_t id) const
+{
+    const auto found = objectIndex.find(id);
+    return found == objectIndex.end() ? nullptr : &objects[found->second];
+}
+
+const Tileset * LevelMap::findTileset(std::uint32_t gid) const
+{
+    gid &= ~GidFlipMask;
+    if (gid == 0) {
+        return nullptr;
+    }
+    const Tileset * found{nullptr};
+    for (const auto& ts : tilesets) {
+        if (ts.firstGid <= gid && (!found || ts.firstGid > found->firstGid)) { found = &ts; }
+    }
+    return found;
+}
+
+std::size_t LevelMap::getMemoryUsage() const
+{
+    std::size_t bytes{sizeof(LevelMap)};
+    for (const auto& layer : layers) {
+        bytes += sizeof(TileLayer) + static_cast<std::size_t>(layer.getSize().x) * layer.getSize().y * sizeof(std::uint32_t);
+    }
+    bytes += tilesets.size() * sizeof(Tileset) + objects.size() * sizeof(LevelObject);
+    bytes += objectIndex.size() * (sizeof(std::pair<std::uint32_t, std::size_t>) + 2 * sizeof(void*));
+    return bytes;
+}
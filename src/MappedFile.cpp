@@ -0,0 +1,68 @@
+#include "MappedFile.h"
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+
+MappedFile::MappedFile(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error{"can not open " + path};
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        throw std::runtime_error{"can not map " + path};
+    }
+    m_size = static_cast<std::size_t>(st.st_size);
+    void * p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        throw std::runtime_error{"can not map " + path};
+    }
+    m_data = static_cast<const unsigned char *>(p);
+}
+
+MappedFile::~MappedFile()
+{
+    ::munmap(const_cast<unsigned char *>(m_data), m_size);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path)
+{
+    std::ifstream src{path, std::ios::binary};
+    m_copy.assign(std::istreambuf_iterator<char>{src}, std::istreambuf_iterator<char>{});
+    if (!src.eof() || m_copy.empty()) {
+        throw std::runtime_error{"can not open " + path};
+    }
+    m_data = m_copy.data();
+    m_size = m_copy.size();
+}
+
+MappedFile::~MappedFile()
+{
+}
+
+#endif
+
+const unsigned char * MappedFile::data() const
+{
+    return m_data;
+}
+
+std::size_t MappedFile::size() const
+{
+    return m_size;
+}
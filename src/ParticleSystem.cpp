@@ -0,0 +1,268 @@
+#include "ParticleSystem.h"
+#include "CommandList.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PARTICLES_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+//! Particles per job when an update is split across a pool
+constexpr std::size_t JobSize = 16 * 1024;
+
+//! Two triangles per particle, as `SpriteBatch` lays out its quads
+constexpr std::size_t VerticesPerParticle = 6;
+
+//! The arrays one integration step touches
+struct Lanes {
+    float * x;
+    float * y;
+    float * vx;
+    float * vy;
+    float * age;
+} /*struct Lanes*/;
+
+using Integrate_t = void (*)(const Lanes&, std::size_t, std::size_t, float, sf::Vector2f);
+
+//! Integrates particles [i, end) one at a time; also the tail of the SIMD kernels
+void integrateScalar(const Lanes& p, std::size_t i, std::size_t end, float dt, sf::Vector2f gravity)
+{
+    const float gx = gravity.x * dt, gy = gravity.y * dt;
+    for (; i < end; ++i) {
+        p.vx[i] += gx, p.vy[i] += gy;
+        p.x[i] += p.vx[i] * dt, p.y[i] += p.vy[i] * dt;
+        p.age[i] += dt;
+    }
+}
+
+#if defined(PARTICLES_X86)
+__attribute__((target("avx2")))
+void integrateAvx2(const Lanes& p, std::size_t i, std::size_t end, float dt, sf::Vector2f gravity)
+{
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256 gx = _mm256_set1_ps(gravity.x * dt), gy = _mm256_set1_ps(gravity.y * dt);
+    for (; i + 8 <= end; i += 8) {
+        const __m256 nvx = _mm256_add_ps(_mm256_loadu_ps(p.vx + i), gx);
+        const __m256 nvy = _mm256_add_ps(_mm256_loadu_ps(p.vy + i), gy);
+        _mm256_storeu_ps(p.vx + i, nvx);
+        _mm256_storeu_ps(p.vy + i, nvy);
+        _mm256_storeu_ps(p.x + i, _mm256_add_ps(_mm256_loadu_ps(p.x + i), _mm256_mul_ps(nvx, vdt)));
+        _mm256_storeu_ps(p.y + i, _mm256_add_ps(_mm256_loadu_ps(p.y + i), _mm256_mul_ps(nvy, vdt)));
+        _mm256_storeu_ps(p.age + i, _mm256_add_ps(_mm256_loadu_ps(p.age + i), vdt));
+    }
+    integrateScalar(p, i, end, dt, gravity);
+}
+
+__attribute__((target("sse2")))
+void integrateSse2(const Lanes& p, std::size_t i, std::size_t end, float dt, sf::Vector2f gravity)
+{
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 gx = _mm_set1_ps(gravity.x * dt), gy = _mm_set1_ps(gravity.y * dt);
+    for (; i + 4 <= end; i += 4) {
+        const __m128 nvx = _mm_add_ps(_mm_loadu_ps(p.vx + i), gx);
+        const __m128 nvy = _mm_add_ps(_mm_loadu_ps(p.vy + i), gy);
+        _mm_storeu_ps(p.vx + i, nvx);
+        _mm_storeu_ps(p.vy + i, nvy);
+        _mm_storeu_ps(p.x + i, _mm_add_ps(_mm_loadu_ps(p.x + i), _mm_mul_ps(nvx, vdt)));
+        _mm_storeu_ps(p.y + i, _mm_add_ps(_mm_loadu_ps(p.y + i), _mm_mul_ps(nvy, vdt)));
+        _mm_storeu_ps(p.age + i, _mm_add_ps(_mm_loadu_ps(p.age + i), vdt));
+    }
+    integrateScalar(p, i, end, dt, gravity);
+}
+#endif
+
+struct Kernel {
+    Integrate_t integrate;
+    const char * name;
+} /*struct Kernel*/;
+
+//! The widest kernel the running CPU supports, whatever the build targets
+const Kernel& kernel()
+{
+    static const Kernel picked = [] {
+#if defined(PARTICLES_X86)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) { return Kernel{integrateAvx2, "AVX2"}; }
+        if (__builtin_cpu_supports("sse2")) { return Kernel{integrateSse2, "SSE2"}; }
+#endif
+        return Kernel{integrateScalar, "scalar"};
+    }();
+    return picked;
+}
+
+} /*namespace*/;
+
+
+ParticleSystem::ParticleSystem(std::size_t capacity)
+  : m_capacity{capacity}
+  , m_x(capacity), m_y(capacity), m_vx(capacity), m_vy(capacity)
+  , m_age(capacity), m_life(capacity), m_invLife(capacity), m_size(capacity)
+  , m_color(capacity)
+{
+    m_vertices.reserve(capacity * VerticesPerParticle);
+}
+
+void ParticleSystem::setGravity(sf::Vector2f gravity)
+{
+    m_gravity = gravity;
+}
+
+void ParticleSystem::setTexture(const sf::Texture * texture, const sf::IntRect& rect)
+{
+    m_texture = texture;
+    m_textureRect = rect;
+    m_texCoordsValid = false;
+}
+
+std::size_t ParticleSystem::emit(const Emitter& emitter, std::size_t count)
+{
+    count = std::min(count, m_capacity - m_count);
+    for (std::size_t i = m_count; i < m_count + count; ++i) {
+        m_x[i] = emitter.position.x;
+        m_y[i] = emitter.position.y;
+        m_vx[i] = emitter.velocity.x + emitter.spread.x * (2.f * random() - 1.f);
+        m_vy[i] = emitter.velocity.y + emitter.spread.y * (2.f * random() - 1.f);
+        m_age[i] = 0.f;
+        m_life[i] = emitter.minLife + (emitter.maxLife - emitter.minLife) * random();
+        m_invLife[i] = 1.f / m_life[i];
+        m_size[i] = emitter.size;
+        m_color[i] = emitter.color;
+    }
+    m_count += count;
+    return count;
+}
+
+void ParticleSystem::update(float dt)
+{
+    simulate(0, m_count, dt);
+    compact();
+    resizeVertices();
+    writeVertices(0, m_count);
+}
+
+void ParticleSystem::update(float dt, WorkerPool& pool)
+{
+    // Waits only for this system's jobs, so other work may share the pool
+    WorkerPool::Latch simulated{};
+    for (std::size_t begin = 0; begin < m_count; begin += JobSize) {
+        const std::size_t end = std::min(begin + JobSize, m_count);
+        pool.submit(simulated, [this, begin, end, dt] { simulate(begin, end, dt); });
+    }
+    pool.wait(simulated);
+    compact();
+    resizeVertices();
+    WorkerPool::Latch written{};
+    for (std::size_t begin = 0; begin < m_count; begin += JobSize) {
+        const std::size_t end = std::min(begin + JobSize, m_count);
+        pool.submit(written, [this, begin, end] { writeVertices(begin, end); });
+    }
+    pool.wait(written);
+}
+
+std::size_t ParticleSystem::size() const
+{
+    return m_count;
+}
+
+std::size_t ParticleSystem::capacity() const
+{
+    return m_capacity;
+}
+
+const char * ParticleSystem::getSimdPath()
+{
+    return kernel().name;
+}
+
+void ParticleSystem::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    if (m_vertices.empty()) {
+        return;
+    }
+    states.transform *= getTransform();
+    states.texture = m_texture;
+    target.draw(m_vertices.data(), m_vertices.size(), sf::Triangles, states);
+}
+
+void ParticleSystem::record(CommandList& list, sf::RenderStates states) const
+{
+    if (m_vertices.empty()) {
+        return;
+    }
+    states.transform *= getTransform();
+    states.texture = m_texture;
+    list.vertices(SortKey::make(getLayer(), getDepth(), m_texture, states.blendMode), m_vertices.data(), m_vertices.size(), sf::Triangles, states);
+}
+
+void ParticleSystem::simulate(std::size_t begin, std::size_t end, float dt)
+{
+    const Lanes lanes{m_x.data(), m_y.data(), m_vx.data(), m_vy.data(), m_age.data()};
+    kernel().integrate(lanes, begin, end, dt, m_gravity);
+}
+
+void ParticleSystem::compact()
+{
+    for (std::size_t i = 0; i < m_count;) {
+        if (m_age[i] < m_life[i]) {
+            ++i;
+            continue;
+        }
+        const std::size_t last = --m_count;
+        m_x[i] = m_x[last], m_y[i] = m_y[last];
+        m_vx[i] = m_vx[last], m_vy[i] = m_vy[last];
+        m_age[i] = m_age[last], m_life[i] = m_life[last], m_invLife[i] = m_invLife[last];
+        m_size[i] = m_size[last], m_color[i] = m_color[last];
+    }
+}
+
+void ParticleSystem::writeVertices(std::size_t begin, std::size_t end)
+{
+    sf::Vertex * out = m_vertices.data() + begin * VerticesPerParticle;
+    for (std::size_t i = begin; i < end; ++i, out += VerticesPerParticle) {
+        const float half = m_size[i] * 0.5f;
+        const float left = m_x[i] - half, right = m_x[i] + half;
+        const float top = m_y[i] - half, bottom = m_y[i] + half;
+
+        // Fade out linearly over the particle's life
+        sf::Color color = m_color[i];
+        color.a = static_cast<sf::Uint8>(color.a * std::max(0.f, 1.f - m_age[i] * m_invLife[i]));
+
+        // Texture coordinates never change per frame, see `setTexture` and `update`
+        out[0].position = {left, top}, out[0].color = color;
+        out[1].position = {right, top}, out[1].color = color;
+        out[2].position = {right, bottom}, out[2].color = color;
+        out[3].position = {left, top}, out[3].color = color;
+        out[4].position = {right, bottom}, out[4].color = color;
+        out[5].position = {left, bottom}, out[5].color = color;
+    }
+}
+
+void ParticleSystem::resizeVertices()
+{
+    const std::size_t quads = m_vertices.size() / VerticesPerParticle;
+    m_vertices.resize(m_count * VerticesPerParticle);
+    const std::size_t fresh = m_texCoordsValid ? std::min(quads, m_count) : 0;
+    const float u0 = static_cast<float>(m_textureRect.left), u1 = u0 + m_textureRect.width;
+    const float v0 = static_cast<float>(m_textureRect.top), v1 = v0 + m_textureRect.height;
+    for (std::size_t q = fresh; q < m_count; ++q) {
+        sf::Vertex * out = &m_vertices[q * VerticesPerParticle];
+        out[0].texCoords = {u0, v0};
+        out[1].texCoords = {u1, v0};
+        out[2].texCoords = {u1, v1};
+        out[3].texCoords = {u0, v0};
+        out[4].texCoords = {u1, v1};
+        out[5].texCoords = {u0, v1};
+    }
+    m_texCoordsValid = true;
+}
+
+float ParticleSystem::random()
+{
+    // xorshift32: plenty for visual noise and far cheaper than <random>
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+    return (m_seed >> 8) * (1.f / 16777216.f);
+}
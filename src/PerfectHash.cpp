@@ -0,0 +1,57 @@
+#include "PerfectHash.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+PerfectHash::PerfectHash() : m_seeds(1, 0u)
+{
+}
+
+PerfectHash::PerfectHash(const std::vector<std::uint64_t>& hashes)
+{
+    // Equal hashes could never be separated, however long the seed search
+    std::vector<std::uint64_t> sorted = hashes;
+    std::sort(sorted.begin(), sorted.end());
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+        throw std::invalid_argument{"perfect hash: duplicate keys"};
+    }
+
+    const std::size_t n = hashes.size();
+    m_seeds.assign(std::max<std::size_t>(1, (n + 3) / 4), 0u);
+    m_slots = n + n / 10 + 1;
+
+    std::vector<std::vector<std::uint64_t>> buckets(m_seeds.size());
+    for (std::uint64_t h : hashes) { buckets[reduce(mix(h), buckets.size())].push_back(h); }
+    std::vector<std::size_t> order(buckets.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    std::vector<bool> taken(m_slots, false);
+    std::vector<std::size_t> placed;
+    for (std::size_t b : order) {
+        const auto& keys = buckets[b];
+        if (keys.empty()) {
+            break;
+        }
+        for (std::uint32_t seed = 0; ; ++seed) {
+            if (seed == 0xffffffffu) {
+                throw std::runtime_error{"perfect hash: no seed separates a bucket"};
+            }
+            m_seeds[b] = seed;
+            placed.clear();
+            bool fits{true};
+            for (std::uint64_t h : keys) {
+                const std::size_t s = slot(h);
+                if (taken[s] || std::find(placed.begin(), placed.end(), s) != placed.end()) {
+                    fits = false;
+                    break;
+                }
+                placed.push_back(s);
+            }
+            if (fits) {
+                for (std::size_t s : placed) { taken[s] = true; }
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#include "QuadTransform.h"
+#include <cstddef>
+#include <cstdlib>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+static_assert(offsetof(sf::Vertex, position) == 0 && sizeof(sf::Vector2f) == 8, "SIMD stores assume packed vertex positions");
+
+//! Writes everything but the positions of one quad's vertices
+void writeAttributes(const LocalQuad& q, sf::Vertex * v, QuadLayout layout)
+{
+    const float u0 = q.texRect.left, u1 = u0 + q.texRect.width;
+    const float v0 = q.texRect.top, v1 = v0 + q.texRect.height;
+    v[0].color = v[1].color = v[2].color = v[3].color = q.color;
+    v[0].texCoords = {u0, v0};
+    v[1].texCoords = {u1, v0};
+    v[2].texCoords = {u1, v1};
+    if (layout == QuadLayout::Quads) {
+        v[3].texCoords = {u0, v1};
+        return;
+    }
+    v[4].color = v[5].color = q.color;
+    v[3].texCoords = {u0, v0};
+    v[4].texCoords = {u1, v1};
+    v[5].texCoords = {u0, v1};
+}
+
+#if defined(__SSE2__)
+//! Stores corners (x, y) 0-3 of one quad, packed as [x0 y0 x1 y1] and [x2 y2 x3 y3]
+void storeCorners(__m128 lo, __m128 hi, sf::Vertex * v, QuadLayout layout)
+{
+    auto at = [](sf::Vertex& vertex) { return reinterpret_cast<__m64 *>(&vertex.position); };
+    _mm_storel_pi(at(v[0]), lo);
+    _mm_storeh_pi(at(v[1]), lo);
+    _mm_storel_pi(at(v[2]), hi);
+    if (layout == QuadLayout::Quads) {
+        _mm_storeh_pi(at(v[3]), hi);
+        return;
+    }
+    _mm_storel_pi(at(v[3]), lo);
+    _mm_storel_pi(at(v[4]), hi);
+    _mm_storeh_pi(at(v[5]), hi);
+}
+#endif
+
+} /*namespace*/;
+
+
+LocalQuad localQuad(const sf::Sprite& sprite)
+{
+    const sf::IntRect rect = sprite.getTextureRect();
+    return LocalQuad{
+        {0.f, 0.f, static_cast<float>(std::abs(rect.width)), static_cast<float>(std::abs(rect.height))}
+      , sf::FloatRect{rect}
+      , sprite.getColor()
+    };
+}
+
+void transformQuads(const sf::Transform * transforms, const LocalQuad * quads, std::size_t count, sf::Vertex * out, QuadLayout layout)
+{
+    const std::size_t stride = layout == QuadLayout::Quads ? 4 : 6;
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    // Lanes 0-3 hold quad i's corners, lanes 4-7 quad i + 1's
+    for (; i + 2 <= count; i += 2) {
+        const float * m0 = transforms[i].getMatrix();
+        const float * m1 = transforms[i + 1].getMatrix();
+        const sf::FloatRect& r0 = quads[i].rect;
+        const sf::FloatRect& r1 = quads[i + 1].rect;
+        const float l0 = r0.left, t0 = r0.top, w0 = l0 + r0.width, b0 = t0 + r0.height;
+        const float l1 = r1.left, t1 = r1.top, w1 = l1 + r1.width, b1 = t1 + r1.height;
+        const __m256 xs = _mm256_setr_ps(l0, w0, w0, l0, l1, w1, w1, l1);
+        const __m256 ys = _mm256_setr_ps(t0, t0, b0, b0, t1, t1, b1, b1);
+        auto pair = [](float a, float b) { return _mm256_setr_m128(_mm_set1_ps(a), _mm_set1_ps(b)); };
+        const __m256 px = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pair(m0[0], m1[0]), xs), _mm256_mul_ps(pair(m0[4], m1[4]), ys)), pair(m0[12], m1[12]));
+        const __m256 py = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pair(m0[1], m1[1]), xs), _mm256_mul_ps(pair(m0[5], m1[5]), ys)), pair(m0[13], m1[13]));
+        const __m256 lo = _mm256_unpacklo_ps(px, py);
+        const __m256 hi = _mm256_unpackhi_ps(px, py);
+        sf::Vertex * v = out + i * stride;
+        storeCorners(_mm256_castps256_ps128(lo), _mm256_castps256_ps128(hi), v, layout);
+        storeCorners(_mm256_extractf128_ps(lo, 1), _mm256_extractf128_ps(hi, 1), v + stride, layout);
+        writeAttributes(quads[i], v, layout);
+        writeAttributes(quads[i + 1], v + stride, layout);
+    }
+#elif defined(__SSE2__)
+    for (; i < count; ++i) {
+        const float * m = transforms[i].getMatrix();
+        const sf::FloatRect& r = quads[i].rect;
+        const float l = r.left, t = r.top, w = l + r.width, b = t + r.height;
+        const __m128 xs = _mm_setr_ps(l, w, w, l);
+        const __m128 ys = _mm_setr_ps(t, t, b, b);
+        const __m128 px = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[0]), xs), _mm_mul_ps(_mm_set1_ps(m[4]), ys)), _mm_set1_ps(m[12]));
+        const __m128 py = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[1]), xs), _mm_mul_ps(_mm_set1_ps(m[5]), ys)), _mm_set1_ps(m[13]));
+        sf::Vertex * v = out + i * stride;
+        storeCorners(_mm_unpacklo_ps(px, py), _mm_unpackhi_ps(px, py), v, layout);
+        writeAttributes(quads[i], v, layout);
+    }
+#endif
+
+    // The scalar loop handles the tail, and everything on other targets
+    for (; i < count; ++i) {
+        const sf::Transform& m = transforms[i];
+        const sf::FloatRect& r = quads[i].rect;
+        const float l = r.left, t = r.top, w = l + r.width, b = t + r.height;
+        sf::Vertex * v = out + i * stride;
+        v[0].position = m.transformPoint(l, t);
+        v[1].position = m.transformPoint(w, t);
+        v[2].position = m.transformPoint(w, b);
+        if (layout == QuadLayout::Quads) {
+            v[3].position = m.transformPoint(l, b);
+        } else {
+            v[3].position = v[0].position;
+            v[4].position = v[2].position;
+            v[5].position = m.transformPoint(l, b);
+        }
+        writeAttributes(quads[i], v, layout);
+    }
+}
@@ -0,0 +1,57 @@
+#include "RenderDevice.h"
+
+RenderTargetDevice::RenderTargetDevice(sf::RenderTarget& target) : m_target{target}
+{
+}
+
+void RenderTargetDevice::draw(const sf::Vertex * vertices, std::size_t count, sf::PrimitiveType primitive, const sf::RenderStates& states)
+{
+    m_target.draw(vertices, count, primitive, states);
+}
+
+bool RenderTargetDevice::draw(const sf::Drawable& drawable, const sf::RenderStates& states)
+{
+    m_target.draw(drawable, states);
+    return true;
+}
+
+const sf::View& RenderTargetDevice::getView() const
+{
+    return m_target.getView();
+}
+
+sf::Vector2u RenderTargetDevice::getSize() const
+{
+    return m_target.getSize();
+}
+
+
+NullRenderDevice::NullRenderDevice(sf::Vector2u size)
+  : m_size{size}
+  , m_view{sf::FloatRect{0.f, 0.f, static_cast<float>(size.x), static_cast<float>(size.y)}}
+{
+}
+
+void NullRenderDevice::draw(const sf::Vertex *, std::size_t, sf::PrimitiveType, const sf::RenderStates&)
+{
+}
+
+bool NullRenderDevice::draw(const sf::Drawable&, const sf::RenderStates&)
+{
+    return true;
+}
+
+const sf::View& NullRenderDevice::getView() const
+{
+    return m_view;
+}
+
+sf::Vector2u NullRenderDevice::getSize() const
+{
+    return m_size;
+}
+
+void NullRenderDevice::setView(const sf::View& view)
+{
+    m_view = view;
+}
@@ -0,0 +1,86 @@
+#include "SkylinePacker.h"
+#include <algorithm>
+#include <limits>
+
+SkylinePacker::SkylinePacker(sf::Vector2u size) : m_size{size}, m_skyline{{0, 0, size.x}}
+{
+}
+
+std::optional<sf::Vector2u> SkylinePacker::insert(sf::Vector2u size)
+{
+    std::size_t best{m_skyline.size()};
+    unsigned int bestTop{std::numeric_limits<unsigned int>::max()};
+    unsigned int bestWidth{std::numeric_limits<unsigned int>::max()};
+    unsigned int bestY{0};
+    for (std::size_t i = 0; i < m_skyline.size(); ++i) {
+        unsigned int y;
+        if (!fits(i, size, y)) {
+            continue;
+        }
+        if (y + size.y < bestTop || (y + size.y == bestTop && m_skyline[i].width < bestWidth)) {
+            best = i, bestTop = y + size.y, bestWidth = m_skyline[i].width, bestY = y;
+        }
+    }
+    if (best == m_skyline.size()) {
+        return std::nullopt;
+    }
+
+    const Segment placed{m_skyline[best].x, bestTop, size.x};
+    m_skyline.insert(m_skyline.begin() + best, placed);
+
+    // Trim whatever the new segment now covers
+    const unsigned int end = placed.x + placed.width;
+    for (std::size_t i = best + 1; i < m_skyline.size();) {
+        Segment& seg = m_skyline[i];
+        if (seg.x >= end) {
+            break;
+        }
+        const unsigned int covered = end - seg.x;
+        if (seg.width <= covered) {
+            m_skyline.erase(m_skyline.begin() + i);
+            continue;
+        }
+        seg.x += covered, seg.width -= covered;
+        break;
+    }
+
+    // Neighbours at the same height are one segment
+    for (std::size_t i = 0; i + 1 < m_skyline.size();) {
+        if (m_skyline[i].y == m_skyline[i + 1].y) {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        } else {
+            ++i;
+        }
+    }
+
+    m_used += static_cast<std::size_t>(size.x) * size.y;
+    return sf::Vector2u{placed.x, bestY};
+}
+
+sf::Vector2u SkylinePacker::getSize() const
+{
+    return m_size;
+}
+
+float SkylinePacker::getOccupancy() const
+{
+    const std::size_t area = static_cast<std::size_t>(m_size.x) * m_size.y;
+    return area ? static_cast<float>(m_used) / area : 0.f;
+}
+
+bool SkylinePacker::fits(std::size_t i, sf::Vector2u size, unsigned int& y) const
+{
+    if (m_skyline[i].x + size.x > m_size.x) {
+        return false;
+    }
+    y = 0;
+    for (long remaining = size.x; remaining > 0; ++i) {
+        y = std::max(y, m_skyline[i].y);
+        if (y + size.y > m_size.y) {
+            return false;
+        }
+        remaining -= m_skyline[i].width;
+    }
+    return true;
+}
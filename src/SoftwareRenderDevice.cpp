@@ -0,0 +1,258 @@
+#include "SoftwareRenderDevice.h"
+#include "Hash.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+float edge(float ax, float ay, float bx, float by, float px, float py)
+{
+    return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+}
+
+//! Breaks ties on shared edges: of the two directions an edge is walked in, exactly one owns it
+bool ownsEdge(float ax, float ay, float bx, float by)
+{
+    return by > ay || (by == ay && bx < ax);
+}
+
+float factor(sf::BlendMode::Factor f, float src, float srcAlpha, float dst, float dstAlpha)
+{
+    switch (f) {
+    case sf::BlendMode::Zero: return 0.f;
+    case sf::BlendMode::One: return 1.f;
+    case sf::BlendMode::SrcColor: return src;
+    case sf::BlendMode::OneMinusSrcColor: return 1.f - src;
+    case sf::BlendMode::DstColor: return dst;
+    case sf::BlendMode::OneMinusDstColor: return 1.f - dst;
+    case sf::BlendMode::SrcAlpha: return srcAlpha;
+    case sf::BlendMode::OneMinusSrcAlpha: return 1.f - srcAlpha;
+    case sf::BlendMode::DstAlpha: return dstAlpha;
+    case sf::BlendMode::OneMinusDstAlpha: return 1.f - dstAlpha;
+    }
+    return 1.f;
+}
+
+float combine(sf::BlendMode::Equation eq, float src, float dst)
+{
+    switch (eq) {
+    case sf::BlendMode::Add: return src + dst;
+    case sf::BlendMode::Subtract: return src - dst;
+    case sf::BlendMode::ReverseSubtract: return dst - src;
+    }
+    return src + dst;
+}
+
+std::uint8_t toByte(float v)
+{
+    return static_cast<std::uint8_t>(std::lround(std::min(std::max(v, 0.f), 1.f) * 255.f));
+}
+
+} /*namespace*/;
+
+
+SoftwareRenderDevice::SoftwareRenderDevice(sf::Vector2u size)
+  : m_pixels(static_cast<std::size_t>(size.x) * size.y * 4)
+  , m_size{size}
+  , m_view{sf::FloatRect{0.f, 0.f, static_cast<float>(size.x), static_cast<float>(size.y)}}
+{
+    clear();
+}
+
+void SoftwareRenderDevice::setTextureImage(const sf::Texture& texture, const sf::Image& image)
+{
+    m_textures[&texture] = image;
+}
+
+void SoftwareRenderDevice::setView(const sf::View& view)
+{
+    m_view = view;
+}
+
+void SoftwareRenderDevice::clear(sf::Color color)
+{
+    for (std::size_t i = 0; i < m_pixels.size(); i += 4) {
+        m_pixels[i] = color.r, m_pixels[i + 1] = color.g, m_pixels[i + 2] = color.b, m_pixels[i + 3] = color.a;
+    }
+}
+
+void SoftwareRenderDevice::draw(const sf::Vertex * vertices, std::size_t count, sf::PrimitiveType primitive, const sf::RenderStates& states)
+{
+    ++m_stats.draws;
+    const sf::Transform transform = m_view.getTransform() * states.transform;
+    const auto found = states.texture ? m_textures.find(states.texture) : m_textures.end();
+    const sf::Image * texture = found != m_textures.end() ? &found->second : nullptr;
+    auto at = [&](std::size_t i) { return project(vertices[i], transform); };
+
+    switch (primitive) {
+    case sf::Points:
+        for (std::size_t i = 0; i < count; ++i) {
+            const Point p = at(i);
+            plot(static_cast<int>(std::floor(p.x)), static_cast<int>(std::floor(p.y)), p.r, p.g, p.b, p.a, states.blendMode);
+        }
+        break;
+    case sf::Lines:
+        for (std::size_t i = 0; i + 1 < count; i += 2) { line(at(i), at(i + 1), states.blendMode); }
+        break;
+    case sf::LineStrip:
+        for (std::size_t i = 0; i + 1 < count; ++i) { line(at(i), at(i + 1), states.blendMode); }
+        break;
+    case sf::Triangles:
+        for (std::size_t i = 0; i + 2 < count; i += 3) { triangle(at(i), at(i + 1), at(i + 2), texture, states.blendMode); }
+        break;
+    case sf::TriangleStrip:
+        for (std::size_t i = 0; i + 2 < count; ++i) { triangle(at(i), at(i + 1), at(i + 2), texture, states.blendMode); }
+        break;
+    case sf::TriangleFan:
+        for (std::size_t i = 1; i + 1 < count; ++i) { triangle(at(0), at(i), at(i + 1), texture, states.blendMode); }
+        break;
+    case sf::Quads:
+        for (std::size_t i = 0; i + 3 < count; i += 4) {
+            const Point a = at(i), c = at(i + 2);
+            triangle(a, at(i + 1), c, texture, states.blendMode);
+            triangle(a, c, at(i + 3), texture, states.blendMode);
+        }
+        break;
+    }
+}
+
+bool SoftwareRenderDevice::draw(const sf::Drawable&, const sf::RenderStates&)
+{
+    ++m_stats.skippedDrawables;
+    return false;
+}
+
+const sf::View& SoftwareRenderDevice::getView() const
+{
+    return m_view;
+}
+
+sf::Vector2u SoftwareRenderDevice::getSize() const
+{
+    return m_size;
+}
+
+sf::Color SoftwareRenderDevice::getPixel(unsigned int x, unsigned int y) const
+{
+    const std::uint8_t * p = &m_pixels[(static_cast<std::size_t>(y) * m_size.x + x) * 4];
+    return {p[0], p[1], p[2], p[3]};
+}
+
+sf::Image SoftwareRenderDevice::copyToImage() const
+{
+    sf::Image image{};
+    image.create(m_size.x, m_size.y, m_pixels.data());
+    return image;
+}
+
+std::uint64_t SoftwareRenderDevice::checksum() const
+{
+    return fnv1a(m_pixels.data(), m_pixels.size());
+}
+
+const SoftwareRenderDevice::Stats& SoftwareRenderDevice::getStats() const
+{
+    return m_stats;
+}
+
+void SoftwareRenderDevice::resetStats()
+{
+    m_stats = {};
+}
+
+SoftwareRenderDevice::Point SoftwareRenderDevice::project(const sf::Vertex& vertex, const sf::Transform& transform) const
+{
+    // Normalized device coordinates, then the view's viewport in pixels
+    const sf::Vector2f ndc = transform.transformPoint(vertex.position);
+    const sf::FloatRect& port = m_view.getViewport();
+    return Point{
+        (port.left + (ndc.x + 1.f) * 0.5f * port.width) * m_size.x
+      , (port.top + (1.f - ndc.y) * 0.5f * port.height) * m_size.y
+      , vertex.color.r / 255.f, vertex.color.g / 255.f, vertex.color.b / 255.f, vertex.color.a / 255.f
+      , vertex.texCoords.x, vertex.texCoords.y
+    };
+}
+
+void SoftwareRenderDevice::triangle(Point a, Point b, Point c, const sf::Image * texture, const sf::BlendMode& blend)
+{
+    float area = edge(a.x, a.y, b.x, b.y, c.x, c.y);
+    if (area == 0.f) {
+        return;
+    }
+    if (area < 0.f) {
+        std::swap(b, c);
+        area = -area;
+    }
+    ++m_stats.triangles;
+
+    const int x0 = std::max(0, static_cast<int>(std::floor(std::min({a.x, b.x, c.x}))));
+    const int y0 = std::max(0, static_cast<int>(std::floor(std::min({a.y, b.y, c.y}))));
+    const int x1 = std::min(static_cast<int>(m_size.x) - 1, static_cast<int>(std::ceil(std::max({a.x, b.x, c.x}))));
+    const int y1 = std::min(static_cast<int>(m_size.y) - 1, static_cast<int>(std::ceil(std::max({a.y, b.y, c.y}))));
+    const bool ownBC = ownsEdge(b.x, b.y, c.x, c.y), ownCA = ownsEdge(c.x, c.y, a.x, a.y), ownAB = ownsEdge(a.x, a.y, b.x, b.y);
+    const sf::Vector2u texSize = texture ? texture->getSize() : sf::Vector2u{};
+    const std::uint8_t * texels = texture ? texture->getPixelsPtr() : nullptr;
+
+    for (int y = y0; y <= y1; ++y) {
+        const float py = y + 0.5f;
+        for (int x = x0; x <= x1; ++x) {
+            const float px = x + 0.5f;
+            const float wa = edge(b.x, b.y, c.x, c.y, px, py);
+            const float wb = edge(c.x, c.y, a.x, a.y, px, py);
+            const float wc = edge(a.x, a.y, b.x, b.y, px, py);
+            if (wa < 0.f || wb < 0.f || wc < 0.f
+                || (wa == 0.f && !ownBC) || (wb == 0.f && !ownCA) || (wc == 0.f && !ownAB)) {
+                continue;
+            }
+            const float la = wa / area, lb = wb / area, lc = wc / area;
+            float r = a.r * la + b.r * lb + c.r * lc;
+            float g = a.g * la + b.g * lb + c.g * lc;
+            float bl = a.b * la + b.b * lb + c.b * lc;
+            float al = a.a * la + b.a * lb + c.a * lc;
+            if (texels && texSize.x && texSize.y) {
+                const float u = a.u * la + b.u * lb + c.u * lc;
+                const float v = a.v * la + b.v * lb + c.v * lc;
+                const int tx = std::min(std::max(static_cast<int>(std::floor(u)), 0), static_cast<int>(texSize.x) - 1);
+                const int ty = std::min(std::max(static_cast<int>(std::floor(v)), 0), static_cast<int>(texSize.y) - 1);
+                const std::uint8_t * t = texels + (static_cast<std::size_t>(ty) * texSize.x + tx) * 4;
+                r *= t[0] / 255.f, g *= t[1] / 255.f, bl *= t[2] / 255.f, al *= t[3] / 255.f;
+            }
+            plot(x, y, r, g, bl, al, blend);
+        }
+    }
+}
+
+void SoftwareRenderDevice::line(const Point& a, const Point& b, const sf::BlendMode& blend)
+{
+    ++m_stats.lines;
+    const float dx = b.x - a.x, dy = b.y - a.y;
+    const int steps = std::max(1, static_cast<int>(std::ceil(std::max(std::abs(dx), std::abs(dy)))));
+    for (int i = 0; i <= steps; ++i) {
+        const float t = static_cast<float>(i) / steps;
+        plot(static_cast<int>(std::floor(a.x + dx * t)), static_cast<int>(std::floor(a.y + dy * t))
+            , a.r + (b.r - a.r) * t, a.g + (b.g - a.g) * t, a.b + (b.b - a.b) * t, a.a + (b.a - a.a) * t, blend);
+    }
+}
+
+void SoftwareRenderDevice::plot(int x, int y, float r, float g, float b, float a, const sf::BlendMode& blend)
+{
+    if (x < 0 || y < 0 || x >= static_cast<int>(m_size.x) || y >= static_cast<int>(m_size.y)) {
+        return;
+    }
+    ++m_stats.pixels;
+    std::uint8_t * p = &m_pixels[(static_cast<std::size_t>(y) * m_size.x + x) * 4];
+    const float dr = p[0] / 255.f, dg = p[1] / 255.f, db = p[2] / 255.f, da = p[3] / 255.f;
+
+    auto channel = [&](float src, float dst) {
+        return combine(blend.colorEquation
+            , src * factor(blend.colorSrcFactor, src, a, dst, da)
+            , dst * factor(blend.colorDstFactor, src, a, dst, da));
+    };
+    p[0] = toByte(channel(r, dr));
+    p[1] = toByte(channel(g, dg));
+    p[2] = toByte(channel(b, db));
+    p[3] = toByte(combine(blend.alphaEquation
+        , a * factor(blend.alphaSrcFactor, a, a, da, da)
+        , da * factor(blend.alphaDstFactor, a, a, da, da)));
+}
@@ -0,0 +1,142 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+sf::FloatRect viewBounds(const sf::View& view)
+{
+    const sf::Vector2f half{view.getSize().x / 2.f, view.getSize().y / 2.f};
+    const sf::FloatRect area{view.getCenter() - half, view.getSize()};
+    if (view.getRotation() == 0.f) {
+        return area;
+    }
+    return sf::Transform{}.rotate(view.getRotation(), view.getCenter()).transformRect(area);
+}
+
+
+SpatialGrid::SpatialGrid(float cellSize) : m_cellSize{cellSize}
+{
+}
+
+void SpatialGrid::update(Id id, const sf::FloatRect& bounds)
+{
+    if (id >= m_entries.size()) {
+        m_entries.resize(id + 1);
+    }
+    Entry& entry = m_entries[id];
+    const sf::IntRect cells = cellsOf(bounds);
+    if (!entry.live) {
+        link(id, cells);
+        entry.live = true;
+        ++m_live;
+    } else if (cells != entry.cells) {
+        unlink(id, entry.cells);
+        link(id, cells);
+    }
+    entry.bounds = bounds;
+    entry.cells = cells;
+}
+
+void SpatialGrid::remove(Id id)
+{
+    if (!contains(id)) {
+        return;
+    }
+    unlink(id, m_entries[id].cells);
+    m_entries[id].live = false;
+    --m_live;
+}
+
+bool SpatialGrid::contains(Id id) const
+{
+    return id < m_entries.size() && m_entries[id].live;
+}
+
+void SpatialGrid::query(const sf::FloatRect& area, std::vector<Id>& out) const
+{
+    if (++m_stamp == 0) {
+        for (const auto& entry : m_entries) { entry.stamp = 0; }
+        m_stamp = 1;
+    }
+
+    const std::size_t first = out.size();
+    auto visit = [&](Id id) {
+        const Entry& entry = m_entries[id];
+        if (entry.stamp != m_stamp) {
+            entry.stamp = m_stamp;
+            if (entry.bounds.intersects(area)) { out.push_back(id); }
+        }
+    };
+
+    // A zoomed-out view may span more cells than are occupied; walk whichever is fewer
+    const sf::IntRect cells = cellsOf(area);
+    if (static_cast<double>(cells.width) * cells.height > m_cells.size()) {
+        for (const auto& cell : m_cells) {
+            for (const Id id : cell.second) { visit(id); }
+        }
+    } else {
+        for (int y = cells.top; y < cells.top + cells.height; ++y) {
+            for (int x = cells.left; x < cells.left + cells.width; ++x) {
+                visitCell(cellKey(x, y), visit);
+            }
+        }
+    }
+    std::sort(out.begin() + first, out.end());
+}
+
+std::size_t SpatialGrid::size() const
+{
+    return m_live;
+}
+
+sf::IntRect SpatialGrid::cellsOf(const sf::FloatRect& bounds) const
+{
+    const int left = static_cast<int>(std::floor(bounds.left / m_cellSize));
+    const int top = static_cast<int>(std::floor(bounds.top / m_cellSize));
+    const int right = static_cast<int>(std::floor((bounds.left + bounds.width) / m_cellSize));
+    const int bottom = static_cast<int>(std::floor((bounds.top + bounds.height) / m_cellSize));
+    return {left, top, right - left + 1, bottom - top + 1};
+}
+
+std::uint64_t SpatialGrid::cellKey(int x, int y)
+{
+    return static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32 | static_cast<std::uint32_t>(y);
+}
+
+void SpatialGrid::link(Id id, const sf::IntRect& cells)
+{
+    for (int y = cells.top; y < cells.top + cells.height; ++y) {
+        for (int x = cells.left; x < cells.left + cells.width; ++x) {
+            m_cells[cellKey(x, y)].push_back(id);
+        }
+    }
+}
+
+void SpatialGrid::unlink(Id id, const sf::IntRect& cells)
+{
+    for (int y = cells.top; y < cells.top + cells.height; ++y) {
+        for (int x = cells.left; x < cells.left + cells.width; ++x) {
+            const auto cell = m_cells.find(cellKey(x, y));
+            if (cell == m_cells.end()) {
+                continue;
+            }
+            auto& ids = cell->second;
+            const auto it = std::find(ids.begin(), ids.end(), id);
+            if (it != ids.end()) {
+                *it = ids.back();
+                ids.pop_back();
+            }
+            if (ids.empty()) {
+                m_cells.erase(cell);
+            }
+        }
+    }
+}
+
+template<typename F>
+void SpatialGrid::visitCell(std::uint64_t key, F&& visit) const
+{
+    const auto cell = m_cells.find(key);
+    if (cell != m_cells.end()) {
+        for (const Id id : cell->second) { visit(id); }
+    }
+}
@@ -0,0 +1,78 @@
+#include "SpriteBatch.h"
+
+void spriteQuad(const sf::Sprite& sprite, const sf::Transform& transform, sf::Vertex (&quad)[4])
+{
+    const sf::Transform combined = transform * sprite.getTransform();
+    const LocalQuad local = localQuad(sprite);
+    transformQuads(&combined, &local, 1, quad);
+}
+
+
+void SpriteBatch::add(const sf::Sprite& sprite, const sf::RenderStates& states)
+{
+    sf::Vertex quad[4];
+    spriteQuad(sprite, states.transform, quad);
+    addQuad(sprite.getTexture(), states.blendMode, quad);
+}
+
+void SpriteBatch::addQuad(const sf::Texture * texture, const sf::BlendMode& blend, const sf::Vertex (&quad)[4])
+{
+    sf::VertexArray& vertices = batchFor(texture, blend).vertices;
+    vertices.append(quad[0]), vertices.append(quad[1]), vertices.append(quad[2]);
+    vertices.append(quad[0]), vertices.append(quad[2]), vertices.append(quad[3]);
+    ++m_stats.quads;
+}
+
+void SpriteBatch::flush(RenderDevice& device, sf::RenderStates states)
+{
+    for (std::size_t i = 0; i < m_live; ++i) {
+        Batch& batch = m_batches[i];
+        if (batch.vertices.getVertexCount() == 0) {
+            continue;
+        }
+        states.texture = batch.texture;
+        states.blendMode = batch.blend;
+        device.draw(&batch.vertices[0], batch.vertices.getVertexCount(), batch.vertices.getPrimitiveType(), states);
+        countDraw(batch.vertices.getVertexCount());
+        batch.vertices.clear();
+    }
+    m_live = 0;
+    m_last = 0;
+}
+
+void SpriteBatch::countDraw(std::size_t vertices)
+{
+    ++m_stats.drawCalls;
+    m_stats.vertices += vertices;
+}
+
+const SpriteBatch::Stats& SpriteBatch::getStats() const
+{
+    return m_stats;
+}
+
+void SpriteBatch::resetStats()
+{
+    m_stats = {};
+}
+
+SpriteBatch::Batch& SpriteBatch::batchFor(const sf::Texture * texture, const sf::BlendMode& blend)
+{
+    // Consecutive sprites nearly always share a texture; check the last hit first
+    if (m_last < m_live && m_batches[m_last].texture == texture && m_batches[m_last].blend == blend) {
+        return m_batches[m_last];
+    }
+    for (std::size_t i = 0; i < m_live; ++i) {
+        if (m_batches[i].texture == texture && m_batches[i].blend == blend) {
+            m_last = i;
+            return m_batches[i];
+        }
+    }
+    if (m_live == m_batches.size()) {
+        m_batches.emplace_back();
+    }
+    m_last = m_live++;
+    m_batches[m_last].texture = texture;
+    m_batches[m_last].blend = blend;
+    return m_batches[m_last];
+}
@@ -0,0 +1,42 @@
+#include "SpriteComp.h"
+#include "CommandList.h"
+
+SpriteComp::SpriteComp(const sf::Texture& texture) : m_sprite{texture}
+{
+}
+
+SpriteComp::SpriteComp(const sf::Texture& texture, const sf::IntRect& rect) : m_sprite{texture, rect}
+{
+}
+
+sf::Sprite& SpriteComp::getSprite()
+{
+    return m_sprite;
+}
+
+const sf::Sprite& SpriteComp::getSprite() const
+{
+    return m_sprite;
+}
+
+std::optional<sf::FloatRect> SpriteComp::getLocalBounds() const
+{
+    return m_sprite.getGlobalBounds();
+}
+
+void SpriteComp::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    states.transform *= getTransform();
+    target.draw(m_sprite, states);
+}
+
+void SpriteComp::record(CommandList& list, sf::RenderStates states) const
+{
+    // Shaders are per-draw state which a shared vertex array can not carry
+    if (states.shader || !m_sprite.getTexture()) {
+        Component::record(list, states);
+        return;
+    }
+    states.transform *= getTransform();
+    list.sprite(getLayer(), getDepth(), m_sprite, states);
+}
@@ -0,0 +1,55 @@
+#include "StartupReport.h"
+#include <algorithm>
+#include <cstdio>
+
+sf::Time StartupReport::now() const
+{
+    return m_clock.getElapsedTime();
+}
+
+void StartupReport::add(Entry entry)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_entries.push_back(std::move(entry));
+}
+
+void StartupReport::firstFrame()
+{
+    const sf::Time at = now();
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (m_firstFrame == sf::Time::Zero) {
+        m_firstFrame = at;
+    }
+}
+
+std::vector<StartupReport::Entry> StartupReport::getEntries() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_entries;
+}
+
+sf::Time StartupReport::getTimeToFirstFrame() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_firstFrame;
+}
+
+void StartupReport::print(std::ostream& dst) const
+{
+    std::vector<Entry> entries = getEntries();
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.start < b.start; });
+
+    char line[256];
+    std::snprintf(line, sizeof line, "%-16s %10s %10s %10s  %s\n", "phase", "start-ms", "ms", "KiB", "file");
+    dst << line;
+    for (const auto& e : entries) {
+        std::snprintf(line, sizeof line, "%-16s %10.1f %10.1f %10zu  %s\n", e.phase.c_str(),
+            e.start.asMicroseconds() / 1000.0, e.elapsed.asMicroseconds() / 1000.0, e.bytes / 1024, e.file.c_str());
+        dst << line;
+    }
+    const sf::Time first = getTimeToFirstFrame();
+    if (first != sf::Time::Zero) {
+        std::snprintf(line, sizeof line, "first frame after %.1f ms\n", first.asMicroseconds() / 1000.0);
+        dst << line;
+    }
+}
@@ -0,0 +1,195 @@
+#include "TextLayout.h"
+#include "Hash.h"
+#include <algorithm>
+
+namespace {
+
+//! Malformed sequences decode as U+FFFD, one per offending byte
+std::u32string decodeUtf8(const std::string& utf8)
+{
+    std::u32string out;
+    out.reserve(utf8.size());
+    for (std::size_t i = 0; i < utf8.size();) {
+        const unsigned char lead = static_cast<unsigned char>(utf8[i]);
+        const std::size_t extra = lead < 0x80 ? 0 : (lead >> 5) == 0x6 ? 1 : (lead >> 4) == 0xE ? 2 : (lead >> 3) == 0x1E ? 3 : 4;
+        char32_t cp = extra == 0 ? lead : extra == 1 ? lead & 0x1F : extra == 2 ? lead & 0x0F : lead & 0x07;
+        bool valid = extra < 4 && i + extra < utf8.size();
+        for (std::size_t k = 1; valid && k <= extra; ++k) {
+            const unsigned char next = static_cast<unsigned char>(utf8[i + k]);
+            valid = (next & 0xC0) == 0x80;
+            cp = (cp << 6) | (next & 0x3F);
+        }
+        if (valid) {
+            out.push_back(cp);
+            i += extra + 1;
+        } else {
+            out.push_back(0xFFFD);
+            ++i;
+        }
+    }
+    return out;
+}
+
+bool isSpace(char32_t c)
+{
+    return c == U' ' || c == U'\t' || c == U'\n';
+}
+
+} /*namespace*/;
+
+
+std::size_t GlyphRun::vertexCount(std::size_t characters) const
+{
+    if (characters == 0 || revealed.empty()) {
+        return 0;
+    }
+    return revealed[std::min(characters, revealed.size()) - 1];
+}
+
+std::size_t GlyphRun::getMemoryUsage() const
+{
+    return sizeof(GlyphRun) + vertices.capacity() * sizeof(sf::Vertex) + revealed.capacity() * sizeof(std::uint32_t);
+}
+
+
+GlyphRun layoutText(const std::string& utf8, const sf::Font& font, unsigned int size, float wrapWidth, sf::Color color)
+{
+    const std::u32string text = decodeUtf8(utf8);
+    const float lineSpacing = font.getLineSpacing(size);
+    const float space = font.getGlyph(U' ', size, false).advance;
+
+    GlyphRun run{};
+    run.revealed.reserve(text.size());
+    float x{0}, y{static_cast<float>(size)};
+    float minX{0}, minY{0}, maxX{0}, maxY{0};
+    bool any{false};
+    char32_t prev{0};
+    run.lines = text.empty() ? 0 : 1;
+
+    auto newLine = [&] {
+        x = 0, y += lineSpacing, prev = 0;
+        ++run.lines;
+    };
+
+    for (std::size_t i = 0; i < text.size();) {
+        const char32_t c = text[i];
+        if (isSpace(c)) {
+            if (c == U'\n') {
+                newLine();
+            } else {
+                x += c == U'\t' ? space * 4 : space;
+            }
+            prev = c;
+            run.revealed.push_back(static_cast<std::uint32_t>(run.vertices.size()));
+            ++i;
+            continue;
+        }
+
+        // Measure the word so that it can move to the next line whole
+        std::size_t end = i;
+        float width{0};
+        for (char32_t p = prev; end < text.size() && !isSpace(text[end]); p = text[end++]) {
+            width += font.getKerning(p, text[end], size) + font.getGlyph(text[end], size, false).advance;
+        }
+        if (wrapWidth > 0 && x > 0 && x + width > wrapWidth) {
+            newLine();
+        }
+
+        for (; i < end; ++i) {
+            const sf::Glyph& glyph = font.getGlyph(text[i], size, false);
+            if (wrapWidth > 0 && x > 0 && x + glyph.advance > wrapWidth) {
+                newLine();
+            }
+            x += font.getKerning(prev, text[i], size);
+            prev = text[i];
+
+            const float left = x + glyph.bounds.left, top = y + glyph.bounds.top;
+            const float right = left + glyph.bounds.width, bottom = top + glyph.bounds.height;
+            const float u0 = static_cast<float>(glyph.textureRect.left), u1 = u0 + glyph.textureRect.width;
+            const float v0 = static_cast<float>(glyph.textureRect.top), v1 = v0 + glyph.textureRect.height;
+            const sf::Vertex quad[4] = {
+                sf::Vertex{{left, top}, color, {u0, v0}}
+              , sf::Vertex{{right, top}, color, {u1, v0}}
+              , sf::Vertex{{right, bottom}, color, {u1, v1}}
+              , sf::Vertex{{left, bottom}, color, {u0, v1}}
+            };
+            run.vertices.insert(run.vertices.end(), {quad[0], quad[1], quad[2], quad[0], quad[2], quad[3]});
+            run.revealed.push_back(static_cast<std::uint32_t>(run.vertices.size()));
+
+            minX = any ? std::min(minX, left) : left, minY = any ? std::min(minY, top) : top;
+            maxX = any ? std::max(maxX, right) : right, maxY = any ? std::max(maxY, bottom) : bottom;
+            any = true;
+            x += glyph.advance;
+        }
+    }
+
+    run.bounds = {minX, minY, maxX - minX, maxY - minY};
+    run.texture = &font.getTexture(size);
+    return run;
+}
+
+
+double TextLayoutCache::Stats::hitRate() const
+{
+    const std::size_t lookups = hits + misses;
+    return lookups ? static_cast<double>(hits) / lookups : 0.0;
+}
+
+bool TextLayoutCache::Key::operator==(const Key& other) const
+{
+    return font == other.font && size == other.size && wrapWidth == other.wrapWidth
+        && color == other.color && text == other.text;
+}
+
+std::size_t TextLayoutCache::KeyHash::operator()(const Key& key) const
+{
+    StateHasher h{};
+    h.bytes(key.text.data(), key.text.size());
+    h << key.font << key.size << key.wrapWidth << key.color;
+    return static_cast<std::size_t>(h.value());
+}
+
+TextLayoutCache::TextLayoutCache(std::size_t budgetBytes) : m_budget{budgetBytes}
+{
+}
+
+std::shared_ptr<const GlyphRun> TextLayoutCache::get(const std::string& utf8, const sf::Font& font, unsigned int size, float wrapWidth, sf::Color color)
+{
+    Key key{utf8, &font, size, wrapWidth, color.toInteger()};
+    const auto found = m_index.find(key);
+    if (found != m_index.end()) {
+        ++m_stats.hits;
+        m_lru.splice(m_lru.begin(), m_lru, found->second);
+        return found->second->run;
+    }
+
+    ++m_stats.misses;
+    auto run = std::make_shared<const GlyphRun>(layoutText(utf8, font, size, wrapWidth, color));
+    const std::size_t bytes = run->getMemoryUsage() + utf8.size();
+    while (!m_lru.empty() && m_stats.bytes + bytes > m_budget) {
+        m_stats.bytes -= m_lru.back().bytes;
+        m_index.erase(*m_lru.back().key);
+        m_lru.pop_back();
+        ++m_stats.evictions;
+    }
+
+    m_lru.push_front(Entry{nullptr, run, bytes});
+    const auto inserted = m_index.emplace(std::move(key), m_lru.begin()).first;
+    m_lru.front().key = &inserted->first;
+    m_stats.bytes += bytes;
+    m_stats.runs = m_lru.size();
+    return run;
+}
+
+void TextLayoutCache::clear()
+{
+    m_index.clear();
+    m_lru.clear();
+    m_stats.bytes = 0;
+    m_stats.runs = 0;
+}
+
+const TextLayoutCache::Stats& TextLayoutCache::getStats() const
+{
+    return m_stats;
+}
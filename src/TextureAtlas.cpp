@@ -0,0 +1,289 @@
+#include "TextureAtlas.h"
+#include "Hash.h"
+#include "SkylinePacker.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_set>
+#include <sys/stat.h>
+
+namespace {
+
+const char Magic[8] = {'M', 'I', 'N', 'T', 'A', 'T', 'L', 'S'};
+const std::uint32_t Version = 1;
+
+//! Region names are sprite names or paths; anything longer is a damaged file
+const std::uint32_t MaxNameBytes = 64 * 1024;
+
+
+void putU32(std::ostream& dst, std::uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) { dst.put(static_cast<char>(v >> (8 * i))); }
+}
+
+void putU64(std::ostream& dst, std::uint64_t v)
+{
+    putU32(dst, static_cast<std::uint32_t>(v)), putU32(dst, static_cast<std::uint32_t>(v >> 32));
+}
+
+std::uint32_t getU32(std::istream& src)
+{
+    unsigned char b[4];
+    if (!src.read(reinterpret_cast<char*>(b), 4)) {
+        throw std::runtime_error{"texture atlas is truncated"};
+    }
+    return b[0] | b[1] << 8 | b[2] << 16 | static_cast<std::uint32_t>(b[3]) << 24;
+}
+
+std::uint64_t getU64(std::istream& src)
+{
+    const std::uint64_t lo = getU32(src);
+    return lo | static_cast<std::uint64_t>(getU32(src)) << 32;
+}
+
+
+//! What stands in for a file's contents in the cache key, without reading them
+void hashFileStamp(StateHasher& h, const std::string& path)
+{
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        throw std::runtime_error{"Could not open " + path};
+    }
+#if defined(__APPLE__)
+    const timespec& modified = st.st_mtimespec;
+#else
+    const timespec& modified = st.st_mtim;
+#endif
+    h.bytes(path.data(), path.size()) << path.size();
+    h << static_cast<std::uint64_t>(st.st_size) << static_cast<std::int64_t>(modified.tv_sec) << static_cast<std::int64_t>(modified.tv_nsec);
+}
+
+sf::Image decode(const AtlasSource& source)
+{
+    if (source.path.empty()) {
+        return source.image;
+    }
+    sf::Image image{};
+    if (!image.loadFromFile(source.path)) {
+        throw std::runtime_error{"Could not decode " + source.path};
+    }
+    return image;
+}
+
+std::string cachePath(const std::string& dir, std::uint64_t key)
+{
+    char name[32];
+    std::snprintf(name, sizeof name, "%016llx.atlas", static_cast<unsigned long long>(key));
+    return dir + "/" + name;
+}
+
+} /*namespace*/;
+
+
+std::uint64_t TextureAtlas::cacheKey(const std::vector<AtlasSource>& sources, const AtlasOptions& options)
+{
+    StateHasher h{};
+    h << Version << options.pageSize.x << options.pageSize.y << options.padding;
+    for (const auto& source : sources) {
+        h.bytes(source.name.data(), source.name.size()) << source.name.size();
+        if (!source.path.empty()) {
+            hashFileStamp(h, source.path);
+        } else {
+            const sf::Vector2u size = source.image.getSize();
+            h << size.x << size.y;
+            h.bytes(source.image.getPixelsPtr(), static_cast<std::size_t>(size.x) * size.y * 4);
+        }
+    }
+    return h.value();
+}
+
+TextureAtlas TextureAtlas::pack(const std::vector<AtlasSource>& sources, const AtlasOptions& options)
+{
+    std::unordered_set<std::string> names;
+    for (const auto& source : sources) {
+        if (!names.insert(source.name).second) {
+            throw std::invalid_argument{"two atlas sources are named '" + source.name + "'"};
+        }
+    }
+
+    std::vector<sf::Image> images;
+    images.reserve(sources.size());
+    for (const auto& source : sources) { images.push_back(decode(source)); }
+
+    // Tallest first, then widest, keeps the skyline flat
+    std::vector<std::size_t> order(sources.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        const sf::Vector2u sa = images[a].getSize(), sb = images[b].getSize();
+        return sa.y != sb.y ? sa.y > sb.y : sa.x > sb.x;
+    });
+
+    TextureAtlas atlas{};
+    atlas.m_key = cacheKey(sources, options);
+    std::vector<SkylinePacker> packers;
+    const sf::Vector2f page{static_cast<float>(options.pageSize.x), static_cast<float>(options.pageSize.y)};
+    for (const std::size_t i : order) {
+        const sf::Vector2u size = images[i].getSize();
+        const sf::Vector2u padded{size.x + options.padding, size.y + options.padding};
+        if (size.x > options.pageSize.x || size.y > options.pageSize.y) {
+            throw std::length_error{"'" + sources[i].name + "' is larger than an atlas page"};
+        }
+
+        std::optional<sf::Vector2u> at{};
+        std::size_t p{0};
+        for (; p < packers.size() && !(at = packers[p].insert(padded)); ++p) {
+        }
+        if (!at) {
+            packers.emplace_back(options.pageSize);
+            atlas.m_pages.emplace_back();
+            atlas.m_pages.back().create(options.pageSize.x, options.pageSize.y, sf::Color::Transparent);
+            // A page-sized source only fits without its padding
+            at = packers.back().insert(padded);
+            if (!at) { at = packers.back().insert(size); }
+        }
+
+        atlas.m_pages[p].copy(images[i], at->x, at->y);
+        Region& region = atlas.m_regions[sources[i].name];
+        region.page = static_cast<std::uint32_t>(p);
+        region.rect = {static_cast<int>(at->x), static_cast<int>(at->y), static_cast<int>(size.x), static_cast<int>(size.y)};
+        region.uv = {at->x / page.x, at->y / page.y, size.x / page.x, size.y / page.y};
+    }
+    return atlas;
+}
+
+TextureAtlas TextureAtlas::loadOrPack(const std::string& cacheDir, const std::vector<AtlasSource>& sources, const AtlasOptions& options)
+{
+    const std::string path = cachePath(cacheDir, cacheKey(sources, options));
+    {
+        std::ifstream src{path, std::ios::binary};
+        if (src) {
+            try {
+                return load(src);
+            } catch (std::runtime_error&) {
+                // A damaged cache entry is only a miss
+            }
+        }
+    }
+
+    TextureAtlas atlas = pack(sources, options);
+
+    // Write beside the final name and rename, so readers never see half a file
+    const std::string partial = path + ".partial";
+    {
+        std::ofstream dst{partial, std::ios::binary | std::ios::trunc};
+        if (dst) { atlas.save(dst); }
+        if (!dst) {
+            std::remove(partial.c_str());
+            return atlas;
+        }
+    }
+    std::rename(partial.c_str(), path.c_str());
+    return atlas;
+}
+
+void TextureAtlas::save(std::ostream& dst) const
+{
+    dst.write(Magic, sizeof Magic);
+    putU32(dst, Version);
+    putU64(dst, m_key);
+    putU32(dst, static_cast<std::uint32_t>(m_pages.size()));
+    for (const auto& page : m_pages) {
+        const sf::Vector2u size = page.getSize();
+        putU32(dst, size.x), putU32(dst, size.y);
+        dst.write(reinterpret_cast<const char*>(page.getPixelsPtr()), static_cast<std::streamsize>(size.x) * size.y * 4);
+    }
+    putU32(dst, static_cast<std::uint32_t>(m_regions.size()));
+    for (const auto& entry : m_regions) {
+        putU32(dst, static_cast<std::uint32_t>(entry.first.size()));
+        dst.write(entry.first.data(), static_cast<std::streamsize>(entry.first.size()));
+        putU32(dst, entry.second.page);
+        putU32(dst, entry.second.rect.left), putU32(dst, entry.second.rect.top);
+        putU32(dst, entry.second.rect.width), putU32(dst, entry.second.rect.height);
+    }
+}
+
+TextureAtlas TextureAtlas::load(std::istream& src)
+{
+    char magic[sizeof Magic];
+    if (!src.read(magic, sizeof magic) || !std::equal(magic, magic + sizeof magic, Magic)) {
+        throw std::runtime_error{"not a texture atlas"};
+    }
+    if (getU32(src) != Version) {
+        throw std::runtime_error{"unsupported texture atlas version"};
+    }
+
+    TextureAtlas atlas{};
+    atlas.m_key = getU64(src);
+    // Counts are only claims; pages and names are read one at a time, so a
+    // damaged file runs out of data before it can ask for much memory
+    std::vector<std::uint8_t> pixels;
+    for (std::uint32_t n = getU32(src); n > 0; --n) {
+        const std::uint32_t w = getU32(src), h = getU32(src);
+        if (w > 16384 || h > 16384) {
+            throw std::runtime_error{"texture atlas page is implausibly large"};
+        }
+        pixels.resize(static_cast<std::size_t>(w) * h * 4);
+        if (!src.read(reinterpret_cast<char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()))) {
+            throw std::runtime_error{"texture atlas is truncated"};
+        }
+        atlas.m_pages.emplace_back();
+        atlas.m_pages.back().create(w, h, pixels.data());
+    }
+
+    for (std::uint32_t n = getU32(src); n > 0; --n) {
+        const std::uint32_t length = getU32(src);
+        if (length > MaxNameBytes) {
+            throw std::runtime_error{"texture atlas region name is implausibly long"};
+        }
+        std::string name(length, '\0');
+        if (!src.read(&name[0], static_cast<std::streamsize>(name.size()))) {
+            throw std::runtime_error{"texture atlas is truncated"};
+        }
+        Region region{};
+        region.page = getU32(src);
+        if (region.page >= atlas.m_pages.size()) {
+            throw std::runtime_error{"texture atlas region names a missing page"};
+        }
+        region.rect.left = static_cast<int>(getU32(src)), region.rect.top = static_cast<int>(getU32(src));
+        region.rect.width = static_cast<int>(getU32(src)), region.rect.height = static_cast<int>(getU32(src));
+        const sf::Vector2u size = atlas.m_pages[region.page].getSize();
+        region.uv = {
+            static_cast<float>(region.rect.left) / size.x, static_cast<float>(region.rect.top) / size.y
+          , static_cast<float>(region.rect.width) / size.x, static_cast<float>(region.rect.height) / size.y
+        };
+        atlas.m_regions.emplace(std::move(name), region);
+    }
+    return atlas;
+}
+
+const TextureAtlas::Region * TextureAtlas::find(const std::string& name) const
+{
+    const auto it = m_regions.find(name);
+    return it == m_regions.end() ? nullptr : &it->second;
+}
+
+sf::IntRect TextureAtlas::remap(const std::string& name, const sf::IntRect& local) const
+{
+    const Region * region = find(name);
+    if (!region) {
+        throw std::out_of_range{"no atlas region named '" + name + "'"};
+    }
+    return {region->rect.left + local.left, region->rect.top + local.top, local.width, local.height};
+}
+
+const std::vector<sf::Image>& TextureAtlas::getPages() const
+{
+    return m_pages;
+}
+
+const std::unordered_map<std::string, TextureAtlas::Region>& TextureAtlas::getRegions() const
+{
+    return m_regions;
+}
+
+std::uint64_t TextureAtlas::getKey() const
+{
+    return m_key;
+}
@@ -0,0 +1,179 @@
+#include "TileMapRenderer.h"
+#include "CommandList.h"
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+constexpr std::uint32_t FlipHorizontal = 0x80000000u;
+constexpr std::uint32_t FlipVertical = 0x40000000u;
+constexpr std::uint32_t FlipDiagonal = 0x20000000u;
+
+} /*namespace*/;
+
+
+TileMapRenderer::TileMapRenderer(LevelInstance& level)
+  : m_level{level}
+  , m_textures(level.getBase().tilesets.size(), nullptr)
+  , m_chunkCount{
+        (level.getBase().size.x + ChunkTiles - 1) / ChunkTiles
+      , (level.getBase().size.y + ChunkTiles - 1) / ChunkTiles
+    }
+  , m_chunks(static_cast<std::size_t>(m_chunkCount.x) * m_chunkCount.y)
+{
+}
+
+void TileMapRenderer::setTexture(std::size_t index, const sf::Texture& texture)
+{
+    m_textures.at(index) = &texture;
+}
+
+void TileMapRenderer::setTile(std::size_t layer, unsigned int x, unsigned int y, std::uint32_t gid)
+{
+    m_level.setTile(layer, x, y, gid);
+    invalidate(x, y);
+}
+
+void TileMapRenderer::invalidate(unsigned int x, unsigned int y)
+{
+    const sf::Vector2u size = m_level.getBase().size;
+    if (x >= size.x || y >= size.y) {
+        throw std::out_of_range{"no tile (" + std::to_string(x) + ", " + std::to_string(y) + ") in level " + m_level.getBase().name};
+    }
+    m_chunks[(y / ChunkTiles) * m_chunkCount.x + x / ChunkTiles].dirty = true;
+}
+
+void TileMapRenderer::invalidateAll()
+{
+    for (auto& chunk : m_chunks) { chunk.dirty = true; }
+}
+
+void TileMapRenderer::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    states.transform *= getTransform();
+    forEachVisibleMesh(target.getView(), states.transform, [&](std::size_t tileset, const std::vector<sf::Vertex>& mesh) {
+        states.texture = m_textures[tileset];
+        target.draw(mesh.data(), mesh.size(), sf::Triangles, states);
+    });
+}
+
+void TileMapRenderer::record(CommandList& list, sf::RenderStates states) const
+{
+    states.transform *= getTransform();
+    forEachVisibleMesh(list.getView(), states.transform, [&](std::size_t tileset, const std::vector<sf::Vertex>& mesh) {
+        states.texture = m_textures[tileset];
+        list.vertices(SortKey::make(getLayer(), getDepth(), states.texture, states.blendMode), mesh.data(), mesh.size(), sf::Triangles, states);
+    });
+}
+
+sf::Vector2u TileMapRenderer::getChunkCount() const
+{
+    return m_chunkCount;
+}
+
+const TileMapRenderer::Stats& TileMapRenderer::getStats() const
+{
+    return m_stats;
+}
+
+sf::IntRect TileMapRenderer::visibleChunks(const sf::View& view, const sf::Transform& transform) const
+{
+    const sf::FloatRect area = transform.getInverse().transformRect(viewBounds(view));
+
+    const sf::Vector2u tile = m_level.getBase().tileSize;
+    const float chunkW = static_cast<float>(tile.x * ChunkTiles);
+    const float chunkH = static_cast<float>(tile.y * ChunkTiles);
+    if (chunkW <= 0.f || chunkH <= 0.f) {
+        return {};
+    }
+    auto clampX = [&](float v) { return static_cast<int>(std::min<float>(std::max(v, 0.f), static_cast<float>(m_chunkCount.x))); };
+    auto clampY = [&](float v) { return static_cast<int>(std::min<float>(std::max(v, 0.f), static_cast<float>(m_chunkCount.y))); };
+    const int left = clampX(std::floor(area.left / chunkW));
+    const int top = clampY(std::floor(area.top / chunkH));
+    const int right = clampX(std::ceil((area.left + area.width) / chunkW));
+    const int bottom = clampY(std::ceil((area.top + area.height) / chunkH));
+    return {left, top, right - left, bottom - top};
+}
+
+template<typename F>
+void TileMapRenderer::forEachVisibleMesh(const sf::View& view, const sf::Transform& transform, F&& f) const
+{
+    m_stats = {};
+    const sf::IntRect range = visibleChunks(view, transform);
+    for (int cy = range.top; cy < range.top + range.height; ++cy) {
+        for (int cx = range.left; cx < range.left + range.width; ++cx) {
+            Chunk& chunk = m_chunks[static_cast<std::size_t>(cy) * m_chunkCount.x + cx];
+            if (chunk.dirty) {
+                rebuild(cx, cy, chunk);
+                ++m_stats.rebuiltChunks;
+            }
+            ++m_stats.visibleChunks;
+            for (std::size_t ts = 0; ts < chunk.meshes.size(); ++ts) {
+                if (!chunk.meshes[ts].empty()) {
+                    f(ts, chunk.meshes[ts]);
+                    ++m_stats.meshes;
+                }
+            }
+        }
+    }
+}
+
+void TileMapRenderer::rebuild(std::size_t cx, std::size_t cy, Chunk& chunk) const
+{
+    // Clearing rather than reallocating keeps each mesh's storage between rebuilds
+    chunk.meshes.resize(m_level.getBase().tilesets.size());
+    for (auto& mesh : chunk.meshes) { mesh.clear(); }
+
+    const sf::Vector2u size = m_level.getBase().size;
+    const unsigned int x0 = static_cast<unsigned int>(cx) * ChunkTiles, x1 = std::min(x0 + ChunkTiles, size.x);
+    const unsigned int y0 = static_cast<unsigned int>(cy) * ChunkTiles, y1 = std::min(y0 + ChunkTiles, size.y);
+    for (std::size_t layer = 0; layer < m_level.getBase().layers.size(); ++layer) {
+        for (unsigned int y = y0; y < y1; ++y) {
+            for (unsigned int x = x0; x < x1; ++x) {
+                const std::uint32_t gid = m_level.getTile(layer, x, y);
+                if (gid & ~GidFlipMask) {
+                    appendTile(chunk, x, y, gid);
+                }
+            }
+        }
+    }
+    chunk.dirty = false;
+}
+
+void TileMapRenderer::appendTile(Chunk& chunk, unsigned int x, unsigned int y, std::uint32_t gid) const
+{
+    const LevelMap& map = m_level.getBase();
+    const Tileset * tileset = map.findTileset(gid);
+    if (!tileset) {
+        return;
+    }
+
+    // Tiles taller or wider than the grid hang from the cell's bottom-left, as in Tiled
+    const sf::IntRect rect = tileset->getTextureRect(gid);
+    const float left = static_cast<float>(x * map.tileSize.x);
+    const float bottom = static_cast<float>((y + 1) * map.tileSize.y);
+    const float right = left + rect.width, top = bottom - rect.height;
+
+    // Tiled transposes first and flips the transposed tile, so once the axes
+    // are swapped a horizontal flip mirrors v and a vertical one mirrors u
+    const bool diagonal = (gid & FlipDiagonal) != 0;
+    float u0 = static_cast<float>(rect.left), u1 = u0 + rect.width;
+    float v0 = static_cast<float>(rect.top), v1 = v0 + rect.height;
+    if (gid & FlipHorizontal) { std::swap(diagonal ? v0 : u0, diagonal ? v1 : u1); }
+    if (gid & FlipVertical) { std::swap(diagonal ? u0 : v0, diagonal ? u1 : v1); }
+    sf::Vector2f tex[4] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+    if (diagonal) { std::swap(tex[1], tex[3]); }
+
+    const sf::Vertex quad[4] = {
+        sf::Vertex{{left, top}, tex[0]}
+      , sf::Vertex{{right, top}, tex[1]}
+      , sf::Vertex{{right, bottom}, tex[2]}
+      , sf::Vertex{{left, bottom}, tex[3]}
+    };
+    auto& mesh = chunk.meshes[static_cast<std::size_t>(tileset - map.tilesets.data())];
+    mesh.insert(mesh.end(), {quad[0], quad[1], quad[2], quad[0], quad[2], quad[3]});
+}
@@ -0,0 +1,738 @@
+#include "TiledLoader.h"
+#include "JsonReader.h"
+#include "XmlReader.h"
+#include <zlib.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+[[noreturn]] void fail(const std::string& what)
+{
+    throw std::runtime_error{"tiled: " + what};
+}
+
+//! For data decoded before its layer's size is known; only compressed data can outgrow its input
+constexpr std::size_t NoLimit = static_cast<std::size_t>(-1);
+
+//! Appends `gid`, failing as soon as the layer would hold more than `limit`
+void pushGid(std::vector<std::uint32_t>& gids, std::size_t limit, std::uint32_t gid)
+{
+    if (gids.size() >= limit) {
+        fail("layer data holds more than " + std::to_string(limit) + " gids");
+    }
+    gids.push_back(gid);
+}
+
+
+//! Assembles little-endian gids from bytes arriving in arbitrary pieces
+class GidBytes {
+
+public:
+
+    GidBytes(std::vector<std::uint32_t>& out, std::size_t limit) : m_out{out}, m_limit{limit}
+    {
+    }
+
+    void feed(const unsigned char * p, std::size_t n)
+    {
+        for (; n > 0 && m_have > 0; --n) { push(*p++); }
+        const std::size_t whole = n / 4;
+        const std::size_t first = m_out.size();
+        if (whole > m_limit - first) {
+            fail("layer data holds more than " + std::to_string(m_limit) + " gids");
+        }
+        m_out.resize(first + whole);
+        for (std::size_t i = 0; i < whole; ++i, p += 4) {
+            m_out[first + i] = static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8
+                | static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+        }
+        for (n -= 4 * whole; n > 0; --n) { push(*p++); }
+    }
+
+    void finish()
+    {
+        if (m_have) {
+            fail("layer data is not a whole number of gids");
+        }
+    }
+
+private:
+
+    void push(unsigned char b)
+    {
+        m_partial |= static_cast<std::uint32_t>(b) << (8 * m_have);
+        if (++m_have == 4) {
+            pushGid(m_out, m_limit, m_partial);
+            m_have = 0, m_partial = 0;
+        }
+    }
+
+    std::vector<std::uint32_t>&  m_out;
+    std::size_t  m_limit;
+    std::uint32_t  m_partial = 0;
+    int  m_have = 0;
+
+} /*class GidBytes*/;
+
+
+//! Inflates zlib or gzip data, detected by its header, into `GidBytes`, which
+//! stops it as soon as the output outgrows the layer
+class Inflater {
+
+public:
+
+    explicit Inflater(GidBytes& sink) : m_sink{sink}, m_out(64 * 1024)
+    {
+        std::memset(&m_z, 0, sizeof m_z);
+        if (inflateInit2(&m_z, 15 + 32) != Z_OK) {
+            fail("can not initialize zlib");
+        }
+    }
+
+    ~Inflater()
+    {
+        inflateEnd(&m_z);
+    }
+
+    Inflater(const Inflater&) = delete;
+    Inflater& operator=(const Inflater&) = delete;
+
+    void feed(const unsigned char * p, std::size_t n)
+    {
+        m_z.next_in = const_cast<Bytef *>(p);
+        m_z.avail_in = static_cast<uInt>(n);
+        while (!m_done && (m_z.avail_in > 0 || m_z.avail_out == 0)) {
+            m_z.next_out = m_out.data();
+            m_z.avail_out = static_cast<uInt>(m_out.size());
+            const int r = inflate(&m_z, Z_NO_FLUSH);
+            if (r == Z_STREAM_END) {
+                m_done = true;
+            } else if (r != Z_OK && r != Z_BUF_ERROR) {
+                fail("corrupt compressed layer data");
+            }
+            m_sink.feed(m_out.data(), m_out.size() - m_z.avail_out);
+            if (r == Z_BUF_ERROR) {
+                break;
+            }
+        }
+    }
+
+    void finish()
+    {
+        if (!m_done) {
+            fail("truncated compressed layer data");
+        }
+    }
+
+private:
+
+    GidBytes&  m_sink;
+    std::vector<unsigned char>  m_out;
+    z_stream  m_z;
+    bool  m_done = false;
+
+} /*class Inflater*/;
+
+
+//! Decodes base64 arriving in arbitrary pieces, skipping whitespace
+class Base64 {
+
+public:
+
+    template<typename F>
+    void feed(const char * p, std::size_t n, F&& out)
+    {
+        m_bytes.clear();
+        for (const char * end = p + n; p != end; ++p) {
+            const int v = value(static_cast<unsigned char>(*p));
+            if (v < 0) {
+                if (v == -1) { fail("malformed base64 layer data"); }
+                continue;
+            }
+            m_acc = (m_acc << 6) | static_cast<std::uint32_t>(v);
+            m_bits += 6;
+            if (m_bits >= 8) {
+                m_bits -= 8;
+                m_bytes.push_back(static_cast<unsigned char>(m_acc >> m_bits));
+            }
+        }
+        out(m_bytes.data(), m_bytes.size());
+    }
+
+private:
+
+    //! The digit's value; -2 for whitespace and padding, -1 for anything else
+    static int value(unsigned char c)
+    {
+        static const auto table = [] {
+            std::array<std::int8_t, 256> t{};
+            t.fill(-1);
+            const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            for (int i = 0; i < 64; ++i) { t[static_cast<unsigned char>(digits[i])] = static_cast<std::int8_t>(i); }
+            for (unsigned char c : {'=', ' ', '\n', '\r', '\t'}) { t[c] = -2; }
+            return t;
+        }();
+        return table[c];
+    }
+
+    std::vector<unsigned char>  m_bytes;
+    std::uint32_t  m_acc = 0;
+    int  m_bits = 0;
+
+} /*class Base64*/;
+
+
+//! Turns a layer's encoded text, in pieces, into at most `limit` gids
+class LayerDecoder {
+
+public:
+
+    LayerDecoder(const std::string& encoding, const std::string& compression, std::vector<std::uint32_t>& out, std::size_t limit)
+      : m_out{out}
+      , m_limit{limit}
+      , m_bytes{out, limit}
+    {
+        if (encoding == "csv") {
+            m_csv = true;
+        } else if (encoding != "base64") {
+            fail("unknown layer encoding '" + encoding + "'");
+        }
+        if (compression == "zlib" || compression == "gzip") {
+            m_inflater = std::make_unique<Inflater>(m_bytes);
+        } else if (!compression.empty()) {
+            fail("unsupported layer compression '" + compression + "'");
+        }
+    }
+
+    void text(const char * p, std::size_t n)
+    {
+        if (m_csv) {
+            csv(p, n);
+            return;
+        }
+        m_base64.feed(p, n, [this](const unsigned char * bytes, std::size_t len) { this->bytes(bytes, len); });
+    }
+
+    //! Already base64-decoded data
+    void bytes(const unsigned char * p, std::size_t n)
+    {
+        if (m_inflater) {
+            m_inflater->feed(p, n);
+        } else {
+            m_bytes.feed(p, n);
+        }
+    }
+
+    void finish()
+    {
+        if (m_inNumber) {
+            pushGid(m_out, m_limit, static_cast<std::uint32_t>(m_value));
+            m_inNumber = false;
+        }
+        if (m_inflater) {
+            m_inflater->finish();
+        }
+        m_bytes.finish();
+    }
+
+private:
+
+    void csv(const char * p, std::size_t n)
+    {
+        for (const char * end = p + n; p != end; ++p) {
+            const char c = *p;
+            if (c >= '0' && c <= '9') {
+                m_value = m_value * 10 + static_cast<std::uint64_t>(c - '0');
+                if (m_value > 0xffffffffu) {
+                    fail("gid out of range");
+                }
+                m_inNumber = true;
+            } else if (c == ',' || c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+                if (m_inNumber) {
+                    pushGid(m_out, m_limit, static_cast<std::uint32_t>(m_value));
+                }
+                m_value = 0, m_inNumber = false;
+            } else {
+                fail("malformed csv layer data");
+            }
+        }
+    }
+
+    std::vector<std::uint32_t>&  m_out;
+    std::size_t  m_limit;
+    GidBytes  m_bytes;
+    std::unique_ptr<Inflater>  m_inflater;
+    Base64  m_base64;
+    bool  m_csv = false;
+    std::uint64_t  m_value = 0;
+    bool  m_inNumber = false;
+
+} /*class LayerDecoder*/;
+
+
+//! Reserves room for a layer's gids, once both of its dimensions are known
+void reserveLayer(sf::Vector2u size, std::vector<std::uint32_t>& gids)
+{
+    // The dimensions are only a claim until the data decodes to match them,
+    // so a huge claim gets a first guess and the vector grows from there
+    const std::size_t firstGuess = 1u << 20;
+    gids.reserve(std::min(static_cast<std::size_t>(size.x) * size.y, firstGuess));
+}
+
+//! How many gids a layer of `size` holds; an empty layer fails
+std::size_t layerCells(const std::string& name, sf::Vector2u size)
+{
+    if (size.x == 0 || size.y == 0) {
+        fail("layer '" + name + "' is " + std::to_string(size.x) + "x" + std::to_string(size.y) + " tiles");
+    }
+    return static_cast<std::size_t>(size.x) * size.y;
+}
+
+void checkLayer(const std::string& name, sf::Vector2u size, const std::vector<std::uint32_t>& gids)
+{
+    const std::size_t cells = layerCells(name, size);
+    if (gids.size() != cells) {
+        fail("layer '" + name + "' has " + std::to_string(gids.size()) + " gids, expected " + std::to_string(cells));
+    }
+}
+
+
+// TMX
+
+unsigned int uintAttribute(const XmlReader& xml, const char * name)
+{
+    const std::string * value = xml.findAttribute(name);
+    return value ? static_cast<unsigned int>(std::strtoul(value->c_str(), nullptr, 10)) : 0u;
+}
+
+float floatAttribute(const XmlReader& xml, const char * name)
+{
+    const std::string * value = xml.findAttribute(name);
+    return value ? std::strtof(value->c_str(), nullptr) : 0.f;
+}
+
+std::string stringAttribute(const XmlReader& xml, const char * name)
+{
+    const std::string * value = xml.findAttribute(name);
+    return value ? *value : std::string{};
+}
+
+//! Calls `child` for each child element of the element just started, which must consume it
+template<typename F>
+void forEachChild(XmlReader& xml, F&& child)
+{
+    for (;;) {
+        switch (xml.next()) {
+        case XmlReader::Event::StartElement: child(); break;
+        case XmlReader::Event::EndElement: return;
+        case XmlReader::Event::Text: break;
+        case XmlReader::Event::End: fail("unexpected end of map");
+        }
+    }
+}
+
+void readTmxTileset(XmlReader& xml, LevelMap& map)
+{
+    Tileset ts{};
+    ts.firstGid = uintAttribute(xml, "firstgid");
+    ts.name = xml.findAttribute("name") ? stringAttribute(xml, "name") : stringAttribute(xml, "source");
+    ts.tileSize = {uintAttribute(xml, "tilewidth"), uintAttribute(xml, "tileheight")};
+    ts.tileCount = uintAttribute(xml, "tilecount");
+    ts.columns = uintAttribute(xml, "columns");
+    ts.margin = uintAttribute(xml, "margin");
+    ts.spacing = uintAttribute(xml, "spacing");
+    forEachChild(xml, [&] {
+        if (xml.getName() == "image") {
+            ts.image = stringAttribute(xml, "source");
+            ts.imageSize = {uintAttribute(xml, "width"), uintAttribute(xml, "height")};
+        }
+        xml.skipElement();
+    });
+    map.tilesets.push_back(std::move(ts));
+}
+
+void readTmxLayer(XmlReader& xml, LevelMap& map)
+{
+    const std::string name = stringAttribute(xml, "name");
+    const sf::Vector2u size{uintAttribute(xml, "width"), uintAttribute(xml, "height")};
+    const std::size_t cells = layerCells(name, size);
+    std::vector<std::uint32_t> gids;
+    reserveLayer(size, gids);
+
+    forEachChild(xml, [&] {
+        if (xml.getName() != "data") {
+            xml.skipElement();
+            return;
+        }
+        const std::string encoding = stringAttribute(xml, "encoding");
+        if (encoding.empty()) {
+            // Legacy XML layout: one <tile gid=".."/> per cell
+            forEachChild(xml, [&] {
+                if (xml.getName() == "chunk") {
+                    fail("infinite maps are not supported");
+                }
+                pushGid(gids, cells, xml.getName() == "tile" ? uintAttribute(xml, "gid") : 0u);
+                xml.skipElement();
+            });
+            return;
+        }
+        LayerDecoder decoder{encoding, stringAttribute(xml, "compression"), gids, cells};
+        for (auto e = xml.next(); e != XmlReader::Event::EndElement; e = xml.next()) {
+            if (e == XmlReader::Event::Text) {
+                decoder.text(xml.getText().data(), xml.getText().size());
+            } else if (e == XmlReader::Event::StartElement) {
+                fail("infinite maps are not supported");
+            } else {
+                fail("unexpected end of map");
+            }
+        }
+        decoder.finish();
+    });
+
+    checkLayer(name, size, gids);
+    map.layers.emplace_back(name, size, std::move(gids));
+}
+
+void readTmxObjects(XmlReader& xml, LevelMap& map)
+{
+    forEachChild(xml, [&] {
+        if (xml.getName() == "object") {
+            LevelObject obj{};
+            obj.id = uintAttribute(xml, "id");
+            obj.name = stringAttribute(xml, "name");
+            obj.type = xml.findAttribute("type") ? stringAttribute(xml, "type") : stringAttribute(xml, "class");
+            obj.bounds = {floatAttribute(xml, "x"), floatAttribute(xml, "y"), floatAttribute(xml, "width"), floatAttribute(xml, "height")};
+            obj.gid = uintAttribute(xml, "gid");
+            map.objects.push_back(std::move(obj));
+        }
+        xml.skipElement();
+    });
+}
+
+void readTmxChildren(XmlReader& xml, LevelMap& map, bool topLevel)
+{
+    forEachChild(xml, [&] {
+        const std::string& element = xml.getName();
+        if (element == "tileset") {
+            readTmxTileset(xml, map);
+        } else if (element == "layer") {
+            readTmxLayer(xml, map);
+        } else if (element == "objectgroup") {
+            readTmxObjects(xml, map);
+        } else if (element == "group") {
+            readTmxChildren(xml, map, false);
+        } else if (element == "properties" && topLevel) {
+            forEachChild(xml, [&] {
+                if (xml.getName() == "property" && stringAttribute(xml, "name") == "name") {
+                    map.name = stringAttribute(xml, "value");
+                }
+                xml.skipElement();
+            });
+        } else {
+            xml.skipElement();
+        }
+    });
+}
+
+// Tiled JSON
+
+using Token = JsonReader::Token;
+
+void expectToken(JsonReader& json, Token token, const char * what)
+{
+    if (json.next() != token) {
+        fail(std::string{"expected "} + what);
+    }
+}
+
+unsigned int readUnsigned(JsonReader& json)
+{
+    expectToken(json, Token::Number, "a number");
+    return static_cast<unsigned int>(json.getUnsigned());
+}
+
+float readFloat(JsonReader& json)
+{
+    expectToken(json, Token::Number, "a number");
+    return static_cast<float>(json.getNumber());
+}
+
+std::string readString(JsonReader& json)
+{
+    expectToken(json, Token::String, "a string");
+    return json.getString();
+}
+
+//! Calls `field(key)` for each key of the object just begun; it must consume the value
+template<typename F>
+void forEachField(JsonReader& json, F&& field)
+{
+    for (Token t = json.next(); t != Token::EndObject; t = json.next()) {
+        if (t != Token::Key) {
+            fail("expected a key");
+        }
+        const std::string key = json.getString();
+        field(key);
+    }
+}
+
+//! Calls `element(first)` for each element of the array just begun, with the element's first token
+template<typename F>
+void forEachElement(JsonReader& json, F&& element)
+{
+    for (Token t = json.next(); t != Token::EndArray; t = json.next()) {
+        element(t);
+    }
+}
+
+void readJsonTileset(JsonReader& json, LevelMap& map)
+{
+    Tileset ts{};
+    forEachField(json, [&](const std::string& key) {
+        if (key == "firstgid") { ts.firstGid = readUnsigned(json); }
+        else if (key == "name") { ts.name = readString(json); }
+        else if (key == "source" && ts.name.empty()) { ts.name = readString(json); }
+        else if (key == "image") { ts.image = readString(json); }
+        else if (key == "imagewidth") { ts.imageSize.x = readUnsigned(json); }
+        else if (key == "imageheight") { ts.imageSize.y = readUnsigned(json); }
+        else if (key == "tilewidth") { ts.tileSize.x = readUnsigned(json); }
+        else if (key == "tileheight") { ts.tileSize.y = readUnsigned(json); }
+        else if (key == "tilecount") { ts.tileCount = readUnsigned(json); }
+        else if (key == "columns") { ts.columns = readUnsigned(json); }
+        else if (key == "margin") { ts.margin = readUnsigned(json); }
+        else if (key == "spacing") { ts.spacing = readUnsigned(json); }
+        else { json.skipValue(json.next()); }
+    });
+    map.tilesets.push_back(std::move(ts));
+}
+
+void readJsonObject(JsonReader& json, LevelMap& map)
+{
+    LevelObject obj{};
+    forEachField(json, [&](const std::string& key) {
+        if (key == "id") { obj.id = readUnsigned(json); }
+        else if (key == "name") { obj.name = readString(json); }
+        else if (key == "type" || key == "class") { obj.type = readString(json); }
+        else if (key == "x") { obj.bounds.left = readFloat(json); }
+        else if (key == "y") { obj.bounds.top = readFloat(json); }
+        else if (key == "width") { obj.bounds.width = readFloat(json); }
+        else if (key == "height") { obj.bounds.height = readFloat(json); }
+        else if (key == "gid") { obj.gid = readUnsigned(json); }
+        else { json.skipValue(json.next()); }
+    });
+    map.objects.push_back(std::move(obj));
+}
+
+void readJsonLayers(JsonReader& json, LevelMap& map);
+
+void readJsonLayer(JsonReader& json, LevelMap& map)
+{
+    std::string type, name, encoding, compression;
+    sf::Vector2u size{};
+    bool sawWidth{false}, sawHeight{false};
+    std::vector<std::uint32_t> gids;
+    // Base64 data seen before its compression, or before the size which bounds
+    // its inflation, is known is kept decoded, but not inflated
+    std::vector<unsigned char> deferred;
+    bool sawCompression{false}, deferring{false};
+
+    forEachField(json, [&](const std::string& key) {
+        if (key == "type") { type = readString(json); }
+        else if (key == "name") { name = readString(json); }
+        else if (key == "width") { size.x = readUnsigned(json), sawWidth = true; }
+        else if (key == "height") { size.y = readUnsigned(json), sawHeight = true; }
+        else if (key == "encoding") { encoding = readString(json); }
+        else if (key == "compression") { compression = readString(json), sawCompression = true; }
+        else if (key == "layers") { expectToken(json, Token::BeginArray, "an array of layers"), readJsonLayers(json, map); }
+        else if (key == "objects") {
+            expectToken(json, Token::BeginArray, "an array of objects");
+            forEachElement(json, [&](Token t) {
+                if (t != Token::BeginObject) { fail("expected an object"); }
+                readJsonObject(json, map);
+            });
+        } else if (key == "data") {
+            const bool sized = sawWidth && sawHeight;
+            const std::size_t limit = sized ? layerCells(name, size) : NoLimit;
+            if (sized) {
+                reserveLayer(size, gids);
+            }
+            if (sawCompression && (sized || compression.empty())) {
+                LayerDecoder decoder{"base64", compression, gids, limit};
+                if (json.streamString([&](const char * p, std::size_t n) { decoder.text(p, n); })) {
+                    decoder.finish();
+                    return;
+                }
+            } else {
+                Base64 base64{};
+                auto keep = [&](const unsigned char * p, std::size_t n) { deferred.insert(deferred.end(), p, p + n); };
+                if (json.streamString([&](const char * p, std::size_t n) { base64.feed(p, n, keep); })) {
+                    deferring = true;
+                    return;
+                }
+            }
+            expectToken(json, Token::BeginArray, "layer data");
+            forEachElement(json, [&](Token t) {
+                if (t != Token::Number) { fail("expected a gid"); }
+                pushGid(gids, limit, static_cast<std::uint32_t>(json.getUnsigned()));
+            });
+        } else {
+            json.skipValue(json.next());
+        }
+    });
+
+    if (type != "tilelayer") {
+        return;
+    }
+    if (deferring) {
+        if (encoding != "base64") {
+            fail("layer '" + name + "' has string data which is not base64");
+        }
+        LayerDecoder decoder{encoding, compression, gids, layerCells(name, size)};
+        decoder.bytes(deferred.data(), deferred.size());
+        decoder.finish();
+    }
+    checkLayer(name, size, gids);
+    map.layers.emplace_back(name, size, std::move(gids));
+}
+
+void readJsonLayers(JsonReader& json, LevelMap& map)
+{
+    forEachElement(json, [&](Token t) {
+        if (t != Token::BeginObject) { fail("expected a layer"); }
+        readJsonLayer(json, map);
+    });
+}
+
+void readJsonProperties(JsonReader& json, LevelMap& map)
+{
+    const Token first = json.next();
+    if (first == Token::BeginObject) {
+        // Before Tiled 1.2: { "name": value, ... }
+        forEachField(json, [&](const std::string& key) {
+            const Token t = json.next();
+            if (key == "name" && t == Token::String) { map.name = json.getString(); }
+            json.skipValue(t);
+        });
+        return;
+    }
+    if (first != Token::BeginArray) {
+        fail("expected properties");
+    }
+    forEachElement(json, [&](Token t) {
+        if (t != Token::BeginObject) { fail("expected a property"); }
+        std::string name, value;
+        bool isString{false};
+        forEachField(json, [&](const std::string& key) {
+            const Token v = json.next();
+            if (key == "name" && v == Token::String) { name = json.getString(); }
+            else if (key == "value" && v == Token::String) { value = json.getString(), isString = true; }
+            json.skipValue(v);
+        });
+        if (name == "name" && isString) {
+            map.name = value;
+        }
+    });
+}
+
+} /*namespace*/;
+
+
+LevelMap readTmx(std::istream& src, const std::string& name)
+{
+    XmlReader xml{src};
+    LevelMap map{};
+    map.name = name;
+
+    for (;;) {
+        const auto e = xml.next();
+        if (e == XmlReader::Event::StartElement) {
+            break;
+        }
+        if (e == XmlReader::Event::End) {
+            fail("no <map> element");
+        }
+    }
+    if (xml.getName() != "map") {
+        fail("root element is <" + xml.getName() + ">, not <map>");
+    }
+    if (stringAttribute(xml, "infinite") == "1") {
+        fail("infinite maps are not supported");
+    }
+    map.size = {uintAttribute(xml, "width"), uintAttribute(xml, "height")};
+    map.tileSize = {uintAttribute(xml, "tilewidth"), uintAttribute(xml, "tileheight")};
+    readTmxChildren(xml, map, true);
+    map.indexObjects();
+    return map;
+}
+
+LevelMap readTiledJson(std::istream& src, const std::string& name)
+{
+    JsonReader json{src};
+    LevelMap map{};
+    map.name = name;
+
+    expectToken(json, Token::BeginObject, "a map object");
+    forEachField(json, [&](const std::string& key) {
+        if (key == "width") { map.size.x = readUnsigned(json); }
+        else if (key == "height") { map.size.y = readUnsigned(json); }
+        else if (key == "tilewidth") { map.tileSize.x = readUnsigned(json); }
+        else if (key == "tileheight") { map.tileSize.y = readUnsigned(json); }
+        else if (key == "infinite") {
+            const Token t = json.next();
+            if (t == Token::True) { fail("infinite maps are not supported"); }
+            json.skipValue(t);
+        } else if (key == "layers") {
+            expectToken(json, Token::BeginArray, "an array of layers");
+            readJsonLayers(json, map);
+        } else if (key == "tilesets") {
+            expectToken(json, Token::BeginArray, "an array of tilesets");
+            forEachElement(json, [&](Token t) {
+                if (t != Token::BeginObject) { fail("expected a tileset"); }
+                readJsonTileset(json, map);
+            });
+        } else if (key == "properties") {
+            readJsonProperties(json, map);
+        } else {
+            json.skipValue(json.next());
+        }
+    });
+    map.indexObjects();
+    return map;
+}
+
+LevelMap readTiledMap(std::istream& src, const std::string& name)
+{
+    int c = src.peek();
+    while (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == 0xEF || c == 0xBB || c == 0xBF) {
+        src.get();
+        c = src.peek();
+    }
+    if (c == '<') {
+        return readTmx(src, name);
+    }
+    if (c == '{') {
+        return readTiledJson(src, name);
+    }
+    fail("neither a TMX nor a JSON map");
+}
+
+LevelMap readTiledFile(const std::string& path)
+{
+    std::ifstream src{path, std::ios::binary};
+    if (!src) {
+        fail("can not open " + path);
+    }
+    const std::size_t slash = path.find_last_of("/\\");
+    std::string name = path.substr(slash == std::string::npos ? 0 : slash + 1);
+    name = name.substr(0, name.find_last_of('.'));
+    return readTiledMap(src, name);
+}
@@ -0,0 +1,100 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(std::size_t threads)
+{
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_threads.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        m_threads.emplace_back([this] { work(); });
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& t : m_threads) { t.join(); }
+}
+
+void WorkerPool::wait(Latch& latch)
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    while (latch.m_pending > 0) {
+        if (m_jobs.empty()) {
+            m_done.wait(lock);
+        } else {
+            runFront(lock);
+        }
+    }
+}
+
+void WorkerPool::waitIdle()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_idle.wait(lock, [this] { return m_jobs.empty() && m_busy == 0; });
+}
+
+std::size_t WorkerPool::getThreadCount() const
+{
+    return m_threads.size();
+}
+
+void WorkerPool::push(Job_t&& job, Latch * latch)
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_jobs.push_back({std::move(job), latch});
+        if (latch) { ++latch->m_pending; }
+    }
+    m_wake.notify_one();
+}
+
+void WorkerPool::work()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+        if (m_jobs.empty()) {
+            return;
+        }
+        runFront(lock);
+    }
+}
+
+void WorkerPool::runFront(std::unique_lock<std::mutex>& lock)
+{
+    Job_t job{std::move(m_jobs.front().job)};
+    Latch * latch = m_jobs.front().latch;
+    m_jobs.pop_front();
+    ++m_busy;
+
+    lock.unlock();
+    try {
+        job();
+    } catch (...) {
+        // Settle the counts first, or the job's latch and `waitIdle` never return
+        job.reset();
+        lock.lock();
+        finish(latch);
+        throw;
+    }
+    job.reset();
+    lock.lock();
+    finish(latch);
+}
+
+void WorkerPool::finish(Latch * latch)
+{
+    if (latch && --latch->m_pending == 0) {
+        m_done.notify_all();
+    }
+    if (--m_busy == 0 && m_jobs.empty()) {
+        m_idle.notify_all();
+    }
+}
@@ -0,0 +1,136 @@
+#include "WorldHost.h"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
+sf::Time WorldHost::WorldStats::meanTick() const
+{
+    return ticks ? sf::microseconds(busy.asMicroseconds() / static_cast<sf::Int64>(ticks)) : sf::Time::Zero;
+}
+
+
+WorldHost::WorldHost(GameContext& context, const GameSettings& settings, std::size_t threads)
+  : m_context{context}
+  , m_settings{settings}
+  , m_pool{threads}
+{
+    m_settings.setHeadless(true);
+}
+
+
+WorldHost::~WorldHost()
+{
+    m_pool.waitIdle();
+}
+
+
+WorldHost::Handle WorldHost::spawn(sf::Time interval)
+{
+    auto slot = std::make_unique<Slot>();
+    slot->world = std::make_unique<GameWorld>(m_context, m_settings);
+    slot->interval = std::max(interval, sf::microseconds(1));
+    m_slots.emplace_back(std::move(slot));
+    return m_slots.size() - 1;
+}
+
+
+GameWorld& WorldHost::getWorld(Handle h)
+{
+    return *m_slots.at(h)->world;
+}
+
+
+std::size_t WorldHost::getWorldCount() const
+{
+    return m_slots.size();
+}
+
+
+void WorldHost::runFor(sf::Time duration)
+{
+    run(duration, false);
+}
+
+
+void WorldHost::runSimulated(sf::Time duration)
+{
+    run(duration, true);
+}
+
+
+void WorldHost::run(sf::Time duration, bool simulated)
+{
+    using Due_t = std::pair<sf::Int64, Handle>;
+    std::priority_queue<Due_t, std::vector<Due_t>, std::greater<Due_t>> due{};
+
+    // Stagger the first ticks so every world does not wake on the same instant
+    const std::size_t count = m_slots.size();
+    for (Handle h = 0; h < count; ++h) {
+        const sf::Int64 offset = m_slots[h]->interval.asMicroseconds() * static_cast<sf::Int64>(h) / static_cast<sf::Int64>(count);
+        due.emplace(offset, h);
+    }
+
+    sf::Clock clock{};
+    while (!due.empty()) {
+        const Due_t next = due.top();
+        const sf::Int64 now = simulated ? next.first : clock.getElapsedTime().asMicroseconds();
+        if (now >= duration.asMicroseconds()) {
+            break;
+        }
+        if (next.first > now) {
+            sf::sleep(sf::microseconds(std::min(next.first, duration.asMicroseconds()) - now));
+            continue;
+        }
+        due.pop();
+
+        Slot& slot = *m_slots[next.second];
+        const sf::Int64 interval = slot.interval.asMicroseconds();
+        std::size_t dropped{0};
+        if (simulated && slot.inFlight.load(std::memory_order_acquire)) {
+            m_pool.waitIdle();
+        }
+        if (slot.inFlight.exchange(true, std::memory_order_acquire)) {
+            // Still busy with its previous tick; this one is lost
+            ++dropped;
+        } else {
+            m_pool.submit([this, &slot] { tickOne(slot); });
+        }
+
+        sf::Int64 deadline = next.first + interval;
+        if (deadline <= now) {
+            const sf::Int64 missed = (now - deadline) / interval + 1;
+            dropped += static_cast<std::size_t>(missed);
+            deadline += missed * interval;
+        }
+        if (dropped) {
+            std::lock_guard<std::mutex> lock{slot.statsMutex};
+            slot.stats.dropped += dropped;
+        }
+        due.emplace(deadline, next.second);
+    }
+    m_pool.waitIdle();
+}
+
+
+WorldHost::WorldStats WorldHost::getStats(Handle h) const
+{
+    const Slot& slot = *m_slots.at(h);
+    std::lock_guard<std::mutex> lock{slot.statsMutex};
+    return slot.stats;
+}
+
+
+void WorldHost::tickOne(Slot& slot)
+{
+    sf::Clock clock{};
+    slot.world->tick(slot.interval.asSeconds());
+    const sf::Time spent = clock.getElapsedTime();
+    {
+        std::lock_guard<std::mutex> lock{slot.statsMutex};
+        ++slot.stats.ticks;
+        slot.stats.busy += spent;
+        slot.stats.worstTick = std::max(slot.stats.worstTick, spent);
+    }
+    slot.inFlight.store(false, std::memory_order_release);
+}
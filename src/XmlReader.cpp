@@ -0,0 +1,325 @@
+#include "XmlReader.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const int Eof = -1;
+
+[[noreturn]] void fail(const char * what)
+{
+    throw std::runtime_error{std::string{"xml: "} + what};
+}
+
+bool isSpace(int c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+void appendUtf8(std::string& out, std::uint32_t cp)
+{
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+} /*namespace*/;
+
+
+XmlReader::XmlReader(std::istream& src, std::size_t bufferSize)
+  : m_src{src}
+  , m_buffer(bufferSize ? bufferSize : 1)
+{
+}
+
+XmlReader::Event XmlReader::next()
+{
+    if (m_selfClosed) {
+        m_selfClosed = false;
+        m_name = std::move(m_open.back());
+        m_open.pop_back();
+        return Event::EndElement;
+    }
+    for (;;) {
+        const int c = peek();
+        if (c == Eof) {
+            if (!m_open.empty()) {
+                fail("unexpected end of input inside an element");
+            }
+            return Event::End;
+        }
+        if (c != '<') {
+            readText();
+            return Event::Text;
+        }
+        Event event;
+        if (readMarkup(event)) {
+            return event;
+        }
+    }
+}
+
+const std::string& XmlReader::getName() const
+{
+    return m_name;
+}
+
+const std::vector<XmlReader::Attribute>& XmlReader::getAttributes() const
+{
+    return m_attributes;
+}
+
+const std::string * XmlReader::findAttribute(const char * name) const
+{
+    for (const auto& a : m_attributes) {
+        if (a.first == name) { return &a.second; }
+    }
+    return nullptr;
+}
+
+const std::string& XmlReader::getText() const
+{
+    return m_text;
+}
+
+void XmlReader::skipElement()
+{
+    for (std::size_t depth = 1; depth > 0; ) {
+        switch (next()) {
+        case Event::StartElement: ++depth; break;
+        case Event::EndElement: --depth; break;
+        case Event::Text: break;
+        case Event::End: fail("unexpected end of input inside an element");
+        }
+    }
+}
+
+bool XmlReader::fill()
+{
+    m_src.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_pos = 0;
+    m_end = static_cast<std::size_t>(m_src.gcount());
+    return m_end > 0;
+}
+
+int XmlReader::peek()
+{
+    if (m_pos == m_end && !fill()) {
+        return Eof;
+    }
+    return static_cast<unsigned char>(m_buffer[m_pos]);
+}
+
+int XmlReader::get()
+{
+    const int c = peek();
+    if (c != Eof) {
+        ++m_pos;
+    }
+    return c;
+}
+
+void XmlReader::expect(char c)
+{
+    if (get() != static_cast<unsigned char>(c)) {
+        fail("unexpected character");
+    }
+}
+
+void XmlReader::skipSpace()
+{
+    while (isSpace(peek())) { ++m_pos; }
+}
+
+void XmlReader::readName(std::string& out)
+{
+    out.clear();
+    for (int c = peek(); c != Eof && !isSpace(c) && c != '=' && c != '/' && c != '>' && c != '<'; c = peek()) {
+        out += static_cast<char>(c);
+        ++m_pos;
+    }
+    if (out.empty()) {
+        fail("expected a name");
+    }
+}
+
+void XmlReader::readEntity(std::string& out)
+{
+    char name[12];
+    std::size_t len{0};
+    for (int c = get(); c != ';'; c = get()) {
+        if (c == Eof || len + 1 == sizeof name) {
+            fail("unterminated entity");
+        }
+        name[len++] = static_cast<char>(c);
+    }
+    name[len] = '\0';
+
+    if (name[0] == '#') {
+        const bool hex = name[1] == 'x' || name[1] == 'X';
+        char * end{nullptr};
+        const unsigned long cp = std::strtoul(name + (hex ? 2 : 1), &end, hex ? 16 : 10);
+        if (*end != '\0' || cp > 0x10FFFF) {
+            fail("malformed character reference");
+        }
+        appendUtf8(out, static_cast<std::uint32_t>(cp));
+    } else if (!std::strcmp(name, "amp")) {
+        out += '&';
+    } else if (!std::strcmp(name, "lt")) {
+        out += '<';
+    } else if (!std::strcmp(name, "gt")) {
+        out += '>';
+    } else if (!std::strcmp(name, "quot")) {
+        out += '"';
+    } else if (!std::strcmp(name, "apos")) {
+        out += '\'';
+    } else {
+        fail("unknown entity");
+    }
+}
+
+void XmlReader::readUntil(const char * terminator, std::string * out)
+{
+    const std::size_t len = std::strlen(terminator);
+    std::string tail;
+    while (tail != terminator) {
+        const int c = get();
+        if (c == Eof) {
+            fail("unterminated markup");
+        }
+        if (out) {
+            *out += static_cast<char>(c);
+        }
+        if (tail.size() == len) {
+            tail.erase(0, 1);
+        }
+        tail += static_cast<char>(c);
+    }
+    if (out) {
+        out->resize(out->size() - len);
+    }
+}
+
+void XmlReader::readText()
+{
+    m_text.clear();
+    while (m_text.size() < m_buffer.size()) {
+        if (m_pos == m_end && !fill()) {
+            return;
+        }
+        const char * begin = m_buffer.data() + m_pos;
+        const char * end = m_buffer.data() + m_end;
+        const char * stop = begin;
+        while (stop != end && *stop != '<' && *stop != '&') { ++stop; }
+        m_text.append(begin, stop);
+        m_pos += static_cast<std::size_t>(stop - begin);
+        if (stop == end) {
+            continue;
+        }
+        if (*stop == '<') {
+            return;
+        }
+        ++m_pos;
+        readEntity(m_text);
+    }
+}
+
+bool XmlReader::readMarkup(Event& event)
+{
+    expect('<');
+    const int c = peek();
+
+    if (c == '?') {
+        readUntil("?>", nullptr);
+        return false;
+    }
+    if (c == '!') {
+        ++m_pos;
+        if (peek() == '-') {
+            expect('-'), expect('-');
+            readUntil("-->", nullptr);
+            return false;
+        }
+        if (peek() == '[') {
+            for (const char * p = "[CDATA["; *p; ++p) { expect(*p); }
+            m_text.clear();
+            readUntil("]]>", &m_text);
+            event = Event::Text;
+            return true;
+        }
+        // A DOCTYPE, perhaps with an internal subset in brackets
+        for (int depth = 0, d = get(); d != '>' || depth > 0; d = get()) {
+            if (d == Eof) {
+                fail("unterminated declaration");
+            }
+            depth += d == '[' ? 1 : d == ']' ? -1 : 0;
+        }
+        return false;
+    }
+    if (c == '/') {
+        ++m_pos;
+        readName(m_name);
+        skipSpace();
+        expect('>');
+        if (m_open.empty() || m_open.back() != m_name) {
+            fail("mismatched end tag");
+        }
+        m_open.pop_back();
+        event = Event::EndElement;
+        return true;
+    }
+
+    readName(m_name);
+    m_attributes.clear();
+    for (;;) {
+        skipSpace();
+        const int a = peek();
+        if (a == '/') {
+            ++m_pos;
+            expect('>');
+            m_selfClosed = true;
+            break;
+        }
+        if (a == '>') {
+            ++m_pos;
+            break;
+        }
+        m_attributes.emplace_back();
+        Attribute& attr = m_attributes.back();
+        readName(attr.first);
+        skipSpace();
+        expect('=');
+        skipSpace();
+        const int quote = get();
+        if (quote != '"' && quote != '\'') {
+            fail("expected a quoted attribute value");
+        }
+        for (int v = get(); v != quote; v = get()) {
+            if (v == Eof) {
+                fail("unterminated attribute value");
+            }
+            if (v == '&') {
+                readEntity(attr.second);
+            } else {
+                attr.second += static_cast<char>(v);
+            }
+        }
+    }
+    m_open.push_back(m_name);
+    event = Event::StartElement;
+    return true;
+}
@@ -0,0 +1,102 @@
+#include "AnimatedSprites.h"
+#include "Animation.h"
+#include "CommandList.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+//! Four 16x16 frames in a row, a tenth of a second each
+AnimationClip walk(AnimationClip::Loop loop)
+{
+    AnimationClip clip{};
+    for (int i = 0; i < 4; ++i) { clip.frames.emplace_back(i * 16, 0, 16, 16); }
+    clip.durations = {0.1f};
+    clip.loop = loop;
+    clip.freeze();
+    return clip;
+}
+
+std::vector<std::size_t> sample(const AnimationClip& clip, int steps)
+{
+    std::vector<std::size_t> frames;
+    for (int i = 0; i < steps; ++i) { frames.push_back(clip.frameAt(0.05f + i * 0.1f)); }
+    return frames;
+}
+
+} /*namespace*/;
+
+
+TEST(Animation, LoopModes)
+{
+    EXPECT_THAT(sample(walk(AnimationClip::Loop::Once), 6), ::testing::ElementsAre(0, 1, 2, 3, 3, 3));
+    EXPECT_THAT(sample(walk(AnimationClip::Loop::Repeat), 6), ::testing::ElementsAre(0, 1, 2, 3, 0, 1));
+    EXPECT_THAT(sample(walk(AnimationClip::Loop::PingPong), 9), ::testing::ElementsAre(0, 1, 2, 3, 2, 1, 0, 1, 2));
+}
+
+TEST(Animation, UnevenDurations)
+{
+    AnimationClip clip{walk(AnimationClip::Loop::Repeat)};
+    clip.durations = {0.5f, 0.1f, 0.1f, 0.3f};
+    clip.freeze();
+    EXPECT_FLOAT_EQ(clip.getLength(), 1.f);
+    EXPECT_EQ(clip.frameAt(0.45f), 0u);
+    EXPECT_EQ(clip.frameAt(0.55f), 1u);
+    EXPECT_EQ(clip.frameAt(0.75f), 3u);
+    EXPECT_EQ(clip.frameAt(1.05f), 0u);
+}
+
+TEST(Animation, LibraryRejectsBadClips)
+{
+    AnimationLibrary library{};
+    EXPECT_THROW(library.add("empty", AnimationClip{}), std::invalid_argument);
+    const ClipId id = library.add("walk", walk(AnimationClip::Loop::Repeat));
+    EXPECT_EQ(library.find("walk"), id);
+    EXPECT_THROW(library.find("run"), std::out_of_range);
+
+    EXPECT_THROW(library.add("walk", walk(AnimationClip::Loop::Once)), std::invalid_argument);
+    EXPECT_EQ(1u, library.size());
+    EXPECT_EQ(AnimationClip::Loop::Repeat, library.get(library.find("walk")).loop);
+
+    for (const float bad : {0.f, -0.1f, std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity()}) {
+        AnimationClip clip{walk(AnimationClip::Loop::Repeat)};
+        clip.durations = {0.1f, bad, 0.1f, 0.1f};
+        EXPECT_THROW(clip.freeze(), std::invalid_argument) << bad;
+        clip.durations = {bad};
+        EXPECT_THROW(library.add("stalled", clip), std::invalid_argument) << bad;
+    }
+    EXPECT_EQ(1u, library.size());
+}
+
+TEST(AnimatedSprites, PatchesOnlyChangedFrames)
+{
+    AnimationLibrary library{};
+    const ClipId id = library.add("walk", walk(AnimationClip::Loop::Repeat));
+    const sf::Texture texture{};
+    AnimatedSprites sprites{library, texture};
+    const auto first = sprites.add(id, {0.f, 0.f});
+    sprites.update(0.05f);
+    const auto second = sprites.add(id, {32.f, 0.f});
+    sprites.update(0.1f);
+    EXPECT_EQ(sprites.getFrame(first), 1u);
+    EXPECT_EQ(sprites.getFrame(second), 1u);
+    sprites.update(0.06f);
+    EXPECT_EQ(sprites.getFrame(first), 2u);
+    EXPECT_EQ(sprites.getFrame(second), 1u);
+
+    CommandList list{};
+    sprites.record(list, {});
+    list.forEach([](std::uint64_t, const RenderCommand& cmd) {
+        ASSERT_EQ(cmd.count, 8u);
+        EXPECT_EQ(cmd.vertices[0].texCoords, sf::Vector2f(32.f, 0.f));
+        EXPECT_EQ(cmd.vertices[4].texCoords, sf::Vector2f(16.f, 0.f));
+        EXPECT_EQ(cmd.vertices[6].position, sf::Vector2f(48.f, 16.f));
+    });
+
+    sprites.remove(first);
+    EXPECT_EQ(sprites.size(), 1u);
+    EXPECT_EQ(sprites.getFrame(first), 1u);
+}
@@ -0,0 +1,300 @@
+#include "CommandList.h"
+#include "FrameArena.h"
+#include "GameContext.h"
+#include "GameSettings.h"
+#include "GameWorld.h"
+#include "RenderDevice.h"
+#include "SoftwareRenderDevice.h"
+#include "SpriteBatch.h"
+#include "SpriteComp.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+//! Never dereferenced, only compared and hashed
+const sf::Texture * fakeTexture(std::uintptr_t id)
+{
+    return reinterpret_cast<const sf::Texture *>(id * 64);
+}
+
+//! Recorded only for its address
+struct Marker : public sf::Drawable {
+    void draw(sf::RenderTarget&, sf::RenderStates) const override { }
+};
+
+std::vector<std::uint64_t> keysOf(const CommandList& list)
+{
+    std::vector<std::uint64_t> keys;
+    list.forEach([&](std::uint64_t key, const RenderCommand&) { keys.push_back(key); });
+    return keys;
+}
+
+} /*namespace*/;
+
+
+TEST(SortKey, LayerDominatesDepth)
+{
+    const auto back = SortKey::make(0, 1000.f, nullptr, sf::BlendAlpha);
+    const auto front = SortKey::make(1, -1000.f, nullptr, sf::BlendAlpha);
+    EXPECT_LT(back, front);
+    EXPECT_EQ(SortKey::layerOf(front), 1u);
+}
+
+TEST(SortKey, DepthOrdersNumerically)
+{
+    const std::vector<float> depths{-500.f, -1.5f, -0.f, 0.25f, 3.f, 1e6f};
+    for (std::size_t i = 1; i < depths.size(); ++i) {
+        EXPECT_LE(SortKey::make(2, depths[i - 1], nullptr, sf::BlendAlpha), SortKey::make(2, depths[i], nullptr, sf::BlendAlpha));
+    }
+}
+
+TEST(SortKey, BlendModesAreInterned)
+{
+    EXPECT_EQ(SortKey::blendIndex(sf::BlendAlpha), 0u);
+    EXPECT_EQ(SortKey::blendIndex(sf::BlendNone), 3u);
+
+    const sf::BlendMode custom{sf::BlendMode::One, sf::BlendMode::OneMinusSrcColor};
+    const auto index = SortKey::blendIndex(custom);
+    EXPECT_EQ(SortKey::blendIndex(custom), index);
+    EXPECT_EQ(SortKey::blendMode(index), custom);
+}
+
+TEST(CommandList, SortIsStableWithinEqualKeys)
+{
+    std::vector<Marker> markers(6);
+    CommandList list{};
+    const auto far = SortKey::make(0, 10.f, fakeTexture(1), sf::BlendAlpha);
+    const auto near = SortKey::make(0, 1.f, fakeTexture(1), sf::BlendAlpha);
+    list.drawable(far, markers[0], {});
+    list.drawable(near, markers[1], {});
+    list.drawable(far, markers[2], {});
+    list.drawable(near, markers[3], {});
+    list.drawable(SortKey::make(1, -5.f, nullptr, sf::BlendAlpha), markers[4], {});
+    list.drawable(near, markers[5], {});
+    list.sort();
+
+    std::vector<const sf::Drawable *> order;
+    list.forEach([&](std::uint64_t, const RenderCommand& cmd) { order.push_back(cmd.drawable); });
+    const std::vector<const sf::Drawable *> expected{&markers[1], &markers[3], &markers[5], &markers[0], &markers[2], &markers[4]};
+    EXPECT_EQ(order, expected);
+    EXPECT_EQ(list.getStats().commands, 6u);
+}
+
+TEST(CommandList, MergeBorrowsAnotherListsCommands)
+{
+    Marker marker{};
+    CommandList frame{}, worker{};
+    frame.drawable(SortKey::make(1, 0.f, nullptr, sf::BlendAlpha), marker, {});
+    sf::Vertex quad[4];
+    worker.quad(SortKey::make(0, 0.f, fakeTexture(2), sf::BlendAdd), fakeTexture(2), sf::BlendAdd, quad);
+    frame.merge(worker);
+    frame.sort();
+
+    ASSERT_EQ(frame.size(), 2u);
+    std::vector<RenderCommand::Kind> kinds;
+    frame.forEach([&](std::uint64_t, const RenderCommand& cmd) { kinds.push_back(cmd.kind); });
+    EXPECT_THAT(kinds, ::testing::ElementsAre(RenderCommand::Kind::Quad, RenderCommand::Kind::Drawable));
+}
+
+TEST(CommandList, CountsOnlyDrawsWhichReachTheDevice)
+{
+    Marker marker{};
+    const sf::Vertex line[2];
+    CommandList list{};
+    list.drawable(SortKey::make(0, 0.f, nullptr, sf::BlendAlpha), marker, {});
+    list.vertices(SortKey::make(0, 1.f, nullptr, sf::BlendAlpha), line, 0, sf::Lines, {});
+    list.vertices(SortKey::make(0, 2.f, nullptr, sf::BlendAlpha), line, 2, sf::Lines, {});
+    list.sort();
+
+    SpriteBatch batch{};
+    SoftwareRenderDevice skipping{{4, 4}};
+    list.submit(skipping, batch);
+    EXPECT_EQ(1u, skipping.getStats().skippedDrawables);
+    EXPECT_EQ(1u, batch.getStats().drawCalls);
+    EXPECT_EQ(2u, batch.getStats().vertices);
+
+    batch.resetStats();
+    NullRenderDevice null{{4, 4}};
+    list.submit(null, batch);
+    EXPECT_EQ(2u, batch.getStats().drawCalls);
+}
+
+TEST(CommandList, SortAdaptsToNearlySortedInput)
+{
+    Marker marker{};
+    std::vector<float> depths(1000);
+    for (std::size_t i = 0; i < depths.size(); ++i) { depths[i] = static_cast<float>(i); }
+
+    auto sorted = [&](const std::vector<float>& input) {
+        CommandList list{};
+        for (const float d : input) { list.drawable(SortKey::make(0, d, nullptr, sf::BlendAlpha), marker, {}); }
+        list.sort();
+        const auto keys = keysOf(list);
+        EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+        return list.getStats().sortMethod;
+    };
+
+    EXPECT_EQ(sorted(depths), CommandList::SortMethod::None);
+    std::swap(depths[10], depths[11]);
+    std::swap(depths[500], depths[900]);
+    EXPECT_EQ(sorted(depths), CommandList::SortMethod::Insertion);
+    std::reverse(depths.begin(), depths.end());
+    EXPECT_EQ(sorted(depths), CommandList::SortMethod::Radix);
+}
+
+TEST(CommandList, EqualKeysTieBySourceThenRecordingOrder)
+{
+    std::vector<Marker> markers(4);
+    const auto key = SortKey::make(0, 0.f, fakeTexture(1), sf::BlendAlpha);
+    const std::vector<const sf::Drawable *> expected{&markers[0], &markers[1], &markers[2], &markers[3]};
+
+    for (const bool reversed : {false, true}) {
+        CommandList list{};
+        // Sorted filler leaves the ties to the insertion pass, reversed filler forces the radix path
+        for (int i = 0; i < 200; ++i) {
+            const float depth = static_cast<float>(reversed ? -i : i);
+            list.drawable(SortKey::make(1, depth, nullptr, sf::BlendAlpha), markers[0], {});
+        }
+        list.setSource(7), list.drawable(key, markers[2], {}), list.drawable(key, markers[3], {});
+        list.setSource(3), list.drawable(key, markers[1], {});
+        list.setSource(CommandList::NoSource), list.drawable(key, markers[3], {});
+        list.setSource(3);
+        list.sort();
+
+        std::vector<const sf::Drawable *> order;
+        list.forEach([&](std::uint64_t k, const RenderCommand& cmd) {
+            if (k == key) { order.push_back(cmd.drawable); }
+        });
+        EXPECT_THAT(order, ::testing::ElementsAre(&markers[1], &markers[2], &markers[3], &markers[3]));
+        EXPECT_EQ(list.getStats().sortMethod, reversed ? CommandList::SortMethod::Radix : CommandList::SortMethod::Insertion);
+    }
+}
+
+TEST(CommandList, TexturesNeverReorderEqualDepths)
+{
+    sf::Vertex quad[4];
+    for (const std::uintptr_t first : {1u, 2u, 3u, 4u}) {
+        CommandList list{};
+        // Recorded in descending texture order as often as ascending, whatever the hash does
+        for (std::uintptr_t t : {first, 5 - first, first + 10}) {
+            list.quad(SortKey::make(0, 0.f, fakeTexture(t), sf::BlendAlpha), fakeTexture(t), sf::BlendAlpha, quad);
+        }
+        list.sort();
+
+        std::vector<const sf::Texture *> order;
+        list.forEach([&](std::uint64_t, const RenderCommand& cmd) { order.push_back(cmd.texture); });
+        EXPECT_THAT(order, ::testing::ElementsAre(fakeTexture(first), fakeTexture(5 - first), fakeTexture(first + 10)));
+    }
+}
+
+TEST(CommandList, WorldDrawsOverlappingSpritesInSubmissionOrder)
+{
+    sf::Texture textures[2];
+    for (const int top : {0, 1}) {
+        GameContext context{};
+        GameSettings settings{};
+        settings.setHeadless(true);
+        GameWorld world{context, settings};
+        auto& under = world.emplace<SpriteComp>(textures[1 - top], sf::IntRect{0, 0, 8, 8});
+        auto& over = world.emplace<SpriteComp>(textures[top], sf::IntRect{0, 0, 8, 8});
+        under.getSprite().setColor(sf::Color::Red);
+        over.getSprite().setColor(sf::Color::Blue);
+        over.setPosition(4.f, 4.f);
+        world.update(0.f);
+
+        SoftwareRenderDevice device{{16, 16}};
+        world.render(device);
+        EXPECT_EQ(device.getPixel(6, 6), sf::Color::Blue) << top;
+        EXPECT_EQ(device.getPixel(2, 2), sf::Color::Red) << top;
+    }
+}
+
+TEST(CommandList, WorldDrawsYSortedComponentsByTheirFeet)
+{
+    GameContext context{};
+    GameSettings settings{};
+    settings.setHeadless(true);
+    GameWorld world{context, settings};
+    sf::Texture texture{};
+    auto& red = world.emplace<SpriteComp>(texture, sf::IntRect{0, 0, 8, 8});
+    auto& blue = world.emplace<SpriteComp>(texture, sf::IntRect{0, 0, 8, 8});
+    red.getSprite().setColor(sf::Color::Red);
+    blue.getSprite().setColor(sf::Color::Blue);
+    red.setYSorted(true), blue.setYSorted(true);
+    red.setPosition(0.f, 4.f);
+    blue.setPosition(4.f, 0.f);
+    for (int i = 0; i < 100; ++i) {
+        world.emplace<SpriteComp>(texture, sf::IntRect{0, 0, 1, 1}).setPosition(20.f + i % 10, 20.f + i / 10);
+    }
+    world.update(0.f);
+
+    SoftwareRenderDevice device{{32, 32}};
+    world.render(device);
+    EXPECT_EQ(device.getPixel(5, 5), sf::Color::Red);
+
+    // The next frame records in this one's order, which needs no sorting
+    world.render(device);
+    EXPECT_EQ(world.getCommandStats().sortMethod, CommandList::SortMethod::None);
+
+    red.setPosition(0.f, -4.f);
+    world.update(0.f);
+    device.clear();
+    world.render(device);
+    EXPECT_EQ(device.getPixel(5, 2), sf::Color::Blue);
+    EXPECT_EQ(world.getCommandStats().sortMethod, CommandList::SortMethod::Insertion);
+}
+
+TEST(CommandList, WorldBreaksEqualFeetByComponentOrderNotTexture)
+{
+    sf::Texture textures[2];
+    for (const int first : {0, 1}) {
+        GameContext context{};
+        GameSettings settings{};
+        settings.setHeadless(true);
+        GameWorld world{context, settings};
+        auto& red = world.emplace<SpriteComp>(textures[first], sf::IntRect{0, 0, 8, 8});
+        auto& blue = world.emplace<SpriteComp>(textures[1 - first], sf::IntRect{0, 0, 8, 8});
+        red.getSprite().setColor(sf::Color::Red);
+        blue.getSprite().setColor(sf::Color::Blue);
+        red.setYSorted(true), blue.setYSorted(true);
+        blue.setPosition(4.f, 0.f);
+        world.update(0.f);
+
+        SoftwareRenderDevice device{{16, 16}};
+        for (int frame = 0; frame < 3; ++frame) {
+            device.clear();
+            world.render(device);
+            EXPECT_EQ(device.getPixel(5, 5), sf::Color::Blue) << first << ' ' << frame;
+        }
+        // Last frame's order is the source order, so later frames need no sorting
+        EXPECT_EQ(world.getCommandStats().sortMethod, CommandList::SortMethod::None) << first;
+    }
+}
+
+TEST(FrameArena, ResetReusesBlocks)
+{
+    FrameArena arena{256};
+    for (int i = 0; i < 100; ++i) { arena.create<std::uint64_t>(i); }
+    const auto reserved = arena.getBytesReserved();
+    EXPECT_GE(reserved, 800u);
+
+    arena.reset();
+    EXPECT_EQ(arena.getBytesUsed(), 0u);
+    for (int i = 0; i < 100; ++i) { arena.create<std::uint64_t>(i); }
+    EXPECT_EQ(arena.getBytesReserved(), reserved);
+}
+
+TEST(FrameArena, AllocationsAreAligned)
+{
+    FrameArena arena{128};
+    arena.create<char>('x');
+    auto * wide = arena.create<double>(1.0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(wide) % alignof(double), 0u);
+    auto * big = arena.createArray<std::uint32_t>(1000);
+    big[999] = 1;
+    EXPECT_EQ(arena.getBytesUsed(), 1 + sizeof(double) + 4000);
+}
@@ -0,0 +1,143 @@
+#include "ConversationDb.h"
+#include "GameContext.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+// As in assets/SampleChat.json, stray comma included
+const char * SampleChat = R"({
+    "type": "Scene"
+  , "sequence": [ "a", "b", "c", "d", "e", "d" ]
+  , "data":
+      {
+      , "a": [ "Bazfee: Hello foobar!" ]
+      , "b": [ "Foobar: Oh, hey Baz!  How've you been?" ]
+      , "c": [ "Bazfee: Oh, you know how it is." ]
+      , "d": [ "Foobar: Yeah...", "Narration without a speaker" ]
+      , "e": "Bazfee: Bruh."
+    }
+})";
+
+ConversationDb compile(const std::string& json)
+{
+    ConversationBuilder builder{};
+    std::istringstream src{json};
+    builder.read(src);
+    return builder.build();
+}
+
+std::vector<std::string> script(const ConversationDb& db, std::uint32_t scene)
+{
+    std::vector<std::string> lines;
+    db.forEachLine(scene, [&](std::size_t, const ConversationDb::Line& line) {
+        const std::string speaker = line.speaker == ConversationDb::NoSpeaker ? "-" : std::string{db.getSpeakerName(line.speaker)};
+        lines.push_back(speaker + "|" + std::string{line.text});
+    });
+    return lines;
+}
+
+} /*namespace*/;
+
+
+TEST(ConversationDb, CompilesTheSampleChat)
+{
+    const ConversationDb db = compile(SampleChat);
+
+    ASSERT_EQ(1u, db.getSceneCount());
+    const std::uint32_t scene = db.findScene("scene0");
+    ASSERT_NE(ConversationDb::NoScene, scene);
+    EXPECT_EQ(ConversationDb::NoScene, db.findScene("scene1"));
+
+    EXPECT_EQ(2u, db.getSpeakerCount());
+    EXPECT_NE(ConversationDb::NoSpeaker, db.findSpeaker("Bazfee"));
+    ASSERT_EQ(6u, db.getStepCount(scene));
+    EXPECT_EQ(db.getStep(scene, 3), db.getStep(scene, 5));
+    EXPECT_EQ(db.findNode(scene, "d"), db.getStep(scene, 3));
+    EXPECT_EQ(5u, db.getNodeCount(scene));
+
+    EXPECT_THAT(script(db, scene), testing::ElementsAre(
+        "Bazfee|Hello foobar!", "Foobar|Oh, hey Baz!  How've you been?", "Bazfee|Oh, you know how it is.",
+        "Foobar|Yeah...", "-|Narration without a speaker", "Bazfee|Bruh.",
+        "Foobar|Yeah...", "-|Narration without a speaker"));
+}
+
+TEST(ConversationDb, StoresRepeatedTextOnce)
+{
+    const ConversationDb once = compile(R"({"id": "x", "sequence": ["a"], "data": {"a": "Guard: Halt!"}})");
+    const ConversationDb twice = compile(R"({"id": "x", "sequence": ["a", "b"], "data": {"a": "Guard: Halt!", "b": "Guard: Halt!"}})");
+
+    // One more node, line and step, and no text but the node's id
+    EXPECT_EQ(once.getMemoryUsage() + 4 * (4 + 3 + 1) + 1, twice.getMemoryUsage());
+}
+
+TEST(ConversationDb, FindsManyScenesById)
+{
+    std::string json = "[";
+    for (int i = 0; i < 500; ++i) {
+        json += R"({"id": "quest)" + std::to_string(i) + R"(", "sequence": ["a"], "data": {"a": "Npc: line )" + std::to_string(i) + "\"}},";
+    }
+    json += "]";
+    const ConversationDb db = compile(json);
+
+    ASSERT_EQ(500u, db.getSceneCount());
+    for (int i = 0; i < 500; ++i) {
+        const std::uint32_t scene = db.findScene("quest" + std::to_string(i));
+        ASSERT_NE(ConversationDb::NoScene, scene);
+        EXPECT_EQ("line " + std::to_string(i), db.getLine(db.getStep(scene, 0), 0).text);
+    }
+    EXPECT_EQ(ConversationDb::NoScene, db.findScene("quest500"));
+}
+
+TEST(ConversationDb, RoundTripsThroughStreamsAndMappedFiles)
+{
+    const ConversationDb db = compile(SampleChat);
+    std::ostringstream dst{};
+    db.write(dst);
+
+    std::istringstream src{dst.str()};
+    EXPECT_EQ(script(db, 0), script(ConversationDb::read(src), 0));
+
+    const std::string path = std::string{P_tmpdir} + "/mint-" + std::to_string(::getpid()) + "-chat.mconv";
+    std::ofstream{path, std::ios::binary} << dst.str();
+    const ConversationDb mapped = ConversationDb::map(path);
+    std::remove(path.c_str());
+    EXPECT_EQ(script(db, 0), script(mapped, mapped.findScene("scene0")));
+}
+
+TEST(ConversationDb, RejectsBadScenesAndDamagedImages)
+{
+    EXPECT_THROW(compile(R"({"sequence": ["a", "z"], "data": {"a": "Hi"}})"), std::runtime_error);
+    EXPECT_THROW(compile(R"([{"id": "x"}, {"id": "x"}])"), std::runtime_error);
+
+    std::ostringstream dst{};
+    compile(SampleChat).write(dst);
+    std::string image = dst.str();
+    image[48 + 12] = 99;                // the first scene's node count
+    std::istringstream src{image};
+    EXPECT_THROW(ConversationDb::read(src), std::runtime_error);
+}
+
+TEST(GameContext, MergesConversationSources)
+{
+    GameContext context{};
+    std::istringstream chat{SampleChat};
+    context.loadConversations(chat);
+
+    std::ostringstream compiled{};
+    compile(R"({"id": "intro", "sequence": ["a"], "data": {"a": "Bazfee: Welcome."}})").write(compiled);
+    std::istringstream binary{compiled.str()};
+    context.loadConversations(binary);
+
+    const ConversationDb& db = context.getConversations();
+    EXPECT_EQ(2u, db.getSceneCount());
+    EXPECT_EQ(2u, db.getSpeakerCount());
+    EXPECT_THAT(script(db, db.findScene("intro")), testing::ElementsAre("Bazfee|Welcome."));
+}
@@ -0,0 +1,186 @@
+#include "CookedLevel.h"
+#include "GameContext.h"
+#include "LevelAtlas.h"
+#include "LevelMap.h"
+#include "TestFiles.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+namespace {
+
+LevelMap makeCave()
+{
+    LevelMap map{};
+    map.name = "cave";
+    map.size = {5, 3};
+    map.tileSize = {16, 8};
+    std::vector<std::uint32_t> floor(15);
+    std::iota(floor.begin(), floor.end(), 1u);
+    floor[14] = 0x80000007u;
+    map.layers.emplace_back("floor", map.size, std::move(floor));
+    map.layers.emplace_back("walls", map.size, std::vector<std::uint32_t>(15, 3u));
+    Tileset ts{};
+    ts.firstGid = 1, ts.name = "rocks", ts.image = "rocks.png", ts.tileSize = {16, 8};
+    ts.imageSize = {64, 32}, ts.columns = 4, ts.tileCount = 16, ts.margin = 1, ts.spacing = 2;
+    map.tilesets.push_back(ts);
+    LevelObject torch{};
+    torch.id = 12, torch.name = "torch", torch.type = "light", torch.bounds = {1.5f, 2, 16, 8}, torch.gid = 9;
+    map.objects.push_back(torch);
+    map.indexObjects();
+    return map;
+}
+
+void expectCave(const LevelMap& map)
+{
+    EXPECT_EQ("cave", map.name);
+    EXPECT_EQ(sf::Vector2u(5, 3), map.size);
+    EXPECT_EQ(sf::Vector2u(16, 8), map.tileSize);
+    ASSERT_EQ(2u, map.layers.size());
+    EXPECT_EQ("walls", map.layers[1].getName());
+    EXPECT_EQ(1u, map.layers[0].at(0, 0));
+    EXPECT_EQ(0x80000007u, map.layers[0].at(4, 2));
+    EXPECT_EQ(3u, map.layers[1].at(2, 1));
+    ASSERT_EQ(1u, map.tilesets.size());
+    EXPECT_EQ("rocks.png", map.tilesets[0].image);
+    EXPECT_EQ(2u, map.tilesets[0].spacing);
+    ASSERT_NE(nullptr, map.findObject(12));
+    EXPECT_EQ("light", map.findObject(12)->type);
+    EXPECT_EQ(sf::FloatRect(1.5f, 2, 16, 8), map.findObject(12)->bounds);
+}
+
+std::string cooked(const LevelMap& map)
+{
+    std::ostringstream dst{};
+    cookLevel(map, dst);
+    return dst.str();
+}
+
+void writeFile(const std::string& path, const std::string& bytes)
+{
+    std::ofstream{path, std::ios::binary} << bytes;
+}
+
+void setModified(const std::string& path, std::time_t when)
+{
+    utimbuf times{when, when};
+    ::utime(path.c_str(), &times);
+}
+
+void setModified(const std::string& path, std::time_t when, long nanoseconds)
+{
+    const timespec times[2] = {{when, nanoseconds}, {when, nanoseconds}};
+    ::utimensat(AT_FDCWD, path.c_str(), times, 0);
+}
+
+} /*namespace*/;
+
+
+TEST(CookedLevel, RoundTripsThroughAStream)
+{
+    std::istringstream src{cooked(makeCave())};
+    expectCave(readCookedLevel(src));
+}
+
+TEST(CookedLevel, MappedLayersPointIntoTheAlignedFile)
+{
+    const std::string path = tempPath("cave.mlvl");
+    writeFile(path, cooked(makeCave()));
+
+    const LevelMap map = mapCookedLevel(path);
+    std::remove(path.c_str());
+
+    expectCave(map);
+    for (const auto& layer : map.layers) {
+        EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(layer.data()) % 64);
+    }
+}
+
+TEST(CookedLevel, RejectsDamagedFiles)
+{
+    const std::string good = cooked(makeCave());
+
+    std::string truncated = good.substr(0, good.size() - 64);
+    std::istringstream a{truncated};
+    EXPECT_THROW(readCookedLevel(a), std::runtime_error);
+
+    std::string newer = good;
+    newer[8] = 2;
+    std::istringstream b{newer};
+    EXPECT_THROW(readCookedLevel(b), std::runtime_error);
+
+    // The first section's offset, pointed past the end of the file
+    std::string wild = good;
+    wild[32 + 8 + 5] = 0x7f;
+    std::istringstream c{wild};
+    EXPECT_THROW(readCookedLevel(c), std::runtime_error);
+
+    // The tile section, moved off its 64-byte boundary but kept in bounds
+    std::string skewed = good;
+    skewed[32 + 5 * 24 + 8] += 4;
+    skewed[32 + 5 * 24 + 16] -= 4;
+    std::istringstream d{skewed};
+    EXPECT_THROW(readCookedLevel(d), std::runtime_error);
+}
+
+TEST(CookedLevel, NamesItsSiblingAfterTheSource)
+{
+    EXPECT_EQ("maps/cave.mlvl", cookedLevelPath("maps/cave.tmx"));
+    EXPECT_EQ("maps.v2/cave.mlvl", cookedLevelPath("maps.v2/cave"));
+}
+
+TEST(CookedLevel, IsStaleOnceItsSourceIsSavedWithinTheSameSecond)
+{
+    const std::string source = tempPath("attic.tmx"), cooked = cookedLevelPath(source);
+    writeFile(source, "<map/>"), writeFile(cooked, "cooked");
+
+    setModified(source, 1000, 100), setModified(cooked, 1000, 200);
+    EXPECT_TRUE(isCookedLevelFresh(cooked, source));
+    setModified(source, 1000, 300);
+    EXPECT_FALSE(isCookedLevelFresh(cooked, source));
+    setModified(source, 1000, 200);
+    EXPECT_FALSE(isCookedLevelFresh(cooked, source));
+
+    std::remove(source.c_str());
+    EXPECT_TRUE(isCookedLevelFresh(cooked, source));
+    std::remove(cooked.c_str());
+    EXPECT_FALSE(isCookedLevelFresh(cooked, source));
+}
+
+TEST(GameContext, PrefersAFreshCookedLevelOverItsSource)
+{
+    const std::string source = tempPath("cellar.json");
+    writeFile(source, "{\"width\": 1, \"height\": 1, \"layers\": "
+        "[{\"type\": \"tilelayer\", \"name\": \"floor\", \"width\": 1, \"height\": 1, \"data\": [4]}]}");
+    // Both name the level after the file
+    LevelMap stand = makeCave();
+    stand.name = "mint-" + std::to_string(::getpid()) + "-cellar";
+    writeFile(cookedLevelPath(source), cooked(stand));
+
+    setModified(source, 1000), setModified(cookedLevelPath(source), 2000);
+    GameContext fresh{};
+    fresh.loadLevelFile(source);
+    ASSERT_NE(nullptr, fresh.getLevelAtlas().find(stand.name));
+    EXPECT_EQ(2u, fresh.getLevelAtlas().find(stand.name)->layers.size());
+
+    setModified(source, 3000);
+    GameContext stale{};
+    stale.loadLevelFile(source);
+    ASSERT_NE(nullptr, stale.getLevelAtlas().find(stand.name));
+    EXPECT_EQ(4u, stale.getLevelAtlas().find(stand.name)->layers.at(0).at(0, 0));
+
+    std::remove(source.c_str());
+    std::remove(cookedLevelPath(source).c_str());
+}
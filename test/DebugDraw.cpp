@@ -0,0 +1,126 @@
+#include "Component.h"
+#include "DebugDraw.h"
+#include "GameContext.h"
+#include "GameSettings.h"
+#include "GameWorld.h"
+#include "SoftwareRenderDevice.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+#include <thread>
+#include <vector>
+
+namespace {
+
+//! Outlines its box every update
+struct BoxComp : public Component {
+
+    sf::Color color;
+
+    explicit BoxComp(sf::Color c) : color{c}
+    {
+    }
+
+    void update(float) override
+    {
+        DebugDraw::box({2.f, 2.f, 4.f, 4.f}, color, true);
+    }
+
+} /*struct BoxComp*/;
+
+} /*namespace*/;
+
+
+TEST(DebugDraw, FlushesEveryThreadInOneDrawPerPrimitive)
+{
+    if (!DebugDraw::Enabled) {
+        return;
+    }
+    SoftwareRenderDevice device{{32, 32}};
+    DebugDraw::flush(device);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 100; ++i) { DebugDraw::line({0.f, 0.f}, {1.f, 1.f}); }
+            DebugDraw::box({t * 8.f, 0.f, 4.f, 4.f}, sf::Color::Red, true);
+        });
+    }
+    for (auto& t : threads) { t.join(); }
+    DebugDraw::circle({16.f, 24.f}, 4.f);
+
+    device.resetStats();
+    DebugDraw::flush(device);
+    EXPECT_EQ(device.getStats().draws, 2u);
+    EXPECT_EQ(DebugDraw::getStats().lines, 400u + 24u);
+    EXPECT_EQ(DebugDraw::getStats().triangles, 8u);
+    EXPECT_EQ(device.getPixel(25, 1), sf::Color::Red);
+    EXPECT_EQ(device.getPixel(20, 24), sf::Color::Green);
+
+    // Flushed shapes are gone
+    device.resetStats();
+    DebugDraw::flush(device);
+    EXPECT_EQ(device.getStats().draws, 0u);
+}
+
+TEST(DebugDraw, WorldDrawsShapesOnTop)
+{
+    if (!DebugDraw::Enabled) {
+        return;
+    }
+    GameContext context{};
+    GameSettings settings{};
+    settings.setHeadless(true);
+    GameWorld world{context, settings};
+    SoftwareRenderDevice device{{16, 16}};
+
+    DebugDraw::label({0.f, 0.f}, "dropped without a font");
+    DebugDraw::box({2.f, 2.f, 4.f, 4.f}, sf::Color::Yellow, true);
+    world.render(device);
+    EXPECT_EQ(device.getPixel(3, 3), sf::Color::Yellow);
+    EXPECT_EQ(DebugDraw::getStats().labels, 0u);
+    EXPECT_EQ(DebugDraw::getStats().draws, 1u);
+}
+
+TEST(DebugDraw, HeadlessTicksDoNotGrowTheBuffer)
+{
+    if (!DebugDraw::Enabled) {
+        return;
+    }
+    GameContext context{};
+    GameSettings settings{};
+    settings.setHeadless(true);
+    GameWorld world{context, settings};
+    world.emplace<BoxComp>(sf::Color::Red);
+
+    world.runTicks(1000, 0.01f);
+    // Only the last tick's box, six vertices, is kept
+    EXPECT_EQ(world.getDebugDraw().getPending(), 6u);
+
+    SoftwareRenderDevice device{{16, 16}};
+    device.resetStats();
+    DebugDraw::flush(device);
+    EXPECT_EQ(device.getStats().draws, 0u);
+}
+
+TEST(DebugDraw, WorldsKeepTheirShapesApart)
+{
+    if (!DebugDraw::Enabled) {
+        return;
+    }
+    GameContext context{};
+    GameSettings settings{};
+    settings.setHeadless(true);
+    GameWorld red{context, settings}, blue{context, settings};
+    red.emplace<BoxComp>(sf::Color::Red);
+    blue.emplace<BoxComp>(sf::Color::Blue);
+    red.update(0.f);
+    blue.update(0.f);
+
+    SoftwareRenderDevice first{{16, 16}}, second{{16, 16}};
+    red.render(first);
+    blue.render(second);
+    EXPECT_EQ(first.getPixel(3, 3), sf::Color::Red);
+    EXPECT_EQ(second.getPixel(3, 3), sf::Color::Blue);
+    EXPECT_EQ(DebugDraw::getStats().triangles, 2u);
+}
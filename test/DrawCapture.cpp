@@ -0,0 +1,206 @@
+#include "CommandList.h"
+#include "DrawCapture.h"
+#include "GameContext.h"
+#include "GameSettings.h"
+#include "GameWorld.h"
+#include "SoftwareRenderDevice.h"
+#include "SpriteBatch.h"
+#include "SpriteComp.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+
+void recordScene(CommandList& list, const sf::Texture& texture, const sf::Vertex (&strip)[3])
+{
+    const sf::Vertex quad[4] = {
+        {{2.f, 2.f}, sf::Color::Red}, {{10.f, 2.f}, sf::Color::Red}
+      , {{10.f, 10.f}, sf::Color::Red}, {{2.f, 10.f}, sf::Color::Red}
+    };
+    list.quad(SortKey::make(1, 0.f, &texture, sf::BlendAdd), &texture, sf::BlendAdd, quad);
+
+    sf::RenderStates states{};
+    states.transform.translate(4.f, 4.f);
+    list.vertices(SortKey::make(0, 0.f, nullptr, sf::BlendAlpha), strip, 3, sf::Triangles, states);
+}
+
+} /*namespace*/;
+
+
+TEST(DrawCapture, RoundTripsCommands)
+{
+    sf::Texture texture{};
+    const sf::Vertex strip[3] = {{{0.f, 0.f}, sf::Color::Blue}, {{8.f, 0.f}, sf::Color::Blue}, {{0.f, 8.f}, sf::Color::Blue}};
+    CommandList original{};
+    recordScene(original, texture, strip);
+    const sf::RectangleShape shape{};
+    original.drawable(0, shape, {});
+
+    std::stringstream capture{};
+    DrawRecorder recorder{capture};
+    recorder.recordFrame(original, sf::View{sf::FloatRect{0.f, 0.f, 16.f, 16.f}});
+    recorder.recordFrame(original, sf::View{sf::FloatRect{0.f, 0.f, 16.f, 16.f}});
+    EXPECT_EQ(recorder.getFrameCount(), 2u);
+    EXPECT_EQ(recorder.getSkippedDrawables(), 2u);
+
+    DrawReplayer replayer{capture};
+    DrawFrame frame{};
+    ASSERT_TRUE(replayer.nextFrame(frame));
+    EXPECT_EQ(frame.size(), 2u);
+    EXPECT_EQ(frame.getView().getSize(), sf::Vector2f(16.f, 16.f));
+    ASSERT_EQ(replayer.getTextureSizes().size(), 1u);
+
+    CommandList replayed{};
+    frame.record(replayed);
+    std::vector<std::uint64_t> keys{};
+    std::vector<std::uint64_t> expected{};
+    replayed.forEach([&](std::uint64_t key, const RenderCommand&) { keys.push_back(key); });
+    original.forEach([&](std::uint64_t key, const RenderCommand& cmd) {
+        if (cmd.kind != RenderCommand::Kind::Drawable) { expected.push_back(key); }
+    });
+    EXPECT_EQ(keys, expected);
+
+    ASSERT_TRUE(replayer.nextFrame(frame));
+    EXPECT_EQ(replayer.getTextureSizes().size(), 1u);
+    EXPECT_FALSE(replayer.nextFrame(frame));
+}
+
+TEST(DrawCapture, ReplayRendersTheSameImage)
+{
+    sf::Texture texture{};
+    const sf::Vertex strip[3] = {{{0.f, 0.f}, sf::Color::Blue}, {{8.f, 0.f}, sf::Color::Blue}, {{0.f, 8.f}, sf::Color::Blue}};
+    CommandList original{};
+    recordScene(original, texture, strip);
+
+    std::stringstream capture{};
+    DrawRecorder recorder{capture};
+    recorder.recordFrame(original, sf::View{sf::FloatRect{0.f, 0.f, 16.f, 16.f}});
+
+    SpriteBatch batch{};
+    SoftwareRenderDevice live{{16, 16}};
+    original.sort();
+    original.submit(live, batch);
+
+    DrawReplayer replayer{capture};
+    DrawFrame frame{};
+    ASSERT_TRUE(replayer.nextFrame(frame));
+    CommandList replayed{};
+    frame.record(replayed);
+    replayed.sort();
+    SoftwareRenderDevice offline{{16, 16}};
+    replayed.submit(offline, batch);
+
+    EXPECT_EQ(live.checksum(), offline.checksum());
+    EXPECT_EQ(offline.getPixel(5, 5), sf::Color::Magenta);
+}
+
+TEST(DrawCapture, CapturesWorldFrames)
+{
+    GameContext context{};
+    GameSettings settings{};
+    settings.setHeadless(true);
+    GameWorld world{context, settings};
+    sf::Texture texture{};
+    for (int i = 0; i < 3; ++i) {
+        world.emplace<SpriteComp>(texture, sf::IntRect{0, 0, 4, 4}).setPosition(i * 8.f, 0.f);
+    }
+    world.update(0.f);
+
+    std::stringstream capture{};
+    DrawRecorder recorder{capture};
+    SoftwareRenderDevice device{{32, 32}};
+    world.render(device);
+    world.setDrawRecorder(&recorder);
+    world.render(device);
+    world.setDrawRecorder(nullptr);
+    world.render(device);
+    EXPECT_EQ(recorder.getFrameCount(), 1u);
+
+    DrawReplayer replayer{capture};
+    DrawFrame frame{};
+    ASSERT_TRUE(replayer.nextFrame(frame));
+    EXPECT_EQ(frame.size(), 3u);
+    EXPECT_FALSE(replayer.nextFrame(frame));
+}
+
+TEST(DrawCapture, CapturesWorldFramesInRecordingOrder)
+{
+    GameContext context{};
+    GameSettings settings{};
+    settings.setHeadless(true);
+    GameWorld world{context, settings};
+    sf::Texture texture{};
+    // Recorded first to last, drawn last to first
+    for (int i = 0; i < 3; ++i) {
+        world.emplace<SpriteComp>(texture, sf::IntRect{0, 0, 4, 4}).setLayer(static_cast<std::uint8_t>(2 - i));
+    }
+    world.update(0.f);
+
+    std::stringstream capture{};
+    DrawRecorder recorder{capture};
+    SoftwareRenderDevice device{{32, 32}};
+    world.setDrawRecorder(&recorder);
+    world.render(device);
+
+    DrawReplayer replayer{capture};
+    DrawFrame frame{};
+    ASSERT_TRUE(replayer.nextFrame(frame));
+    CommandList replayed{};
+    frame.record(replayed);
+    std::vector<std::uint8_t> layers{};
+    replayed.forEach([&](std::uint64_t key, const RenderCommand&) { layers.push_back(SortKey::layerOf(key)); });
+    EXPECT_EQ((std::vector<std::uint8_t>{2, 1, 0}), layers);
+
+    // Sorting the replay orders it as the world did
+    replayed.sort();
+    layers.clear();
+    replayed.forEach([&](std::uint64_t key, const RenderCommand&) { layers.push_back(SortKey::layerOf(key)); });
+    EXPECT_EQ((std::vector<std::uint8_t>{0, 1, 2}), layers);
+}
+
+TEST(DrawCapture, KeepsEachCommandsSource)
+{
+    sf::Texture texture{};
+    const sf::Vertex strip[3] = {{{0.f, 0.f}, sf::Color::Blue}, {{8.f, 0.f}, sf::Color::Blue}, {{0.f, 8.f}, sf::Color::Blue}};
+    CommandList original{};
+    original.setSource(7);
+    recordScene(original, texture, strip);
+    original.setSource(CommandList::NoSource);
+    recordScene(original, texture, strip);
+
+    std::stringstream capture{};
+    DrawRecorder recorder{capture};
+    recorder.recordFrame(original, sf::View{});
+    DrawReplayer replayer{capture};
+    DrawFrame frame{};
+    ASSERT_TRUE(replayer.nextFrame(frame));
+    CommandList replayed{};
+    frame.record(replayed);
+
+    std::vector<std::uint32_t> sources{};
+    replayed.forEach([&](std::uint64_t, const RenderCommand& cmd) { sources.push_back(cmd.source); });
+    EXPECT_EQ((std::vector<std::uint32_t>{7, 7, CommandList::NoSource, CommandList::NoSource}), sources);
+}
+
+TEST(DrawCapture, RejectsForeignInput)
+{
+    std::stringstream bad{"MINTINPT\x01"};
+    EXPECT_THROW(DrawReplayer{bad}, std::runtime_error);
+
+    std::stringstream truncated{};
+    DrawRecorder recorder{truncated};
+    CommandList list{};
+    recorder.recordFrame(list, sf::View{});
+    std::string bytes = truncated.str();
+    bytes.pop_back();
+    std::stringstream cut{bytes};
+    DrawReplayer replayer{cut};
+    DrawFrame frame{};
+    EXPECT_THROW(replayer.nextFrame(frame), std::runtime_error);
+}
@@ -0,0 +1,143 @@
+#include "EquipmentTable.h"
+#include "GameContext.h"
+#include "PerfectHash.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Column = EquipmentTable::Column;
+using Slot = EquipmentTable::Slot;
+
+std::vector<EquipmentTable::Item> randomItems(std::size_t n)
+{
+    std::mt19937 rng{3};
+    std::vector<EquipmentTable::Item> items(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        items[i].id = static_cast<std::uint32_t>(1000 + 7 * i);
+        items[i].name = "item-" + std::to_string(i);
+        items[i].slot = static_cast<Slot>(rng() % static_cast<unsigned int>(Slot::Count));
+        for (auto& stat : items[i].stats) { stat = static_cast<std::int32_t>(rng() % 61) - 10; }
+    }
+    return items;
+}
+
+//! The rows a plain loop over the items finds
+std::vector<std::uint32_t> bruteForce(const std::vector<EquipmentTable::Item>& items, std::set<Slot> slots, int minAtt, int maxLevel)
+{
+    std::vector<std::uint32_t> rows;
+    for (std::uint32_t row = 0; row < items.size(); ++row) {
+        const auto& item = items[row];
+        if ((slots.empty() || slots.count(item.slot)) && item.stats[int(Column::Att)] >= minAtt && item.stats[int(Column::Level)] <= maxLevel) {
+            rows.push_back(row);
+        }
+    }
+    return rows;
+}
+
+} /*namespace*/;
+
+
+TEST(PerfectHash, GivesEveryKeyItsOwnSlot)
+{
+    std::vector<std::uint64_t> hashes;
+    for (std::uint64_t k = 0; k < 10000; ++k) { hashes.push_back(PerfectHash::mix(k)); }
+    const PerfectHash hash{hashes};
+
+    std::set<std::size_t> slots;
+    for (std::uint64_t h : hashes) {
+        const std::size_t slot = hash.slot(h);
+        EXPECT_LT(slot, hash.getSlotCount());
+        slots.insert(slot);
+    }
+    EXPECT_EQ(hashes.size(), slots.size());
+    EXPECT_LE(hash.getSlotCount(), hashes.size() * 12 / 10);
+
+    hashes.push_back(hashes[17]);
+    EXPECT_THROW(PerfectHash{hashes}, std::invalid_argument);
+}
+
+TEST(EquipmentTable, FindsRowsByIdAndName)
+{
+    const auto items = randomItems(3000);
+    const EquipmentTable table{items};
+
+    for (std::uint32_t row = 0; row < items.size(); row += 37) {
+        EXPECT_EQ(row, table.findId(items[row].id));
+        EXPECT_EQ(row, table.findName(items[row].name));
+        EXPECT_EQ(items[row].name, table.getName(row));
+        EXPECT_EQ(items[row].slot, table.getSlot(row));
+    }
+    EXPECT_EQ(EquipmentTable::NoRow, table.findId(1001));
+    EXPECT_EQ(EquipmentTable::NoRow, table.findName("item-3000"));
+    EXPECT_EQ(EquipmentTable::NoRow, EquipmentTable{}.findName("item-0"));
+
+    auto twins = randomItems(2);
+    twins[1].name = twins[0].name;
+    EXPECT_THROW(EquipmentTable{twins}, std::invalid_argument);
+}
+
+TEST(EquipmentTable, ScansMatchAPlainLoop)
+{
+    // Not a multiple of any vector width, so every tail path runs
+    const auto items = randomItems(64 * 20 + 37);
+    const EquipmentTable table{items};
+
+    for (int minAtt : {-100, 0, 20, 45, 51}) {
+        for (int maxLevel : {-11, 10, 50}) {
+            for (const std::set<Slot>& slots : {std::set<Slot>{}, {Slot::Weapon}, {Slot::Head, Slot::Accessory}}) {
+                EquipmentTable::Query query{};
+                for (Slot s : slots) { query.slot(s); }
+                query.atLeast(Column::Att, minAtt).atMost(Column::Level, maxLevel);
+
+                std::vector<std::uint32_t> rows;
+                table.select(query, rows);
+                const auto expected = bruteForce(items, slots, minAtt, maxLevel);
+                EXPECT_EQ(expected, rows) << minAtt << " " << maxLevel << " " << slots.size();
+                EXPECT_EQ(expected.size(), table.count(query));
+            }
+        }
+    }
+}
+
+TEST(EquipmentTable, ModifiesBattleStats)
+{
+    EquipmentTable::Item cursed{};
+    cursed.stats[int(Column::Att)] = 7;
+    cursed.stats[int(Column::Spd)] = -5;
+    const EquipmentTable table{{cursed}};
+
+    BattleStats stats{};
+    table.applyTo(0, stats);
+    EXPECT_EQ(10u, stats.att);
+    EXPECT_EQ(0u, stats.spd);
+    EXPECT_EQ(3u, stats.def);
+}
+
+TEST(GameContext, LoadsEquipmentFromJson)
+{
+    GameContext context{};
+    std::istringstream weapons{R"([
+        {"id": 1, "name": "Bronze Sword", "slot": "weapon", "level": 1, "price": 40, "att": 5},
+        {"id": 2, "name": "Flame Rod", "slot": "weapon", "level": 12, "att": 21, "mag": 9, "rarity": "rare"},
+    ])"};
+    std::istringstream armor{R"([{"id": 3, "name": "Leather Cap", "slot": "head", "def": 2}])"};
+    context.loadEquipment(weapons);
+    context.loadEquipment(armor);
+
+    const EquipmentTable& table = context.getEquipment();
+    ASSERT_EQ(3u, table.size());
+    EXPECT_EQ(1u, table.findName("Flame Rod"));
+    EXPECT_EQ(9, table.get(1, Column::Mag));
+    EXPECT_EQ(Slot::Head, table.getSlot(table.findId(3)));
+    EXPECT_EQ(1u, table.count(EquipmentTable::Query{}.slot(Slot::Weapon).atLeast(Column::Att, 20)));
+
+    std::istringstream clash{R"([{"id": 1, "name": "Copper Sword"}])"};
+    EXPECT_THROW(context.loadEquipment(clash), std::invalid_argument);
+}
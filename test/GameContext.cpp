@@ -0,0 +1,224 @@
+#include "ConversationDb.h"
+#include "EquipmentTable.h"
+#include "GameContext.h"
+#include "LevelAtlas.h"
+#include "StartupReport.h"
+#include "TestFiles.h"
+#include "WorkerPool.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using DataType = GameContext::DataType;
+
+//! Writes each file on construction and removes it again on destruction
+struct TempFiles {
+    std::vector<std::string> paths;
+
+    std::string add(const std::string& leaf, const std::string& bytes)
+    {
+        paths.push_back(tempPath(leaf));
+        std::ofstream{paths.back(), std::ios::binary} << bytes;
+        return paths.back();
+    }
+
+    ~TempFiles()
+    {
+        for (const auto& path : paths) { std::remove(path.c_str()); }
+    }
+} /*struct TempFiles*/;
+
+std::string items(std::uint32_t first, std::size_t count)
+{
+    std::string json = "[";
+    for (std::uint32_t id = first; id < first + count; ++id) {
+        json += "{\"id\": " + std::to_string(id) + ", \"name\": \"item " + std::to_string(id) + "\", \"att\": 1},";
+    }
+    return json + "]";
+}
+
+std::string level(unsigned int width)
+{
+    std::string data;
+    for (unsigned int i = 0; i < width; ++i) { data += "1,"; }
+    return "{\"width\": " + std::to_string(width) + ", \"height\": 1, \"tilewidth\": 8, \"tileheight\": 8, "
+        "\"layers\": [{\"type\": \"tilelayer\", \"name\": \"ground\", \"width\": " + std::to_string(width)
+        + ", \"height\": 1, \"data\": [" + data + "]}], \"tilesets\": []}";
+}
+
+std::size_t countPhase(const StartupReport& report, const std::string& phase)
+{
+    const auto entries = report.getEntries();
+    return static_cast<std::size_t>(std::count_if(entries.begin(), entries.end(), [&](const StartupReport::Entry& e) { return e.phase == phase; }));
+}
+
+} /*namespace*/;
+
+
+TEST(GameContext, LoadsFilesInParallelButMergesInOrder)
+{
+    TempFiles files{};
+    std::vector<GameContext::Source> sources;
+    for (std::uint32_t i = 0; i < 8; ++i) {
+        // Earlier files are larger, so they tend to finish last
+        sources.push_back({DataType::EquipmentData, files.add("items" + std::to_string(i) + ".json", items(1000 * i, 800 - 100 * i))});
+        sources.push_back({DataType::LevelMap, files.add("level" + std::to_string(i) + ".json", level(4000 - 400 * i))});
+    }
+    sources.push_back({DataType::Conversation, files.add("talk.json", R"([{"id": "hello", "sequence": ["a"], "data": {"a": ["Ann: Hi."]}}])")});
+
+    StartupReport report{};
+    GameContext context{};
+    context.setStartupReport(&report);
+    WorkerPool pool{4};
+    context.loadFiles(sources, pool);
+
+    const EquipmentTable& table = context.getEquipment();
+    ASSERT_EQ(3600u, table.size());
+    std::uint32_t row{0};
+    for (std::uint32_t i = 0; i < 8; ++i) {
+        EXPECT_EQ(1000 * i, table.getId(row)) << i;
+        row += 800 - 100 * i;
+    }
+    ASSERT_EQ(8u, context.getLevelAtlas().size());
+    ASSERT_NE(nullptr, context.getLevelAtlas().find("mint-" + std::to_string(::getpid()) + "-level7"));
+
+    EXPECT_EQ(8u, countPhase(report, "equipment"));
+    EXPECT_EQ(8u, countPhase(report, "level"));
+    EXPECT_EQ(1u, countPhase(report, "deferred"));
+
+    const ConversationDb& db = context.getConversations();
+    EXPECT_NE(ConversationDb::NoScene, db.findScene("hello"));
+    EXPECT_EQ(1u, countPhase(report, "conversation"));
+}
+
+TEST(GameContext, LeavesItselfAsItWasWhenAFileFails)
+{
+    TempFiles files{};
+    const std::string good = files.add("good.json", items(1, 3));
+    const std::string clash = files.add("clash.json", items(3, 3));
+    const std::string missing = tempPath("missing.json");
+
+    GameContext context{};
+    WorkerPool pool{2};
+    context.loadFiles({{DataType::EquipmentData, good}}, pool);
+
+    try {
+        context.loadFiles({{DataType::LevelMap, files.add("broken.json", "{\"width\": ")}, {DataType::EquipmentData, missing}}, pool);
+        FAIL() << "expected a failure";
+    } catch (const std::runtime_error& ex) {
+        EXPECT_THAT(ex.what(), ::testing::HasSubstr("broken.json"));
+    }
+    EXPECT_THROW(context.loadFiles({{DataType::Conversation, missing}}, pool), std::runtime_error);
+    try {
+        context.loadFiles({{DataType::EquipmentData, files.add("other.json", items(10, 3))}, {DataType::EquipmentData, clash}}, pool);
+        FAIL() << "expected a failure";
+    } catch (const std::runtime_error& ex) {
+        EXPECT_THAT(ex.what(), ::testing::HasSubstr("clash.json"));
+        EXPECT_THAT(ex.what(), ::testing::HasSubstr("duplicate item ids"));
+    }
+
+    EXPECT_EQ(3u, context.getEquipment().size());
+    EXPECT_EQ(0u, context.getLevelAtlas().size());
+    EXPECT_EQ(0u, context.getConversations().getSceneCount());
+
+    // Nor does it keep the ids of files loaded alongside the clash
+    context.loadFiles({{DataType::EquipmentData, tempPath("other.json")}}, pool);
+    EXPECT_EQ(6u, context.getEquipment().size());
+}
+
+TEST(GameContext, CompilesConversationsOnThePoolAfterLoading)
+{
+    TempFiles files{};
+    const std::string first = files.add("first.json", R"([{"sequence": ["a"], "data": {"a": ["Ann: Hi."]}}])");
+    const std::string second = files.add("second.json", R"([{"sequence": ["a"], "data": {"a": ["Bob: Yo."]}}])");
+    const std::string broken = files.add("broken-talk.json", R"([{"sequence": ["a"], "data": )");
+
+    GameContext context{};
+    {
+        // The pool finishes compiling before it goes away, long before the context does
+        WorkerPool pool{1};
+        context.loadFiles({{DataType::Conversation, first}, {DataType::Conversation, second}}, pool);
+    }
+    const ConversationDb& db = context.getConversations();
+    ASSERT_EQ(2u, db.getSceneCount());
+    EXPECT_EQ("Bob", db.getSpeakerName(db.getLine(db.getFirstNode(db.findScene("scene1")), 0).speaker));
+
+    // Failures still surface from getConversations, naming the file
+    WorkerPool pool{1};
+    context.loadFiles({{DataType::Conversation, broken}}, pool);
+    try {
+        context.getConversations();
+        FAIL() << "expected a failure";
+    } catch (const std::runtime_error& ex) {
+        EXPECT_THAT(ex.what(), ::testing::HasSubstr("broken-talk.json"));
+    }
+}
+
+TEST(GameContext, HoldsALoneCompiledDatabaseAsIs)
+{
+    ConversationBuilder builder{};
+    std::istringstream json{R"([{"id": "intro", "sequence": ["a"], "data": {"a": ["Ann: Hi."]}}])"};
+    builder.read(json);
+    std::ostringstream image{};
+    builder.build().write(image);
+    TempFiles files{};
+    const std::string compiled = files.add("talk.mconv", image.str());
+
+    StartupReport report{};
+    GameContext context{};
+    context.setStartupReport(&report);
+    {
+        WorkerPool pool{1};
+        context.loadFiles({{DataType::Conversation, compiled}}, pool);
+    }
+    // Mapped and used as it is, so nothing was built
+    EXPECT_NE(ConversationDb::NoScene, context.getConversations().findScene("intro"));
+    EXPECT_EQ(image.str().size(), context.getConversations().getMemoryUsage());
+    EXPECT_EQ(0u, countPhase(report, "conversation-db"));
+
+    // A second source is merged after it, as before
+    std::istringstream more{R"([{"id": "outro", "sequence": ["a"], "data": {"a": ["Bob: Bye."]}}])"};
+    context.loadConversations(more);
+    const ConversationDb& db = context.getConversations();
+    EXPECT_EQ(0u, db.findScene("intro"));
+    EXPECT_EQ(1u, db.findScene("outro"));
+    EXPECT_EQ(1u, countPhase(report, "conversation-db"));
+}
+
+TEST(GameContext, IndexesEquipmentOnceForARunOfLoads)
+{
+    StartupReport report{};
+    GameContext context{};
+    context.setStartupReport(&report);
+    for (std::uint32_t i = 0; i < 50; ++i) {
+        std::istringstream src{items(10 * i, 10)};
+        context.loadEquipment(src);
+    }
+    EXPECT_EQ(0u, countPhase(report, "equipment-index"));
+    EXPECT_EQ(500u, context.getEquipment().size());
+    EXPECT_EQ(491u, context.getEquipment().getId(491));
+    EXPECT_EQ(1u, countPhase(report, "equipment-index"));
+
+    // A clash, even within one stream, adds nothing and keeps the index
+    std::istringstream twice{R"([{"id": 2000, "name": "Twin"}, {"id": 2001, "name": "Twin"}])"};
+    EXPECT_THROW(context.loadEquipment(twice), std::invalid_argument);
+    std::istringstream late{R"([{"id": 2001, "name": "Twin"}, {"id": 499, "name": "Elder"}])"};
+    EXPECT_THROW(context.loadEquipment(late), std::invalid_argument);
+    EXPECT_EQ(500u, context.getEquipment().size());
+    EXPECT_EQ(1u, countPhase(report, "equipment-index"));
+
+    // The first item of the rejected stream was given back
+    std::istringstream retry{R"([{"id": 2001, "name": "Twin"}])"};
+    context.loadEquipment(retry);
+    EXPECT_EQ(501u, context.getEquipment().size());
+    EXPECT_EQ(2u, countPhase(report, "equipment-index"));
+}
@@ -0,0 +1,43 @@
+#include "GameWorld.h"
+#include "TestWorlds.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+#include <thread>
+
+
+TEST(HeadlessWorld, NeverOpensAWindow)
+{
+    TestWorld test{};
+    GameWorld& world = test.world;
+
+    EXPECT_TRUE(world.isHeadless());
+    world.render();
+}
+
+TEST(HeadlessWorld, RunsRequestedTicks)
+{
+    TestWorld test{};
+    GameWorld& world = test.world;
+    auto& counter = world.emplace<CountingComp>();
+
+    const auto report = world.runTicks(120, 0.5f);
+
+    EXPECT_EQ(120u, report.ticks);
+    EXPECT_EQ(120, counter.updates);
+    EXPECT_FLOAT_EQ(60.f, counter.elapsed);
+    EXPECT_GE(report.elapsed, report.worstTick);
+}
+
+TEST(HeadlessWorld, RunsPostedWorkEachTick)
+{
+    TestWorld test{};
+    GameWorld& world = test.world;
+    int ran{0};
+
+    std::thread producer{[&] { world.post([&](GameWorld&) { ++ran; }); }};
+    producer.join();
+    world.runTicks(1, 0.f);
+
+    EXPECT_EQ(1, ran);
+}
@@ -0,0 +1,137 @@
+#include "GameContext.h"
+#include "GameSettings.h"
+#include "GameWorld.h"
+#include "InputLog.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+
+sf::Event mouseMoved(int x, int y)
+{
+    sf::Event e{};
+    e.type = sf::Event::MouseMoved;
+    e.mouseMove.x = x, e.mouseMove.y = y;
+    return e;
+}
+
+sf::Event keyPressed(sf::Keyboard::Key code, bool shift)
+{
+    sf::Event e{};
+    e.type = sf::Event::KeyPressed;
+    e.key.code = code, e.key.shift = shift;
+    return e;
+}
+
+//! Walks towards wherever the mouse was last seen
+struct FollowComp : public Component {
+
+    sf::Vector2f target{};
+
+    void update(float dt) override
+    {
+        move((target - getPosition()) * dt);
+    }
+
+} /*struct FollowComp*/;
+
+} /*namespace*/;
+
+
+TEST(InputLog, RoundTripsFrames)
+{
+    std::stringstream log{};
+    InputRecorder recorder{log};
+    recorder.recordEvent(mouseMoved(-3, 700));
+    recorder.recordEvent(keyPressed(sf::Keyboard::Escape, true));
+    recorder.endFrame(0.016f);
+    recorder.endFrame(0.5f);
+
+    InputReplayer replayer{log};
+    float dt{0};
+    std::vector<sf::Event> events{};
+
+    ASSERT_TRUE(replayer.nextFrame(dt, events));
+    EXPECT_EQ(0.016f, dt);
+    ASSERT_EQ(2u, events.size());
+    EXPECT_EQ(sf::Event::MouseMoved, events[0].type);
+    EXPECT_EQ(-3, events[0].mouseMove.x);
+    EXPECT_EQ(700, events[0].mouseMove.y);
+    EXPECT_EQ(sf::Keyboard::Escape, events[1].key.code);
+    EXPECT_TRUE(events[1].key.shift);
+    EXPECT_FALSE(events[1].key.alt);
+
+    ASSERT_TRUE(replayer.nextFrame(dt, events));
+    EXPECT_EQ(0.5f, dt);
+    EXPECT_TRUE(events.empty());
+
+    EXPECT_FALSE(replayer.nextFrame(dt, events));
+}
+
+TEST(InputLog, RejectsForeignFiles)
+{
+    std::stringstream log{"definitely not a log"};
+
+    EXPECT_THROW(InputReplayer{log}, std::runtime_error);
+}
+
+TEST(InputLog, RejectsTruncatedFrames)
+{
+    std::stringstream full{};
+    InputRecorder recorder{full};
+    recorder.recordEvent(mouseMoved(1, 2));
+    recorder.endFrame(1.f);
+    std::string bytes = full.str();
+    std::stringstream truncated{bytes.substr(0, bytes.size() - 1)};
+
+    InputReplayer replayer{truncated};
+    float dt{0};
+    std::vector<sf::Event> events{};
+    EXPECT_THROW(replayer.nextFrame(dt, events), std::runtime_error);
+}
+
+TEST(InputLog, RejectsEventCountsTheFrameDoesNotHold)
+{
+    std::stringstream header{};
+    InputRecorder recorder{header};
+    // A zero dt, then a count of 2^60 - 1 events with none following
+    std::stringstream damaged{header.str() + std::string(4, '\0') + "\xff\xff\xff\xff\xff\xff\xff\xff\x0f"};
+
+    InputReplayer replayer{damaged};
+    float dt{0};
+    std::vector<sf::Event> events{};
+    EXPECT_THROW(replayer.nextFrame(dt, events), std::runtime_error);
+}
+
+TEST(InputLog, ReplaysDeterministically)
+{
+    std::stringstream log{};
+    InputRecorder recorder{log};
+    for (int i = 0; i < 50; ++i) {
+        recorder.recordEvent(mouseMoved(i * 7, 300 - i));
+        recorder.endFrame(1.f / 60.f);
+    }
+    const std::string bytes = log.str();
+
+    auto replayOnce = [&bytes] {
+        GameContext context{};
+        GameSettings settings{};
+        settings.setHeadless(true);
+        GameWorld world{context, settings};
+        auto& follower = world.emplace<FollowComp>();
+        world.subscribe(sf::Event::MouseMoved, [&](const sf::Event& e) {
+            follower.target = sf::Vector2f(float(e.mouseMove.x), float(e.mouseMove.y));
+        });
+        std::stringstream src{bytes}, report{};
+        InputReplayer replayer{src};
+        world.replay(replayer, false, report);
+        return world.stateHash();
+    };
+
+    EXPECT_EQ(replayOnce(), replayOnce());
+}
@@ -0,0 +1,111 @@
+#include "JsonReader.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+using Token = JsonReader::Token;
+
+//! A random value whose strings are full of brackets, quotes and backslashes
+void randomValue(std::mt19937& rng, int depth, std::string& out)
+{
+    static const char * pieces[] = {"x", "}", "]", "{", "[", "\\\"", "\\\\", "\\n", "\\u00e9", ",", " "};
+    switch (depth > 4 ? rng() % 3 : rng() % 5) {
+    case 0:
+        out += std::to_string(rng() % 100000);
+        break;
+    case 1:
+    case 2:
+        out += '"';
+        for (unsigned int i = rng() % 40; i > 0; --i) { out += pieces[rng() % 11]; }
+        out += '"';
+        break;
+    case 3:
+        out += "[";
+        for (unsigned int i = rng() % 6; i > 0; --i) { randomValue(rng, depth + 1, out), out += ", "; }
+        out += "]";
+        break;
+    default:
+        out += "{\n";
+        for (unsigned int i = rng() % 6; i > 0; --i) {
+            out += std::string(rng() % 20, ' ') + "\"k" + std::to_string(i) + "\": ";
+            randomValue(rng, depth + 1, out);
+            out += ",\n";
+        }
+        out += "}";
+    }
+}
+
+} /*namespace*/;
+
+
+TEST(JsonReader, SkipsOverBracketsInStrings)
+{
+    const std::string skipped = R"({"a": "}]", "b": ["\"]", "\\", {"c": "\\\"}"}], "d": [[], {}]})";
+    for (std::size_t pad = 0; pad < 70; ++pad) {
+        for (std::size_t bufferSize : {1, 5, 64, 4096}) {
+            std::istringstream src{"{" + std::string(pad, ' ') + "\"skip\": " + skipped + ", \"keep\": [12]}"};
+            JsonReader json{src, bufferSize};
+            ASSERT_EQ(Token::BeginObject, json.next());
+            ASSERT_EQ(Token::Key, json.next());
+            json.skipValue(json.next());
+            EXPECT_EQ(1u, json.getDepth());
+            ASSERT_EQ(Token::Key, json.next()) << pad << " " << bufferSize;
+            EXPECT_EQ("keep", json.getString());
+            json.skipValue(json.next());
+            EXPECT_EQ(Token::EndObject, json.next());
+            EXPECT_EQ(Token::End, json.next());
+        }
+    }
+}
+
+TEST(JsonReader, SkipsRandomValues)
+{
+    std::mt19937 rng{29};
+    for (int round = 0; round < 300; ++round) {
+        std::string value;
+        randomValue(rng, 0, value);
+        std::istringstream src{"[" + value + ", \"after\"]"};
+        JsonReader json{src, 1 + rng() % 200};
+
+        ASSERT_EQ(Token::BeginArray, json.next());
+        json.skipValue(json.next());
+        ASSERT_EQ(Token::String, json.next()) << value;
+        EXPECT_EQ("after", json.getString());
+        EXPECT_EQ(Token::EndArray, json.next());
+    }
+}
+
+TEST(JsonReader, ReadsLongStringsAndNumbersAcrossBuffers)
+{
+    std::string text;
+    for (int i = 0; i < 300; ++i) { text += (i % 37 == 0) ? "\\\"" : "abc"; }
+    std::string expected;
+    for (int i = 0; i < 300; ++i) { expected += (i % 37 == 0) ? "\"" : "abc"; }
+
+    for (std::size_t bufferSize : {3, 17, 1000}) {
+        std::istringstream src{"[\"" + text + "\"," + std::string(100, ' ') + "-12345.5e3,\n\t\t1234567890123]"};
+        JsonReader json{src, bufferSize};
+        ASSERT_EQ(Token::BeginArray, json.next());
+        ASSERT_EQ(Token::String, json.next());
+        EXPECT_EQ(expected, json.getString());
+        ASSERT_EQ(Token::Number, json.next());
+        EXPECT_EQ(-12345.5e3, json.getNumber());
+        ASSERT_EQ(Token::Number, json.next());
+        EXPECT_EQ(1234567890123u, json.getUnsigned());
+        EXPECT_EQ(Token::EndArray, json.next());
+    }
+}
+
+TEST(JsonReader, RejectsAnUnclosedSkippedValue)
+{
+    std::istringstream src{R"({"a": [1, "]", {"b": 2})"};
+    JsonReader json{src, 8};
+    ASSERT_EQ(Token::BeginObject, json.next());
+    ASSERT_EQ(Token::Key, json.next());
+    EXPECT_THROW(json.skipValue(json.next()), std::runtime_error);
+}
@@ -0,0 +1,116 @@
+#include "LayerCache.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace {
+
+//! Never dereferenced, only used as a key
+const CachedLayer * fakeLayer(std::uintptr_t id)
+{
+    return reinterpret_cast<const CachedLayer *>(id * 64);
+}
+
+const sf::Vector2u Side{16, 16};
+const std::size_t Bytes = 16 * 16 * 4;
+
+//! Stands in for `LayerCache::createTexture`, which needs a GL context
+struct FakeTextures {
+    std::vector<sf::Vector2u> sizes;
+
+    LayerCache::TextureFactory factory()
+    {
+        return [this](sf::Vector2u size) {
+            sizes.push_back(size);
+            return std::make_unique<sf::RenderTexture>();
+        };
+    }
+} /*struct FakeTextures*/;
+
+} /*namespace*/;
+
+
+TEST(LayerCache, EvictsTheLeastRecentlyUsedLayers)
+{
+    FakeTextures textures{};
+    LayerCache cache{3 * Bytes, textures.factory()};
+    const CachedLayer * a = fakeLayer(1), * b = fakeLayer(2), * c = fakeLayer(3), * d = fakeLayer(4), * e = fakeLayer(5);
+    cache.acquire(a, Side), cache.acquire(b, Side), cache.acquire(c, Side);
+
+    cache.beginFrame();
+    ASSERT_NE(nullptr, cache.find(a));
+    cache.beginFrame();
+    cache.acquire(d, Side);
+
+    // b is now the coldest, a having been seen after it
+    EXPECT_EQ(1u, cache.getStats().evictions);
+    EXPECT_EQ(3 * Bytes, cache.getStats().bytes);
+    EXPECT_EQ(nullptr, cache.find(b));
+    EXPECT_NE(nullptr, cache.find(a));
+    EXPECT_NE(nullptr, cache.find(c));
+    EXPECT_NE(nullptr, cache.find(d));
+
+    // A texture twice the size pushes out the two coldest
+    cache.beginFrame();
+    cache.find(c);
+    cache.acquire(e, {32, 16});
+    EXPECT_EQ(3u, cache.getStats().evictions);
+    EXPECT_EQ(3 * Bytes, cache.getStats().bytes);
+    EXPECT_EQ(nullptr, cache.find(a));
+    EXPECT_EQ(nullptr, cache.find(d));
+    EXPECT_NE(nullptr, cache.find(c));
+    EXPECT_NE(nullptr, cache.find(e));
+}
+
+TEST(LayerCache, OverrunsTheBudgetRatherThanEvictThisFramesLayers)
+{
+    FakeTextures textures{};
+    LayerCache cache{2 * Bytes, textures.factory()};
+    const CachedLayer * a = fakeLayer(1), * b = fakeLayer(2), * c = fakeLayer(3);
+    cache.acquire(a, Side), cache.acquire(b, Side), cache.acquire(c, Side);
+
+    EXPECT_EQ(0u, cache.getStats().evictions);
+    EXPECT_EQ(3 * Bytes, cache.getStats().bytes);
+
+    // Next frame, only c is seen; the others go as soon as room is wanted
+    cache.beginFrame();
+    cache.find(c);
+    cache.setBudget(Bytes);
+    EXPECT_EQ(2u, cache.getStats().evictions);
+    EXPECT_EQ(Bytes, cache.getStats().bytes);
+    EXPECT_EQ(nullptr, cache.find(a));
+    EXPECT_EQ(nullptr, cache.find(b));
+    EXPECT_NE(nullptr, cache.find(c));
+}
+
+TEST(LayerCache, ReleasingALayerReturnsItsBytes)
+{
+    FakeTextures textures{};
+    LayerCache cache{4 * Bytes, textures.factory()};
+    cache.acquire(fakeLayer(1), Side);
+    cache.acquire(fakeLayer(1), {32, 32});
+    EXPECT_EQ(4 * Bytes, cache.getStats().bytes);
+
+    cache.release(fakeLayer(1));
+    cache.release(fakeLayer(1));
+    EXPECT_EQ(0u, cache.getStats().bytes);
+    EXPECT_EQ(0u, cache.getStats().evictions);
+
+    // Each acquire asked for a texture of its own size
+    ASSERT_EQ(2u, textures.sizes.size());
+    EXPECT_EQ(Side, textures.sizes[0]);
+    EXPECT_EQ(sf::Vector2u(32, 32), textures.sizes[1]);
+}
+
+TEST(LayerCache, FindsTheTextureItAcquired)
+{
+    FakeTextures textures{};
+    LayerCache cache{4 * Bytes, textures.factory()};
+    sf::RenderTexture& texture = cache.acquire(fakeLayer(1), Side);
+
+    EXPECT_EQ(&texture, cache.find(fakeLayer(1)));
+    EXPECT_EQ(nullptr, cache.find(fakeLayer(2)));
+    EXPECT_EQ(1u, cache.getStats().hits);
+}
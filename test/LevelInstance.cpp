@@ -0,0 +1,109 @@
+#include "LevelAtlas.h"
+#include "LevelInstance.h"
+#include "LevelMap.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+LevelMap makeDungeon(unsigned int side)
+{
+    LevelMap map{};
+    map.name = "dungeon";
+    map.size = {side, side};
+    map.tileSize = {16, 16};
+    std::vector<std::uint32_t> floor(side * side);
+    std::iota(floor.begin(), floor.end(), 1u);
+    map.layers.emplace_back("floor", map.size, std::move(floor));
+    map.layers.emplace_back("walls", map.size, std::vector<std::uint32_t>(side * side, 0u));
+    LevelObject chest{};
+    chest.id = 7, chest.name = "chest", chest.bounds = {32, 48, 16, 16};
+    map.objects.push_back(chest);
+    return map;
+}
+
+} /*namespace*/;
+
+
+TEST(LevelInstance, EditsStayLocalToTheirInstance)
+{
+    LevelAtlas atlas{};
+    atlas.add(makeDungeon(8));
+    LevelInstance a = atlas.instantiate("dungeon");
+    LevelInstance b = atlas.instantiate("dungeon");
+
+    a.setTile(1, 2, 3, 99);
+
+    EXPECT_EQ(99u, a.getTile(1, 2, 3));
+    EXPECT_EQ(0u, b.getTile(1, 2, 3));
+    EXPECT_EQ(&a.getBase(), &b.getBase());
+    EXPECT_EQ(8u * 3 + 2 + 1, a.getTile(0, 2, 3));
+}
+
+TEST(LevelInstance, RestoringATileReleasesItsEdit)
+{
+    LevelAtlas atlas{};
+    atlas.add(makeDungeon(8));
+    LevelInstance level = atlas.instantiate("dungeon");
+
+    level.setTile(0, 1, 1, 500);
+    EXPECT_EQ(1u, level.getEditCount());
+    level.setTile(0, 1, 1, 10);
+
+    EXPECT_EQ(0u, level.getEditCount());
+}
+
+TEST(LevelInstance, RejectsTilesOutsideTheMap)
+{
+    LevelAtlas atlas{};
+    atlas.add(makeDungeon(8));
+    LevelInstance level = atlas.instantiate("dungeon");
+
+    EXPECT_THROW(level.getTile(2, 0, 0), std::out_of_range);
+    EXPECT_THROW(level.getTile(0, 8, 0), std::out_of_range);
+    EXPECT_THROW(level.getTile(0, 0, 8), std::out_of_range);
+    EXPECT_THROW(level.setTile(2, 0, 0, 1), std::out_of_range);
+    // Would alias (0, 1) if the row were not checked
+    EXPECT_THROW(level.setTile(0, 8, 0, 99), std::out_of_range);
+    EXPECT_EQ(0u, level.getEditCount());
+    EXPECT_EQ(8u * 7 + 7 + 1, level.getTile(0, 7, 7));
+}
+
+TEST(LevelInstance, MemoryScalesWithEditsNotMapSize)
+{
+    LevelAtlas atlas{};
+    const auto base = atlas.add(makeDungeon(1024));
+    LevelInstance level{base};
+    for (unsigned int i = 0; i < 16; ++i) { level.setTile(1, i, i, 3); }
+
+    EXPECT_GT(base->getMemoryUsage(), 8u * 1024 * 1024);
+    EXPECT_LT(level.getMemoryUsage(), 4096u);
+}
+
+TEST(LevelInstance, OverlaysObjects)
+{
+    LevelAtlas atlas{};
+    atlas.add(makeDungeon(8));
+    LevelInstance level = atlas.instantiate("dungeon");
+
+    LevelObject door{};
+    door.id = 8, door.name = "door";
+    level.setObject(door);
+    level.removeObject(7);
+
+    std::vector<std::uint32_t> live{};
+    level.forEachObject([&](const LevelObject& obj) { live.push_back(obj.id); });
+    EXPECT_EQ(std::vector<std::uint32_t>{8}, live);
+    EXPECT_EQ(nullptr, level.findObject(7));
+    EXPECT_NE(nullptr, atlas.find("dungeon")->findObject(7));
+}
+
+TEST(LevelAtlas, RejectsUnknownLevels)
+{
+    LevelAtlas atlas{};
+
+    EXPECT_THROW(atlas.instantiate("nowhere"), std::out_of_range);
+}
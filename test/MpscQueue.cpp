@@ -0,0 +1,81 @@
+#include "InlineFunction.h"
+#include "MpscQueue.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+TEST(InlineFunction, InvokesStoredCallable)
+{
+    int actual{0};
+    InlineFunction<void(int)> f{[&](int n) { actual += n; }};
+    f(2), f(3);
+
+    EXPECT_EQ(5, actual);
+}
+
+TEST(InlineFunction, MoveTransfersOwnership)
+{
+    auto counter = std::make_shared<int>(0);
+    InlineFunction<int()> src{[counter] { return ++*counter; }};
+    InlineFunction<int()> dst{std::move(src)};
+
+    EXPECT_FALSE(src);
+    EXPECT_EQ(1, dst());
+    EXPECT_EQ(2, counter.use_count());
+    dst.reset();
+    EXPECT_EQ(1, counter.use_count());
+}
+
+TEST(MpscQueue, RoundsCapacityToPowerOfTwo)
+{
+    MpscQueue<int> queue{100};
+
+    EXPECT_EQ(128u, queue.capacity());
+}
+
+TEST(MpscQueue, RejectsPushWhenFull)
+{
+    MpscQueue<int> queue{4};
+    for (int i = 0; i < 4; ++i) { EXPECT_TRUE(queue.tryPush(int{i})); }
+
+    EXPECT_FALSE(queue.tryPush(4));
+
+    int out{-1};
+    EXPECT_TRUE(queue.tryPop(out));
+    EXPECT_EQ(0, out);
+    EXPECT_TRUE(queue.tryPush(4));
+}
+
+TEST(MpscQueue, PreservesPerProducerOrder)
+{
+    constexpr int Producers{4}, PerProducer{5000};
+    MpscQueue<int> queue{64};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < Producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < PerProducer; ++i) {
+                while (!queue.tryPush(p * PerProducer + i)) { std::this_thread::yield(); }
+            }
+        });
+    }
+
+    std::vector<int> last(Producers, -1);
+    int received{0}, item{0};
+    while (received < Producers * PerProducer) {
+        if (queue.tryPop(item)) {
+            const int p = item / PerProducer;
+            EXPECT_LT(last[p], item % PerProducer);
+            last[p] = item % PerProducer;
+            ++received;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& t : threads) { t.join(); }
+
+    EXPECT_FALSE(queue.tryPop(item));
+}
@@ -0,0 +1,90 @@
+#include "CommandList.h"
+#include "ParticleSystem.h"
+#include "WorkerPool.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+ParticleSystem::Emitter still(float life)
+{
+    ParticleSystem::Emitter emitter{};
+    emitter.position = {10.f, 20.f};
+    emitter.minLife = emitter.maxLife = life;
+    return emitter;
+}
+
+} /*namespace*/;
+
+
+TEST(ParticleSystem, EmitsUpToCapacity)
+{
+    ParticleSystem particles{100};
+    EXPECT_EQ(particles.emit(still(1.f), 60), 60u);
+    EXPECT_EQ(particles.emit(still(1.f), 60), 40u);
+    EXPECT_EQ(particles.size(), 100u);
+}
+
+TEST(ParticleSystem, IntegratesVelocityAndGravity)
+{
+    ParticleSystem particles{37};
+    ParticleSystem::Emitter emitter{still(10.f)};
+    emitter.velocity = {4.f, 0.f};
+    emitter.size = 2.f;
+    particles.setGravity({0.f, 10.f});
+    particles.emit(emitter, 37);
+    particles.update(0.5f);
+
+    // Every lane, SIMD body and scalar tail alike, lands in the same place
+    CommandList list{};
+    particles.record(list, {});
+    ASSERT_EQ(list.size(), 1u);
+    list.forEach([](std::uint64_t, const RenderCommand& cmd) {
+        ASSERT_EQ(cmd.count, 37u * 6u);
+        EXPECT_EQ(cmd.primitive, sf::Triangles);
+        for (std::uint32_t q = 0; q < 37; ++q) {
+            const sf::Vertex& topLeft = cmd.vertices[q * 6];
+            EXPECT_FLOAT_EQ(topLeft.position.x, 10.f + 2.f - 1.f);
+            EXPECT_FLOAT_EQ(topLeft.position.y, 20.f + 2.5f - 1.f);
+        }
+    });
+}
+
+TEST(ParticleSystem, DropsExpiredParticles)
+{
+    ParticleSystem particles{64};
+    particles.emit(still(0.25f), 20);
+    particles.emit(still(1.f), 30);
+    particles.update(0.5f);
+    EXPECT_EQ(particles.size(), 30u);
+    particles.update(0.6f);
+    EXPECT_EQ(particles.size(), 0u);
+
+    CommandList list{};
+    particles.record(list, {});
+    EXPECT_EQ(list.size(), 0u);
+}
+
+TEST(ParticleSystem, SplitsAcrossAPool)
+{
+    WorkerPool pool{2};
+    ParticleSystem serial{100000}, parallel{100000};
+    ParticleSystem::Emitter emitter{still(2.f)};
+    emitter.spread = {5.f, 5.f};
+    serial.emit(emitter, 100000);
+    parallel.emit(emitter, 100000);
+    serial.update(0.1f);
+    parallel.update(0.1f, pool);
+    EXPECT_EQ(parallel.size(), serial.size());
+
+    CommandList a{}, b{};
+    serial.record(a, {});
+    parallel.record(b, {});
+    const sf::Vertex * va{nullptr};
+    const sf::Vertex * vb{nullptr};
+    a.forEach([&](std::uint64_t, const RenderCommand& cmd) { va = cmd.vertices; });
+    b.forEach([&](std::uint64_t, const RenderCommand& cmd) { vb = cmd.vertices; });
+    for (std::size_t i = 0; i < 100000 * 6; i += 9973) {
+        EXPECT_EQ(va[i].position, vb[i].position);
+    }
+}
@@ -0,0 +1,130 @@
+#include "CommandList.h"
+#include "QuadTransform.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+struct Scene {
+    std::vector<sf::Transform> transforms;
+    std::vector<LocalQuad> quads;
+};
+
+//! An odd count, so that SIMD loops leave a scalar tail
+Scene makeScene(std::size_t count)
+{
+    Scene scene{};
+    for (std::size_t i = 0; i < count; ++i) {
+        sf::Transformable t{};
+        t.setPosition(i * 3.5f, 100.f - i);
+        t.setRotation(i * 17.f);
+        t.setScale(1.f + i * 0.1f, 0.5f);
+        t.setOrigin(4.f, 2.f);
+        scene.transforms.push_back(t.getTransform());
+        const float f = static_cast<float>(i);
+        scene.quads.push_back(LocalQuad{{f, -f, 8.f + f, 6.f}, {f * 2.f, 0.f, -16.f, 12.f}, sf::Color(static_cast<sf::Uint8>(i * 20), 1, 2, 255)});
+    }
+    return scene;
+}
+
+void expectVertex(const sf::Vertex& actual, const sf::Transform& t, float x, float y, sf::Color color, sf::Vector2f uv)
+{
+    const sf::Vector2f expected = t.transformPoint(x, y);
+    EXPECT_FLOAT_EQ(actual.position.x, expected.x);
+    EXPECT_FLOAT_EQ(actual.position.y, expected.y);
+    EXPECT_EQ(actual.color, color);
+    EXPECT_EQ(actual.texCoords, uv);
+}
+
+} /*namespace*/;
+
+
+TEST(QuadTransform, QuadsMatchTransformPoint)
+{
+    const Scene scene = makeScene(7);
+    std::vector<sf::Vertex> out(4 * 7);
+    transformQuads(scene.transforms.data(), scene.quads.data(), 7, out.data());
+
+    for (std::size_t i = 0; i < 7; ++i) {
+        const auto& r = scene.quads[i].rect;
+        const auto& tex = scene.quads[i].texRect;
+        const sf::Color c = scene.quads[i].color;
+        const sf::Vertex * v = &out[4 * i];
+        expectVertex(v[0], scene.transforms[i], r.left, r.top, c, {tex.left, tex.top});
+        expectVertex(v[1], scene.transforms[i], r.left + r.width, r.top, c, {tex.left + tex.width, tex.top});
+        expectVertex(v[2], scene.transforms[i], r.left + r.width, r.top + r.height, c, {tex.left + tex.width, tex.top + tex.height});
+        expectVertex(v[3], scene.transforms[i], r.left, r.top + r.height, c, {tex.left, tex.top + tex.height});
+    }
+}
+
+TEST(QuadTransform, TrianglesRepeatTheSharedCorners)
+{
+    const Scene scene = makeScene(5);
+    std::vector<sf::Vertex> quads(4 * 5), triangles(6 * 5);
+    transformQuads(scene.transforms.data(), scene.quads.data(), 5, quads.data());
+    transformQuads(scene.transforms.data(), scene.quads.data(), 5, triangles.data(), QuadLayout::Triangles);
+
+    const int corner[6] = {0, 1, 2, 0, 2, 3};
+    for (std::size_t i = 0; i < 5; ++i) {
+        for (int k = 0; k < 6; ++k) {
+            const sf::Vertex& a = triangles[6 * i + k];
+            const sf::Vertex& b = quads[4 * i + corner[k]];
+            EXPECT_EQ(a.position, b.position);
+            EXPECT_EQ(a.color, b.color);
+            EXPECT_EQ(a.texCoords, b.texCoords);
+        }
+    }
+}
+
+TEST(QuadTransform, SortedSpritesMatchTransformPoint)
+{
+    sf::Texture texture{};
+    CommandList list{};
+    std::vector<sf::Sprite> sprites;
+    std::vector<sf::Transform> placed;
+    // An odd count, so that SIMD loops leave a scalar tail
+    for (int i = 0; i < 7; ++i) {
+        sprites.emplace_back(texture, sf::IntRect{i, 0, 8 + i, 6});
+        sprites.back().setPosition(i * 3.5f, 100.f - i);
+        sprites.back().setRotation(i * 17.f);
+        sprites.back().setScale(1.f + i * 0.1f, 0.5f);
+    }
+    for (int i = 0; i < 7; ++i) {
+        sf::RenderStates states{};
+        states.transform.translate(-2.f, 5.f).scale(2.f, 2.f);
+        list.sprite(0, static_cast<float>(i), sprites[i], states);
+        placed.push_back(states.transform * sprites[i].getTransform());
+    }
+    EXPECT_THROW(list.forEach([](std::uint64_t, const RenderCommand&) { }), std::logic_error);
+    list.sort();
+
+    std::size_t i{0};
+    list.forEach([&](std::uint64_t, const RenderCommand& cmd) {
+        const float w = 8.f + i, h = 6.f;
+        const float u = static_cast<float>(i);
+        const sf::Color c = sf::Color::White;
+        expectVertex(cmd.vertices[0], placed[i], 0.f, 0.f, c, {u, 0.f});
+        expectVertex(cmd.vertices[1], placed[i], w, 0.f, c, {u + w, 0.f});
+        expectVertex(cmd.vertices[2], placed[i], w, h, c, {u + w, h});
+        expectVertex(cmd.vertices[3], placed[i], 0.f, h, c, {u, h});
+        ++i;
+    });
+    EXPECT_EQ(i, 7u);
+}
+
+TEST(QuadTransform, MergedSpritesAreExpandedByTheBorrowersSort)
+{
+    sf::Texture texture{};
+    const sf::Sprite sprite{texture, sf::IntRect{0, 0, 4, 4}};
+    CommandList worker{}, frame{};
+    worker.sprite(0, 0.f, sprite, {});
+    frame.merge(worker);
+    frame.sort();
+
+    frame.forEach([&](std::uint64_t, const RenderCommand& cmd) {
+        expectVertex(cmd.vertices[2], sf::Transform::Identity, 4.f, 4.f, sf::Color::White, {4.f, 4.f});
+    });
+}
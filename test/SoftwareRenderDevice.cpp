@@ -0,0 +1,108 @@
+#include "GameContext.h"
+#include "GameSettings.h"
+#include "GameWorld.h"
+#include "SoftwareRenderDevice.h"
+#include "SpriteComp.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+
+namespace {
+
+void rect(SoftwareRenderDevice& device, float x, float y, float w, float h, sf::Color color, const sf::RenderStates& states = {})
+{
+    const sf::Vertex quad[4] = {
+        {{x, y}, color}, {{x + w, y}, color}, {{x + w, y + h}, color}, {{x, y + h}, color}
+    };
+    device.draw(quad, 4, sf::Quads, states);
+}
+
+} /*namespace*/;
+
+TEST(SoftwareRenderDevice, FillsQuadsInPixelSpace)
+{
+    SoftwareRenderDevice device{{16, 16}};
+    rect(device, 4.f, 4.f, 8.f, 8.f, sf::Color::Red);
+
+    EXPECT_EQ(device.getPixel(4, 4), sf::Color::Red);
+    EXPECT_EQ(device.getPixel(11, 11), sf::Color::Red);
+    EXPECT_EQ(device.getPixel(3, 4), sf::Color::Black);
+    EXPECT_EQ(device.getPixel(12, 11), sf::Color::Black);
+    EXPECT_EQ(device.getStats().triangles, 2u);
+    EXPECT_EQ(device.getStats().pixels, 64u);
+}
+
+TEST(SoftwareRenderDevice, SharedEdgesAreBlendedOnce)
+{
+    SoftwareRenderDevice device{{16, 16}};
+    rect(device, 0.f, 0.f, 16.f, 16.f, sf::Color{255, 255, 255, 128});
+    rect(device, 0.f, 0.f, 8.f, 16.f, sf::Color{255, 255, 255, 128});
+    rect(device, 8.f, 0.f, 8.f, 16.f, sf::Color{255, 255, 255, 128});
+
+    // Every pixel is covered by exactly two translucent layers
+    const sf::Color expected = device.getPixel(0, 0);
+    for (unsigned int y = 0; y < 16; ++y) {
+        for (unsigned int x = 0; x < 16; ++x) {
+            ASSERT_EQ(device.getPixel(x, y), expected) << x << "," << y;
+        }
+    }
+    EXPECT_EQ(device.getStats().pixels, 2u * 256u);
+}
+
+TEST(SoftwareRenderDevice, SamplesTextureImages)
+{
+    sf::Texture texture{};
+    sf::Image image{};
+    image.create(2, 1, sf::Color::Green);
+    image.setPixel(1, 0, sf::Color::Blue);
+
+    SoftwareRenderDevice device{{4, 2}};
+    device.setTextureImage(texture, image);
+    const sf::Vertex quad[4] = {
+        {{0.f, 0.f}, sf::Color::White, {0.f, 0.f}}, {{4.f, 0.f}, sf::Color::White, {2.f, 0.f}}
+      , {{4.f, 2.f}, sf::Color::White, {2.f, 1.f}}, {{0.f, 2.f}, sf::Color::White, {0.f, 1.f}}
+    };
+    sf::RenderStates states{};
+    states.texture = &texture;
+    device.draw(quad, 4, sf::Quads, states);
+
+    EXPECT_EQ(device.getPixel(0, 0), sf::Color::Green);
+    EXPECT_EQ(device.getPixel(1, 1), sf::Color::Green);
+    EXPECT_EQ(device.getPixel(2, 0), sf::Color::Blue);
+    EXPECT_EQ(device.getPixel(3, 1), sf::Color::Blue);
+}
+
+TEST(SoftwareRenderDevice, ChecksumTracksContent)
+{
+    SoftwareRenderDevice a{{32, 32}}, b{{32, 32}};
+    rect(a, 3.f, 5.f, 10.f, 7.f, sf::Color::Cyan);
+    rect(b, 3.f, 5.f, 10.f, 7.f, sf::Color::Cyan);
+    EXPECT_EQ(a.checksum(), b.checksum());
+
+    rect(b, 20.f, 20.f, 1.f, 1.f, sf::Color::Cyan);
+    EXPECT_NE(a.checksum(), b.checksum());
+}
+
+TEST(SoftwareRenderDevice, RendersWorldHeadless)
+{
+    GameContext context{};
+    GameSettings settings{};
+    settings.setHeadless(true);
+    GameWorld world{context, settings};
+
+    sf::Texture texture{};
+    for (int i = 0; i < 10; ++i) {
+        world.emplace<SpriteComp>(texture, sf::IntRect{0, 0, 10, 10}).setPosition(i * 100.f, 0.f);
+    }
+    world.update(0.f);
+
+    SoftwareRenderDevice device{{200, 100}};
+    world.render(device);
+
+    EXPECT_EQ(world.getCullStats().visible, 2u);
+    EXPECT_EQ(world.getCullStats().culled, 8u);
+    EXPECT_EQ(device.getStats().draws, 1u);
+    EXPECT_EQ(device.getPixel(5, 5), sf::Color::White);
+    EXPECT_EQ(device.getPixel(105, 5), sf::Color::White);
+    EXPECT_EQ(device.getPixel(50, 5), sf::Color::Black);
+}
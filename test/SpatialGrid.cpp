@@ -0,0 +1,115 @@
+#include "Component.h"
+#include "GameContext.h"
+#include "GameSettings.h"
+#include "GameWorld.h"
+#include "SpatialGrid.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+namespace {
+
+//! A 10x10 box which walks right by `speed` per update
+struct BoxComp : public Component {
+
+    float speed{0};
+
+    std::optional<sf::FloatRect> getLocalBounds() const override
+    {
+        return sf::FloatRect{0.f, 0.f, 10.f, 10.f};
+    }
+
+    void update(float dt) override
+    {
+        move(speed * dt, 0.f);
+    }
+
+} /*struct BoxComp*/;
+
+std::vector<SpatialGrid::Id> bruteForce(const std::vector<sf::FloatRect>& rects, const sf::FloatRect& area)
+{
+    std::vector<SpatialGrid::Id> hits;
+    for (std::size_t i = 0; i < rects.size(); ++i) {
+        if (rects[i].intersects(area)) { hits.push_back(static_cast<SpatialGrid::Id>(i)); }
+    }
+    return hits;
+}
+
+} /*namespace*/;
+
+
+TEST(SpatialGrid, MatchesABruteForceScan)
+{
+    SpatialGrid grid{64.f};
+    std::vector<sf::FloatRect> rects;
+    for (int i = 0; i < 500; ++i) {
+        rects.emplace_back((i * 37) % 2000 - 1000.f, (i * 91) % 2000 - 1000.f, 5.f + i % 200, 5.f + i % 70);
+        grid.update(static_cast<SpatialGrid::Id>(i), rects.back());
+    }
+    for (const sf::FloatRect area : {sf::FloatRect{0, 0, 800, 600}, sf::FloatRect{-1000, -1000, 50, 50}, sf::FloatRect{-5000, -5000, 10000, 10000}}) {
+        std::vector<SpatialGrid::Id> hits;
+        grid.query(area, hits);
+        EXPECT_EQ(hits, bruteForce(rects, area));
+    }
+}
+
+TEST(SpatialGrid, FollowsMovesAndRemovals)
+{
+    SpatialGrid grid{100.f};
+    grid.update(3, {10, 10, 20, 20});
+    std::vector<SpatialGrid::Id> hits;
+    grid.query({0, 0, 50, 50}, hits);
+    EXPECT_THAT(hits, ::testing::ElementsAre(3u));
+
+    grid.update(3, {510, 10, 20, 20});
+    hits.clear();
+    grid.query({0, 0, 50, 50}, hits);
+    EXPECT_TRUE(hits.empty());
+    grid.query({500, 0, 50, 50}, hits);
+    EXPECT_THAT(hits, ::testing::ElementsAre(3u));
+
+    grid.remove(3);
+    hits.clear();
+    grid.query({500, 0, 50, 50}, hits);
+    EXPECT_TRUE(hits.empty());
+    EXPECT_EQ(grid.size(), 0u);
+}
+
+TEST(SpatialGrid, ViewBoundsMatchAnUnrotatedView)
+{
+    sf::View view{sf::FloatRect{0.f, 0.f, 800.f, 600.f}};
+    EXPECT_EQ(viewBounds(view), sf::FloatRect(0.f, 0.f, 800.f, 600.f));
+}
+
+TEST(SpatialGrid, WorldCullsComponentsOutOfView)
+{
+    GameContext context{};
+    GameSettings settings{};
+    settings.setHeadless(true);
+    GameWorld world{context, settings};
+
+    for (int i = 0; i < 100; ++i) {
+        world.emplace<BoxComp>().setPosition(i * 100.f, 0.f);
+    }
+    world.emplace<Component>();
+    world.update(0.f);
+
+    std::vector<std::uint32_t> visible;
+    world.queryVisible({0.f, 0.f, 800.f, 600.f}, visible);
+    EXPECT_EQ(visible.size(), 8u + 1u);
+    EXPECT_EQ(visible.back(), 100u);
+
+    // Bounds follow transforms changed during update
+    auto& walker = world.emplace<BoxComp>();
+    walker.setPosition(-500.f, 0.f);
+    walker.speed = 1000.f;
+    world.update(0.f);
+    visible.clear();
+    world.queryVisible({0.f, 0.f, 800.f, 600.f}, visible);
+    EXPECT_EQ(visible.size(), 9u);
+    world.update(1.f);
+    visible.clear();
+    world.queryVisible({0.f, 0.f, 800.f, 600.f}, visible);
+    EXPECT_EQ(visible.size(), 10u);
+}
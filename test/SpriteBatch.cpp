@@ -0,0 +1,120 @@
+#include "RenderDevice.h"
+#include "SpriteBatch.h"
+#include "SpriteComp.h"
+#include "TestWorlds.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace {
+
+//! Remembers the texture, blend mode and size of every draw it is handed
+class DrawLog : public RenderDevice {
+
+public:
+
+    struct Draw {
+        const sf::Texture * texture;
+        sf::BlendMode blend;
+        std::size_t count;
+    } /*struct Draw*/;
+
+    std::vector<Draw> draws;
+
+    void draw(const sf::Vertex *, std::size_t count, sf::PrimitiveType, const sf::RenderStates& states) override
+    {
+        draws.push_back({states.texture, states.blendMode, count});
+    }
+
+    bool draw(const sf::Drawable&, const sf::RenderStates&) override
+    {
+        return false;
+    }
+
+    const sf::View& getView() const override
+    {
+        return m_view;
+    }
+
+    sf::Vector2u getSize() const override
+    {
+        return {64, 64};
+    }
+
+private:
+
+    sf::View  m_view{sf::FloatRect{0.f, 0.f, 64.f, 64.f}};
+
+} /*class DrawLog*/;
+
+} /*namespace*/;
+
+
+TEST(SpriteBatch, DrawsOncePerTextureAndBlendMode)
+{
+    sf::Texture grass{}, stone{};
+    const sf::Sprite sprites[] = {sf::Sprite{grass}, sf::Sprite{stone}, sf::Sprite{grass}, sf::Sprite{stone}, sf::Sprite{grass}};
+    SpriteBatch batch{};
+    for (const auto& sprite : sprites) { batch.add(sprite, {}); }
+    batch.add(sprites[0], sf::RenderStates{sf::BlendAdd});
+
+    DrawLog log{};
+    batch.flush(log);
+    ASSERT_EQ(3u, log.draws.size());
+    // In order of each pair's first quad, whatever order the quads came in
+    EXPECT_EQ(&grass, log.draws[0].texture);
+    EXPECT_EQ(3u * 6u, log.draws[0].count);
+    EXPECT_EQ(&stone, log.draws[1].texture);
+    EXPECT_EQ(2u * 6u, log.draws[1].count);
+    EXPECT_EQ(&grass, log.draws[2].texture);
+    EXPECT_EQ(sf::BlendAdd, log.draws[2].blend);
+    EXPECT_EQ(6u, log.draws[2].count);
+
+    EXPECT_EQ(3u, batch.getStats().drawCalls);
+    EXPECT_EQ(6u, batch.getStats().quads);
+    EXPECT_EQ(36u, batch.getStats().vertices);
+}
+
+TEST(SpriteBatch, FlushEmptiesTheBatchesButKeepsCounting)
+{
+    sf::Texture texture{};
+    SpriteBatch batch{};
+    DrawLog log{};
+    batch.add(sf::Sprite{texture}, {});
+    batch.flush(log);
+    batch.flush(log);
+    EXPECT_EQ(1u, log.draws.size());
+
+    batch.add(sf::Sprite{texture}, {});
+    batch.flush(log);
+    EXPECT_EQ(2u, log.draws.size());
+    EXPECT_EQ(2u, batch.getStats().drawCalls);
+
+    batch.resetStats();
+    EXPECT_EQ(0u, batch.getStats().drawCalls);
+    EXPECT_EQ(0u, batch.getStats().quads);
+}
+
+TEST(SpriteBatch, WorldDrawsSpritesSharingATextureInOneCall)
+{
+    sf::Texture grass{}, stone{};
+    TestWorld test{};
+    for (int i = 0; i < 20; ++i) {
+        test.world.emplace<SpriteComp>(grass, sf::IntRect{0, 0, 4, 4}).setPosition(i * 2.f, 0.f);
+        auto& wall = test.world.emplace<SpriteComp>(stone, sf::IntRect{0, 0, 4, 4});
+        wall.setPosition(i * 2.f, 8.f);
+        wall.setLayer(1);
+    }
+    test.world.update(0.f);
+
+    DrawLog log{};
+    test.world.render(log);
+    ASSERT_EQ(2u, log.draws.size());
+    EXPECT_EQ(&grass, log.draws[0].texture);
+    EXPECT_EQ(&stone, log.draws[1].texture);
+    EXPECT_EQ(2u, test.world.getRenderStats().drawCalls);
+    EXPECT_EQ(40u, test.world.getRenderStats().quads);
+    EXPECT_EQ(240u, test.world.getRenderStats().vertices);
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+//! The bundled assets/ directory, as the test build names it
+#ifndef TEST_ASSETS
+#define TEST_ASSETS "assets"
+#endif
+
+
+//! A path in the temp directory no other test run will share
+inline std::string tempPath(const std::string& leaf)
+{
+    return std::string{P_tmpdir} + "/mint-" + std::to_string(::getpid()) + "-" + leaf;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "Component.h"
+#include "GameContext.h"
+#include "GameSettings.h"
+#include "GameWorld.h"
+
+
+//! Counts its updates and the time they covered
+struct CountingComp : public Component {
+
+    int updates{0};
+    float elapsed{0};
+
+    void update(float dt) override
+    {
+        ++updates, elapsed += dt;
+    }
+
+} /*struct CountingComp*/;
+
+
+inline GameSettings headlessSettings()
+{
+    GameSettings settings{};
+    settings.setHeadless(true);
+    return settings;
+}
+
+
+//! A headless world with a context and settings of its own
+struct TestWorld {
+
+    GameContext context{};
+    GameSettings settings{headlessSettings()};
+    GameWorld world{context, settings};
+
+} /*struct TestWorld*/;
@@ -0,0 +1,165 @@
+#include "TestFiles.h"
+#include "TextLayout.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <string>
+
+namespace {
+
+const unsigned int Size = 16;
+
+//! A face with real glyph metrics; an empty sf::Font measures every glyph as 0
+bool loadFont(sf::Font& font)
+{
+    return font.loadFromFile(TEST_ASSETS "/fonts/SourceCodePro-Regular.ttf");
+}
+
+//! Expectations below are derived from the font's own metrics
+float advance(const sf::Font& font, char32_t c)
+{
+    return font.getGlyph(c, Size, false).advance;
+}
+
+//! What the cache charges for `text` laid out without wrapping
+std::size_t chargeFor(const std::string& text, const sf::Font& font)
+{
+    return layoutText(text, font, Size, 0.f).getMemoryUsage() + text.size();
+}
+
+} /*namespace*/;
+
+
+TEST(TextLayout, WrapsAtSpacesKeepingWordsWhole)
+{
+    sf::Font font{};
+    ASSERT_TRUE(loadFont(font));
+    const float a = advance(font, U'a'), space = advance(font, U' ');
+    const GlyphRun run = layoutText("aaa aaa aaa", font, Size, 7 * a + space);
+
+    EXPECT_EQ(2u, run.lines);
+    ASSERT_EQ(9u * 6u, run.vertices.size());
+    // The third word starts the second line rather than splitting
+    EXPECT_FLOAT_EQ(run.vertices[0].position.x, run.vertices[6 * 6].position.x);
+    EXPECT_FLOAT_EQ(run.vertices[0].position.y + font.getLineSpacing(Size), run.vertices[6 * 6].position.y);
+}
+
+TEST(TextLayout, BreaksWordsWiderThanALine)
+{
+    sf::Font font{};
+    ASSERT_TRUE(loadFont(font));
+    const GlyphRun run = layoutText("aaaaaa", font, Size, 4 * advance(font, U'a'));
+
+    EXPECT_EQ(2u, run.lines);
+    EXPECT_FLOAT_EQ(run.vertices[0].position.x, run.vertices[4 * 6].position.x);
+}
+
+TEST(TextLayout, ZeroWidthNeverWrapsButNewlinesBreak)
+{
+    sf::Font font{};
+    ASSERT_TRUE(loadFont(font));
+    EXPECT_EQ(1u, layoutText(std::string(200, 'a'), font, Size, 0.f).lines);
+    EXPECT_EQ(2u, layoutText("a\nb", font, Size, 0.f).lines);
+    EXPECT_EQ(0u, layoutText("", font, Size, 0.f).lines);
+}
+
+TEST(TextLayout, RevealCountsSkipWhitespace)
+{
+    sf::Font font{};
+    ASSERT_TRUE(loadFont(font));
+    const GlyphRun run = layoutText("a b", font, Size, 0.f);
+
+    EXPECT_EQ(0u, run.vertexCount(0));
+    EXPECT_EQ(6u, run.vertexCount(1));
+    EXPECT_EQ(6u, run.vertexCount(2));
+    EXPECT_EQ(12u, run.vertexCount(3));
+    EXPECT_EQ(12u, run.vertexCount(99));
+}
+
+TEST(TextLayoutCache, SharesOneRunPerKey)
+{
+    sf::Font font{};
+    ASSERT_TRUE(loadFont(font));
+    TextLayoutCache cache{};
+
+    const auto first = cache.get("hello", font, Size, 0.f);
+    EXPECT_EQ(first, cache.get("hello", font, Size, 0.f));
+    EXPECT_NE(first, cache.get("hello", font, Size + 1, 0.f));
+    EXPECT_NE(first, cache.get("hello", font, Size, 100.f));
+    EXPECT_NE(first, cache.get("hello", font, Size, 0.f, sf::Color::Red));
+
+    const TextLayoutCache::Stats& stats = cache.getStats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(4u, stats.misses);
+    EXPECT_EQ(4u, stats.runs);
+    EXPECT_DOUBLE_EQ(0.2, stats.hitRate());
+}
+
+TEST(TextLayoutCache, CountsTheBytesOfEachRunAndItsString)
+{
+    sf::Font font{};
+    ASSERT_TRUE(loadFont(font));
+    TextLayoutCache cache{};
+
+    const auto shortRun = cache.get("ab", font, Size, 0.f);
+    const auto longRun = cache.get("a longer line", font, Size, 0.f);
+    EXPECT_EQ(shortRun->getMemoryUsage() + 2 + longRun->getMemoryUsage() + 13, cache.getStats().bytes);
+    EXPECT_EQ(chargeFor("ab", font) + chargeFor("a longer line", font), cache.getStats().bytes);
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.getStats().bytes);
+    EXPECT_EQ(0u, cache.getStats().runs);
+    cache.get("ab", font, Size, 0.f);
+    EXPECT_EQ(3u, cache.getStats().misses);
+}
+
+TEST(TextLayoutCache, EvictsTheLeastRecentlyUsedRun)
+{
+    sf::Font font{};
+    ASSERT_TRUE(loadFont(font));
+    const std::size_t each = chargeFor("aa", font);
+    ASSERT_EQ(each, chargeFor("bb", font));
+    ASSERT_EQ(each, chargeFor("cc", font));
+    TextLayoutCache cache{2 * each};
+
+    cache.get("aa", font, Size, 0.f);
+    const auto bb = cache.get("bb", font, Size, 0.f);
+    cache.get("aa", font, Size, 0.f);
+    cache.get("cc", font, Size, 0.f);
+
+    const TextLayoutCache::Stats& stats = cache.getStats();
+    EXPECT_EQ(1u, stats.evictions);
+    EXPECT_EQ(2u, stats.runs);
+    EXPECT_EQ(2 * each, stats.bytes);
+
+    // "aa" was touched after "bb", so "bb" went first and "aa" survived
+    const std::size_t misses = stats.misses;
+    cache.get("aa", font, Size, 0.f);
+    EXPECT_EQ(misses, stats.misses);
+    EXPECT_NE(bb, cache.get("bb", font, Size, 0.f));
+    EXPECT_EQ(misses + 1, stats.misses);
+
+    // ... which in turn pushed out "cc", now the oldest
+    EXPECT_EQ(2u, stats.evictions);
+    cache.get("aa", font, Size, 0.f);
+    cache.get("cc", font, Size, 0.f);
+    EXPECT_EQ(misses + 2, stats.misses);
+
+    // A handed-out run outlives its eviction
+    EXPECT_EQ(12u, bb->vertices.size());
+}
+
+TEST(TextLayoutCache, KeepsARunLargerThanTheBudgetUntilTheNext)
+{
+    sf::Font font{};
+    ASSERT_TRUE(loadFont(font));
+    TextLayoutCache cache{1};
+
+    cache.get("aa", font, Size, 0.f);
+    EXPECT_EQ(1u, cache.getStats().runs);
+    cache.get("bb", font, Size, 0.f);
+    EXPECT_EQ(1u, cache.getStats().runs);
+    EXPECT_EQ(1u, cache.getStats().evictions);
+    EXPECT_EQ(chargeFor("bb", font), cache.getStats().bytes);
+}
@@ -0,0 +1,209 @@
+#include "SkylinePacker.h"
+#include "TestFiles.h"
+#include "TextureAtlas.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+namespace {
+
+AtlasSource solid(const std::string& name, unsigned int w, unsigned int h, sf::Color color)
+{
+    AtlasSource source{};
+    source.name = name;
+    source.image.create(w, h, color);
+    return source;
+}
+
+void setModified(const std::string& path, std::time_t when, long nanoseconds)
+{
+    const timespec times[2] = {{when, nanoseconds}, {when, nanoseconds}};
+    ::utimensat(AT_FDCWD, path.c_str(), times, 0);
+}
+
+bool overlaps(const sf::IntRect& a, const sf::IntRect& b)
+{
+    return a.left < b.left + b.width && b.left < a.left + a.width
+        && a.top < b.top + b.height && b.top < a.top + a.height;
+}
+
+} /*namespace*/;
+
+
+TEST(SkylinePacker, PlacesRectanglesWithoutOverlap)
+{
+    SkylinePacker packer{{256, 256}};
+    std::vector<sf::IntRect> placed;
+    float area{0};
+    for (unsigned int i = 0; i < 40; ++i) {
+        const sf::Vector2u size{8 + (i * 7) % 41, 8 + (i * 13) % 29};
+        const auto at = packer.insert(size);
+        ASSERT_TRUE(at.has_value());
+        const sf::IntRect rect{int(at->x), int(at->y), int(size.x), int(size.y)};
+        EXPECT_LE(rect.left + rect.width, 256);
+        EXPECT_LE(rect.top + rect.height, 256);
+        for (const auto& other : placed) { EXPECT_FALSE(overlaps(rect, other)); }
+        placed.push_back(rect);
+        area += size.x * size.y;
+    }
+    EXPECT_FLOAT_EQ(packer.getOccupancy(), area / (256 * 256));
+}
+
+TEST(SkylinePacker, RejectsWhatDoesNotFit)
+{
+    SkylinePacker packer{{64, 64}};
+    EXPECT_FALSE(packer.insert({65, 1}).has_value());
+    EXPECT_TRUE(packer.insert({64, 48}).has_value());
+    EXPECT_FALSE(packer.insert({32, 32}).has_value());
+    EXPECT_TRUE(packer.insert({64, 16}).has_value());
+}
+
+TEST(TextureAtlas, PacksSourcesVerbatim)
+{
+    const std::vector<AtlasSource> sources{
+        solid("tiles", 384, 224, sf::Color::Red)
+      , solid("hero", 32, 48, sf::Color::Green)
+      , solid("coin", 16, 16, sf::Color::Blue)
+    };
+    AtlasOptions options{};
+    options.pageSize = {512, 512};
+    const TextureAtlas atlas = TextureAtlas::pack(sources, options);
+    ASSERT_EQ(atlas.getPages().size(), 1u);
+
+    const auto * hero = atlas.find("hero");
+    ASSERT_NE(hero, nullptr);
+    EXPECT_EQ(hero->rect.width, 32);
+    EXPECT_FLOAT_EQ(hero->uv.width, 32.f / 512.f);
+    EXPECT_EQ(atlas.getPages()[0].getPixel(hero->rect.left, hero->rect.top), sf::Color::Green);
+    EXPECT_FALSE(overlaps(hero->rect, atlas.find("tiles")->rect));
+
+    const sf::IntRect tile = atlas.remap("tiles", {16, 32, 16, 16});
+    EXPECT_EQ(tile.left, atlas.find("tiles")->rect.left + 16);
+    EXPECT_THROW(atlas.remap("missing", {}), std::out_of_range);
+}
+
+TEST(TextureAtlas, OpensPagesAsNeeded)
+{
+    std::vector<AtlasSource> sources;
+    for (int i = 0; i < 5; ++i) { sources.push_back(solid("s" + std::to_string(i), 100, 100, sf::Color::White)); }
+    AtlasOptions options{};
+    options.pageSize = {128, 128};
+    EXPECT_EQ(TextureAtlas::pack(sources, options).getPages().size(), 5u);
+
+    sources.push_back(solid("huge", 200, 10, sf::Color::White));
+    EXPECT_THROW(TextureAtlas::pack(sources, options), std::length_error);
+}
+
+TEST(TextureAtlas, RoundTripsThroughItsCacheFormat)
+{
+    AtlasOptions options{};
+    options.pageSize = {64, 64};
+    const TextureAtlas packed = TextureAtlas::pack({solid("a", 10, 20, sf::Color::Red), solid("b", 30, 5, sf::Color::Blue)}, options);
+    std::stringstream buffer{};
+    packed.save(buffer);
+    const TextureAtlas loaded = TextureAtlas::load(buffer);
+
+    EXPECT_EQ(loaded.getKey(), packed.getKey());
+    ASSERT_NE(loaded.find("b"), nullptr);
+    EXPECT_EQ(loaded.find("b")->rect, packed.find("b")->rect);
+    EXPECT_EQ(loaded.getPages()[0].getPixel(loaded.find("b")->rect.left, loaded.find("b")->rect.top), sf::Color::Blue);
+
+    std::stringstream garbage{"MINTATLS\x07"};
+    EXPECT_THROW(TextureAtlas::load(garbage), std::runtime_error);
+}
+
+TEST(TextureAtlas, RejectsCountsItsCacheCanNotHold)
+{
+    AtlasOptions options{};
+    options.pageSize = {64, 64};
+    std::stringstream buffer{};
+    TextureAtlas::pack({solid("a", 10, 20, sf::Color::Red)}, options).save(buffer);
+    const std::string saved = buffer.str();
+
+    // Magic, version and key, then the page count; one 64x64 page, then the region count
+    const std::size_t pageCount = 8 + 4 + 8, nameLength = pageCount + 4 + 8 + 64 * 64 * 4 + 4;
+    ASSERT_EQ(saved.size(), nameLength + 4 + 1 + 5 * 4);
+    for (const std::size_t at : {pageCount, nameLength}) {
+        std::string damaged = saved;
+        damaged.replace(at, 4, "\xff\xff\xff\x7f");
+        std::stringstream src{damaged};
+        EXPECT_THROW(TextureAtlas::load(src), std::runtime_error) << at;
+    }
+}
+
+TEST(TextureAtlas, KeysChangeWithAnyInput)
+{
+    const std::vector<AtlasSource> sources{solid("a", 4, 4, sf::Color::Red)};
+    const AtlasOptions options{};
+    const auto key = TextureAtlas::cacheKey(sources, options);
+    EXPECT_EQ(TextureAtlas::cacheKey(sources, options), key);
+    EXPECT_NE(TextureAtlas::cacheKey({solid("a", 4, 4, sf::Color::Blue)}, options), key);
+    EXPECT_NE(TextureAtlas::cacheKey({solid("b", 4, 4, sf::Color::Red)}, options), key);
+
+    AtlasOptions padded{};
+    padded.padding = 2;
+    EXPECT_NE(TextureAtlas::cacheKey(sources, padded), key);
+}
+
+TEST(TextureAtlas, KeysFilesByStampWithoutReadingThem)
+{
+    const std::string path = tempPath("hero.png");
+    std::ofstream{path, std::ios::binary} << "not even an image";
+    setModified(path, 1000, 100);
+    AtlasSource source{};
+    source.name = "hero", source.path = path;
+    const AtlasOptions options{};
+    const auto key = TextureAtlas::cacheKey({source}, options);
+    EXPECT_EQ(TextureAtlas::cacheKey({source}, options), key);
+
+    setModified(path, 1000, 200);
+    const auto touched = TextureAtlas::cacheKey({source}, options);
+    EXPECT_NE(touched, key);
+
+    std::ofstream{path, std::ios::binary | std::ios::app} << "!";
+    setModified(path, 1000, 200);
+    EXPECT_NE(TextureAtlas::cacheKey({source}, options), touched);
+
+    std::remove(path.c_str());
+    EXPECT_THROW(TextureAtlas::cacheKey({source}, options), std::runtime_error);
+}
+
+TEST(TextureAtlas, RejectsDuplicateNames)
+{
+    EXPECT_THROW(TextureAtlas::pack({solid("a", 4, 4, sf::Color::Red), solid("b", 4, 4, sf::Color::Red), solid("a", 2, 2, sf::Color::Blue)}),
+        std::invalid_argument);
+}
+
+TEST(TextureAtlas, LoadOrPackWritesThenReadsTheCache)
+{
+    const std::string dir = tempPath("atlases");
+    ASSERT_EQ(0, ::mkdir(dir.c_str(), 0700));
+    const std::vector<AtlasSource> sources{solid("a", 8, 8, sf::Color::Red)};
+    AtlasOptions options{};
+    options.pageSize = {32, 32};
+    const TextureAtlas first = TextureAtlas::loadOrPack(dir, sources, options);
+
+    char name[32];
+    std::snprintf(name, sizeof name, "/%016llx.atlas", static_cast<unsigned long long>(first.getKey()));
+    const std::string path = dir + name;
+    ASSERT_TRUE(std::ifstream{path}.good());
+
+    const TextureAtlas second = TextureAtlas::loadOrPack(dir, sources, options);
+    EXPECT_EQ(second.getKey(), first.getKey());
+    EXPECT_EQ(second.find("a")->rect, first.find("a")->rect);
+
+    // A damaged entry is packed again rather than thrown
+    std::ofstream{path, std::ios::binary | std::ios::trunc} << "MINTATLS";
+    const TextureAtlas third = TextureAtlas::loadOrPack(dir, sources, options);
+    EXPECT_EQ(third.find("a")->rect, first.find("a")->rect);
+    std::remove(path.c_str());
+    ::rmdir(dir.c_str());
+}
@@ -0,0 +1,175 @@
+#include "CommandList.h"
+#include "LevelInstance.h"
+#include "LevelMap.h"
+#include "RenderDevice.h"
+#include "TestWorlds.h"
+#include "TileMapRenderer.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+//! A `side` x `side` map of 16px tiles: a floor from tileset 0 and sparse walls from tileset 1
+std::shared_ptr<const LevelMap> makeField(unsigned int side)
+{
+    auto map = std::make_shared<LevelMap>();
+    map->name = "field";
+    map->size = {side, side};
+    map->tileSize = {16, 16};
+    Tileset ground{};
+    ground.firstGid = 1, ground.tileSize = {16, 16}, ground.columns = 8, ground.tileCount = 64;
+    Tileset walls{};
+    walls.firstGid = 65, walls.tileSize = {16, 16}, walls.columns = 8, walls.tileCount = 64;
+    map->tilesets = {ground, walls};
+    map->layers.emplace_back("floor", map->size, std::vector<std::uint32_t>(side * side, 1u));
+    std::vector<std::uint32_t> wallGids(side * side, 0u);
+    for (unsigned int i = 0; i < side; ++i) { wallGids[i] = 65u; }
+    map->layers.emplace_back("walls", map->size, std::move(wallGids));
+    return map;
+}
+
+//! Texture coordinates of the corners of a 1x1 map's only tile, clockwise from its top-left
+std::vector<sf::Vector2f> cornerTexCoords(std::uint32_t gid)
+{
+    auto map = std::make_shared<LevelMap>();
+    map->name = "tile";
+    map->size = {1, 1};
+    map->tileSize = {16, 16};
+    Tileset tiles{};
+    tiles.firstGid = 1, tiles.tileSize = {16, 16}, tiles.columns = 1, tiles.tileCount = 1;
+    map->tilesets = {tiles};
+    map->layers.emplace_back("floor", map->size, std::vector<std::uint32_t>{gid});
+
+    LevelInstance level{map};
+    TileMapRenderer renderer{level};
+    CommandList list{};
+    list.setView(sf::View{sf::FloatRect{0.f, 0.f, 16.f, 16.f}});
+    renderer.record(list, {});
+
+    std::vector<sf::Vector2f> corners;
+    list.forEach([&](std::uint64_t, const RenderCommand& cmd) {
+        // Two triangles: TL, TR, BR, then TL, BR, BL
+        if (cmd.count == 6) {
+            corners = {cmd.vertices[0].texCoords, cmd.vertices[1].texCoords, cmd.vertices[2].texCoords, cmd.vertices[5].texCoords};
+        }
+    });
+    return corners;
+}
+
+} /*namespace*/;
+
+
+TEST(TileMapRenderer, RecordsOnlyChunksInView)
+{
+    LevelInstance level{makeField(1000)};
+    TileMapRenderer tiles{level};
+    EXPECT_EQ(tiles.getChunkCount(), sf::Vector2u(32, 32));
+
+    // 512px chunks: a 800x600 view at the origin straddles 2x2 of them
+    CommandList list{};
+    list.setView(sf::View{sf::FloatRect{0.f, 0.f, 800.f, 600.f}});
+    tiles.record(list, {});
+    EXPECT_EQ(tiles.getStats().visibleChunks, 4u);
+    EXPECT_EQ(tiles.getStats().rebuiltChunks, 4u);
+
+    // The top row of chunks holds walls too, so it needs a second mesh
+    EXPECT_EQ(list.size(), 6u);
+}
+
+TEST(TileMapRenderer, CostFollowsTheViewNotTheMap)
+{
+    LevelInstance small{makeField(64)}, large{makeField(2000)};
+    TileMapRenderer smallTiles{small}, largeTiles{large};
+    const sf::View view{sf::FloatRect{600.f, 600.f, 320.f, 240.f}};
+
+    CommandList smallList{}, largeList{};
+    smallList.setView(view), largeList.setView(view);
+    smallTiles.record(smallList, {});
+    largeTiles.record(largeList, {});
+    EXPECT_EQ(smallTiles.getStats().visibleChunks, largeTiles.getStats().visibleChunks);
+    EXPECT_EQ(smallList.size(), largeList.size());
+}
+
+TEST(TileMapRenderer, EditsRebuildOnlyTheirChunk)
+{
+    LevelInstance level{makeField(256)};
+    TileMapRenderer tiles{level};
+    CommandList list{};
+    list.setView(sf::View{sf::FloatRect{0.f, 0.f, 4096.f, 4096.f}});
+    tiles.record(list, {});
+    EXPECT_EQ(tiles.getStats().rebuiltChunks, 64u);
+
+    list.clear();
+    tiles.record(list, {});
+    EXPECT_EQ(tiles.getStats().rebuiltChunks, 0u);
+
+    tiles.setTile(1, 40, 40, 66u);
+    EXPECT_EQ(level.getTile(1, 40, 40), 66u);
+    list.clear();
+    tiles.record(list, {});
+    EXPECT_EQ(tiles.getStats().rebuiltChunks, 1u);
+    EXPECT_EQ(tiles.getStats().meshes, 64u + 8u + 1u);
+}
+
+TEST(TileMapRenderer, SkipsViewsOutsideTheMap)
+{
+    LevelInstance level{makeField(100)};
+    TileMapRenderer tiles{level};
+    CommandList list{};
+    list.setView(sf::View{sf::FloatRect{-5000.f, -5000.f, 800.f, 600.f}});
+    tiles.record(list, {});
+    EXPECT_EQ(tiles.getStats().visibleChunks, 0u);
+    EXPECT_EQ(list.size(), 0u);
+}
+
+TEST(TileMapRenderer, CullsAgainstTheWorldsView)
+{
+    LevelInstance level{makeField(1000)};
+    TestWorld test{};
+    const TileMapRenderer& tiles = test.world.emplace<TileMapRenderer>(level);
+
+    // A 512px view well inside the map, one chunk from each edge of it
+    NullRenderDevice device{{512, 512}};
+    device.setView(sf::View{sf::FloatRect{2048.f, 2048.f, 512.f, 512.f}});
+    test.world.render(device);
+    EXPECT_EQ(tiles.getStats().visibleChunks, 1u);
+
+    device.setView(sf::View{sf::FloatRect{-5000.f, -5000.f, 512.f, 512.f}});
+    test.world.render(device);
+    EXPECT_EQ(tiles.getStats().visibleChunks, 0u);
+}
+
+TEST(TileMapRenderer, RejectsTilesOutsideTheMap)
+{
+    LevelInstance level{makeField(40)};
+    TileMapRenderer tiles{level};
+    tiles.invalidate(39, 39);
+    EXPECT_THROW(tiles.invalidate(40, 0), std::out_of_range);
+    EXPECT_THROW(tiles.invalidate(0, 40), std::out_of_range);
+    EXPECT_THROW(tiles.setTile(0, 40, 0, 1u), std::out_of_range);
+}
+
+TEST(TileMapRenderer, FlipsLikeTiled)
+{
+    // Tiled transposes (D) first, then mirrors horizontally (H), then vertically (V)
+    const std::uint32_t H = 0x80000000u, V = 0x40000000u, D = 0x20000000u;
+    const sf::Vector2f screen[4] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    for (std::uint32_t flags : {0u, H, V, D, H | V, H | D, V | D, H | V | D}) {
+        const auto corners = cornerTexCoords(1u | flags);
+        ASSERT_EQ(4u, corners.size());
+        for (int i = 0; i < 4; ++i) {
+            const float x = (flags & H) ? 1 - screen[i].x : screen[i].x;
+            const float y = (flags & V) ? 1 - screen[i].y : screen[i].y;
+            const sf::Vector2f expected = (flags & D) ? sf::Vector2f{16 * y, 16 * x} : sf::Vector2f{16 * x, 16 * y};
+            EXPECT_EQ(expected, corners[i]) << std::hex << flags << " corner " << i;
+        }
+    }
+
+    // D|H turns the tile a quarter clockwise: the top-left shows what was bottom-left
+    EXPECT_EQ(sf::Vector2f(0, 16), cornerTexCoords(1u | D | H)[0]);
+    // D|V turns it counter-clockwise: the top-left shows what was top-right
+    EXPECT_EQ(sf::Vector2f(16, 0), cornerTexCoords(1u | D | V)[0]);
+}
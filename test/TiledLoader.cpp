@@ -0,0 +1,271 @@
+#include "JsonReader.h"
+#include "TestFiles.h"
+#include "TiledLoader.h"
+#include "XmlReader.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <zlib.h>
+#include <cstdint>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::vector<std::uint32_t> Gids{1, 2, 3, 4, 5, 0x80000006u};
+
+std::string base64(const std::string& bytes)
+{
+    static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    std::size_t i = 0;
+    for (; i + 3 <= bytes.size(); i += 3) {
+        const std::uint32_t v = std::uint32_t(std::uint8_t(bytes[i])) << 16 | std::uint32_t(std::uint8_t(bytes[i + 1])) << 8 | std::uint8_t(bytes[i + 2]);
+        out += {digits[v >> 18], digits[(v >> 12) & 63], digits[(v >> 6) & 63], digits[v & 63]};
+    }
+    if (i + 1 == bytes.size()) {
+        const std::uint32_t v = std::uint32_t(std::uint8_t(bytes[i])) << 16;
+        out += {digits[v >> 18], digits[(v >> 12) & 63], '=', '='};
+    } else if (i + 2 == bytes.size()) {
+        const std::uint32_t v = std::uint32_t(std::uint8_t(bytes[i])) << 16 | std::uint32_t(std::uint8_t(bytes[i + 1])) << 8;
+        out += {digits[v >> 18], digits[(v >> 12) & 63], digits[(v >> 6) & 63], '='};
+    }
+    return out;
+}
+
+std::string littleEndian(const std::vector<std::uint32_t>& gids)
+{
+    std::string bytes;
+    for (std::uint32_t gid : gids) {
+        for (int b = 0; b < 4; ++b) { bytes += static_cast<char>((gid >> (8 * b)) & 0xff); }
+    }
+    return bytes;
+}
+
+std::string compressed(const std::string& bytes)
+{
+    uLongf size = compressBound(bytes.size());
+    std::string out(size, '\0');
+    compress(reinterpret_cast<Bytef *>(&out[0]), &size, reinterpret_cast<const Bytef *>(bytes.data()), bytes.size());
+    out.resize(size);
+    return out;
+}
+
+std::string tmx(const std::string& data)
+{
+    return "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<!-- exported -->\n"
+        "<map version=\"1.0\" width=\"3\" height=\"2\" tilewidth=\"16\" tileheight=\"8\">\n"
+        " <properties><property name=\"name\" value=\"cellar\"/></properties>\n"
+        " <tileset firstgid=\"1\" name=\"tiles\" tilewidth=\"16\" tileheight=\"8\" tilecount=\"24\" columns=\"6\">\n"
+        "  <image source=\"tiles.png\" width=\"96\" height=\"32\"/>\n"
+        " </tileset>\n"
+        " <tileset firstgid=\"25\" source=\"props.tsx\"/>\n"
+        " <group name=\"ground\">\n"
+        "  <layer name=\"floor\" width=\"3\" height=\"2\">\n" + data + "\n  </layer>\n"
+        " </group>\n"
+        " <objectgroup name=\"things\">\n"
+        "  <object id=\"4\" name=\"door &amp; frame\" type=\"door\" x=\"16\" y=\"8\" width=\"16\" height=\"8\"/>\n"
+        "  <object id=\"9\" gid=\"25\" x=\"32\" y=\"0\"><properties/></object>\n"
+        " </objectgroup>\n"
+        "</map>\n";
+}
+
+void expectCellar(const LevelMap& map)
+{
+    EXPECT_EQ("cellar", map.name);
+    EXPECT_EQ(sf::Vector2u(3, 2), map.size);
+    EXPECT_EQ(sf::Vector2u(16, 8), map.tileSize);
+    ASSERT_EQ(1u, map.layers.size());
+    EXPECT_EQ("floor", map.layers[0].getName());
+    EXPECT_EQ(Gids, std::vector<std::uint32_t>(map.layers[0].data(), map.layers[0].data() + 6));
+    ASSERT_EQ(2u, map.tilesets.size());
+    EXPECT_EQ("tiles.png", map.tilesets[0].image);
+    EXPECT_EQ(6u, map.tilesets[0].columns);
+    EXPECT_EQ(25u, map.tilesets[1].firstGid);
+    EXPECT_EQ("props.tsx", map.tilesets[1].name);
+    ASSERT_NE(nullptr, map.findObject(4));
+    EXPECT_EQ("door & frame", map.findObject(4)->name);
+    EXPECT_EQ("door", map.findObject(4)->type);
+    EXPECT_EQ(sf::FloatRect(16, 8, 16, 8), map.findObject(4)->bounds);
+    ASSERT_NE(nullptr, map.findObject(9));
+    EXPECT_EQ(25u, map.findObject(9)->gid);
+}
+
+LevelMap read(const std::string& text)
+{
+    std::istringstream src{text};
+    return readTiledMap(src, "unnamed");
+}
+
+} /*namespace*/;
+
+
+TEST(XmlReader, StreamsElementsAttributesAndText)
+{
+    std::istringstream src{"<a x='1' y=\"&lt;2&gt;\"><b/>one<![CDATA[<two>]]></a>"};
+    XmlReader xml{src, 4};
+
+    ASSERT_EQ(XmlReader::Event::StartElement, xml.next());
+    EXPECT_EQ("a", xml.getName());
+    ASSERT_NE(nullptr, xml.findAttribute("y"));
+    EXPECT_EQ("<2>", *xml.findAttribute("y"));
+    EXPECT_EQ(nullptr, xml.findAttribute("z"));
+    ASSERT_EQ(XmlReader::Event::StartElement, xml.next());
+    EXPECT_EQ("b", xml.getName());
+    ASSERT_EQ(XmlReader::Event::EndElement, xml.next());
+
+    std::string text;
+    XmlReader::Event e;
+    while ((e = xml.next()) == XmlReader::Event::Text) { text += xml.getText(); }
+    EXPECT_EQ("one<two>", text);
+    EXPECT_EQ(XmlReader::Event::EndElement, e);
+    EXPECT_EQ(XmlReader::Event::End, xml.next());
+}
+
+TEST(JsonReader, ToleratesStrayCommas)
+{
+    std::istringstream src{"{ \"a\": [1, 2,], , \"b\": \"x\\u00e9\", }"};
+    JsonReader json{src};
+    using Token = JsonReader::Token;
+
+    EXPECT_EQ(Token::BeginObject, json.next());
+    EXPECT_EQ(Token::Key, json.next());
+    EXPECT_EQ("a", json.getString());
+    EXPECT_EQ(Token::BeginArray, json.next());
+    EXPECT_EQ(Token::Number, json.next());
+    EXPECT_EQ(1u, json.getUnsigned());
+    EXPECT_EQ(Token::Number, json.next());
+    EXPECT_EQ(Token::EndArray, json.next());
+    EXPECT_EQ(Token::Key, json.next());
+    EXPECT_EQ(Token::String, json.next());
+    EXPECT_EQ("x\xc3\xa9", json.getString());
+    EXPECT_EQ(Token::EndObject, json.next());
+    EXPECT_EQ(Token::End, json.next());
+}
+
+TEST(TiledLoader, ReadsEveryTmxEncoding)
+{
+    const std::string bytes = littleEndian(Gids);
+    expectCellar(read(tmx("<data encoding=\"csv\">\n1,2,3,\n4,5,2147483654\n</data>")));
+    expectCellar(read(tmx("<data encoding=\"base64\">\n   " + base64(bytes) + "\n  </data>")));
+    expectCellar(read(tmx("<data encoding=\"base64\" compression=\"zlib\">" + base64(compressed(bytes)) + "</data>")));
+    expectCellar(read(tmx("<data><tile gid=\"1\"/><tile gid=\"2\"/><tile gid=\"3\"/><tile gid=\"4\"/><tile gid=\"5\"/><tile gid=\"2147483654\"/></data>")));
+}
+
+TEST(TiledLoader, ReadsJsonWhateverTheKeyOrder)
+{
+    const std::string bytes = littleEndian(Gids);
+    const std::string tail =
+        "], \"objects\": [], \"width\": 3, \"height\": 2, \"tilewidth\": 16, \"tileheight\": 8,\n"
+        "\"properties\": [{\"name\": \"name\", \"type\": \"string\", \"value\": \"cellar\"}],\n"
+        "\"tilesets\": [{\"firstgid\": 1, \"name\": \"tiles\", \"image\": \"tiles.png\", \"columns\": 6},\n"
+        "               {\"firstgid\": 25, \"source\": \"props.tsx\"},],\n"
+        "}";
+    const std::string objects =
+        "{\"type\": \"objectgroup\", \"objects\": [\n"
+        " {\"id\": 4, \"name\": \"door & frame\", \"type\": \"door\", \"x\": 16, \"y\": 8, \"width\": 16, \"height\": 8},\n"
+        " {\"id\": 9, \"gid\": 25, \"x\": 32, \"y\": 0, \"properties\": [{\"name\": \"a\", \"value\": [1, {}]}]}]}";
+    auto json = [&](const std::string& layer) {
+        return "{ \"layers\": [{\"type\": \"group\", \"layers\": [" + layer + "]}, " + objects + tail;
+    };
+
+    expectCellar(read(json("{\"data\": [1, 2, 3, 4, 5, 2147483654], \"name\": \"floor\", \"type\": \"tilelayer\", \"width\": 3, \"height\": 2}")));
+    expectCellar(read(json("{\"name\": \"floor\", \"width\": 3, \"height\": 2, \"encoding\": \"base64\", \"compression\": \"zlib\", "
+        "\"data\": \"" + base64(compressed(bytes)) + "\", \"type\": \"tilelayer\"}")));
+    expectCellar(read(json("{\"data\": \"" + base64(compressed(bytes)) + "\", \"compression\": \"zlib\", "
+        "\"encoding\": \"base64\", \"name\": \"floor\", \"type\": \"tilelayer\", \"width\": 3, \"height\": 2,}")));
+    expectCellar(read(json("{\"data\": \"" + base64(bytes) + "\", \"encoding\": \"base64\", "
+        "\"name\": \"floor\", \"type\": \"tilelayer\", \"width\": 3, \"height\": 2}")));
+}
+
+TEST(TiledLoader, NamesTheMapAfterItsSourceWithoutANameProperty)
+{
+    const LevelMap map = read("{\"width\": 1, \"height\": 1, \"properties\": {}, \"layers\": ["
+        "{\"type\": \"tilelayer\", \"name\": \"a\", \"width\": 1, \"height\": 1, \"data\": [7]}]}");
+
+    EXPECT_EQ("unnamed", map.name);
+    EXPECT_EQ(7u, map.layers.at(0).at(0, 0));
+}
+
+TEST(TiledLoader, RejectsWhatItCanNotRead)
+{
+    EXPECT_THROW(read(tmx("<data encoding=\"csv\">1,2,3</data>")), std::runtime_error);
+    EXPECT_THROW(read(tmx("<data encoding=\"base64\" compression=\"zstd\">AAAA</data>")), std::runtime_error);
+    EXPECT_THROW(read(tmx("<data encoding=\"base64\" compression=\"zlib\">" + base64(compressed(littleEndian(Gids))).substr(0, 12) + "</data>")), std::runtime_error);
+    EXPECT_THROW(read("<map width=\"2\" height=\"2\" infinite=\"1\"></map>"), std::runtime_error);
+    EXPECT_THROW(read("tiles"), std::runtime_error);
+}
+
+TEST(TiledLoader, RejectsLayerSizesTheDataDoesNotFill)
+{
+    auto layer = [](const std::string& size, const std::string& data) {
+        return "<map width=\"3\" height=\"2\"><layer name=\"floor\" " + size + ">" + data + "</layer></map>";
+    };
+    EXPECT_THROW(read(layer("width=\"0\" height=\"2\"", "<data encoding=\"csv\"></data>")), std::runtime_error);
+    EXPECT_THROW(read(layer("width=\"3\"", "<data encoding=\"csv\"></data>")), std::runtime_error);
+    EXPECT_THROW(read("{\"layers\": [{\"type\": \"tilelayer\", \"name\": \"a\", \"width\": 0, \"height\": 0, \"data\": []}]}"), std::runtime_error);
+
+    // A claim of four billion cells must fail on its data, not on its reservation
+    try {
+        read(layer("width=\"65536\" height=\"65536\"", "<data encoding=\"csv\">1,2,3</data>"));
+        FAIL() << "a 65536x65536 layer of three gids was accepted";
+    } catch (const std::bad_alloc&) {
+        FAIL() << "reserved the claimed size before decoding";
+    } catch (const std::runtime_error&) {
+    }
+    try {
+        read("{\"layers\": [{\"type\": \"tilelayer\", \"name\": \"a\", \"width\": 65536, \"height\": 65536, \"data\": [1, 2, 3]}]}");
+        FAIL() << "a 65536x65536 layer of three gids was accepted";
+    } catch (const std::bad_alloc&) {
+        FAIL() << "reserved the claimed size before decoding";
+    } catch (const std::runtime_error&) {
+    }
+}
+
+TEST(TiledLoader, StopsDecodingAtTheLayersSize)
+{
+    // 16 MiB of zeros which deflate to a few KiB, for a layer of six cells
+    const std::string bomb = base64(compressed(std::string(16u << 20, '\0')));
+    auto expectOverflow = [](const std::string& text) {
+        try {
+            read(text);
+            ADD_FAILURE() << "accepted more gids than the layer has cells";
+        } catch (const std::runtime_error& e) {
+            // Caught while decoding, not by the size check after the whole layer was kept
+            EXPECT_THAT(e.what(), ::testing::HasSubstr("more than 6 gids"));
+        }
+    };
+
+    expectOverflow(tmx("<data encoding=\"base64\" compression=\"zlib\">" + bomb + "</data>"));
+    expectOverflow(tmx("<data encoding=\"csv\">1,2,3,4,5,6,7</data>"));
+    expectOverflow(tmx("<data><tile/><tile/><tile/><tile/><tile/><tile/><tile/></data>"));
+    const std::string layer = "\"type\": \"tilelayer\", \"name\": \"floor\", \"encoding\": \"base64\", \"compression\": \"zlib\"";
+    expectOverflow("{\"layers\": [{" + layer + ", \"width\": 3, \"height\": 2, \"data\": \"" + bomb + "\"}]}");
+    expectOverflow("{\"layers\": [{\"data\": \"" + bomb + "\", " + layer + ", \"width\": 3, \"height\": 2}]}");
+    expectOverflow("{\"layers\": [{\"type\": \"tilelayer\", \"width\": 3, \"height\": 2, \"data\": [1, 2, 3, 4, 5, 6, 7]}]}");
+}
+
+TEST(TiledLoader, ReadsTheBundledMapInEitherFormat)
+{
+    const LevelMap tmx = readTiledFile(TEST_ASSETS "/tilesets/basic-map.tmx");
+    const LevelMap json = readTiledFile(TEST_ASSETS "/tilesets/basic-map.json");
+
+    for (const LevelMap * map : {&tmx, &json}) {
+        EXPECT_EQ("basic-map", map->name);
+        EXPECT_EQ(sf::Vector2u(23, 14), map->size);
+        EXPECT_EQ(sf::Vector2u(16, 16), map->tileSize);
+        ASSERT_EQ(1u, map->tilesets.size());
+        EXPECT_EQ("../images/basic-tiles.png", map->tilesets[0].image);
+        EXPECT_EQ(24u, map->tilesets[0].columns);
+        ASSERT_EQ(1u, map->layers.size());
+        EXPECT_EQ("Tile Layer 1", map->layers[0].getName());
+        EXPECT_EQ(1u, map->layers[0].at(0, 0));
+        EXPECT_EQ(25u, map->layers[0].at(0, 1));
+        EXPECT_EQ(335u, map->layers[0].at(22, 13));
+    }
+    EXPECT_EQ(std::vector<std::uint32_t>(tmx.layers[0].data(), tmx.layers[0].data() + 23 * 14),
+        std::vector<std::uint32_t>(json.layers[0].data(), json.layers[0].data() + 23 * 14));
+}
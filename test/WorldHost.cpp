@@ -0,0 +1,133 @@
+#include "GameContext.h"
+#include "TestWorlds.h"
+#include "WorkerPool.h"
+#include "WorldHost.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <SFML/System.hpp>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+
+TEST(WorkerPool, RunsEverySubmittedJob)
+{
+    std::atomic<int> ran{0};
+    WorkerPool pool{4};
+    for (int i = 0; i < 1000; ++i) {
+        pool.submit([&] { ran.fetch_add(1, std::memory_order_relaxed); });
+    }
+    pool.waitIdle();
+
+    EXPECT_EQ(1000, ran.load());
+}
+
+TEST(WorkerPool, WaitsOnlyForItsOwnLatch)
+{
+    std::mutex gate{};
+    std::unique_lock<std::mutex> hold{gate};
+    std::atomic<int> ran{0};
+    std::atomic<bool> started{false};
+    WorkerPool pool{2};
+    // Occupies one thread until released, which waitIdle would wait for
+    pool.submit([&] { started = true; std::lock_guard<std::mutex> lock{gate}; });
+    while (!started) { std::this_thread::yield(); }
+
+    WorkerPool::Latch latch{};
+    for (int i = 0; i < 100; ++i) {
+        pool.submit(latch, [&] { ran.fetch_add(1, std::memory_order_relaxed); });
+    }
+    pool.wait(latch);
+    EXPECT_EQ(100, ran.load());
+
+    hold.unlock();
+    pool.waitIdle();
+}
+
+TEST(WorkerPool, WaitingFromInsideAJobDoesNotDeadlock)
+{
+    std::atomic<int> ran{0};
+    WorkerPool pool{1};
+    WorkerPool::Latch outer{};
+    pool.submit(outer, [&] {
+        WorkerPool::Latch inner{};
+        for (int i = 0; i < 10; ++i) {
+            pool.submit(inner, [&] { ran.fetch_add(1, std::memory_order_relaxed); });
+        }
+        pool.wait(inner);
+        ran.fetch_add(100, std::memory_order_relaxed);
+    });
+    pool.wait(outer);
+
+    EXPECT_EQ(110, ran.load());
+}
+
+TEST(WorkerPool, AThrowingJobRunByAWaiterStillCountsAsDone)
+{
+    std::mutex gate{};
+    std::unique_lock<std::mutex> hold{gate};
+    std::atomic<bool> started{false};
+    WorkerPool pool{1};
+    // Keeps the only thread busy, so the waiter runs the queued jobs itself
+    pool.submit([&] { started = true; std::lock_guard<std::mutex> lock{gate}; });
+    while (!started) { std::this_thread::yield(); }
+
+    WorkerPool::Latch latch{};
+    pool.submit(latch, [] { throw std::runtime_error{"job failed"}; });
+    EXPECT_THROW(pool.wait(latch), std::runtime_error);
+
+    // Neither the latch nor the pool is left waiting for the failed job
+    pool.wait(latch);
+    std::atomic<int> ran{0};
+    pool.submit(latch, [&] { ++ran; });
+    pool.wait(latch);
+    EXPECT_EQ(1, ran.load());
+    hold.unlock();
+    pool.waitIdle();
+}
+
+TEST(WorldHost, TicksEachWorldAtItsOwnRate)
+{
+    GameContext context{};
+    WorldHost host{context, headlessSettings(), 2};
+    const auto fast = host.spawn(sf::milliseconds(5));
+    const auto slow = host.spawn(sf::milliseconds(25));
+    auto& fastCounter = host.getWorld(fast).emplace<CountingComp>();
+    auto& slowCounter = host.getWorld(slow).emplace<CountingComp>();
+
+    host.runSimulated(sf::milliseconds(250));
+
+    // Every 5 ms from 0, and every 25 ms from 12.5, the second world's stagger
+    EXPECT_EQ(50, fastCounter.updates);
+    EXPECT_EQ(10, slowCounter.updates);
+    EXPECT_EQ(50u, host.getStats(fast).ticks);
+    EXPECT_EQ(10u, host.getStats(slow).ticks);
+    EXPECT_EQ(0u, host.getStats(fast).dropped + host.getStats(slow).dropped);
+    EXPECT_NEAR(0.25f, fastCounter.elapsed, 1e-4f);
+}
+
+TEST(WorldHost, AccountsForEveryTickItRuns)
+{
+    GameContext context{};
+    WorldHost host{context, GameSettings{}, 2};
+    const auto world = host.spawn(sf::milliseconds(5));
+    auto& counter = host.getWorld(world).emplace<CountingComp>();
+
+    host.runFor(sf::milliseconds(50));
+
+    EXPECT_TRUE(host.getWorld(world).isHeadless());
+    EXPECT_EQ(static_cast<int>(host.getStats(world).ticks), counter.updates);
+    EXPECT_GT(counter.updates, 0);
+}
+
+TEST(WorldHost, SharesOneContext)
+{
+    GameContext context{};
+    WorldHost host{context, GameSettings{}, 1};
+    const auto a = host.spawn(sf::milliseconds(10));
+    const auto b = host.spawn(sf::milliseconds(10));
+
+    EXPECT_EQ(&context, &host.getWorld(a).getContext());
+    EXPECT_EQ(&host.getWorld(a).getContext(), &host.getWorld(b).getContext());
+}